@@ -22,6 +22,7 @@
 #ifndef DAVIX_FILE_TYPES_HPP
 #define DAVIX_FILE_TYPES_HPP
 
+#include <functional>
 #include <memory>
 #include <utils/davix_types.hpp>
 #include <utils/davix_uri.hpp>
@@ -44,6 +45,7 @@ typedef struct Davix_fd DAVIX_FD;
 
 namespace Davix{
 
+class DavixError;
 
 /// @struct DavIOVecInput
 /// @brief input parameters for vector operations in Davix
@@ -60,16 +62,42 @@ struct DAVIX_EXPORT DavIOVecOuput{
     dav_ssize_t diov_size;                /**< size of the data returned, -1 if error */
 };
 
+/// @struct VecReadPlan
+/// @brief strategy chosen by davix to execute a vector read
+///
+/// Unless overridden with the "mergewindow" / "nconnections" URL fragment
+/// parameters, both are derived from the latency and throughput observed
+/// so far on the same endpoint.
+struct DAVIX_EXPORT VecReadPlan{
+    VecReadPlan() : merge_window(0), nconnections(0), adaptive(false), ranges(0), bytes_requested(0), bytes_overread(0) {}
+
+    dav_size_t merge_window;              /**< ranges closer than this are fetched together, gap included */
+    dav_size_t nconnections;              /**< maximum number of requests in flight at the same time */
+    bool adaptive;                        /**< true if derived from endpoint statistics, false for defaults or user-provided values */
+    dav_size_t ranges;                    /**< number of ranges after merging */
+    dav_size_t bytes_requested;           /**< bytes requested by the user, overlaps counted once */
+    dav_size_t bytes_overread;            /**< bytes fetched only because they lie between merged ranges */
+};
+
+/// @brief completion callback of asynchronous I/O operations
+///
+/// Called from a davix worker thread with the result of the operation, or
+/// with -1 and the error that occurred. The error belongs to davix and is
+/// only valid for the duration of the call. The callback must not throw.
+typedef std::function<void (dav_ssize_t result, DavixError* err)> IOCallback;
+
 
 /// @enum advise_t
 /// Information about the next type of operation executed
 /// AdviseAuto : default operation, no optimization
 /// AdviseSequentialRead : optimize next operation for sequential read/write
 /// AdviseRandomRead: optimize next operation for random position read/write
+/// AdviseWillNeed: the given range is going to be read, fetch it in the background
 enum DAVIX_EXPORT advise_t{
     AdviseAuto=0x00,
     AdviseSequential,
     AdviseRandom,
+    AdviseWillNeed,
 
 };
 
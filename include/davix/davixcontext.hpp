@@ -48,6 +48,98 @@ class DavPosix;
 
 
 
+/// @brief Connection usage of a Context's requests (libcurl backend only),
+/// see RequestParams::setHttp2Multiplexing
+struct DAVIX_EXPORT ConnectionStats
+{
+    ConnectionStats();
+
+    /// requests which had to open a new connection
+    uint64_t newConnections;
+    /// requests which ran over an already established connection
+    uint64_t reusedConnections;
+    /// requests carried over HTTP/2
+    uint64_t http2Streams;
+    /// HTTP/2 requests multiplexed over an already established connection
+    uint64_t multiplexedStreams;
+};
+
+
+/// @brief Usage statistics of a Context's pool of upload part buffers
+struct DAVIX_EXPORT BufferPoolStats
+{
+    BufferPoolStats();
+
+    /// requests served with a cached buffer
+    uint64_t hits;
+    /// requests which needed a fresh allocation
+    uint64_t misses;
+    /// requests which hit the memory limit, and had to wait or go without
+    uint64_t waits;
+    /// bytes currently held by the pool, in use or cached
+    dav_size_t allocatedBytes;
+    /// bytes currently cached for reuse
+    dav_size_t cachedBytes;
+    /// highest value of allocatedBytes so far
+    dav_size_t highWaterMark;
+};
+
+
+/// @brief Usage statistics of a Context's block cache, see Context::setBlockCacheLimit
+struct DAVIX_EXPORT BlockCacheStats
+{
+    BlockCacheStats();
+
+    /// blocks served from the cache
+    uint64_t hits;
+    /// blocks which had to be fetched
+    uint64_t misses;
+    /// blocks which were being fetched already, and waited for
+    uint64_t coalesced;
+    /// blocks evicted to stay under the memory limit
+    uint64_t evictions;
+    /// bytes currently cached
+    dav_size_t cachedBytes;
+
+    /// fraction of block lookups which sent no request, 0 if none was made
+    double hitRatio() const;
+};
+
+
+/// @brief Counters of a Context's hedged reads, see RequestParams::setHedgePercentile
+struct DAVIX_EXPORT HedgingStats
+{
+    HedgingStats();
+
+    /// reads made with hedging enabled
+    uint64_t reads;
+    /// reads which were duplicated
+    uint64_t hedged;
+    /// duplicated reads answered first by the duplicate
+    uint64_t wins;
+
+    /// fraction of reads which were duplicated, 0 if none was made
+    double hedgeRatio() const;
+};
+
+
+/// @brief Counters of a Context's retries, see Context::setRetryBudget
+/// and Context::setCircuitBreaker
+struct DAVIX_EXPORT RetryStats
+{
+    RetryStats();
+
+    /// operations retried
+    uint64_t retries;
+    /// operations which failed instead of retrying, for lack of retry budget
+    uint64_t budgetExhausted;
+    /// circuits opened, endpoints considered down
+    uint64_t circuitOpenings;
+    /// operations which failed right away, their endpoint being down
+    uint64_t fastFailures;
+};
+
+
 /// @brief Main handle for Davix
 ///
 /// Each new davix context contains its own session-reuse pool and set of parameters
@@ -110,7 +202,103 @@ public:
     /// get session caching status
     bool getSessionCaching() const;
 
-    /// clear both redirect and session cache
+    /// close idle connections which outlived their idle timeout (see
+    /// RequestParams::setIdleConnectionTimeout) from a background thread,
+    /// every "interval" seconds. 0 disables the reaper, which is the default:
+    /// stale connections are then only dropped the next time a connection
+    /// to the same host is needed
+    void setIdleConnectionReaping(unsigned int interval);
+
+    /// get the idle connection reaping interval in seconds, 0 if disabled
+    unsigned int getIdleConnectionReaping() const;
+
+    /// get the connection usage counters of the requests made with libcurl,
+    /// reset by clearCache
+    ConnectionStats getConnectionStats() const;
+
+    /// set the maximum amount of memory used for the parts of multi-part
+    /// uploads, across all uploads of this context. Once reached, uploads
+    /// send fewer parts in parallel, or wait for memory to be freed.
+    /// Default 1 GB
+    void setUploadBufferLimit(dav_size_t limit);
+
+    /// get the maximum amount of memory used for multi-part upload buffers
+    dav_size_t getUploadBufferLimit() const;
+
+    /// get usage statistics of the multi-part upload buffers
+    BufferPoolStats getUploadBufferStats() const;
+
+    /// set the maximum amount of memory used to cache blocks of remote
+    /// files read with pread, across all files of this context. Small
+    /// position independent reads are then served in blocks of 64 KB, kept
+    /// until the entity tag of the file changes or they are evicted.
+    /// 0 disables the cache, which is the default
+    void setBlockCacheLimit(dav_size_t limit);
+
+    /// get the maximum amount of memory used by the block cache
+    dav_size_t getBlockCacheLimit() const;
+
+    /// get usage statistics of the block cache
+    BlockCacheStats getBlockCacheStats() const;
+
+    /// set for how long, in seconds, the replicas listed by the Metalink of
+    /// a file are remembered, so that a failover doesn't fetch the Metalink
+    /// again. Files without Metalink are remembered as such.
+    /// 0 disables the cache. Default 300
+    void setReplicaCacheTtl(unsigned int ttl);
+
+    /// get for how long the replicas of a file are remembered, in seconds
+    unsigned int getReplicaCacheTtl() const;
+
+    /// set the maximum number of files whose replicas are remembered,
+    /// the least recently used are dropped first. Default 10000
+    void setReplicaCacheMaxEntries(size_t maxEntries);
+
+    /// get the maximum number of files whose replicas are remembered
+    size_t getReplicaCacheMaxEntries() const;
+
+    /// set for how long, in seconds, a replica which failed is skipped
+    /// on failover - unless all replicas of the file failed.
+    /// 0 disables it. Default 60
+    void setReplicaCooldown(unsigned int cooldown);
+
+    /// get for how long a replica which failed is skipped, in seconds
+    unsigned int getReplicaCooldown() const;
+
+    /// get the counters of hedged reads
+    HedgingStats getHedgingStats() const;
+
+    /// set the retry budget of each endpoint: a retry takes one of "burst"
+    /// tokens, which are given back at "rate" per second. Once an endpoint
+    /// has none left, its operations fail instead of retrying, so that
+    /// retries can't flood a server in trouble.
+    /// A burst of 0 disables the budget. Default 100 tokens, 10 per second
+    void setRetryBudget(double burst, double rate);
+
+    /// get the number of retry tokens of each endpoint
+    double getRetryBudgetBurst() const;
+
+    /// get the number of retry tokens given back every second
+    double getRetryBudgetRate() const;
+
+    /// set the circuit breaker of each endpoint: after "threshold" failures
+    /// in a row - connection errors, timeouts, server errors - an endpoint is
+    /// considered down, and its operations fail right away for "cooldown"
+    /// milliseconds. A single operation is then sent to check whether it's
+    /// back. A threshold of 0 disables it. Default 20 failures, 5000 ms
+    void setCircuitBreaker(unsigned int threshold, unsigned int cooldown);
+
+    /// get the number of failures in a row opening the circuit of an endpoint
+    unsigned int getCircuitBreakerThreshold() const;
+
+    /// get for how long an endpoint considered down is left alone, in milliseconds
+    unsigned int getCircuitBreakerCooldown() const;
+
+    /// get the counters of retries
+    RetryStats getRetryStats() const;
+
+    /// clear the redirect, session, block and replica caches, and forget the multi-range capabilities,
+    /// read latencies, retry budgets and circuit breakers of known servers
     void clearCache();
 
 private:
@@ -22,12 +22,15 @@
 #ifndef DAVFILE_HPP
 #define DAVFILE_HPP
 
+#include <functional>
+#include <future>
 #include <memory>
 #include <istream>
 #include <ostream>
 #include <davixcontext.hpp>
 #include <params/davixrequestparams.hpp>
 #include <file/davix_file_info.hpp>
+#include <file/davix_listing_batch.hpp>
 #include <compat/deprecated.hpp>
 
 
@@ -75,6 +78,26 @@ public:
            std::shared_ptr<Internal> d_ptr;
     };
 
+    class BatchIterator{
+        friend struct DavFileInternal;
+        public:
+            BatchIterator() : d_ptr() {}
+            BatchIterator(const BatchIterator & orig) : d_ptr(orig.d_ptr){}
+
+            ///
+            ///  @brief Replace the content of batch with the next entries
+            ///
+            ///  @param batch filled with about count entries, sometimes a few more
+            ///  @param count number of entries to fetch
+            ///  @return false once the end of the collection is reached
+            ///  @throw  throw @ref DavixException if an error occurs
+            bool next(ListingBatch & batch, size_t count = 4096);
+        private:
+           struct Internal;
+
+           std::shared_ptr<Internal> d_ptr;
+    };
+
     ///
     /// \brief default constructor
     /// \param c context
@@ -151,10 +174,78 @@ public:
                             dav_off_t offset,
                             DavixError** err) throw();
 
+    ///
+    ///  @brief Asynchronous vector read operation
+    ///
+    ///         Same as @ref readPartialBufferVec, but returns immediately:
+    ///         the read runs on the I/O worker threads shared by everything
+    ///         using the same Context.
+    ///         Buffers and vectors must stay valid until the read completes.
+    ///
+    ///  @param params Davix request Parameters
+    ///  @param input_vec input vectors, parameters
+    ///  @param ioutput_vec  output vectors, results
+    ///  @param count_vec  number of vector
+    ///  @return future holding the total number of bytes read,
+    ///          throws DavixException from get() on error
+    std::future<dav_ssize_t> readPartialBufferVecAsync(const RequestParams* params,
+                          const DavIOVecInput * input_vec,
+                          DavIOVecOuput * ioutput_vec,
+                          const dav_size_t count_vec);
+
+    ///
+    ///  @brief Asynchronous vector read operation, reporting to a callback
+    ///
+    ///  @param params Davix request Parameters
+    ///  @param input_vec input vectors, parameters
+    ///  @param ioutput_vec  output vectors, results
+    ///  @param count_vec  number of vector
+    ///  @param callback called from a worker thread once the read completes
+    void readPartialBufferVecAsync(const RequestParams* params,
+                          const DavIOVecInput * input_vec,
+                          DavIOVecOuput * ioutput_vec,
+                          const dav_size_t count_vec,
+                          const IOCallback & callback);
+
+    ///
+    ///  @brief Asynchronous partial position independant read
+    ///
+    ///         Same as @ref readPartial, but returns immediately:
+    ///         the read runs on the I/O worker threads shared by everything
+    ///         using the same Context.
+    ///         The buffer must stay valid until the read completes.
+    ///
+    ///  @param params Davix request Parameters
+    ///  @param buff  buffer
+    ///  @param count  maximum read size
+    ///  @param offset  starting offset for the read operation
+    ///  @return future holding the total number of bytes read,
+    ///          throws DavixException from get() on error
+    std::future<dav_ssize_t> readPartialAsync(const RequestParams* params,
+                            void* buff,
+                            dav_size_t count,
+                            dav_off_t offset);
+
+    ///
+    ///  @brief Asynchronous partial position independant read, reporting to a callback
+    ///
+    ///  @param params Davix request Parameters
+    ///  @param buff  buffer
+    ///  @param count  maximum read size
+    ///  @param offset  starting offset for the read operation
+    ///  @param callback called from a worker thread once the read completes
+    void readPartialAsync(const RequestParams* params,
+                            void* buff,
+                            dav_size_t count,
+                            dav_off_t offset,
+                            const IOCallback & callback);
+
 
     ///
     ///  @brief Get the full file content and write it to file descriptor
     ///
+    ///  Regular files can be written in parallel segments, see RequestParams::setDownloadParallelism
+    ///
     ///  @param params Davix request Parameters
     ///  @param fd  file descriptor for write operation
     ///  @param err Davix error report
@@ -340,6 +431,42 @@ public:
     ///  @snippet example_code_snippets.cpp listCollection
     Iterator  listCollection(const RequestParams* params);
 
+    ///
+    ///  @brief Collection listing, by batches
+    ///
+    ///  Same as listCollection, without an allocation per entry: entries
+    ///  are parsed straight into a @ref ListingBatch - meant for very large
+    ///  collections, like S3 buckets of millions of objects.
+    ///
+    ///  @param params Davix request parameters
+    ///  @return BatchIterator to the collection
+    BatchIterator listCollectionBatches(const RequestParams* params);
+
+    ///
+    ///  @brief callback of a recursive walk: path of an entry, relative to
+    ///  the walked collection, and its meta-data
+    ///
+    typedef std::function<void (const std::string & path, const StatInfo & info)> WalkCallback;
+
+    ///
+    ///  @brief Recursive collection listing
+    ///
+    ///  Call callback for every entry below the current collection, on the
+    ///  calling thread, with its path relative to the collection.
+    ///
+    ///  WebDAV collections are first walked with a single PROPFIND
+    ///  "Depth: infinity", entries streaming out in the server's order. If
+    ///  the server refuses it - or for S3, Azure, Swift - each collection is
+    ///  listed on its own, several at once on the Context's worker pool (see
+    ///  RequestParams::setWalkParallelism and RequestParams::setWalkHostLimit).
+    ///  Entries then come out in order: each collection's entries as listed,
+    ///  every sub-collection's contents right after its own entry.
+    ///
+    ///  @param params Davix request parameters
+    ///  @param callback called for each entry; may throw to stop the walk
+    ///  @throw  throw @ref DavixException if a listing fails
+    void walk(const RequestParams* params, const WalkCallback & callback);
+
 
     ///
     ///  @brief compute checksum of the file
@@ -0,0 +1,106 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef DAVIX_LISTING_BATCH_HPP
+#define DAVIX_LISTING_BATCH_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <davix_file_types.hpp>
+
+
+///
+/// @file davix_listing_batch.hpp
+///
+///  Compact container for large collection listings
+
+
+namespace Davix{
+
+///
+/// @class ListingBatch
+/// @brief A batch of collection entries, stored contiguously
+///
+/// All names sit in one string blob, and every entry is a fixed-size record
+/// of its StatInfo and the position of its name in the blob: listing a
+/// million entries costs a handful of allocations, not a million - and none
+/// at all once a reused batch has grown to size.
+///
+/// Name views point into the blob, they are only valid until the next
+/// append() or clear().
+///
+class ListingBatch{
+public:
+    ListingBatch() : _names(), _records() {}
+
+    /// number of entries
+    size_t size() const { return _records.size(); }
+
+    /// true if there is no entry
+    bool empty() const { return _records.empty(); }
+
+    /// name of entry i
+    std::string_view name(size_t i) const {
+        const Record & r = _records[i];
+        return std::string_view(_names.data() + r.offset, r.length);
+    }
+
+    /// meta-data of entry i
+    const StatInfo & info(size_t i) const { return _records[i].info; }
+
+    /// add an entry
+    void append(std::string_view name, const StatInfo & info){
+        Record r;
+        r.info = info;
+        r.offset = _names.size();
+        r.length = name.size();
+        _names.append(name.data(), name.size());
+        _records.push_back(r);
+    }
+
+    /// remove all entries, keeping the memory for the next ones
+    void clear(){
+        _names.clear();
+        _records.clear();
+    }
+
+    /// make room for "entries" entries, of "nameBytes" bytes of names in total
+    void reserve(size_t entries, size_t nameBytes){
+        _records.reserve(entries);
+        _names.reserve(nameBytes);
+    }
+
+private:
+    struct Record{
+        StatInfo info;
+        size_t offset;
+        size_t length;
+    };
+
+    std::string _names;
+    std::vector<Record> _records;
+};
+
+} // Davix
+
+
+#endif // DAVIX_LISTING_BATCH_HPP
@@ -25,6 +25,8 @@
 
 
 
+#include <functional>
+#include <future>
 #include <davix_file_types.hpp>
 #include <davixcontext.hpp>
 #include <params/davixrequestparams.hpp>
@@ -190,6 +192,27 @@ public:
     */
     int closedirpp(DAVIX_DIR* d, DavixError** err );
 
+    /**
+      @brief callback of a recursive walk: path of an entry, relative to the
+      walked directory, and its stat() information
+    */
+    typedef std::function<void (const std::string & path, const struct stat & st)> WalkCallback;
+
+    /**
+      @brief walk a directory recursively
+
+      Call callback for every entry below the directory, with its path
+      relative to it. See \ref Davix::DavFile::walk for the order of the
+      entries and the way directories are listed.
+
+      @param params request options, can be NULL
+      @param url url of the directory to walk
+      @param callback called for each entry; may throw to stop the walk
+      @param err Davix error report system
+      @return 0 if success, or -1 if error, in this case err is set.
+    */
+    int walk(const RequestParams* params, const std::string & url, const WalkCallback & callback, DavixError** err);
+
     /**
       @brief execute a mkdir function with Webdav.
 
@@ -354,6 +377,62 @@ public:
                           DavIOVecOuput * output_vec,
                           dav_size_t count_vec, DavixError** err);
 
+    /**
+      @brief asynchronous version of /ref Davix::DavPosix::pread64
+
+      Returns immediately, the read runs on the I/O worker threads of the
+      parent davix context. The file descriptor and the buffer must stay
+      valid until the read completes.
+
+      @param fd davix file descriptor
+      @param buffer buffer to fill
+      @param count maximum number of bytes to read
+      @param offset  offset to use
+      @return future holding the size of data, throws DavixException from get() on error
+     */
+    std::future<dav_ssize_t> preadAsync(DAVIX_FD* fd, void* buffer, dav_size_t count, dav_off_t offset);
+
+    /**
+      @brief asynchronous version of /ref Davix::DavPosix::pread64, reporting to a callback
+
+      @param fd davix file descriptor
+      @param buffer buffer to fill
+      @param count maximum number of bytes to read
+      @param offset  offset to use
+      @param callback called from a worker thread once the read completes
+     */
+    void preadAsync(DAVIX_FD* fd, void* buffer, dav_size_t count, dav_off_t offset, const IOCallback & callback);
+
+    /**
+      @brief asynchronous version of /ref Davix::DavPosix::preadVec
+
+      Returns immediately, the read runs on the I/O worker threads of the
+      parent davix context. The file descriptor, the buffers and vectors
+      must stay valid until the read completes.
+
+      @param fd davix file descriptor
+      @param input_vec input vectors, parameters
+      @param output_vec output vectors, results
+      @param count_vec number of vector struct
+      @return future holding the total number of bytes read, throws DavixException from get() on error
+     */
+    std::future<dav_ssize_t> preadVecAsync(DAVIX_FD* fd, const DavIOVecInput * input_vec,
+                          DavIOVecOuput * output_vec,
+                          dav_size_t count_vec);
+
+    /**
+      @brief asynchronous version of /ref Davix::DavPosix::preadVec, reporting to a callback
+
+      @param fd davix file descriptor
+      @param input_vec input vectors, parameters
+      @param output_vec output vectors, results
+      @param count_vec number of vector struct
+      @param callback called from a worker thread once the read completes
+     */
+    void preadVecAsync(DAVIX_FD* fd, const DavIOVecInput * input_vec,
+                          DavIOVecOuput * output_vec,
+                          dav_size_t count_vec, const IOCallback & callback);
+
     /**
       @brief write a file in a POSIX-like approach with HTTP(S).
 
@@ -409,10 +488,16 @@ public:
       similar to posix_fadvise, allow I/O optimizations
       non-blocking asynchronous function
 
+      With AdviseWillNeed, the chunk is fetched in the background into the
+      read-ahead cache of the descriptor, later read() and pread() calls
+      are served from. With AdviseSequential, read() keeps a window of data
+      fetched ahead of the current position. See
+      RequestParams::setReadAheadLimit.
+
       @param fd Davix file descriptor
       @param offset offset of the next chunk to read
       @param len size of the next chunk to read
-      @param advise type of pattern for I/O : sequential, random
+      @param advise type of pattern for I/O : sequential, random, or will need
     */
     void fadvise(DAVIX_FD* fd, dav_off_t offset, dav_size_t len, advise_t advise);
 
@@ -25,6 +25,7 @@
 
 #include <utils/davix_types.hpp>
 #include <request/httprequest.hpp>
+#include <davix_file_types.hpp>
 
 
 /**
@@ -53,6 +54,9 @@ typedef std::function<void (HttpRequest& req, const std::string & start_line) >
 /// Hook called when receiving any request, just after receiving headers
 typedef std::function<void (HttpRequest& req, const std::string & init_line, const HeaderVec & headers, int status_code) > RequestPreReceHook;
 
+/// Hook called once the strategy of a vector read has been decided, before executing it
+typedef std::function<void (const Uri & u, const VecReadPlan & plan) > VecReadPlanHook;
+
 
 #endif
 
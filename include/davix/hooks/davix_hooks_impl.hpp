@@ -43,6 +43,8 @@ public:
 
     RequestPreReceHook _pre_rece_req;
 
+    VecReadPlanHook _vec_read_plan;
+
 private:
     HookList();
     friend struct ContextInternal;
@@ -72,6 +74,11 @@ inline void hookDefine(HookList &c, const RequestPreReceHook & hook){
     c._pre_rece_req = hook;
 }
 
+template<>
+inline void hookDefine(HookList &c, const VecReadPlanHook & hook){
+    c._vec_read_plan = hook;
+}
+
 
 // get
 template<typename HookType>
@@ -95,6 +102,11 @@ inline const RequestPreReceHook & hookGet(HookList & c){
     return c._pre_rece_req;
 }
 
+template<>
+inline const VecReadPlanHook & hookGet(HookList & c){
+    return c._vec_read_plan;
+}
+
 
 #endif
 
@@ -72,7 +72,9 @@ namespace MetalinkMode{
         Disable,
         // Use only for failover purpose
         FailOver,
-        // Enable parallel DL
+        // Download from all replicas at once: getToFd, getFull and large
+        // reads are striped across them, see RequestParams::setDownloadSegmentSize.
+        // Failover for everything else
         XStream
     };
 }
@@ -304,7 +304,8 @@ public:
     /// \brief Delay in second between retry attempts
     ///// \param delay_retry
     ///
-    /// define the number of seconds between retry attempts in case of slow servers
+    /// define the number of seconds before the first retry attempt in case of slow
+    /// servers, replacing the base of the backoff, see \ref setRetryBackoffBase
     void setOperationRetryDelay(int delay_retry);
 
 
@@ -431,6 +432,171 @@ public:
     /// perform in case it receives 202-Accepted on a GET request
     /// @param delay the delay in seconds
     void setAcceptedRetryDelay(int delay);
+
+    /// enable HTTP/2 multiplexing (libcurl backend only). Concurrent requests
+    /// to the same endpoint then share a single connection whenever the server
+    /// supports HTTP/2, instead of opening one connection each, see
+    /// Context::getConnectionStats
+    void setHttp2Multiplexing(bool enabled);
+
+    /// get whether HTTP/2 multiplexing is enabled
+    bool getHttp2Multiplexing() const;
+
+    /// set the maximum number of concurrent HTTP/2 streams per connection,
+    /// additional requests open a new connection
+    /// @param max_streams maximum number of streams, default 100
+    void setMaxConcurrentStreams(unsigned int max_streams);
+
+    /// get the maximum number of concurrent HTTP/2 streams per connection
+    unsigned int getMaxConcurrentStreams() const;
+
+    /// set how long a connection may stay idle in the pool before it is
+    /// considered stale, and closed rather than reused. Servers close idle
+    /// connections on their own after a while, reusing such a connection
+    /// costs a failed request and a round trip.
+    /// A zero timeout keeps idle connections forever, default 30s
+    void setIdleConnectionTimeout(struct timespec* idle_timeout);
+
+    /// get the idle connection timeout
+    const struct timespec* getIdleConnectionTimeout() const;
+
+    /// set the maximum number of idle connections kept per host for reuse,
+    /// the least recently used ones are closed first. libcurl keeps no
+    /// per-host limit: with the curl backend, the limit applies to each
+    /// connection cache - that of a shared event loop, or of a request
+    /// @param max_idle maximum number of idle connections, 0 for unlimited, default 16
+    void setMaxIdleConnections(unsigned int max_idle);
+
+    /// get the maximum number of idle connections kept per host
+    unsigned int getMaxIdleConnections() const;
+
+    /// set the size of the parts large S3, Swift and Azure uploads are split
+    /// into. It is grown as needed for objects which would otherwise exceed
+    /// the maximum number of parts of the service. Default 32 MB
+    void setUploadPartSize(dav_size_t part_size);
+
+    /// get the size of the parts of multi-part uploads
+    dav_size_t getUploadPartSize() const;
+
+    /// set the number of parts of a multi-part upload sent in parallel, while
+    /// the next part is read. Each costs a part-sized buffer. Default 4
+    void setUploadParallelism(unsigned int parallelism);
+
+    /// get the number of parts of a multi-part upload sent in parallel
+    unsigned int getUploadParallelism() const;
+
+    /// make multi-part uploads resumable: the upload id, part size and
+    /// completed parts are recorded in a local file at "path". An upload
+    /// which fails can then be resumed by uploading the same object again
+    /// with the same manifest path - only the missing parts are sent, and
+    /// parts whose data changed since. An upload from a file modified or
+    /// replaced since starts over. The file is removed once the upload
+    /// completes. Default: empty, disabled
+    void setUploadManifest(const std::string &path);
+
+    /// get the path of the multi-part upload manifest, empty if disabled
+    const std::string & getUploadManifest() const;
+
+    /// set the number of pages of an S3 listing fetched in the background,
+    /// ahead of the page being read. Default 0: each page is only requested
+    /// once the previous one has been read
+    void setListingPrefetch(unsigned int pages);
+
+    /// get the number of listing pages fetched ahead
+    unsigned int getListingPrefetch() const;
+
+    /// set the number of partitions of a flat S3 listing listed concurrently.
+    /// The bucket is split along its top-level prefixes, each listed on its
+    /// own; entries still come out in key order. Default 1: no partitioning
+    void setListingPartitions(unsigned int partitions);
+
+    /// get the number of partitions of a flat listing listed concurrently
+    unsigned int getListingPartitions() const;
+
+    /// set the number of collections listed concurrently by a recursive walk
+    /// (see DavFile::walk). Default 8
+    void setWalkParallelism(unsigned int parallelism);
+
+    /// get the number of collections listed concurrently by a recursive walk
+    unsigned int getWalkParallelism() const;
+
+    /// set the maximum number of walk listings sent to a single server at
+    /// once, across all the walks of a Context. 0: no limit. Default 16
+    void setWalkHostLimit(unsigned int limit);
+
+    /// get the maximum number of walk listings sent to a single server
+    unsigned int getWalkHostLimit() const;
+
+    /// let recursive walks of WebDAV collections first try a single
+    /// PROPFIND with "Depth: infinity", before falling back to listing each
+    /// collection on its own if the server refuses it. Default true
+    void setWalkDepthInfinity(bool enable);
+
+    /// check whether recursive walks try "Depth: infinity" first
+    bool getWalkDepthInfinity() const;
+
+    /// set the memory bound of the read-ahead cache of each file opened with
+    /// DavPosix: AdviseWillNeed hints fetch the hinted ranges into it in the
+    /// background, and AdviseSequential readers get a window of data fetched
+    /// ahead of them. 0 disables read-ahead. Default 32 MB
+    void setReadAheadLimit(dav_size_t limit);
+
+    /// get the memory bound of the read-ahead cache of a file descriptor
+    dav_size_t getReadAheadLimit() const;
+
+    /// set the size of the segments of segmented downloads, see
+    /// setDownloadParallelism. Default 16 MB
+    void setDownloadSegmentSize(dav_size_t segment_size);
+
+    /// get the size of the segments of segmented downloads
+    dav_size_t getDownloadSegmentSize() const;
+
+    /// set the number of segments of a download fetched in parallel, each
+    /// with its own ranged GET, by DavFile::getToFd. Segments are written to
+    /// the destination at their offset as they arrive, which must then be a
+    /// regular file; a failed segment is fetched again from where it stopped,
+    /// without restarting the others. Default 1: a single GET
+    void setDownloadParallelism(unsigned int parallelism);
+
+    /// get the number of segments of a download fetched in parallel
+    unsigned int getDownloadParallelism() const;
+
+    /// hedge reads made with pread, and the single-range requests of
+    /// preadVec: once a read has been running for longer than "percentile"
+    /// (e.g. 0.95) of the recent reads of about its size from the same
+    /// server, the same range is requested again - from a replica, if the
+    /// Context already knows the Metalink of the file, from the same server
+    /// otherwise. The first answer is used, the other request is abandoned.
+    /// Hedging starts once a few reads of the server have been timed, see
+    /// Context::getHedgingStats. Reads over 1 MB are never hedged. 0 disables
+    /// hedging, which is the default
+    void setHedgePercentile(double percentile);
+
+    /// get the latency percentile after which reads are hedged, 0 if disabled
+    double getHedgePercentile() const;
+
+    /// set the largest fraction of reads hedged, across the Context, to
+    /// bound the extra load put on servers. Default 0.05
+    void setHedgeMaxRatio(double ratio);
+
+    /// get the largest fraction of reads hedged
+    double getHedgeMaxRatio() const;
+
+    /// set the base of the delay between retry attempts, in milliseconds.
+    /// Retry n waits for a random delay between 0 and base * 2^(n-1), at most
+    /// \ref setRetryBackoffMax, so that clients failing together don't retry
+    /// together. 0 retries right away. Default 100
+    void setRetryBackoffBase(unsigned int base);
+
+    /// get the base of the delay between retry attempts, in milliseconds
+    unsigned int getRetryBackoffBase() const;
+
+    /// set the longest delay between retry attempts, in milliseconds.
+    /// Default 10000
+    void setRetryBackoffMax(unsigned int max);
+
+    /// get the longest delay between retry attempts, in milliseconds
+    unsigned int getRetryBackoffMax() const;
 private:
 
    // dptr
@@ -240,6 +240,15 @@ public:
     /// get the scope of this error
     const std::string & getErrScope() const;
 
+    ///
+    /// get the status of the HTTP answer this error was built from,
+    /// 0 if the server never answered
+    int getHttpStatus() const;
+
+    ///
+    /// set the status of the HTTP answer this error was built from
+    void setHttpStatus(int status);
+
 
 
     ///
@@ -325,6 +334,10 @@ public:
     /// return a string representation or the error
     virtual const char*  what() const throw();
 
+    /// return the status of the HTTP answer this exception was built from, 0 if the server never answered,
+    /// same than @ref DavixError::getHttpStatus()
+    int httpStatus() const throw();
+
     /// Extract a DavixError from this exception
     void toDavixError(DavixError** err);
 
@@ -69,6 +69,14 @@ bool SessionFactory::getSessionCaching() const {
   return _neon_factory->getSessionCaching();
 }
 
+//------------------------------------------------------------------------------
+// Close expired idle sessions periodically - libcurl prunes its own
+// connection cache
+//------------------------------------------------------------------------------
+void SessionFactory::setReapInterval(std::chrono::milliseconds interval) {
+  _neon_factory->setReapInterval(interval);
+}
+
 //------------------------------------------------------------------------------
 // "httpize" protocol
 //------------------------------------------------------------------------------
@@ -95,7 +103,12 @@ std::string SessionFactory::httpizeProtocol(const std::string &protocol) {
 // Create session key based on Uri
 //------------------------------------------------------------------------------
 std::string SessionFactory::makeSessionKey(const Uri &uri) {
-    return SSTR(httpizeProtocol(uri.getProtocol()) << uri.getHost() << ":" << uri.getPort());
+    // called for every single request, keep it cheap
+    std::string key = httpizeProtocol(uri.getProtocol());
+    key.append(uri.getHost());
+    key.append(":");
+    key.append(std::to_string(uri.getPort()));
+    return key;
 }
 
 
@@ -24,8 +24,9 @@
 
 #include <davix_internal.hpp>
 
-#include <mutex>
+#include <chrono>
 #include <memory>
+#include <mutex>
 
 namespace Davix {
 
@@ -68,6 +69,12 @@ public:
   //----------------------------------------------------------------------------
   bool getSessionCaching() const;
 
+  //----------------------------------------------------------------------------
+  // Close expired idle sessions every "interval" from a background thread,
+  // 0 disables it
+  //----------------------------------------------------------------------------
+  void setReapInterval(std::chrono::milliseconds interval);
+
   //----------------------------------------------------------------------------
   // "httpize" protocol
   //----------------------------------------------------------------------------
@@ -0,0 +1,329 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "BlockCache.hpp"
+#include <utils/davix_logger_internal.hpp>
+
+#include <cstring>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Stats: Constructor
+//------------------------------------------------------------------------------
+BlockCacheStats::BlockCacheStats() : hits(0), misses(0), coalesced(0),
+  evictions(0), cachedBytes(0) {}
+
+//------------------------------------------------------------------------------
+// Stats: Fraction of lookups which sent no request
+//------------------------------------------------------------------------------
+double BlockCacheStats::hitRatio() const {
+  uint64_t lookups = hits + misses + coalesced;
+  if(lookups == 0) {
+    return 0;
+  }
+
+  return (double) (hits + coalesced) / lookups;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+BlockCache::BlockCache(dav_size_t limit, dav_size_t blockSize)
+: _limit(limit), _blockSize(std::max<dav_size_t>(blockSize, 1)) {}
+
+//------------------------------------------------------------------------------
+// Read a range, starting over whenever the file changes under it
+//------------------------------------------------------------------------------
+dav_ssize_t BlockCache::read(const std::string &url, void *buffer, dav_size_t count, dav_off_t offset, const FetchFunction &fetch) {
+  char *out = static_cast<char*>(buffer);
+  dav_ssize_t done = 0;
+
+  for(int restarts = 0; restarts <= DAVIX_BLOCK_CACHE_MAX_RESTARTS; restarts++) {
+    if(readVersion(url, out, count, offset, fetch, done)) {
+      return done;
+    }
+  }
+
+  throw DavixException(davix_scope_io_buff(), StatusCode::InvalidServerResponse,
+    fmt::format("{} kept changing while being read", url));
+}
+
+//------------------------------------------------------------------------------
+// Read a range block by block, all blocks from the same version
+//------------------------------------------------------------------------------
+bool BlockCache::readVersion(const std::string &url, char *out, dav_size_t count, dav_off_t offset,
+  const FetchFunction &fetch, dav_ssize_t &done) {
+
+  std::string etag;
+  dav_size_t copied = 0;
+
+  while(copied < count) {
+    dav_off_t pos = offset + copied;
+    dav_size_t within = pos % _blockSize;
+
+    BlockPtr block = getBlock(url, pos / _blockSize, fetch);
+
+    // blocks without an entity tag can't be told apart, and aren't cached
+    if(!block->etag.empty()) {
+      if(etag.empty()) {
+        etag = block->etag;
+      }
+      else if(block->etag != etag) {
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Entity tag of {} changed from {} to {} within a read, starting over", url, etag, block->etag);
+        discard(url, etag, block->etag);
+        return false;
+      }
+    }
+
+    if(block->size <= within) {
+      break;
+    }
+
+    // the data of a block never changes once fetched
+    dav_size_t n = std::min<dav_size_t>(count - copied, block->size - within);
+    memcpy(out + copied, block->data.get() + within, n);
+    copied += n;
+
+    if(block->size < _blockSize) {
+      break;
+    }
+  }
+
+  done = copied;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Forget the blocks of stale versions of a URL
+//------------------------------------------------------------------------------
+void BlockCache::discard(const std::string &url, const std::string &first, const std::string &second) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  // the blocks of the version last seen are still good
+  std::string current;
+  std::map<std::string, Version>::iterator version = _versions.find(url);
+  if(version != _versions.end()) {
+    current = version->second.etag;
+  }
+
+  BlockMap::iterator it = _blocks.lower_bound(Key(url, 0));
+  while(it != _blocks.end() && it->first.first == url) {
+    const std::string &etag = it->second->etag;
+    if(it->second->ready && etag != current && (etag == first || etag == second)) {
+      erase(it++);
+    }
+    else {
+      ++it;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get a block, from the cache or fetched
+//------------------------------------------------------------------------------
+BlockCache::BlockPtr BlockCache::getBlock(const std::string &url, uint64_t index, const FetchFunction &fetch) {
+  const Key key(url, index);
+  std::unique_lock<std::mutex> lock(_mtx);
+
+  BlockMap::iterator it = _blocks.find(key);
+  if(it != _blocks.end()) {
+    BlockPtr block = it->second;
+
+    if(!block->ready) {
+      _stats.coalesced++;
+      _cv.wait(lock, [&] { return block->ready; });
+
+      if(block->error) {
+        std::rethrow_exception(block->error);
+      }
+      return block;
+    }
+
+    std::map<std::string, Version>::iterator version = _versions.find(url);
+    if(version != _versions.end() && version->second.etag == block->etag) {
+      _stats.hits++;
+      _lru.splice(_lru.begin(), _lru, block->lru);
+      return block;
+    }
+
+    // left over from a previous version of the file
+    erase(it);
+  }
+
+  _stats.misses++;
+  BlockPtr block = std::make_shared<Block>();
+  _blocks[key] = block;
+  lock.unlock();
+
+  try {
+    std::string etag;
+    block->data.reset(new char[_blockSize]);
+    dav_ssize_t ret = fetch(block->data.get(), _blockSize, index * _blockSize, etag);
+    block->size = std::max<dav_ssize_t>(ret, 0);
+    block->etag = etag;
+  }
+  catch(...) {
+    block->error = std::current_exception();
+  }
+
+  lock.lock();
+  block->ready = true;
+
+  // unless invalidated in the meantime
+  it = _blocks.find(key);
+  if(it != _blocks.end() && it->second == block) {
+    if(block->error || block->etag.empty() || block->size == 0) {
+      _blocks.erase(it);
+    }
+    else {
+      insert(it);
+    }
+  }
+
+  _cv.notify_all();
+
+  if(block->error) {
+    std::rethrow_exception(block->error);
+  }
+  return block;
+}
+
+//------------------------------------------------------------------------------
+// Add a fetched block to the LRU list
+//------------------------------------------------------------------------------
+void BlockCache::insert(BlockMap::iterator it) {
+  if(!makeRoom(_blockSize)) {
+    _blocks.erase(it);
+    return;
+  }
+
+  const std::string &url = it->first.first;
+  Block &block = *it->second;
+
+  Version &version = _versions[url];
+  if(version.etag != block.etag) {
+    if(!version.etag.empty()) {
+      DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Entity tag of {} changed from {} to {}, not serving cached blocks of the previous version", url, version.etag, block.etag);
+    }
+    version.etag = block.etag;
+  }
+
+  version.blocks++;
+  _lru.push_front(it->first);
+  block.lru = _lru.begin();
+  block.cached = true;
+  _stats.cachedBytes += _blockSize;
+}
+
+//------------------------------------------------------------------------------
+// Remove a block from the cache
+//------------------------------------------------------------------------------
+void BlockCache::erase(BlockMap::iterator it) {
+  Block &block = *it->second;
+
+  if(block.cached) {
+    _lru.erase(block.lru);
+    block.cached = false;
+    _stats.cachedBytes -= _blockSize;
+
+    std::map<std::string, Version>::iterator version = _versions.find(it->first.first);
+    if(version != _versions.end() && --version->second.blocks == 0) {
+      _versions.erase(version);
+    }
+  }
+
+  _blocks.erase(it);
+}
+
+//------------------------------------------------------------------------------
+// Evict least recently used blocks until "size" more bytes fit
+//------------------------------------------------------------------------------
+bool BlockCache::makeRoom(dav_size_t size) {
+  if(size > _limit) {
+    return false;
+  }
+
+  while(_stats.cachedBytes + size > _limit) {
+    if(_lru.empty()) {
+      return false;
+    }
+
+    erase(_blocks.find(_lru.back()));
+    _stats.evictions++;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Forget all blocks of a URL
+//------------------------------------------------------------------------------
+void BlockCache::invalidate(const std::string &url) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  BlockMap::iterator it = _blocks.lower_bound(Key(url, 0));
+  while(it != _blocks.end() && it->first.first == url) {
+    erase(it++);
+  }
+
+  _versions.erase(url);
+}
+
+//------------------------------------------------------------------------------
+// Change the memory limit
+//------------------------------------------------------------------------------
+void BlockCache::setLimit(dav_size_t limit) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _limit = limit;
+
+  while(_stats.cachedBytes > _limit && !_lru.empty()) {
+    erase(_blocks.find(_lru.back()));
+    _stats.evictions++;
+  }
+}
+
+dav_size_t BlockCache::getLimit() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _limit;
+}
+
+//------------------------------------------------------------------------------
+// Drop all cached blocks - fetches in flight are not cached once done
+//------------------------------------------------------------------------------
+void BlockCache::clear() {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  BlockMap::iterator it = _blocks.begin();
+  while(it != _blocks.end()) {
+    erase(it++);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get usage statistics
+//------------------------------------------------------------------------------
+BlockCacheStats BlockCache::getStats() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _stats;
+}
+
+}
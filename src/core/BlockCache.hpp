@@ -0,0 +1,173 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef DAVIX_CORE_BLOCK_CACHE_HPP
+#define DAVIX_CORE_BLOCK_CACHE_HPP
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <davix_internal.hpp>
+#include <davix_internal_config.hpp>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Context-wide cache of fixed-size, aligned blocks of remote files, shared by
+// all reads made through the same context.
+//
+// Blocks are keyed by URL and block index, and remember the entity tag of the
+// response they came from: whenever a fetch sees a new entity tag for a URL,
+// the blocks cached for its previous version are no longer served. Responses
+// without an entity tag can't be told apart across versions, and are never
+// cached. A read never mixes two versions of a file: if the blocks it spans
+// don't all carry the same entity tag, the stale ones are dropped and the read
+// starts over. Concurrent misses for the same block share a single fetch. Once
+// the memory limit is reached, the least recently used blocks are evicted.
+//------------------------------------------------------------------------------
+class BlockCache {
+public:
+  //----------------------------------------------------------------------------
+  // Fetch "count" bytes at "offset" into "buffer", set "etag" to the entity
+  // tag of the response. Short only on end of file.
+  //----------------------------------------------------------------------------
+  typedef std::function<dav_ssize_t(char *buffer, dav_size_t count, dav_off_t offset, std::string &etag)> FetchFunction;
+
+  //----------------------------------------------------------------------------
+  // Constructor - a limit of 0 disables caching
+  //----------------------------------------------------------------------------
+  BlockCache(dav_size_t limit = DAVIX_DEFAULT_BLOCK_CACHE_LIMIT, dav_size_t blockSize = DAVIX_BLOCK_CACHE_BLOCK_SIZE);
+
+  //----------------------------------------------------------------------------
+  // Read "count" bytes at "offset" of "url", fetching the blocks which aren't
+  // cached yet with "fetch". Short only on end of file, throws if the file
+  // keeps changing while being read.
+  //----------------------------------------------------------------------------
+  dav_ssize_t read(const std::string &url, void *buffer, dav_size_t count, dav_off_t offset, const FetchFunction &fetch);
+
+  //----------------------------------------------------------------------------
+  // Forget all blocks of "url", such as after it was written to
+  //----------------------------------------------------------------------------
+  void invalidate(const std::string &url);
+
+  //----------------------------------------------------------------------------
+  // Change the memory limit, evicting blocks over the new one
+  //----------------------------------------------------------------------------
+  void setLimit(dav_size_t limit);
+
+  dav_size_t getLimit() const;
+
+  dav_size_t getBlockSize() const {
+    return _blockSize;
+  }
+
+  //----------------------------------------------------------------------------
+  // Drop all cached blocks
+  //----------------------------------------------------------------------------
+  void clear();
+
+  //----------------------------------------------------------------------------
+  // Get usage statistics
+  //----------------------------------------------------------------------------
+  BlockCacheStats getStats() const;
+
+private:
+  // url, block index
+  typedef std::pair<std::string, uint64_t> Key;
+
+  struct Block {
+    Block() : ready(false), cached(false), size(0) {}
+
+    bool ready;
+    bool cached;
+    std::exception_ptr error;
+    std::string etag;
+    std::unique_ptr<char[]> data;
+    dav_size_t size;
+    std::list<Key>::iterator lru;
+  };
+
+  typedef std::shared_ptr<Block> BlockPtr;
+  typedef std::map<Key, BlockPtr> BlockMap;
+
+  // entity tag last seen for a URL, and the number of its blocks cached
+  struct Version {
+    Version() : blocks(0) {}
+
+    std::string etag;
+    size_t blocks;
+  };
+
+  //----------------------------------------------------------------------------
+  // Get a block, from the cache or fetched - throws if the fetch failed
+  //----------------------------------------------------------------------------
+  BlockPtr getBlock(const std::string &url, uint64_t index, const FetchFunction &fetch);
+
+  //----------------------------------------------------------------------------
+  // Read a range from blocks of a single version, false if it changed midway
+  //----------------------------------------------------------------------------
+  bool readVersion(const std::string &url, char *out, dav_size_t count, dav_off_t offset,
+    const FetchFunction &fetch, dav_ssize_t &done);
+
+  //----------------------------------------------------------------------------
+  // Forget the blocks of "url" tagged "first" or "second", except those of
+  // the version last seen
+  //----------------------------------------------------------------------------
+  void discard(const std::string &url, const std::string &first, const std::string &second);
+
+  //----------------------------------------------------------------------------
+  // Add a fetched block to the LRU list, if it can be made to fit. Call with
+  // _mtx held.
+  //----------------------------------------------------------------------------
+  void insert(BlockMap::iterator it);
+
+  //----------------------------------------------------------------------------
+  // Remove a block from the cache. Call with _mtx held.
+  //----------------------------------------------------------------------------
+  void erase(BlockMap::iterator it);
+
+  //----------------------------------------------------------------------------
+  // Evict the least recently used blocks until "size" more bytes fit under
+  // the limit. Call with _mtx held.
+  //----------------------------------------------------------------------------
+  bool makeRoom(dav_size_t size);
+
+  mutable std::mutex _mtx;
+  std::condition_variable _cv;
+
+  dav_size_t _limit;
+  const dav_size_t _blockSize;
+
+  BlockMap _blocks;
+  std::list<Key> _lru;
+  std::map<std::string, Version> _versions;
+
+  BlockCacheStats _stats;
+};
+
+}
+
+#endif
@@ -0,0 +1,244 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include "BufferPool.hpp"
+
+namespace Davix {
+
+const dav_size_t BufferPool::kDefaultLimit;
+const dav_size_t BufferPool::kMinSizeClass;
+
+//------------------------------------------------------------------------------
+// Stats: Constructor
+//------------------------------------------------------------------------------
+BufferPoolStats::BufferPoolStats() : hits(0), misses(0), waits(0),
+  allocatedBytes(0), cachedBytes(0), highWaterMark(0) {}
+
+//------------------------------------------------------------------------------
+// PooledBuffer: Destructor
+//------------------------------------------------------------------------------
+PooledBuffer::~PooledBuffer() {
+  release();
+}
+
+//------------------------------------------------------------------------------
+// PooledBuffer: Move constructor
+//------------------------------------------------------------------------------
+PooledBuffer::PooledBuffer(PooledBuffer &&other)
+: _pool(other._pool), _data(std::move(other._data)), _size(other._size) {
+  other._pool = NULL;
+  other._size = 0;
+}
+
+//------------------------------------------------------------------------------
+// PooledBuffer: Move assignment
+//------------------------------------------------------------------------------
+PooledBuffer& PooledBuffer::operator=(PooledBuffer &&other) {
+  if(this != &other) {
+    release();
+    _pool = other._pool;
+    _data = std::move(other._data);
+    _size = other._size;
+    other._pool = NULL;
+    other._size = 0;
+  }
+
+  return *this;
+}
+
+//------------------------------------------------------------------------------
+// PooledBuffer: Give the buffer back to its pool
+//------------------------------------------------------------------------------
+void PooledBuffer::release() {
+  if(_pool && _data) {
+    _pool->put(std::move(_data), _size);
+  }
+
+  _pool = NULL;
+  _size = 0;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+BufferPool::BufferPool(dav_size_t limit) : _limit(limit) {}
+
+//------------------------------------------------------------------------------
+// Size class of a request
+//------------------------------------------------------------------------------
+dav_size_t BufferPool::sizeClass(dav_size_t size) {
+  const dav_size_t MB = 1024 * 1024;
+
+  if(size > MB) {
+    return ((size + MB - 1) / MB) * MB;
+  }
+
+  dav_size_t cls = kMinSizeClass;
+  while(cls < size) {
+    cls *= 2;
+  }
+
+  return cls;
+}
+
+//------------------------------------------------------------------------------
+// Get a buffer, waiting if needed
+//------------------------------------------------------------------------------
+PooledBuffer BufferPool::acquire(dav_size_t size) {
+  return get(size, true);
+}
+
+//------------------------------------------------------------------------------
+// Get a buffer, never waiting
+//------------------------------------------------------------------------------
+PooledBuffer BufferPool::tryAcquire(dav_size_t size) {
+  return get(size, false);
+}
+
+//------------------------------------------------------------------------------
+// Get a buffer
+//------------------------------------------------------------------------------
+PooledBuffer BufferPool::get(dav_size_t size, bool wait) {
+  PooledBuffer out;
+  bool waited = false;
+
+  dav_size_t cls = sizeClass(size);
+  std::unique_lock<std::mutex> lock(_mtx);
+
+  while(true) {
+    auto it = _free.find(cls);
+    if(it != _free.end() && !it->second.empty()) {
+      out._data = std::move(it->second.back());
+      it->second.pop_back();
+      _stats.cachedBytes -= cls;
+      _stats.hits++;
+      break;
+    }
+
+    if(makeRoom(cls)) {
+      out._data.reset(new char[cls]);
+      _stats.allocatedBytes += cls;
+      _stats.highWaterMark = std::max(_stats.highWaterMark, _stats.allocatedBytes);
+      _stats.misses++;
+      break;
+    }
+
+    if(!waited) {
+      _stats.waits++;
+      waited = true;
+    }
+
+    if(!wait) {
+      return out;
+    }
+
+    _cv.wait(lock);
+  }
+
+  out._pool = this;
+  out._size = cls;
+  return out;
+}
+
+//------------------------------------------------------------------------------
+// Buffer released
+//------------------------------------------------------------------------------
+void BufferPool::put(std::unique_ptr<char[]> data, dav_size_t size) {
+  std::unique_ptr<char[]> dropped;
+
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+
+    if(_stats.allocatedBytes > _limit) {
+      // the limit was lowered meanwhile
+      dropped = std::move(data);
+      _stats.allocatedBytes -= size;
+    }
+    else {
+      _free[size].push_back(std::move(data));
+      _stats.cachedBytes += size;
+    }
+  }
+
+  _cv.notify_all();
+}
+
+//------------------------------------------------------------------------------
+// Free cached buffers until "size" more bytes fit under the limit
+//------------------------------------------------------------------------------
+bool BufferPool::makeRoom(dav_size_t size) {
+  auto it = _free.begin();
+
+  while(_stats.allocatedBytes + size > _limit && it != _free.end()) {
+    if(it->second.empty()) {
+      it = _free.erase(it);
+      continue;
+    }
+
+    it->second.pop_back();
+    _stats.allocatedBytes -= it->first;
+    _stats.cachedBytes -= it->first;
+  }
+
+  // a request larger than the limit can still be served by an empty pool
+  return _stats.allocatedBytes + size <= _limit || _stats.allocatedBytes == 0;
+}
+
+//------------------------------------------------------------------------------
+// Change the memory limit
+//------------------------------------------------------------------------------
+void BufferPool::setLimit(dav_size_t limit) {
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _limit = limit;
+    makeRoom(0);
+  }
+
+  _cv.notify_all();
+}
+
+//------------------------------------------------------------------------------
+// Get the memory limit
+//------------------------------------------------------------------------------
+dav_size_t BufferPool::getLimit() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _limit;
+}
+
+//------------------------------------------------------------------------------
+// Free all cached buffers
+//------------------------------------------------------------------------------
+void BufferPool::trim() {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  _stats.allocatedBytes -= _stats.cachedBytes;
+  _stats.cachedBytes = 0;
+  _free.clear();
+}
+
+//------------------------------------------------------------------------------
+// Get usage statistics
+//------------------------------------------------------------------------------
+BufferPoolStats BufferPool::getStats() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _stats;
+}
+
+}
@@ -0,0 +1,158 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#ifndef DAVIX_CORE_BUFFER_POOL_HPP
+#define DAVIX_CORE_BUFFER_POOL_HPP
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <davix_internal.hpp>
+
+namespace Davix {
+
+class BufferPool;
+
+//------------------------------------------------------------------------------
+// A buffer borrowed from a BufferPool, given back on destruction
+//------------------------------------------------------------------------------
+class PooledBuffer {
+public:
+  PooledBuffer() : _pool(NULL), _size(0) {}
+  ~PooledBuffer();
+
+  PooledBuffer(PooledBuffer &&other);
+  PooledBuffer& operator=(PooledBuffer &&other);
+
+  PooledBuffer(const PooledBuffer &other) = delete;
+  PooledBuffer& operator=(const PooledBuffer &other) = delete;
+
+  char* data() {
+    return _data.get();
+  }
+
+  //----------------------------------------------------------------------------
+  // Usable size - at least what was asked for
+  //----------------------------------------------------------------------------
+  dav_size_t size() const {
+    return _size;
+  }
+
+  bool valid() const {
+    return _data != nullptr;
+  }
+
+  //----------------------------------------------------------------------------
+  // Give the buffer back to its pool early
+  //----------------------------------------------------------------------------
+  void release();
+
+private:
+  friend class BufferPool;
+
+  BufferPool *_pool;
+  std::unique_ptr<char[]> _data;
+  dav_size_t _size;
+};
+
+//------------------------------------------------------------------------------
+// Context-wide pool of large transient buffers, such as the parts of
+// multi-part uploads.
+//
+// Requests are rounded up to a size class, and released buffers are kept
+// around to be handed out again, so that back-to-back uploads don't go
+// through fresh allocations and page faults for every part. The total memory
+// held by the pool - in use or cached - never exceeds its limit: when it is
+// reached, cached buffers of other size classes are freed first, then
+// callers either wait for a buffer to be released, or make do without.
+//------------------------------------------------------------------------------
+class BufferPool {
+public:
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  BufferPool(dav_size_t limit = kDefaultLimit);
+
+  //----------------------------------------------------------------------------
+  // Get a buffer of at least "size" bytes, waiting for buffers to be released
+  // if that would exceed the limit. A request larger than the limit is only
+  // served once the pool holds nothing else.
+  //----------------------------------------------------------------------------
+  PooledBuffer acquire(dav_size_t size);
+
+  //----------------------------------------------------------------------------
+  // Same as acquire, but never waits - returns an invalid buffer instead
+  //----------------------------------------------------------------------------
+  PooledBuffer tryAcquire(dav_size_t size);
+
+  //----------------------------------------------------------------------------
+  // Change the memory limit. Cached buffers over the new limit are freed,
+  // buffers in use are only accounted for once released.
+  //----------------------------------------------------------------------------
+  void setLimit(dav_size_t limit);
+
+  dav_size_t getLimit() const;
+
+  //----------------------------------------------------------------------------
+  // Free all cached buffers
+  //----------------------------------------------------------------------------
+  void trim();
+
+  //----------------------------------------------------------------------------
+  // Get usage statistics
+  //----------------------------------------------------------------------------
+  BufferPoolStats getStats() const;
+
+  //----------------------------------------------------------------------------
+  // Size class of a request: powers of two up to 1 MB, multiples of 1 MB
+  // beyond that
+  //----------------------------------------------------------------------------
+  static dav_size_t sizeClass(dav_size_t size);
+
+  static const dav_size_t kDefaultLimit = 1024 * 1024 * 1024;
+  static const dav_size_t kMinSizeClass = 64 * 1024;
+
+private:
+  friend class PooledBuffer;
+
+  PooledBuffer get(dav_size_t size, bool wait);
+  void put(std::unique_ptr<char[]> data, dav_size_t size);
+
+  //----------------------------------------------------------------------------
+  // Free cached buffers until "size" more bytes fit under the limit. Call
+  // with _mtx held.
+  //----------------------------------------------------------------------------
+  bool makeRoom(dav_size_t size);
+
+  mutable std::mutex _mtx;
+  std::condition_variable _cv;
+  std::map<dav_size_t, std::vector<std::unique_ptr<char[]>>> _free;
+
+  dav_size_t _limit;
+
+  // allocatedBytes counts buffers in use and cached ones alike
+  BufferPoolStats _stats;
+};
+
+}
+
+#endif
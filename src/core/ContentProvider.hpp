@@ -196,6 +196,18 @@ public:
   //----------------------------------------------------------------------------
   ssize_t getSize();
 
+  //----------------------------------------------------------------------------
+  // Underlying file descriptor, and offset of the first byte provided - for
+  // consumers able to access the file directly rather than through pullBytes
+  //----------------------------------------------------------------------------
+  int getFd() const {
+    return _fd;
+  }
+
+  off_t getOffset() const {
+    return _offset;
+  }
+
 private:
   int _fd;
   ssize_t _fd_size;
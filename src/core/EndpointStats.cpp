@@ -0,0 +1,103 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include "EndpointStats.hpp"
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Fold a new sample into an exponentially weighted average
+//------------------------------------------------------------------------------
+static void smooth(double &average, size_t &samples, double value) {
+  if(samples == 0) {
+    average = value;
+  }
+  else {
+    average = (1 - EndpointStats::kSmoothing) * average + EndpointStats::kSmoothing * value;
+  }
+
+  samples++;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+EndpointStats::EndpointStats() {}
+
+//------------------------------------------------------------------------------
+// Record time until response headers
+//------------------------------------------------------------------------------
+void EndpointStats::recordLatency(const std::string &endpoint, double seconds) {
+  if(seconds < 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(_mtx);
+  EndpointEstimate &est = _estimates[endpoint];
+  smooth(est.rtt, est.latencySamples, seconds);
+}
+
+//------------------------------------------------------------------------------
+// Record time spent receiving the response body
+//------------------------------------------------------------------------------
+void EndpointStats::recordThroughput(const std::string &endpoint, double seconds, dav_size_t bytes) {
+  if(seconds <= 0 || bytes == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(_mtx);
+  EndpointEstimate &est = _estimates[endpoint];
+  smooth(est.throughput, est.throughputSamples, bytes / seconds);
+}
+
+//------------------------------------------------------------------------------
+// Record a complete request
+//------------------------------------------------------------------------------
+void EndpointStats::recordTransfer(const std::string &endpoint, double seconds, dav_size_t bytes) {
+  if(seconds <= 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(_mtx);
+  EndpointEstimate &est = _estimates[endpoint];
+
+  if(est.latencySamples > 0 && bytes > 0 && seconds > 2 * est.rtt) {
+    smooth(est.throughput, est.throughputSamples, bytes / (seconds - est.rtt));
+  }
+  else {
+    smooth(est.rtt, est.latencySamples, seconds);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Current estimate for the given endpoint
+//------------------------------------------------------------------------------
+EndpointEstimate EndpointStats::getEstimate(const std::string &endpoint) const {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  auto it = _estimates.find(endpoint);
+  if(it == _estimates.end()) {
+    return EndpointEstimate();
+  }
+
+  return it->second;
+}
+
+}
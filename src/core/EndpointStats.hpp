@@ -0,0 +1,105 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#ifndef DAVIX_CORE_ENDPOINT_STATS_HPP
+#define DAVIX_CORE_ENDPOINT_STATS_HPP
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utils/davix_types.hpp>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Latency and throughput estimates of a single endpoint
+//------------------------------------------------------------------------------
+struct EndpointEstimate {
+  EndpointEstimate() : rtt(0), throughput(0), latencySamples(0), throughputSamples(0) {}
+
+  // seconds from sending a request until its response headers arrive
+  double rtt;
+
+  // bytes per second, once the response body is flowing
+  double throughput;
+
+  size_t latencySamples;
+  size_t throughputSamples;
+
+  //----------------------------------------------------------------------------
+  // Do we know enough about this endpoint to base decisions on it?
+  //----------------------------------------------------------------------------
+  bool valid() const {
+    return latencySamples > 0 && throughputSamples > 0;
+  }
+
+  //----------------------------------------------------------------------------
+  // Bytes that could have been transferred during one round trip - reading a
+  // gap smaller than that costs less than issuing a separate request for it
+  //----------------------------------------------------------------------------
+  double bandwidthDelayProduct() const {
+    return rtt * throughput;
+  }
+};
+
+//------------------------------------------------------------------------------
+// Per-endpoint exponentially weighted estimates of latency and throughput,
+// shared by everything running on the same Context. Endpoints are identified
+// by SessionFactory::makeSessionKey.
+//------------------------------------------------------------------------------
+class EndpointStats {
+public:
+  EndpointStats();
+
+  //----------------------------------------------------------------------------
+  // Record time until the response headers of a request arrived
+  //----------------------------------------------------------------------------
+  void recordLatency(const std::string &endpoint, double seconds);
+
+  //----------------------------------------------------------------------------
+  // Record time spent receiving "bytes" of response body
+  //----------------------------------------------------------------------------
+  void recordThroughput(const std::string &endpoint, double seconds, dav_size_t bytes);
+
+  //----------------------------------------------------------------------------
+  // Record a complete request, when latency and body time can't be told
+  // apart: once the latency is known, whatever took significantly longer
+  // than a round trip counts towards throughput, the rest towards latency.
+  //----------------------------------------------------------------------------
+  void recordTransfer(const std::string &endpoint, double seconds, dav_size_t bytes);
+
+  //----------------------------------------------------------------------------
+  // Current estimate for the given endpoint - invalid if we know nothing
+  //----------------------------------------------------------------------------
+  EndpointEstimate getEstimate(const std::string &endpoint) const;
+
+  //----------------------------------------------------------------------------
+  // Weight of each new sample
+  //----------------------------------------------------------------------------
+  static constexpr double kSmoothing = 0.2;
+
+private:
+  mutable std::mutex _mtx;
+  std::map<std::string, EndpointEstimate> _estimates;
+};
+
+}
+
+#endif
@@ -0,0 +1,331 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "Hedger.hpp"
+#include <core/WorkerPool.hpp>
+#include <utils/davix_logger_internal.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <memory>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Stats: Constructor
+//------------------------------------------------------------------------------
+HedgingStats::HedgingStats() : reads(0), hedged(0), wins(0) {}
+
+//------------------------------------------------------------------------------
+// Stats: Fraction of reads which were hedged
+//------------------------------------------------------------------------------
+double HedgingStats::hedgeRatio() const {
+  if(reads == 0) {
+    return 0;
+  }
+
+  return (double) hedged / reads;
+}
+
+namespace {
+
+typedef std::chrono::steady_clock SteadyClock;
+
+double secondsSince(SteadyClock::time_point start) {
+  return std::chrono::duration<double>(SteadyClock::now() - start).count();
+}
+
+//------------------------------------------------------------------------------
+// One of the two reads of a hedged read
+//------------------------------------------------------------------------------
+struct Attempt {
+  Attempt() : claimed(false), done(false), cancelled(false), result(-1) {}
+
+  // picked up by a thread, finished
+  bool claimed;
+  bool done;
+  std::atomic<bool> cancelled;
+
+  dav_ssize_t result;
+  std::exception_ptr error;
+  std::vector<char> buffer;
+};
+
+//------------------------------------------------------------------------------
+// Shared by the caller and both reads, outlives the caller if needed
+//------------------------------------------------------------------------------
+struct HedgedRead {
+  HedgedRead(Hedger &h, const std::string &ep, dav_size_t n, const Hedger::ReadFunction &f)
+  : hedger(h), endpoint(ep), count(n), fn(f), start(SteadyClock::now()) {}
+
+  //----------------------------------------------------------------------------
+  // Run an attempt, unless someone else already did or it's not needed
+  // anymore
+  //----------------------------------------------------------------------------
+  void run(size_t i) {
+    Attempt &attempt = attempts[i];
+
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      if(attempt.claimed) {
+        return;
+      }
+
+      attempt.claimed = true;
+      if(attempt.cancelled) {
+        attempt.done = true;
+        cv.notify_all();
+        return;
+      }
+    }
+
+    dav_ssize_t result = -1;
+    std::exception_ptr error;
+
+    try {
+      attempt.buffer.resize(count);
+      result = fn(i, attempt.buffer.data(), attempt.cancelled);
+    }
+    catch(...) {
+      error = std::current_exception();
+    }
+
+    // a late answer of the original read is what the delay is based on
+    if(i == 0 && !error) {
+      hedger.recordLatency(endpoint, count, secondsSince(start));
+    }
+
+    std::lock_guard<std::mutex> lock(mtx);
+    attempt.done = true;
+    attempt.result = result;
+    attempt.error = error;
+    cv.notify_all();
+  }
+
+  Hedger &hedger;
+  const std::string endpoint;
+  const dav_size_t count;
+  const Hedger::ReadFunction fn;
+  const SteadyClock::time_point start;
+
+  std::mutex mtx;
+  std::condition_variable cv;
+  Attempt attempts[2];
+};
+
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+Hedger::Hedger(size_t window, size_t minSamples, dav_size_t maxSize)
+: _window(std::max<size_t>(window, 1)), _minSamples(std::max<size_t>(minSamples, 1)), _maxSize(maxSize) {}
+
+//------------------------------------------------------------------------------
+// Read, duplicating the read if it takes too long
+//------------------------------------------------------------------------------
+dav_ssize_t Hedger::read(WorkerPool &pool, const std::string &endpoint, double percentile, double maxRatio,
+  char *buffer, dav_size_t count, const ReadFunction &fn, size_t &winner) {
+
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _stats.reads++;
+  }
+
+  winner = 0;
+  std::chrono::microseconds delay;
+
+  static const std::atomic<bool> notCancelled(false);
+
+  // too large to be worth hedging: a plain read, not timed either
+  if(count > _maxSize) {
+    return fn(0, buffer, notCancelled);
+  }
+
+  // nothing to base a delay on yet: a plain read, timed
+  if(percentile <= 0 || !getDelay(endpoint, count, percentile, delay)) {
+    SteadyClock::time_point start = SteadyClock::now();
+    dav_ssize_t ret = fn(0, buffer, notCancelled);
+    recordLatency(endpoint, count, secondsSince(start));
+    return ret;
+  }
+
+  std::shared_ptr<HedgedRead> read = std::make_shared<HedgedRead>(*this, endpoint, count, fn);
+  pool.submit([read]() { read->run(0); });
+
+  std::unique_lock<std::mutex> lock(read->mtx);
+  read->cv.wait_until(lock, read->start + delay, [&]() { return read->attempts[0].done; });
+
+  bool hedged = false;
+  if(!read->attempts[0].done) {
+    if(!read->attempts[0].claimed) {
+      // no worker was free to run it, nothing to hedge it against
+      lock.unlock();
+      read->run(0);
+      lock.lock();
+    }
+    else if(allowHedge(maxRatio)) {
+      DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Read of {} bytes from {} still running after {} us, hedging it", count, endpoint, delay.count());
+      hedged = true;
+      lock.unlock();
+      pool.submit([read]() { read->run(1); });
+      lock.lock();
+    }
+  }
+
+  // first successful answer wins, failures wait for the other one
+  const size_t nattempts = hedged ? 2 : 1;
+  bool found = false;
+
+  while(true) {
+    bool pending = false;
+    for(size_t i = 0; i < nattempts && !found; i++) {
+      if(read->attempts[i].done && !read->attempts[i].error) {
+        winner = i;
+        found = true;
+      }
+
+      pending |= !read->attempts[i].done;
+    }
+
+    if(found || !pending) {
+      break;
+    }
+
+    // the original read failed, and no worker picked up the duplicate yet
+    if(hedged && read->attempts[0].done && !read->attempts[1].claimed) {
+      lock.unlock();
+      read->run(1);
+      lock.lock();
+      continue;
+    }
+
+    read->cv.wait(lock);
+  }
+
+  for(size_t i = 0; i < nattempts; i++) {
+    read->attempts[i].cancelled = true;
+  }
+
+  if(!found) {
+    std::rethrow_exception(read->attempts[0].error ? read->attempts[0].error : read->attempts[1].error);
+  }
+
+  const Attempt &attempt = read->attempts[winner];
+  if(attempt.result > 0) {
+    memcpy(buffer, attempt.buffer.data(), attempt.result);
+  }
+
+  if(winner == 1) {
+    std::lock_guard<std::mutex> statsLock(_mtx);
+    _stats.wins++;
+  }
+
+  return attempt.result;
+}
+
+//------------------------------------------------------------------------------
+// Count a duplicate read, within the budget
+//------------------------------------------------------------------------------
+bool Hedger::allowHedge(double maxRatio) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  if(_stats.hedged + 1 > maxRatio * _stats.reads) {
+    return false;
+  }
+
+  _stats.hedged++;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Delay after which a read is hedged
+//------------------------------------------------------------------------------
+bool Hedger::getDelay(const std::string &endpoint, dav_size_t size, double percentile, std::chrono::microseconds &delay) {
+  std::vector<double> samples;
+
+  if(size > _maxSize) {
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto it = _latencies.find(std::make_pair(endpoint, sizeClass(size)));
+    if(it == _latencies.end() || it->second.samples.size() < _minSamples) {
+      return false;
+    }
+
+    samples = it->second.samples;
+  }
+
+  size_t index = std::min<size_t>(samples.size() * std::min(percentile, 1.0), samples.size() - 1);
+  std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+
+  delay = std::chrono::microseconds((int64_t) (samples[index] * 1e6));
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Record the time taken by a read
+//------------------------------------------------------------------------------
+void Hedger::recordLatency(const std::string &endpoint, dav_size_t size, double seconds) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  Window &window = _latencies[std::make_pair(endpoint, sizeClass(size))];
+
+  if(window.samples.size() < _window) {
+    window.samples.push_back(seconds);
+    return;
+  }
+
+  window.samples[window.next] = seconds;
+  window.next = (window.next + 1) % _window;
+}
+
+//------------------------------------------------------------------------------
+// Size class of a read
+//------------------------------------------------------------------------------
+size_t Hedger::sizeClass(dav_size_t size) {
+  size_t cls = 0;
+  for(dav_size_t limit = 16 * 1024; limit < size; limit *= 4) {
+    cls++;
+  }
+  return cls;
+}
+
+//------------------------------------------------------------------------------
+// Get the counters
+//------------------------------------------------------------------------------
+HedgingStats Hedger::getStats() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _stats;
+}
+
+//------------------------------------------------------------------------------
+// Forget the latencies
+//------------------------------------------------------------------------------
+void Hedger::clear() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _latencies.clear();
+}
+
+}
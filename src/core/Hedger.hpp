@@ -0,0 +1,134 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef DAVIX_CORE_HEDGER_HPP
+#define DAVIX_CORE_HEDGER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <davix_internal.hpp>
+#include <davix_internal_config.hpp>
+
+namespace Davix {
+
+class WorkerPool;
+
+//------------------------------------------------------------------------------
+// Context-wide hedging of reads. The time taken by the last reads of each
+// endpoint is kept, by size class - a read is only compared with reads of
+// about its size. Once a read has been running for longer than a given
+// percentile of them, a second, identical read is started. Whichever
+// answers first is used, and the other is told to stop.
+//
+// Reads larger than "maxSize" are never hedged: they are dominated by
+// transfer time rather than latency, and duplicating them would cost a
+// second buffer of their size. They run plainly, on the caller's thread.
+//
+// Both reads run on the worker pool, each into a buffer of its own, since
+// the slower one may still be running after the caller returns. If no
+// worker picks up a read in time, the caller runs it itself, so a busy pool
+// costs latency but can't deadlock. The number of duplicated reads is
+// capped by a fraction of all reads, to bound the extra load on servers.
+//------------------------------------------------------------------------------
+class Hedger {
+public:
+  //----------------------------------------------------------------------------
+  // Read into "buffer", returning the number of bytes read. "attempt" is 0
+  // for the original read and 1 for the duplicate. Once "cancelled" is
+  // raised the answer isn't needed anymore, and the read may stop early.
+  //----------------------------------------------------------------------------
+  typedef std::function<dav_ssize_t (size_t attempt, char *buffer, const std::atomic<bool> &cancelled)> ReadFunction;
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  Hedger(size_t window = DAVIX_HEDGE_LATENCY_WINDOW, size_t minSamples = DAVIX_HEDGE_MIN_SAMPLES,
+    dav_size_t maxSize = DAVIX_HEDGE_MAX_SIZE);
+
+  //----------------------------------------------------------------------------
+  // Read up to "count" bytes from "endpoint" into "buffer". The read is
+  // hedged after the "percentile" latency of the endpoint, if at most
+  // "maxRatio" of all reads have been hedged so far. Returns the number of
+  // bytes read, and sets "winner" to the attempt whose answer was used.
+  // If both attempts fail, the error of the original read is thrown.
+  //----------------------------------------------------------------------------
+  dav_ssize_t read(WorkerPool &pool, const std::string &endpoint, double percentile, double maxRatio,
+    char *buffer, dav_size_t count, const ReadFunction &fn, size_t &winner);
+
+  //----------------------------------------------------------------------------
+  // Time after which a read of "size" bytes from "endpoint" is hedged.
+  // Returns false if too few reads of that size class have been timed yet,
+  // or if reads of that size are never hedged.
+  //----------------------------------------------------------------------------
+  bool getDelay(const std::string &endpoint, dav_size_t size, double percentile, std::chrono::microseconds &delay);
+
+  //----------------------------------------------------------------------------
+  // Record the time taken by a read of "size" bytes from "endpoint"
+  //----------------------------------------------------------------------------
+  void recordLatency(const std::string &endpoint, dav_size_t size, double seconds);
+
+  //----------------------------------------------------------------------------
+  // Size class of a read: reads of up to 16 KB, 64 KB, 256 KB...
+  //----------------------------------------------------------------------------
+  static size_t sizeClass(dav_size_t size);
+
+  //----------------------------------------------------------------------------
+  // Get the counters
+  //----------------------------------------------------------------------------
+  HedgingStats getStats() const;
+
+  //----------------------------------------------------------------------------
+  // Forget the latencies of all endpoints, keep the counters
+  //----------------------------------------------------------------------------
+  void clear();
+
+private:
+  struct Window {
+    Window() : next(0) {}
+
+    std::vector<double> samples;
+    size_t next;
+  };
+
+  //----------------------------------------------------------------------------
+  // Count a duplicate read, unless that would exceed "maxRatio" of all reads
+  //----------------------------------------------------------------------------
+  bool allowHedge(double maxRatio);
+
+  const size_t _window;
+  const size_t _minSamples;
+  const dav_size_t _maxSize;
+
+  mutable std::mutex _mtx;
+  // by endpoint and size class
+  std::map<std::pair<std::string, size_t>, Window> _latencies;
+  HedgingStats _stats;
+};
+
+}
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "HostLimiter.hpp"
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// HostSlot: Destructor
+//------------------------------------------------------------------------------
+HostSlot::~HostSlot() {
+  release();
+}
+
+//------------------------------------------------------------------------------
+// HostSlot: Move constructor
+//------------------------------------------------------------------------------
+HostSlot::HostSlot(HostSlot &&other)
+: _limiter(other._limiter), _host(std::move(other._host)) {
+  other._limiter = NULL;
+}
+
+//------------------------------------------------------------------------------
+// HostSlot: Move assignment
+//------------------------------------------------------------------------------
+HostSlot& HostSlot::operator=(HostSlot &&other) {
+  if(this != &other) {
+    release();
+    _limiter = other._limiter;
+    _host = std::move(other._host);
+    other._limiter = NULL;
+  }
+
+  return *this;
+}
+
+//------------------------------------------------------------------------------
+// HostSlot: Give the slot back
+//------------------------------------------------------------------------------
+void HostSlot::release() {
+  if(_limiter) {
+    _limiter->put(_host);
+  }
+
+  _limiter = NULL;
+}
+
+//------------------------------------------------------------------------------
+// Take a slot
+//------------------------------------------------------------------------------
+HostSlot HostLimiter::acquire(const std::string &host, size_t limit) {
+  std::unique_lock<std::mutex> lock(_mtx);
+
+  if(limit != 0) {
+    _cv.wait(lock, [&]() {
+      std::map<std::string, size_t>::const_iterator it = _inUse.find(host);
+      return it == _inUse.end() || it->second < limit;
+    });
+  }
+
+  _inUse[host]++;
+
+  HostSlot slot;
+  slot._limiter = this;
+  slot._host = host;
+  return slot;
+}
+
+//------------------------------------------------------------------------------
+// Give a slot back
+//------------------------------------------------------------------------------
+void HostLimiter::put(const std::string &host) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  std::map<std::string, size_t>::iterator it = _inUse.find(host);
+  if(it != _inUse.end() && --it->second == 0) {
+    _inUse.erase(it);
+  }
+
+  _cv.notify_all();
+}
+
+//------------------------------------------------------------------------------
+// Number of slots taken
+//------------------------------------------------------------------------------
+size_t HostLimiter::inUse(const std::string &host) const {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  std::map<std::string, size_t>::const_iterator it = _inUse.find(host);
+  return (it == _inUse.end()) ? 0 : it->second;
+}
+
+}
@@ -0,0 +1,91 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef DAVIX_CORE_HOST_LIMITER_HPP
+#define DAVIX_CORE_HOST_LIMITER_HPP
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace Davix {
+
+class HostLimiter;
+
+//------------------------------------------------------------------------------
+// A slot taken from a HostLimiter, given back on destruction
+//------------------------------------------------------------------------------
+class HostSlot {
+public:
+  HostSlot() : _limiter(NULL) {}
+  ~HostSlot();
+
+  HostSlot(HostSlot &&other);
+  HostSlot& operator=(HostSlot &&other);
+
+  HostSlot(const HostSlot &other) = delete;
+  HostSlot& operator=(const HostSlot &other) = delete;
+
+  //----------------------------------------------------------------------------
+  // Give the slot back early
+  //----------------------------------------------------------------------------
+  void release();
+
+private:
+  friend class HostLimiter;
+
+  HostLimiter *_limiter;
+  std::string _host;
+};
+
+//------------------------------------------------------------------------------
+// Context-wide limit on the number of concurrent requests of one kind - such
+// as the listings of a recursive walk - sent to any single endpoint (see
+// SessionFactory::makeSessionKey), so that concurrent walks of the same
+// server don't add up to more than it is willing to take.
+//------------------------------------------------------------------------------
+class HostLimiter {
+public:
+  //----------------------------------------------------------------------------
+  // Take a slot for "host", waiting while "limit" of them are taken already.
+  // A limit of 0 means no limit.
+  //----------------------------------------------------------------------------
+  HostSlot acquire(const std::string &host, size_t limit);
+
+  //----------------------------------------------------------------------------
+  // Number of slots currently taken for "host"
+  //----------------------------------------------------------------------------
+  size_t inUse(const std::string &host) const;
+
+private:
+  friend class HostSlot;
+
+  void put(const std::string &host);
+
+  mutable std::mutex _mtx;
+  std::condition_variable _cv;
+  std::map<std::string, size_t> _inUse;
+};
+
+}
+
+#endif
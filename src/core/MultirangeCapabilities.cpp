@@ -0,0 +1,129 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include "MultirangeCapabilities.hpp"
+
+namespace Davix {
+
+const dav_size_t MultirangeCapabilityCache::kDefaultMaxHeaderSize;
+const dav_size_t MultirangeCapabilityCache::kMinHeaderSize;
+constexpr std::chrono::milliseconds MultirangeCapabilityCache::kDefaultTtl;
+
+//------------------------------------------------------------------------------
+// Default capabilities: multi-range presumed to work, conservative header
+//------------------------------------------------------------------------------
+MultirangeCapability::MultirangeCapability()
+: unsupported(false), maxRanges(0),
+  maxHeaderSize(MultirangeCapabilityCache::kDefaultMaxHeaderSize),
+  largestSuccess(0) {}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+MultirangeCapabilityCache::MultirangeCapabilityCache(std::chrono::milliseconds ttl)
+: _ttl(ttl) {}
+
+//------------------------------------------------------------------------------
+// Get capabilities of the given endpoint
+//------------------------------------------------------------------------------
+MultirangeCapability MultirangeCapabilityCache::get(const std::string &endpoint) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  auto it = _entries.find(endpoint);
+  if(it == _entries.end()) {
+    return MultirangeCapability();
+  }
+
+  if(it->second.expires < std::chrono::steady_clock::now()) {
+    _entries.erase(it);
+    return MultirangeCapability();
+  }
+
+  return it->second.caps;
+}
+
+//------------------------------------------------------------------------------
+// Get entry for update
+//------------------------------------------------------------------------------
+MultirangeCapability& MultirangeCapabilityCache::update(const std::string &endpoint) {
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+  Entry &entry = _entries[endpoint];
+  if(entry.expires < now) {
+    entry.caps = MultirangeCapability();
+  }
+
+  entry.expires = now + _ttl;
+  return entry.caps;
+}
+
+//------------------------------------------------------------------------------
+// Proper multipart response received
+//------------------------------------------------------------------------------
+void MultirangeCapabilityCache::recordSuccess(const std::string &endpoint, dav_size_t nranges) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  MultirangeCapability &caps = update(endpoint);
+
+  if(nranges > caps.largestSuccess) {
+    caps.largestSuccess = nranges;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Whole file, or broken multipart response received
+//------------------------------------------------------------------------------
+void MultirangeCapabilityCache::recordFailure(const std::string &endpoint, dav_size_t nranges) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  MultirangeCapability &caps = update(endpoint);
+
+  if(caps.largestSuccess > 1 && caps.largestSuccess < nranges) {
+    caps.maxRanges = caps.largestSuccess;
+  }
+  else {
+    caps.unsupported = true;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Range header rejected as too large
+//------------------------------------------------------------------------------
+void MultirangeCapabilityCache::recordHeaderTooLarge(const std::string &endpoint, dav_size_t headerSize) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  MultirangeCapability &caps = update(endpoint);
+
+  dav_size_t limit = headerSize / 2;
+  if(limit < kMinHeaderSize) {
+    limit = kMinHeaderSize;
+  }
+
+  if(limit < caps.maxHeaderSize) {
+    caps.maxHeaderSize = limit;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Forget everything
+//------------------------------------------------------------------------------
+void MultirangeCapabilityCache::clear() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _entries.clear();
+}
+
+}
@@ -0,0 +1,120 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#ifndef DAVIX_CORE_MULTIRANGE_CAPABILITIES_HPP
+#define DAVIX_CORE_MULTIRANGE_CAPABILITIES_HPP
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utils/davix_types.hpp>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// What we know about the multi-range support of a single endpoint
+//------------------------------------------------------------------------------
+struct MultirangeCapability {
+  MultirangeCapability();
+
+  // server answers multi-range requests with the whole file, or a broken
+  // multipart response - don't even try
+  bool unsupported;
+
+  // maximum number of ranges per request, 0 if unknown
+  dav_size_t maxRanges;
+
+  // maximum size of the Range header
+  dav_size_t maxHeaderSize;
+
+  // largest number of ranges served successfully in a single request
+  dav_size_t largestSuccess;
+};
+
+//------------------------------------------------------------------------------
+// Context-wide cache of multi-range capabilities, keyed by endpoint (see
+// SessionFactory::makeSessionKey). Entries expire "ttl" after they were last
+// updated, so that a server upgrade is eventually picked up.
+//------------------------------------------------------------------------------
+class MultirangeCapabilityCache {
+public:
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  MultirangeCapabilityCache(std::chrono::milliseconds ttl = kDefaultTtl);
+
+  //----------------------------------------------------------------------------
+  // Get capabilities of the given endpoint - defaults if nothing is known
+  //----------------------------------------------------------------------------
+  MultirangeCapability get(const std::string &endpoint);
+
+  //----------------------------------------------------------------------------
+  // A request with "nranges" ranges was served as a proper multipart response
+  //----------------------------------------------------------------------------
+  void recordSuccess(const std::string &endpoint, dav_size_t nranges);
+
+  //----------------------------------------------------------------------------
+  // A request with "nranges" ranges got the whole file, or a broken multipart
+  // response. If fewer ranges worked before, this is only a limit on the
+  // number of ranges per request - otherwise, multi-range is unsupported.
+  //----------------------------------------------------------------------------
+  void recordFailure(const std::string &endpoint, dav_size_t nranges);
+
+  //----------------------------------------------------------------------------
+  // A request was rejected because its Range header of "headerSize" bytes
+  // was too large
+  //----------------------------------------------------------------------------
+  void recordHeaderTooLarge(const std::string &endpoint, dav_size_t headerSize);
+
+  //----------------------------------------------------------------------------
+  // Forget everything
+  //----------------------------------------------------------------------------
+  void clear();
+
+  // header line needs to be below 8K on Apache2 / nginx, and some S3
+  // implementations limit the total header size to 4K
+  static const dav_size_t kDefaultMaxHeaderSize = 3900;
+
+  // don't shrink the Range header below this
+  static const dav_size_t kMinHeaderSize = 256;
+
+  static constexpr std::chrono::milliseconds kDefaultTtl = std::chrono::minutes(10);
+
+private:
+  struct Entry {
+    MultirangeCapability caps;
+    std::chrono::steady_clock::time_point expires;
+  };
+
+  //----------------------------------------------------------------------------
+  // Get entry for update, dropping it first if it has expired. Refreshes
+  // the expiration time. Call with _mtx held.
+  //----------------------------------------------------------------------------
+  MultirangeCapability& update(const std::string &endpoint);
+
+  std::chrono::milliseconds _ttl;
+  std::mutex _mtx;
+  std::map<std::string, Entry> _entries;
+};
+
+}
+
+#endif
@@ -0,0 +1,248 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "ReplicaCache.hpp"
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+ReplicaCache::ReplicaCache(size_t maxEntries, std::chrono::milliseconds ttl, std::chrono::milliseconds cooldown)
+: _maxEntries(maxEntries), _ttl(ttl), _cooldown(cooldown) {}
+
+//------------------------------------------------------------------------------
+// Get the replicas of a URL
+//------------------------------------------------------------------------------
+bool ReplicaCache::get(const std::string &url, std::vector<std::string> &replicas) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  Entry *entry = lookup(url);
+  if(entry == NULL) {
+    return false;
+  }
+
+  replicas = entry->replicas;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Store the replicas of a URL
+//------------------------------------------------------------------------------
+void ReplicaCache::put(const std::string &url, const std::vector<std::string> &replicas) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  if(_ttl.count() <= 0 || _maxEntries == 0) {
+    return;
+  }
+
+  auto it = _entries.find(url);
+  if(it == _entries.end()) {
+    it = _entries.insert(std::make_pair(url, Entry())).first;
+    it->second.lru = _lru.insert(_lru.end(), url);
+  }
+  else {
+    _lru.splice(_lru.end(), _lru, it->second.lru);
+  }
+
+  it->second.replicas = replicas;
+  it->second.sizeKnown = false;
+  it->second.expires = std::chrono::steady_clock::now() + _ttl;
+  trim();
+}
+
+//------------------------------------------------------------------------------
+// Store the size of a URL
+//------------------------------------------------------------------------------
+void ReplicaCache::putSize(const std::string &url, dav_size_t size) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  Entry *entry = lookup(url);
+  if(entry != NULL) {
+    entry->sizeKnown = true;
+    entry->size = size;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get the size of a URL
+//------------------------------------------------------------------------------
+bool ReplicaCache::getSize(const std::string &url, dav_size_t &size) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  Entry *entry = lookup(url);
+  if(entry == NULL || !entry->sizeKnown) {
+    return false;
+  }
+
+  size = entry->size;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Forget the replicas of a URL
+//------------------------------------------------------------------------------
+void ReplicaCache::invalidate(const std::string &url) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  auto it = _entries.find(url);
+  if(it != _entries.end()) {
+    _lru.erase(it->second.lru);
+    _entries.erase(it);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Access to a replica failed
+//------------------------------------------------------------------------------
+void ReplicaCache::markFailed(const std::string &replica) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  if(_cooldown.count() <= 0) {
+    return;
+  }
+
+  _failed[replica] = std::chrono::steady_clock::now() + _cooldown;
+  trim();
+}
+
+//------------------------------------------------------------------------------
+// Access to a replica worked
+//------------------------------------------------------------------------------
+void ReplicaCache::markSucceeded(const std::string &replica) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _failed.erase(replica);
+}
+
+//------------------------------------------------------------------------------
+// Is a replica not known to have failed recently?
+//------------------------------------------------------------------------------
+bool ReplicaCache::isHealthy(const std::string &replica) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  auto it = _failed.find(replica);
+  if(it == _failed.end()) {
+    return true;
+  }
+
+  if(it->second <= std::chrono::steady_clock::now()) {
+    _failed.erase(it);
+    return true;
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Valid entry of a URL. Call with _mtx held.
+//------------------------------------------------------------------------------
+ReplicaCache::Entry* ReplicaCache::lookup(const std::string &url) {
+  auto it = _entries.find(url);
+  if(it == _entries.end()) {
+    return NULL;
+  }
+
+  if(it->second.expires <= std::chrono::steady_clock::now()) {
+    _lru.erase(it->second.lru);
+    _entries.erase(it);
+    return NULL;
+  }
+
+  _lru.splice(_lru.end(), _lru, it->second.lru);
+  return &it->second;
+}
+
+//------------------------------------------------------------------------------
+// Drop entries past the limit. Call with _mtx held.
+//------------------------------------------------------------------------------
+void ReplicaCache::trim() {
+  while(_entries.size() > _maxEntries) {
+    _entries.erase(_lru.front());
+    _lru.pop_front();
+  }
+
+  if(_failed.size() > _maxEntries) {
+    TimePoint now = std::chrono::steady_clock::now();
+    for(auto it = _failed.begin(); it != _failed.end();) {
+      if(it->second <= now) {
+        it = _failed.erase(it);
+      }
+      else {
+        ++it;
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Settings
+//------------------------------------------------------------------------------
+void ReplicaCache::setTtl(std::chrono::milliseconds ttl) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _ttl = ttl;
+
+  if(_ttl.count() <= 0) {
+    _entries.clear();
+    _lru.clear();
+  }
+}
+
+std::chrono::milliseconds ReplicaCache::getTtl() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _ttl;
+}
+
+void ReplicaCache::setMaxEntries(size_t maxEntries) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _maxEntries = maxEntries;
+  trim();
+}
+
+size_t ReplicaCache::getMaxEntries() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _maxEntries;
+}
+
+void ReplicaCache::setCooldown(std::chrono::milliseconds cooldown) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _cooldown = cooldown;
+
+  if(_cooldown.count() <= 0) {
+    _failed.clear();
+  }
+}
+
+std::chrono::milliseconds ReplicaCache::getCooldown() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _cooldown;
+}
+
+//------------------------------------------------------------------------------
+// Forget everything
+//------------------------------------------------------------------------------
+void ReplicaCache::clear() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _entries.clear();
+  _lru.clear();
+  _failed.clear();
+}
+
+}
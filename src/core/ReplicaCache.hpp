@@ -0,0 +1,170 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef DAVIX_CORE_REPLICA_CACHE_HPP
+#define DAVIX_CORE_REPLICA_CACHE_HPP
+
+#include <chrono>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <davix_internal_config.hpp>
+#include <utils/davix_types.hpp>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Context-wide cache of the replicas listed by Metalink documents, keyed by
+// the URL of the file they describe, so that a failover doesn't fetch and
+// parse the same document over and over. Entries expire "ttl" after they
+// were stored; past "maxEntries", the least recently used one is dropped.
+// An empty list is cached too: the server has no Metalink for the file.
+// The size of the file can be stored along, so that reads striped across
+// the replicas don't stat it each time.
+//
+// Replicas which failed are also remembered, and skipped by filterHealthy
+// until "cooldown" has passed, or they succeed again.
+//------------------------------------------------------------------------------
+class ReplicaCache {
+public:
+  //----------------------------------------------------------------------------
+  // Constructor - a ttl of 0 disables the cache, a cooldown of 0 the health
+  // marks
+  //----------------------------------------------------------------------------
+  ReplicaCache(size_t maxEntries = DAVIX_DEFAULT_REPLICA_CACHE_ENTRIES,
+    std::chrono::milliseconds ttl = std::chrono::seconds(DAVIX_DEFAULT_REPLICA_CACHE_TTL),
+    std::chrono::milliseconds cooldown = std::chrono::seconds(DAVIX_DEFAULT_REPLICA_COOLDOWN));
+
+  //----------------------------------------------------------------------------
+  // Get the replicas of "url", return false if they're not known
+  //----------------------------------------------------------------------------
+  bool get(const std::string &url, std::vector<std::string> &replicas);
+
+  //----------------------------------------------------------------------------
+  // Store the replicas of "url", none if it has no Metalink
+  //----------------------------------------------------------------------------
+  void put(const std::string &url, const std::vector<std::string> &replicas);
+
+  //----------------------------------------------------------------------------
+  // Store the size of "url", whose replicas are cached - forgotten along
+  // with them, or when they are stored again
+  //----------------------------------------------------------------------------
+  void putSize(const std::string &url, dav_size_t size);
+
+  //----------------------------------------------------------------------------
+  // Get the size of "url", return false if it's not known
+  //----------------------------------------------------------------------------
+  bool getSize(const std::string &url, dav_size_t &size);
+
+  //----------------------------------------------------------------------------
+  // Forget the replicas of "url"
+  //----------------------------------------------------------------------------
+  void invalidate(const std::string &url);
+
+  //----------------------------------------------------------------------------
+  // Access to "replica" failed, skip it for a while
+  //----------------------------------------------------------------------------
+  void markFailed(const std::string &replica);
+
+  //----------------------------------------------------------------------------
+  // Access to "replica" worked
+  //----------------------------------------------------------------------------
+  void markSucceeded(const std::string &replica);
+
+  //----------------------------------------------------------------------------
+  // Is "replica" not known to have failed recently?
+  //----------------------------------------------------------------------------
+  bool isHealthy(const std::string &replica);
+
+  //----------------------------------------------------------------------------
+  // Drop replicas which failed recently, keeping the order of the others.
+  // If none is left, all are kept: better retry them than not try at all.
+  //----------------------------------------------------------------------------
+  template<typename T, typename GetUrl>
+  void filterHealthy(std::vector<T> &replicas, GetUrl getUrl) {
+    std::vector<T> healthy;
+    for(size_t i = 0; i < replicas.size(); i++) {
+      if(isHealthy(getUrl(replicas[i]))) {
+        healthy.push_back(replicas[i]);
+      }
+    }
+
+    if(!healthy.empty()) {
+      replicas.swap(healthy);
+    }
+  }
+
+  void setTtl(std::chrono::milliseconds ttl);
+  std::chrono::milliseconds getTtl();
+
+  void setMaxEntries(size_t maxEntries);
+  size_t getMaxEntries();
+
+  void setCooldown(std::chrono::milliseconds cooldown);
+  std::chrono::milliseconds getCooldown();
+
+  //----------------------------------------------------------------------------
+  // Forget everything
+  //----------------------------------------------------------------------------
+  void clear();
+
+private:
+  typedef std::chrono::steady_clock::time_point TimePoint;
+
+  struct Entry {
+    Entry() : sizeKnown(false), size(0) {}
+
+    std::vector<std::string> replicas;
+    bool sizeKnown;
+    dav_size_t size;
+    TimePoint expires;
+    std::list<std::string>::iterator lru;
+  };
+
+  //----------------------------------------------------------------------------
+  // Entry of "url" if there's one still valid, marked as most recently used.
+  // Call with _mtx held.
+  //----------------------------------------------------------------------------
+  Entry* lookup(const std::string &url);
+
+  //----------------------------------------------------------------------------
+  // Drop entries past the limit, and expired health marks once there are too
+  // many of them. Call with _mtx held.
+  //----------------------------------------------------------------------------
+  void trim();
+
+  std::mutex _mtx;
+  size_t _maxEntries;
+  std::chrono::milliseconds _ttl;
+  std::chrono::milliseconds _cooldown;
+
+  std::map<std::string, Entry> _entries;
+  // most recently used last
+  std::list<std::string> _lru;
+  // replica -> end of its cooldown
+  std::map<std::string, TimePoint> _failed;
+};
+
+}
+
+#endif
@@ -0,0 +1,267 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "RetryPolicy.hpp"
+#include <utils/davix_logger_internal.hpp>
+
+#include <algorithm>
+#include <random>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Stats: Constructor
+//------------------------------------------------------------------------------
+RetryStats::RetryStats() : retries(0), budgetExhausted(0), circuitOpenings(0), fastFailures(0) {}
+
+//------------------------------------------------------------------------------
+// Exponential backoff with full jitter
+//------------------------------------------------------------------------------
+std::chrono::milliseconds backoffDelay(unsigned int attempt, std::chrono::milliseconds base, std::chrono::milliseconds max) {
+  if(base.count() <= 0 || attempt == 0) {
+    return std::chrono::milliseconds(0);
+  }
+
+  // no overflow, however many retries
+  int64_t ceiling = std::max(base.count(), max.count());
+  int64_t cap = base.count();
+  for(unsigned int i = 1; i < attempt && cap < ceiling; i++) {
+    cap *= 2;
+  }
+  cap = std::min(cap, ceiling);
+
+  static thread_local std::mt19937_64 generator(std::random_device{}());
+  std::uniform_int_distribution<int64_t> distribution(0, cap);
+  return std::chrono::milliseconds(distribution(generator));
+}
+
+std::chrono::milliseconds backoffDelay(unsigned int attempt, const RequestParams &params) {
+  return backoffDelay(attempt, backoffBase(params), std::chrono::milliseconds(params.getRetryBackoffMax()));
+}
+
+std::chrono::milliseconds backoffBase(const RequestParams &params) {
+  // the legacy fixed delay, in seconds
+  if(params.getOperationRetryDelay() > 0) {
+    return std::chrono::seconds(params.getOperationRetryDelay());
+  }
+  return std::chrono::milliseconds(params.getRetryBackoffBase());
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+RetryBudget::RetryBudget(double burst, double rate, unsigned int threshold, std::chrono::milliseconds cooldown)
+: _burst(burst), _rate(rate), _threshold(threshold), _cooldown(cooldown) {}
+
+//------------------------------------------------------------------------------
+// Take a token for a retry
+//------------------------------------------------------------------------------
+bool RetryBudget::tryRetry(const std::string &endpoint) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  if(_burst <= 0) {
+    _stats.retries++;
+    return true;
+  }
+
+  Endpoint &ep = _endpoints[endpoint];
+  TimePoint now = std::chrono::steady_clock::now();
+
+  if(ep.tokens < 0) {
+    ep.tokens = _burst;
+  }
+  else {
+    double elapsed = std::chrono::duration<double>(now - ep.refilled).count();
+    ep.tokens = std::min(_burst, ep.tokens + elapsed * _rate);
+  }
+  ep.refilled = now;
+
+  if(ep.tokens < 1) {
+    _stats.budgetExhausted++;
+    return false;
+  }
+
+  ep.tokens -= 1;
+  _stats.retries++;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// May an operation be sent?
+//------------------------------------------------------------------------------
+bool RetryBudget::allowRequest(const std::string &endpoint) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  if(_threshold == 0) {
+    return true;
+  }
+
+  auto it = _endpoints.find(endpoint);
+  if(it == _endpoints.end() || !it->second.open) {
+    return true;
+  }
+
+  // half-open: a single probe at a time
+  Endpoint &ep = it->second;
+  if(!ep.probing && std::chrono::steady_clock::now() >= ep.opened + _cooldown) {
+    ep.probing = true;
+    return true;
+  }
+
+  _stats.fastFailures++;
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Throw if the circuit of an endpoint is open
+//------------------------------------------------------------------------------
+void RetryBudget::checkCircuit(const std::string &endpoint) {
+  if(!allowRequest(endpoint)) {
+    throw DavixException(davix_scope_io_buff(), StatusCode::ConnectionProblem,
+      fmt::format("{} failed repeatedly, not trying it again for now", endpoint));
+  }
+}
+
+//------------------------------------------------------------------------------
+// An operation got an answer
+//------------------------------------------------------------------------------
+void RetryBudget::recordSuccess(const std::string &endpoint) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  auto it = _endpoints.find(endpoint);
+  if(it == _endpoints.end()) {
+    return;
+  }
+
+  Endpoint &ep = it->second;
+  if(ep.open) {
+    DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "{} answers again, closing its circuit", endpoint);
+  }
+
+  ep.failures = 0;
+  ep.open = false;
+  ep.probing = false;
+}
+
+//------------------------------------------------------------------------------
+// An operation got no usable answer
+//------------------------------------------------------------------------------
+void RetryBudget::recordFailure(const std::string &endpoint) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  if(_threshold == 0) {
+    return;
+  }
+
+  Endpoint &ep = _endpoints[endpoint];
+  ep.failures++;
+
+  // a failed probe opens the circuit again, for another cooldown
+  if(ep.probing || (!ep.open && ep.failures >= _threshold)) {
+    DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "{} failed {} times in a row, opening its circuit for {} ms", endpoint, ep.failures, _cooldown.count());
+    ep.open = true;
+    ep.probing = false;
+    ep.opened = std::chrono::steady_clock::now();
+    _stats.circuitOpenings++;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Errors telling that the endpoint is in trouble: the server failing with a
+// 5xx, or no answer at all. Status codes alone can't tell, several 4xx map
+// to ConnectionProblem.
+//------------------------------------------------------------------------------
+bool RetryBudget::isEndpointFailure(StatusCode::Code code, int httpStatus) {
+  if(httpStatus != 0) {
+    // not implemented, version not supported: about the request, not the server
+    return httpStatus >= 500 && httpStatus != 501 && httpStatus != 505;
+  }
+
+  switch(code) {
+    case StatusCode::ConnectionProblem:
+    case StatusCode::ConnectionTimeout:
+    case StatusCode::OperationTimeout:
+    case StatusCode::NameResolutionFailure:
+    case StatusCode::SessionCreationError:
+    case StatusCode::SSLError:
+    case StatusCode::UnknownError:
+      return true;
+    default:
+      return false;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Settings
+//------------------------------------------------------------------------------
+void RetryBudget::setBudget(double burst, double rate) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _burst = burst;
+  _rate = rate;
+
+  for(auto it = _endpoints.begin(); it != _endpoints.end(); ++it) {
+    it->second.tokens = -1;
+  }
+}
+
+double RetryBudget::getBurst() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _burst;
+}
+
+double RetryBudget::getRate() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _rate;
+}
+
+void RetryBudget::setCircuitBreaker(unsigned int threshold, std::chrono::milliseconds cooldown) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _threshold = threshold;
+  _cooldown = cooldown;
+}
+
+unsigned int RetryBudget::getThreshold() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _threshold;
+}
+
+std::chrono::milliseconds RetryBudget::getCooldown() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _cooldown;
+}
+
+//------------------------------------------------------------------------------
+// Get the counters
+//------------------------------------------------------------------------------
+RetryStats RetryBudget::getStats() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _stats;
+}
+
+//------------------------------------------------------------------------------
+// Forget all endpoints
+//------------------------------------------------------------------------------
+void RetryBudget::clear() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _endpoints.clear();
+}
+
+}
@@ -0,0 +1,155 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef DAVIX_CORE_RETRY_POLICY_HPP
+#define DAVIX_CORE_RETRY_POLICY_HPP
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <davix_internal.hpp>
+#include <davix_internal_config.hpp>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Delay before retry number "attempt" (1 for the first retry), exponential
+// backoff with full jitter: uniformly random between 0 and
+// min(max, base * 2^(attempt-1)), so that clients failing together don't
+// retry together
+//------------------------------------------------------------------------------
+std::chrono::milliseconds backoffDelay(unsigned int attempt, std::chrono::milliseconds base, std::chrono::milliseconds max);
+
+//------------------------------------------------------------------------------
+// Same, with the backoff settings of "params"
+//------------------------------------------------------------------------------
+std::chrono::milliseconds backoffDelay(unsigned int attempt, const RequestParams &params);
+
+//------------------------------------------------------------------------------
+// Base of the backoff of "params": the legacy retry delay, if set
+//------------------------------------------------------------------------------
+std::chrono::milliseconds backoffBase(const RequestParams &params);
+
+//------------------------------------------------------------------------------
+// Context-wide retry budgets and circuit breakers, one per endpoint (see
+// SessionFactory::makeSessionKey).
+//
+// Each retry takes a token from the bucket of its endpoint, which holds up
+// to "burst" tokens and gets "rate" new ones every second: once it's empty,
+// operations fail instead of retrying, however many retries they have left.
+//
+// After "threshold" failures of an endpoint in a row, without a single
+// success in between, the endpoint is considered down: its circuit opens,
+// and operations fail right away for "cooldown". A single operation is then
+// let through to probe it - the circuit closes again if it succeeds.
+//------------------------------------------------------------------------------
+class RetryBudget {
+public:
+  //----------------------------------------------------------------------------
+  // Constructor - a burst of 0 disables the budgets, a threshold of 0 the
+  // circuit breakers
+  //----------------------------------------------------------------------------
+  RetryBudget(double burst = DAVIX_DEFAULT_RETRY_BUDGET_BURST, double rate = DAVIX_DEFAULT_RETRY_BUDGET_RATE,
+    unsigned int threshold = DAVIX_DEFAULT_CIRCUIT_BREAKER_THRESHOLD,
+    std::chrono::milliseconds cooldown = std::chrono::milliseconds(DAVIX_DEFAULT_CIRCUIT_BREAKER_COOLDOWN));
+
+  //----------------------------------------------------------------------------
+  // Take a token for a retry, return false if there's none left
+  //----------------------------------------------------------------------------
+  bool tryRetry(const std::string &endpoint);
+
+  //----------------------------------------------------------------------------
+  // May an operation be sent to "endpoint"? False while its circuit is open,
+  // or while another operation is probing it.
+  //----------------------------------------------------------------------------
+  bool allowRequest(const std::string &endpoint);
+
+  //----------------------------------------------------------------------------
+  // Throw, if an operation may not be sent to "endpoint"
+  //----------------------------------------------------------------------------
+  void checkCircuit(const std::string &endpoint);
+
+  //----------------------------------------------------------------------------
+  // An operation sent to "endpoint" got an answer - whatever it was
+  //----------------------------------------------------------------------------
+  void recordSuccess(const std::string &endpoint);
+
+  //----------------------------------------------------------------------------
+  // An operation sent to "endpoint" got no usable answer
+  //----------------------------------------------------------------------------
+  void recordFailure(const std::string &endpoint);
+
+  //----------------------------------------------------------------------------
+  // Does an error tell that the endpoint itself is in trouble - unreachable,
+  // timing out, failing with a server error? Errors built from an HTTP
+  // answer are judged by its status "httpStatus", never by "code".
+  //----------------------------------------------------------------------------
+  static bool isEndpointFailure(StatusCode::Code code, int httpStatus);
+
+  void setBudget(double burst, double rate);
+  double getBurst() const;
+  double getRate() const;
+
+  void setCircuitBreaker(unsigned int threshold, std::chrono::milliseconds cooldown);
+  unsigned int getThreshold() const;
+  std::chrono::milliseconds getCooldown() const;
+
+  //----------------------------------------------------------------------------
+  // Get the counters
+  //----------------------------------------------------------------------------
+  RetryStats getStats() const;
+
+  //----------------------------------------------------------------------------
+  // Forget the state of all endpoints, keep the counters
+  //----------------------------------------------------------------------------
+  void clear();
+
+private:
+  typedef std::chrono::steady_clock::time_point TimePoint;
+
+  struct Endpoint {
+    Endpoint() : tokens(-1), failures(0), open(false), probing(false) {}
+
+    // token bucket, full until first used
+    double tokens;
+    TimePoint refilled;
+
+    // circuit breaker: consecutive failures, open since, probe in flight
+    unsigned int failures;
+    bool open;
+    TimePoint opened;
+    bool probing;
+  };
+
+  mutable std::mutex _mtx;
+  double _burst;
+  double _rate;
+  unsigned int _threshold;
+  std::chrono::milliseconds _cooldown;
+
+  std::map<std::string, Endpoint> _endpoints;
+  RetryStats _stats;
+};
+
+}
+
+#endif
@@ -22,65 +22,366 @@
 #ifndef DAVIX_CORE_SESSION_POOL_HPP
 #define DAVIX_CORE_SESSION_POOL_HPP
 
-#include <map>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 //------------------------------------------------------------------------------
 // Utility class to juggle sessions based on URI and parameters.
+//
+// Sessions are spread over independently locked shards by the hash of their
+// key, so that threads talking to different endpoints never contend on the
+// same lock. The sessions of a single key are further spread over kLanes
+// shards: each thread inserts into, and first retrieves from, the lane it
+// was assigned, and only falls back to the other lanes when its own is
+// empty - so that many threads talking to the same endpoint don't all
+// contend on one lock either. Keys are hashed once per call, shards index
+// their sessions by that hash.
+//
+// Within a lane, sessions are reused last-in first-out: the most recently
+// used one is the most likely to still have a live connection and a warm
+// TLS session.
+//
+// Idle sessions expire after the timeout given when they were inserted, as
+// the server has most likely closed their connection by then: they are
+// discarded instead of handed out, either on the next retrieve under their
+// key, or by the optional background reaper. The items of a key are counted
+// across its lanes, so that a maximum per key holds whatever lane they are in.
 //------------------------------------------------------------------------------
 template<typename T>
 class SessionPool {
 public:
+  typedef std::chrono::steady_clock Clock;
+
   //----------------------------------------------------------------------------
   // Constructor
   //----------------------------------------------------------------------------
-  SessionPool() {}
+  SessionPool() : _reapInterval(0), _reaperStop(false) {}
 
   //----------------------------------------------------------------------------
   // Destructor
   //----------------------------------------------------------------------------
   virtual ~SessionPool() {
+    setReapInterval(std::chrono::milliseconds(0));
     clear();
   }
 
   //----------------------------------------------------------------------------
-  // Insert
+  // Insert. The item expires once idle for "idleTimeout" (0: never), and at
+  // most "maxIdle" items are kept under this key (0: unlimited) - the least
+  // recently inserted ones of the calling thread's lane are dropped first.
   //----------------------------------------------------------------------------
-  void insert(const std::string &key, T item) {
-    std::lock_guard<std::mutex> lock(_mutex);
-    _map.insert(std::pair<std::string, T>(key, std::move(item)));
+  void insert(const std::string &key, T item,
+              std::chrono::milliseconds idleTimeout = std::chrono::milliseconds(0),
+              size_t maxIdle = 0) {
+
+    Entry entry;
+    entry.item = std::move(item);
+    entry.expires = Clock::time_point::max();
+
+    if(idleTimeout.count() > 0) {
+      entry.expires = Clock::now() + idleTimeout;
+    }
+
+    // closing connections can take a while, dropped items are destroyed
+    // only once the shard lock is released
+    std::vector<Entry> dropped;
+    {
+      const size_t hash = hashKey(key);
+      Shard &shard = getShard(hash, getLane());
+      std::unique_lock<std::mutex> lock(shard.mutex);
+      Bucket *bucket = shard.find(hash, key, false);
+
+      if(bucket == NULL) {
+        // first item of the key in this lane: share the count of the others
+        lock.unlock();
+        std::shared_ptr<std::atomic<size_t>> count = getCount(key);
+        lock.lock();
+
+        bucket = shard.find(hash, key, true);
+        if(!bucket->count) {
+          bucket->count = count;
+        }
+      }
+
+      bucket->entries.push_back(std::move(entry));
+      size_t total = ++*bucket->count;
+
+      // the other lanes may hold more, this one has at least the new item
+      if(maxIdle != 0 && total > maxIdle) {
+        size_t excess = std::min(total - maxIdle, bucket->entries.size());
+        dropped.insert(dropped.end(), std::make_move_iterator(bucket->entries.begin()),
+                       std::make_move_iterator(bucket->entries.begin() + excess));
+        bucket->entries.erase(bucket->entries.begin(), bucket->entries.begin() + excess);
+        *bucket->count -= excess;
+      }
+    }
   }
 
   //----------------------------------------------------------------------------
   // Clear
   //----------------------------------------------------------------------------
   void clear() {
-    std::lock_guard<std::mutex> lock(_mutex);
-    _map.clear();
+    for(size_t i = 0; i < kShards; i++) {
+      std::lock_guard<std::mutex> lock(_shards[i].mutex);
+      _shards[i].map.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(_countsMtx);
+    _counts.clear();
   }
 
   //----------------------------------------------------------------------------
-  // Retrieve: Remove from the map and copy value onto caller variable.
+  // Retrieve: Remove the most recently inserted item under this key which has
+  // not expired yet, from the lane of the calling thread first, and move it
+  // onto caller variable. Expired items met on the way are discarded.
   // Return true if value was found, returned and erased, and false otherwise.
   //----------------------------------------------------------------------------
   bool retrieve(const std::string &key, T& item) {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto it = _map.find(key);
+    Clock::time_point now = Clock::now();
+    const size_t hash = hashKey(key);
+    const size_t lane = getLane();
+
+    for(size_t i = 0; i < kLanes; i++) {
+      std::vector<Entry> dropped;
+
+      Shard &shard = getShard(hash, (lane + i) % kLanes);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      Bucket *bucket = shard.find(hash, key, false);
+
+      if(bucket == NULL) {
+        continue;
+      }
 
-    if(it == _map.end()) {
-      return false;
+      std::vector<Entry> &entries = bucket->entries;
+      while(!entries.empty()) {
+        Entry entry = std::move(entries.back());
+        entries.pop_back();
+        --*bucket->count;
+
+        if(entry.expires > now) {
+          item = std::move(entry.item);
+          return true;
+        }
+
+        dropped.push_back(std::move(entry));
+      }
     }
 
-    item = it->second;
-    _map.erase(it);
-    return true;
+    return false;
   }
 
+  //----------------------------------------------------------------------------
+  // Discard all expired items, return how many
+  //----------------------------------------------------------------------------
+  size_t reap() {
+    Clock::time_point now = Clock::now();
+    size_t count = 0;
+
+    for(size_t i = 0; i < kShards; i++) {
+      std::vector<Entry> dropped;
+      {
+        std::lock_guard<std::mutex> lock(_shards[i].mutex);
+        auto &map = _shards[i].map;
+
+        for(auto it = map.begin(); it != map.end(); ) {
+          std::vector<Bucket> &buckets = it->second;
+
+          for(size_t b = 0; b < buckets.size(); ) {
+            std::vector<Entry> &entries = buckets[b].entries;
+
+            for(size_t j = 0; j < entries.size(); ) {
+              if(entries[j].expires <= now) {
+                dropped.push_back(std::move(entries[j]));
+                entries.erase(entries.begin() + j);
+                --*buckets[b].count;
+              }
+              else {
+                j++;
+              }
+            }
+
+            if(entries.empty()) {
+              buckets.erase(buckets.begin() + b);
+            }
+            else {
+              b++;
+            }
+          }
+
+          if(buckets.empty()) {
+            it = map.erase(it);
+          }
+          else {
+            it++;
+          }
+        }
+      }
+
+      count += dropped.size();
+    }
+
+    return count;
+  }
+
+  //----------------------------------------------------------------------------
+  // Run reap() every "interval" from a background thread. 0 stops the reaper.
+  //----------------------------------------------------------------------------
+  void setReapInterval(std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> setLock(_reaperSetMtx);
+
+    if(_reaper.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(_reaperMtx);
+        _reaperStop = true;
+      }
+
+      _reaperCv.notify_all();
+      _reaper.join();
+    }
+
+    _reapInterval = interval;
+    _reaperStop = false;
+
+    if(interval.count() > 0) {
+      _reaper = std::thread(&SessionPool::reaperLoop, this);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Number of items stored, expired or not
+  //----------------------------------------------------------------------------
+  size_t size() const {
+    size_t total = 0;
+    for(size_t i = 0; i < kShards; i++) {
+      std::lock_guard<std::mutex> lock(_shards[i].mutex);
+      for(auto it = _shards[i].map.begin(); it != _shards[i].map.end(); it++) {
+        for(size_t b = 0; b < it->second.size(); b++) {
+          total += it->second[b].entries.size();
+        }
+      }
+    }
+    return total;
+  }
+
+  static const size_t kShards = 16;
+  static const size_t kLanes = 4;
+
 private:
-  std::multimap<std::string, T> _map;
-  std::mutex _mutex;
+  struct Entry {
+    T item;
+    Clock::time_point expires;
+  };
+
+  // items of a single key in one lane, and how many there are in all lanes
+  struct Bucket {
+    std::string key;
+    std::vector<Entry> entries;
+    std::shared_ptr<std::atomic<size_t>> count;
+  };
+
+  // identity hash: keys are hashed once, by the caller
+  struct PreHashed {
+    size_t operator()(size_t hash) const {
+      return hash;
+    }
+  };
+
+  // one cache line each, so that neighbouring locks don't false-share
+  struct alignas(64) Shard {
+    mutable std::mutex mutex;
+
+    // keys sharing a hash share a slot
+    std::unordered_map<size_t, std::vector<Bucket>, PreHashed> map;
+
+    Bucket* find(size_t hash, const std::string &key, bool create) {
+      std::vector<Bucket> *buckets;
+
+      if(create) {
+        buckets = &map[hash];
+      }
+      else {
+        auto it = map.find(hash);
+        if(it == map.end()) {
+          return NULL;
+        }
+        buckets = &it->second;
+      }
+
+      for(size_t i = 0; i < buckets->size(); i++) {
+        if((*buckets)[i].key == key) {
+          return &(*buckets)[i];
+        }
+      }
+
+      if(!create) {
+        return NULL;
+      }
 
+      buckets->emplace_back();
+      buckets->back().key = key;
+      return &buckets->back();
+    }
+  };
+
+  // item count of a key, shared by its lanes
+  std::shared_ptr<std::atomic<size_t>> getCount(const std::string &key) {
+    std::lock_guard<std::mutex> lock(_countsMtx);
+    std::shared_ptr<std::atomic<size_t>> &count = _counts[key];
+    if(!count) {
+      count = std::make_shared<std::atomic<size_t>>(0);
+    }
+    return count;
+  }
+
+  static size_t hashKey(const std::string &key) {
+    return std::hash<std::string>()(key);
+  }
+
+  // the lanes of a key land on distinct shards
+  Shard& getShard(size_t hash, size_t lane) {
+    return _shards[(hash + lane * (kShards / kLanes)) % kShards];
+  }
+
+  // lanes are handed out to threads round-robin
+  static size_t getLane() {
+    static std::atomic<size_t> next(0);
+    static thread_local size_t lane = next++ % kLanes;
+    return lane;
+  }
+
+  void reaperLoop() {
+    std::unique_lock<std::mutex> lock(_reaperMtx);
+
+    while(!_reaperCv.wait_for(lock, _reapInterval, [this] { return _reaperStop; })) {
+      lock.unlock();
+      reap();
+      lock.lock();
+    }
+  }
+
+  std::array<Shard, kShards> _shards;
+
+  // only looked up when a lane gets its first item of a key
+  std::mutex _countsMtx;
+  std::unordered_map<std::string, std::shared_ptr<std::atomic<size_t>>> _counts;
+
+  std::mutex _reaperSetMtx;
+  std::mutex _reaperMtx;
+  std::condition_variable _reaperCv;
+  std::chrono::milliseconds _reapInterval;
+  bool _reaperStop;
+  std::thread _reaper;
 };
 
 #endif
-
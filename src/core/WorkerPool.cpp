@@ -0,0 +1,240 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include "WorkerPool.hpp"
+
+#include <exception>
+#include <memory>
+
+namespace Davix {
+
+namespace {
+
+//------------------------------------------------------------------------------
+// Shared state of a single forEach call. Helpers queued on the pool may only
+// get to run after the caller has returned - they hold a reference to the
+// batch, and never touch the callback unless they manage to claim an item.
+//------------------------------------------------------------------------------
+struct Batch {
+  Batch(size_t c, const std::function<void(size_t)> &f)
+  : count(c), fn(f), next(0), inflight(0), failed(false) {}
+
+  //----------------------------------------------------------------------------
+  // Claim next item, returns false if there's nothing left to do
+  //----------------------------------------------------------------------------
+  bool claim(size_t &item) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if(failed || next >= count) {
+      return false;
+    }
+
+    item = next++;
+    inflight++;
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Mark claimed item as finished
+  //----------------------------------------------------------------------------
+  void finish(std::exception_ptr exc) {
+    std::lock_guard<std::mutex> lock(mtx);
+    inflight--;
+
+    if(exc && !failed) {
+      failed = true;
+      error = exc;
+    }
+
+    cv.notify_all();
+  }
+
+  //----------------------------------------------------------------------------
+  // Process items until there's none left
+  //----------------------------------------------------------------------------
+  void drain() {
+    size_t item;
+    while(claim(item)) {
+      std::exception_ptr exc;
+
+      try {
+        fn(item);
+      }
+      catch(...) {
+        exc = std::current_exception();
+      }
+
+      finish(exc);
+    }
+  }
+
+  const size_t count;
+  const std::function<void(size_t)> &fn;
+
+  std::mutex mtx;
+  std::condition_variable cv;
+  size_t next;
+  size_t inflight;
+  bool failed;
+  std::exception_ptr error;
+};
+
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+WorkerPool::WorkerPool(size_t maxWorkers)
+: _max_workers(maxWorkers), _idle(0), _shutdown(false) {}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _shutdown = true;
+  }
+
+  _cv.notify_all();
+
+  for(auto it = _workers.begin(); it != _workers.end(); it++) {
+    it->join();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Make sure at least n workers are running
+//------------------------------------------------------------------------------
+void WorkerPool::ensureWorkers(size_t n) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  if(n > _max_workers) {
+    n = _max_workers;
+  }
+
+  // the destructor is iterating over _workers
+  if(_shutdown) {
+    return;
+  }
+
+  while(_workers.size() < n) {
+    _workers.emplace_back(&WorkerPool::work, this);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Queue a task
+//------------------------------------------------------------------------------
+void WorkerPool::submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _queue.push_back(std::move(task));
+
+    // every queued task should have a worker to run on, so that long
+    // operations submitted back to back don't wait for each other
+    if(!_shutdown && _queue.size() > _idle && _workers.size() < _max_workers) {
+      _workers.emplace_back(&WorkerPool::work, this);
+    }
+  }
+
+  _cv.notify_one();
+}
+
+//------------------------------------------------------------------------------
+// Run fn over [0, count) with dynamic assignment of items to threads
+//------------------------------------------------------------------------------
+void WorkerPool::forEach(size_t count, size_t parallelism, const std::function<void(size_t)> &fn) {
+  if(count == 0) {
+    return;
+  }
+
+  if(parallelism == 0) {
+    parallelism = 1;
+  }
+
+  if(parallelism > count) {
+    parallelism = count;
+  }
+
+  std::shared_ptr<Batch> batch = std::make_shared<Batch>(count, fn);
+
+  //----------------------------------------------------------------------------
+  // The calling thread takes part, so we only need parallelism - 1 helpers.
+  // Even if every worker is busy with someone else's batch, the caller alone
+  // guarantees progress.
+  //----------------------------------------------------------------------------
+  size_t helpers = parallelism - 1;
+  if(helpers > 0) {
+    ensureWorkers(helpers);
+
+    {
+      std::lock_guard<std::mutex> lock(_mtx);
+      for(size_t i = 0; i < helpers; i++) {
+        _queue.push_back([batch]() { batch->drain(); });
+      }
+    }
+
+    _cv.notify_all();
+  }
+
+  batch->drain();
+
+  std::unique_lock<std::mutex> lock(batch->mtx);
+  batch->cv.wait(lock, [&batch]() { return batch->inflight == 0; });
+
+  if(batch->error) {
+    std::rethrow_exception(batch->error);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Number of worker threads spawned so far
+//------------------------------------------------------------------------------
+size_t WorkerPool::getWorkerCount() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _workers.size();
+}
+
+//------------------------------------------------------------------------------
+// Worker thread main
+//------------------------------------------------------------------------------
+void WorkerPool::work() {
+  while(true) {
+    std::function<void()> task;
+
+    {
+      std::unique_lock<std::mutex> lock(_mtx);
+      _idle++;
+      _cv.wait(lock, [this]() { return _shutdown || !_queue.empty(); });
+      _idle--;
+
+      if(_queue.empty()) {
+        return;
+      }
+
+      task = std::move(_queue.front());
+      _queue.pop_front();
+    }
+
+    task();
+  }
+}
+
+}
@@ -0,0 +1,110 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#ifndef DAVIX_CORE_WORKER_POOL_HPP
+#define DAVIX_CORE_WORKER_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// A pool of long-lived worker threads, owned by a Context. Threads are
+// spawned lazily, the first time someone asks for them, and stay around
+// until the pool is destroyed.
+//------------------------------------------------------------------------------
+class WorkerPool {
+public:
+  //----------------------------------------------------------------------------
+  // Constructor - no threads are started until needed
+  //----------------------------------------------------------------------------
+  WorkerPool(size_t maxWorkers = kDefaultMaxWorkers);
+
+  //----------------------------------------------------------------------------
+  // Destructor - drains the queue and joins all workers
+  //----------------------------------------------------------------------------
+  ~WorkerPool();
+
+  //----------------------------------------------------------------------------
+  // No copying, no moving
+  //----------------------------------------------------------------------------
+  WorkerPool(const WorkerPool& other) = delete;
+  WorkerPool& operator=(const WorkerPool& other) = delete;
+
+  //----------------------------------------------------------------------------
+  // Queue a task for execution on one of the workers. A new worker is
+  // spawned if none is idle, up to the maximum.
+  //----------------------------------------------------------------------------
+  void submit(std::function<void()> task);
+
+  //----------------------------------------------------------------------------
+  // Call fn(i) for every i in [0, count), using up to "parallelism" threads,
+  // the calling thread included. Indices are handed out one at a time to
+  // whichever thread becomes idle first, so a single slow item doesn't hold
+  // back a whole statically assigned slice.
+  //
+  // Blocks until every claimed item has finished. If fn throws, no new items
+  // are handed out and the first exception is rethrown to the caller.
+  //----------------------------------------------------------------------------
+  void forEach(size_t count, size_t parallelism, const std::function<void(size_t)> &fn);
+
+  //----------------------------------------------------------------------------
+  // Number of worker threads spawned so far
+  //----------------------------------------------------------------------------
+  size_t getWorkerCount() const;
+
+  //----------------------------------------------------------------------------
+  // Maximum number of worker threads this pool will ever spawn
+  //----------------------------------------------------------------------------
+  size_t getMaxWorkers() const {
+    return _max_workers;
+  }
+
+  static const size_t kDefaultMaxWorkers = 64;
+
+private:
+  //----------------------------------------------------------------------------
+  // Make sure at least n workers are running, capped to _max_workers
+  //----------------------------------------------------------------------------
+  void ensureWorkers(size_t n);
+
+  //----------------------------------------------------------------------------
+  // Worker thread main
+  //----------------------------------------------------------------------------
+  void work();
+
+  size_t _max_workers;
+
+  mutable std::mutex _mtx;
+  std::condition_variable _cv;
+  std::deque<std::function<void()>> _queue;
+  std::vector<std::thread> _workers;
+  size_t _idle;
+  bool _shutdown;
+};
+
+}
+
+#endif
@@ -0,0 +1,375 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include "CurlMultiLoop.hpp"
+#include "CurlSession.hpp"
+#include <utils/davix_logger_internal.hpp>
+#include <curl/curl.h>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Maximum time the event loop sleeps when idle - curl_multi_wakeup interrupts
+// it as soon as there's a new command.
+//------------------------------------------------------------------------------
+static const int kIdlePollMs = 1000;
+
+//------------------------------------------------------------------------------
+// CurlTransfer: Constructor
+//------------------------------------------------------------------------------
+CurlTransfer::CurlTransfer(CURL *handle, size_t maxBuffered)
+: _handle(handle), _max_buffered(maxBuffered), _max_streams(0), _max_connects(0), _done(false),
+  _detached(true), _paused(false), _result(CURLE_OK), _status_code(0) {}
+
+//------------------------------------------------------------------------------
+// CurlTransfer: feed response body
+//------------------------------------------------------------------------------
+bool CurlTransfer::feed(const char *buff, size_t len) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  if(_buffer.size() >= _max_buffered) {
+    _paused = true;
+    return false;
+  }
+
+  _buffer.feed(buff, len);
+  _cv.notify_all();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// CurlTransfer: mark transfer as completed
+//------------------------------------------------------------------------------
+void CurlTransfer::markDone(int result) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _done = true;
+  _result = result;
+  _cv.notify_all();
+}
+
+//------------------------------------------------------------------------------
+// CurlTransfer: event loop no longer references the easy handle
+//------------------------------------------------------------------------------
+void CurlTransfer::markDetached() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _detached = true;
+  _cv.notify_all();
+}
+
+//------------------------------------------------------------------------------
+// CurlTransfer: remember status code
+//------------------------------------------------------------------------------
+void CurlTransfer::setStatusCode(long code) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _status_code = code;
+}
+
+//------------------------------------------------------------------------------
+// CurlTransfer: consume buffered body
+//------------------------------------------------------------------------------
+size_t CurlTransfer::consume(char *target, size_t maxlen, bool &needsResume) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  size_t bytes = _buffer.consume(target, maxlen);
+
+  needsResume = false;
+  if(_paused && _buffer.size() < _max_buffered) {
+    _paused = false;
+    needsResume = true;
+  }
+
+  return bytes;
+}
+
+//------------------------------------------------------------------------------
+// CurlTransfer: wait until there's body data, or the transfer is done
+//------------------------------------------------------------------------------
+bool CurlTransfer::waitForData(uint64_t timeoutMs) {
+  std::unique_lock<std::mutex> lock(_mtx);
+
+  auto ready = [this]() { return _done || _buffer.size() != 0u; };
+
+  if(timeoutMs == std::numeric_limits<uint64_t>::max()) {
+    _cv.wait(lock, ready);
+  }
+  else {
+    _cv.wait_for(lock, std::chrono::milliseconds(timeoutMs), ready);
+  }
+
+  return _done;
+}
+
+//------------------------------------------------------------------------------
+// CurlTransfer: wait until the event loop has released the easy handle
+//------------------------------------------------------------------------------
+void CurlTransfer::waitDetached() {
+  std::unique_lock<std::mutex> lock(_mtx);
+  _cv.wait(lock, [this]() { return _detached; });
+}
+
+//------------------------------------------------------------------------------
+// CurlTransfer: accessors
+//------------------------------------------------------------------------------
+size_t CurlTransfer::size() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _buffer.size();
+}
+
+bool CurlTransfer::isDone() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _done;
+}
+
+bool CurlTransfer::isDetached() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _detached;
+}
+
+int CurlTransfer::getResult() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _result;
+}
+
+long CurlTransfer::getStatusCode() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _status_code;
+}
+
+//------------------------------------------------------------------------------
+// Constructor - starts the event loop thread
+//------------------------------------------------------------------------------
+CurlMultiLoop::CurlMultiLoop(CurlConnectionCounters &counters)
+: _mhandle(curl_multi_init()), _counters(counters), _max_streams(0), _max_connects(0),
+  _shutdown(false), _active_count(0) {
+  curl_multi_setopt(_mhandle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+  _thread = std::thread(&CurlMultiLoop::eventLoop, this);
+}
+
+//------------------------------------------------------------------------------
+// Destructor - stops the event loop thread
+//------------------------------------------------------------------------------
+CurlMultiLoop::~CurlMultiLoop() {
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _shutdown = true;
+  }
+
+  curl_multi_wakeup(_mhandle);
+  _thread.join();
+
+  curl_multi_cleanup(_mhandle);
+}
+
+//------------------------------------------------------------------------------
+// Queue command for the event loop thread, and wake it up
+//------------------------------------------------------------------------------
+void CurlMultiLoop::enqueue(CommandType type, std::shared_ptr<CurlTransfer> transfer) {
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _commands.push_back(Command{type, transfer});
+  }
+
+  curl_multi_wakeup(_mhandle);
+}
+
+//------------------------------------------------------------------------------
+// Hand over a fully configured transfer to the event loop
+//------------------------------------------------------------------------------
+void CurlMultiLoop::submit(std::shared_ptr<CurlTransfer> transfer) {
+  {
+    std::lock_guard<std::mutex> lock(transfer->_mtx);
+    transfer->_detached = false;
+  }
+
+  enqueue(CommandType::kAdd, transfer);
+}
+
+//------------------------------------------------------------------------------
+// Resume a paused transfer
+//------------------------------------------------------------------------------
+void CurlMultiLoop::resume(std::shared_ptr<CurlTransfer> transfer) {
+  enqueue(CommandType::kResume, transfer);
+}
+
+//------------------------------------------------------------------------------
+// Remove transfer from the event loop, wait until it's released
+//------------------------------------------------------------------------------
+void CurlMultiLoop::detach(std::shared_ptr<CurlTransfer> transfer) {
+  if(transfer->isDetached()) {
+    return;
+  }
+
+  enqueue(CommandType::kRemove, transfer);
+  transfer->waitDetached();
+}
+
+//------------------------------------------------------------------------------
+// Number of transfers currently driven by this loop
+//------------------------------------------------------------------------------
+size_t CurlMultiLoop::activeTransfers() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _active_count;
+}
+
+//------------------------------------------------------------------------------
+// Apply a single command - event loop thread only
+//------------------------------------------------------------------------------
+void CurlMultiLoop::apply(const Command &cmd) {
+  CURL *handle = cmd.transfer->getHandle();
+
+  switch(cmd.type) {
+    case CommandType::kAdd: {
+      //------------------------------------------------------------------------
+      // The stream limit is a property of the multi handle, the most recent
+      // request asking for a different one wins
+      //------------------------------------------------------------------------
+      long streams = cmd.transfer->_max_streams;
+      if(streams > 0 && streams != _max_streams) {
+        curl_multi_setopt(_mhandle, CURLMOPT_MAX_CONCURRENT_STREAMS, streams);
+        _max_streams = streams;
+      }
+
+      // so is the size of the connection cache
+      long connects = cmd.transfer->_max_connects;
+      if(connects > 0 && connects != _max_connects) {
+        curl_multi_setopt(_mhandle, CURLMOPT_MAXCONNECTS, connects);
+        _max_connects = connects;
+      }
+
+      CURLMcode rc = curl_multi_add_handle(_mhandle, handle);
+
+      if(rc != CURLM_OK) {
+        DAVIX_SLOG(DAVIX_LOG_WARNING, DAVIX_LOG_HTTP, "curl_multi_add_handle failed: {}", curl_multi_strerror(rc));
+        cmd.transfer->markDone(CURLE_FAILED_INIT);
+        cmd.transfer->markDetached();
+        return;
+      }
+
+      _active[handle] = cmd.transfer;
+      break;
+    }
+    case CommandType::kResume: {
+      if(_active.find(handle) != _active.end()) {
+        curl_easy_pause(handle, CURLPAUSE_CONT);
+      }
+
+      break;
+    }
+    case CommandType::kRemove: {
+      auto it = _active.find(handle);
+      if(it != _active.end()) {
+        curl_multi_remove_handle(_mhandle, handle);
+        _active.erase(it);
+      }
+
+      cmd.transfer->markDetached();
+      break;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Collect completed transfers - event loop thread only
+//------------------------------------------------------------------------------
+void CurlMultiLoop::reapCompleted() {
+  CURLMsg *msg;
+  int msgs_left = 0;
+
+  while((msg = curl_multi_info_read(_mhandle, &msgs_left))) {
+    if(msg->msg != CURLMSG_DONE) {
+      continue;
+    }
+
+    CURL *handle = msg->easy_handle;
+    CURLcode result = msg->data.result;
+
+    auto it = _active.find(handle);
+    if(it == _active.end()) {
+      continue;
+    }
+
+    std::shared_ptr<CurlTransfer> transfer = it->second;
+    _counters.recordTransfer(handle);
+    curl_multi_remove_handle(_mhandle, handle);
+    _active.erase(it);
+
+    transfer->markDone(result);
+    transfer->markDetached();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Event loop thread main
+//------------------------------------------------------------------------------
+void CurlMultiLoop::eventLoop() {
+  while(true) {
+    std::deque<Command> commands;
+
+    {
+      std::lock_guard<std::mutex> lock(_mtx);
+      if(_shutdown) {
+        break;
+      }
+
+      commands.swap(_commands);
+    }
+
+    for(auto it = commands.begin(); it != commands.end(); it++) {
+      apply(*it);
+    }
+
+    int still_running = 0;
+    curl_multi_perform(_mhandle, &still_running);
+    reapCompleted();
+
+    {
+      std::lock_guard<std::mutex> lock(_mtx);
+      _active_count = _active.size();
+    }
+
+    int numfds = 0;
+    curl_multi_poll(_mhandle, NULL, 0, kIdlePollMs, &numfds);
+  }
+
+  //----------------------------------------------------------------------------
+  // Shutting down: release whatever is still attached to us
+  //----------------------------------------------------------------------------
+  std::lock_guard<std::mutex> lock(_mtx);
+  for(auto it = _commands.begin(); it != _commands.end(); it++) {
+    if(it->type == CommandType::kAdd) {
+      it->transfer->markDone(CURLE_ABORTED_BY_CALLBACK);
+    }
+
+    if(it->type != CommandType::kResume) {
+      it->transfer->markDetached();
+    }
+  }
+
+  for(auto it = _active.begin(); it != _active.end(); it++) {
+    curl_multi_remove_handle(_mhandle, it->first);
+    it->second->markDone(CURLE_ABORTED_BY_CALLBACK);
+    it->second->markDetached();
+  }
+
+  _commands.clear();
+  _active.clear();
+  _active_count = 0;
+}
+
+}
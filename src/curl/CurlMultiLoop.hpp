@@ -0,0 +1,232 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#ifndef DAVIX_CURL_MULTI_LOOP_HPP
+#define DAVIX_CURL_MULTI_LOOP_HPP
+
+#include "ResponseBuffer.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+typedef void CURL;
+typedef void CURLM;
+
+namespace Davix {
+
+class CurlConnectionCounters;
+
+//------------------------------------------------------------------------------
+// State of a single transfer driven by a CurlMultiLoop. The event loop thread
+// feeds the response body, the thread owning the request consumes it.
+//------------------------------------------------------------------------------
+class CurlTransfer {
+public:
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  CurlTransfer(CURL *handle, size_t maxBuffered);
+
+  //----------------------------------------------------------------------------
+  // Get underlying easy handle
+  //----------------------------------------------------------------------------
+  CURL* getHandle() const {
+    return _handle;
+  }
+
+  //----------------------------------------------------------------------------
+  // Limit of concurrent HTTP/2 streams per connection this transfer asks
+  // for, 0 if it doesn't care. Must be set before submitting.
+  //----------------------------------------------------------------------------
+  void setMaxConcurrentStreams(long streams) {
+    _max_streams = streams;
+  }
+
+  //----------------------------------------------------------------------------
+  // Size of the connection cache this transfer asks for, 0 if it doesn't
+  // care. Must be set before submitting.
+  //----------------------------------------------------------------------------
+  void setMaxConnects(long connects) {
+    _max_connects = connects;
+  }
+
+  //----------------------------------------------------------------------------
+  // Event loop side: feed response body. Returns false if the buffer is full
+  // and the transfer should be paused - in that case nothing is consumed.
+  //----------------------------------------------------------------------------
+  bool feed(const char *buff, size_t len);
+
+  //----------------------------------------------------------------------------
+  // Event loop side: mark transfer as completed with the given CURLcode
+  //----------------------------------------------------------------------------
+  void markDone(int result);
+
+  //----------------------------------------------------------------------------
+  // Event loop side: the loop holds no more references to the easy handle
+  //----------------------------------------------------------------------------
+  void markDetached();
+
+  //----------------------------------------------------------------------------
+  // Event loop side: remember status code once response headers are complete
+  //----------------------------------------------------------------------------
+  void setStatusCode(long code);
+
+  //----------------------------------------------------------------------------
+  // Consume a maximum of maxlen bytes out of the buffer. Sets needsResume if
+  // the transfer was paused and there's now room for more data.
+  //----------------------------------------------------------------------------
+  size_t consume(char *target, size_t maxlen, bool &needsResume);
+
+  //----------------------------------------------------------------------------
+  // Block until some body data is available, the transfer is done, or the
+  // timeout expires. Returns true if the transfer is done.
+  //----------------------------------------------------------------------------
+  bool waitForData(uint64_t timeoutMs);
+
+  //----------------------------------------------------------------------------
+  // Block until the event loop has released the easy handle
+  //----------------------------------------------------------------------------
+  void waitDetached();
+
+  //----------------------------------------------------------------------------
+  // Accessors
+  //----------------------------------------------------------------------------
+  size_t size() const;
+  bool isDone() const;
+  bool isDetached() const;
+  int getResult() const;
+  long getStatusCode() const;
+
+private:
+  friend class CurlMultiLoop;
+
+  CURL *_handle;
+  size_t _max_buffered;
+  long _max_streams;
+  long _max_connects;
+
+  mutable std::mutex _mtx;
+  std::condition_variable _cv;
+
+  ResponseBuffer _buffer;
+  bool _done;
+  bool _detached;
+  bool _paused;
+  int _result;
+  long _status_code;
+};
+
+//------------------------------------------------------------------------------
+// A curl multi handle shared by many requests, driven by a dedicated event
+// loop thread. Requests on the same loop share curl's connection cache and
+// DNS cache, and no longer need a poll loop of their own. HTTP/2 transfers
+// towards the same endpoint are multiplexed over a single connection.
+//------------------------------------------------------------------------------
+class CurlMultiLoop {
+public:
+  //----------------------------------------------------------------------------
+  // Constructor - starts the event loop thread. Completed transfers are
+  // recorded into the given counters.
+  //----------------------------------------------------------------------------
+  CurlMultiLoop(CurlConnectionCounters &counters);
+
+  //----------------------------------------------------------------------------
+  // Destructor - stops the event loop thread
+  //----------------------------------------------------------------------------
+  ~CurlMultiLoop();
+
+  //----------------------------------------------------------------------------
+  // No copying, no moving
+  //----------------------------------------------------------------------------
+  CurlMultiLoop(const CurlMultiLoop& other) = delete;
+  CurlMultiLoop& operator=(const CurlMultiLoop& other) = delete;
+
+  //----------------------------------------------------------------------------
+  // Hand over a fully configured transfer to the event loop
+  //----------------------------------------------------------------------------
+  void submit(std::shared_ptr<CurlTransfer> transfer);
+
+  //----------------------------------------------------------------------------
+  // Resume a transfer paused because its buffer was full
+  //----------------------------------------------------------------------------
+  void resume(std::shared_ptr<CurlTransfer> transfer);
+
+  //----------------------------------------------------------------------------
+  // Remove transfer from the event loop, blocks until the easy handle is no
+  // longer in use by the loop thread. Safe to call on completed transfers.
+  //----------------------------------------------------------------------------
+  void detach(std::shared_ptr<CurlTransfer> transfer);
+
+  //----------------------------------------------------------------------------
+  // Number of transfers currently driven by this loop
+  //----------------------------------------------------------------------------
+  size_t activeTransfers() const;
+
+private:
+  enum class CommandType { kAdd, kResume, kRemove };
+
+  struct Command {
+    CommandType type;
+    std::shared_ptr<CurlTransfer> transfer;
+  };
+
+  //----------------------------------------------------------------------------
+  // Queue command for the event loop thread, and wake it up
+  //----------------------------------------------------------------------------
+  void enqueue(CommandType type, std::shared_ptr<CurlTransfer> transfer);
+
+  //----------------------------------------------------------------------------
+  // Apply a single command - event loop thread only
+  //----------------------------------------------------------------------------
+  void apply(const Command &cmd);
+
+  //----------------------------------------------------------------------------
+  // Collect completed transfers - event loop thread only
+  //----------------------------------------------------------------------------
+  void reapCompleted();
+
+  //----------------------------------------------------------------------------
+  // Event loop thread main
+  //----------------------------------------------------------------------------
+  void eventLoop();
+
+  CURLM *_mhandle;
+  CurlConnectionCounters &_counters;
+  long _max_streams;
+  long _max_connects;
+
+  mutable std::mutex _mtx;
+  std::deque<Command> _commands;
+  bool _shutdown;
+  size_t _active_count;
+
+  std::map<CURL*, std::shared_ptr<CurlTransfer>> _active;
+  std::thread _thread;
+};
+
+}
+
+#endif
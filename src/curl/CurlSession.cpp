@@ -21,6 +21,7 @@
 
 #include "CurlSession.hpp"
 #include <curl/curl.h>
+#include <davixcontext.hpp>
 #include <params/davixrequestparams.hpp>
 #include <mutex>
 
@@ -51,7 +52,9 @@ CurlHandle::~CurlHandle() {
 // CurlHandle: Constructor
 //------------------------------------------------------------------------------
 CurlHandle::CurlHandle(const std::string &k, CURLM *mh, CURL *h) : key(k), mhandle(mh), handle(h) {
-  curl_multi_add_handle(mhandle, handle);
+  if(mhandle) {
+    curl_multi_add_handle(mhandle, handle);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -63,7 +66,60 @@ void CurlHandle::renewHandle() {
   }
 
   handle = curl_easy_init();
-  curl_multi_add_handle(mhandle, handle);
+
+  if(mhandle) {
+    curl_multi_add_handle(mhandle, handle);
+  }
+}
+
+//------------------------------------------------------------------------------
+// CurlConnectionCounters: Constructor
+//------------------------------------------------------------------------------
+CurlConnectionCounters::CurlConnectionCounters() : _new_connections(0),
+  _reused_connections(0), _http2_streams(0), _multiplexed_streams(0) {}
+
+//------------------------------------------------------------------------------
+// CurlConnectionCounters: record a completed transfer
+//------------------------------------------------------------------------------
+void CurlConnectionCounters::recordTransfer(CURL *handle) {
+  long connects = 0;
+  long httpVersion = 0;
+
+  curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects);
+  curl_easy_getinfo(handle, CURLINFO_HTTP_VERSION, &httpVersion);
+
+  if(connects > 0) {
+    _new_connections++;
+  }
+  else {
+    _reused_connections++;
+  }
+
+  if(httpVersion == CURL_HTTP_VERSION_2_0) {
+    _http2_streams++;
+
+    if(connects == 0) {
+      _multiplexed_streams++;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// ConnectionStats: constructor
+//------------------------------------------------------------------------------
+ConnectionStats::ConnectionStats() : newConnections(0), reusedConnections(0),
+  http2Streams(0), multiplexedStreams(0) {}
+
+//------------------------------------------------------------------------------
+// CurlConnectionCounters: get a snapshot of the counters
+//------------------------------------------------------------------------------
+ConnectionStats CurlConnectionCounters::snapshot() const {
+  ConnectionStats stats;
+  stats.newConnections = _new_connections;
+  stats.reusedConnections = _reused_connections;
+  stats.http2Streams = _http2_streams;
+  stats.multiplexedStreams = _multiplexed_streams;
+  return stats;
 }
 
 //------------------------------------------------------------------------------
@@ -22,6 +22,8 @@
 #ifndef DAVIX_CURL_SESSION_HPP
 #define DAVIX_CURL_SESSION_HPP
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -34,6 +36,7 @@ class CurlSessionFactory;
 class Uri;
 class RequestParams;
 class Status;
+struct ConnectionStats;
 
 //------------------------------------------------------------------------------
 // CurlHandle, internal use only
@@ -51,6 +54,30 @@ struct CurlHandle {
 
 typedef std::shared_ptr<CurlHandle> CurlHandlePtr;
 
+//------------------------------------------------------------------------------
+// Connection usage counters, updated once per completed transfer
+//------------------------------------------------------------------------------
+class CurlConnectionCounters {
+public:
+  CurlConnectionCounters();
+
+  //----------------------------------------------------------------------------
+  // Record a completed transfer - must be called from the thread driving it
+  //----------------------------------------------------------------------------
+  void recordTransfer(CURL *handle);
+
+  //----------------------------------------------------------------------------
+  // Get a snapshot of the counters
+  //----------------------------------------------------------------------------
+  ConnectionStats snapshot() const;
+
+private:
+  std::atomic<uint64_t> _new_connections;
+  std::atomic<uint64_t> _reused_connections;
+  std::atomic<uint64_t> _http2_streams;
+  std::atomic<uint64_t> _multiplexed_streams;
+};
+
 class CurlSession {
 public:
   //----------------------------------------------------------------------------
@@ -21,8 +21,13 @@
 
 #include "CurlSessionFactory.hpp"
 #include "CurlSession.hpp"
+#include "CurlMultiLoop.hpp"
 #include <backend/SessionFactory.hpp>
+#include <davixcontext.hpp>
 #include <utils/davix_env_variables.hpp>
+#include <params/davixrequestparams.hpp>
+
+#include <algorithm>
 
 #include <curl/curl.h>
 
@@ -40,7 +45,8 @@ static bool isSessionCachingDisabled() {
 //------------------------------------------------------------------------------
 // Constructor
 //------------------------------------------------------------------------------
-CurlSessionFactory::CurlSessionFactory() : _session_caching(!isSessionCachingDisabled()) {}
+CurlSessionFactory::CurlSessionFactory() : _session_caching(!isSessionCachingDisabled()),
+  _event_loops_count(EnvUtils::getCurlEventLoopsValue()) {}
 
 //------------------------------------------------------------------------------
 // Destructor
@@ -86,6 +92,65 @@ bool CurlSessionFactory::getSessionCaching() const {
   return _session_caching;
 }
 
+//------------------------------------------------------------------------------
+// Set the number of shared event loops
+//------------------------------------------------------------------------------
+void CurlSessionFactory::setEventLoops(size_t count) {
+  std::lock_guard<std::mutex> lock(_event_loops_mtx);
+
+  if(_event_loops.empty()) {
+    _event_loops_count = count;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get the number of shared event loops
+//------------------------------------------------------------------------------
+size_t CurlSessionFactory::getEventLoops() const {
+  std::lock_guard<std::mutex> lock(_event_loops_mtx);
+  return _event_loops_count;
+}
+
+//------------------------------------------------------------------------------
+// Get the shared event loop responsible for the given session key. Requests
+// towards the same endpoint always land on the same loop, so they share
+// its connection cache.
+//------------------------------------------------------------------------------
+CurlMultiLoop* CurlSessionFactory::getEventLoop(const std::string &sessionKey) {
+  std::lock_guard<std::mutex> lock(_event_loops_mtx);
+
+  if(_event_loops.empty()) {
+    size_t count = std::max<size_t>(_event_loops_count, 1u);
+
+    for(size_t i = 0; i < count; i++) {
+      _event_loops.emplace_back(new CurlMultiLoop(_counters));
+    }
+  }
+
+  return _event_loops[std::hash<std::string>()(sessionKey) % _event_loops.size()].get();
+}
+
+//------------------------------------------------------------------------------
+// Should requests with the given parameters be driven by a shared event loop?
+//------------------------------------------------------------------------------
+bool CurlSessionFactory::usesEventLoop(const RequestParams &params) const {
+  return getEventLoops() != 0 || params.getHttp2Multiplexing();
+}
+
+//------------------------------------------------------------------------------
+// Connection usage counters
+//------------------------------------------------------------------------------
+CurlConnectionCounters& CurlSessionFactory::getConnectionCounters() {
+  return _counters;
+}
+
+//------------------------------------------------------------------------------
+// Get a snapshot of connection usage counters
+//------------------------------------------------------------------------------
+ConnectionStats CurlSessionFactory::getConnectionStats() const {
+  return _counters.snapshot();
+}
+
 //------------------------------------------------------------------------------
 // Retrieve cached handle, if possible
 //------------------------------------------------------------------------------
@@ -107,7 +172,14 @@ CurlHandlePtr CurlSessionFactory::makeNewHandle(const Uri &uri, const RequestPar
   std::string sessionKey = SessionFactory::makeSessionKey(uri);
 
   CURL *handle = curl_easy_init();
-  CURLM *mhandle = curl_multi_init();
+
+  //----------------------------------------------------------------------------
+  // No private multi handle needed when a shared event loop drives requests
+  //----------------------------------------------------------------------------
+  CURLM *mhandle = NULL;
+  if(!usesEventLoop(params)) {
+    mhandle = curl_multi_init();
+  }
 
   return CurlHandlePtr(new CurlHandle(sessionKey, mhandle, handle));
 }
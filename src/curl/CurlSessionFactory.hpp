@@ -23,8 +23,10 @@
 #define DAVIX_CURL_SESSION_FACTORY_HPP
 
 #include "../backend/SessionFactory.hpp"
+#include "CurlSession.hpp"
 #include <status/DavixStatus.hpp>
 #include <core/SessionPool.hpp>
+#include <vector>
 
 namespace Davix {
 
@@ -32,6 +34,7 @@ struct CurlHandle;
 typedef std::shared_ptr<CurlHandle> CurlHandlePtr;
 
 class CurlSession;
+class CurlMultiLoop;
 
 class CurlSessionFactory {
 public:
@@ -60,6 +63,41 @@ public:
     //--------------------------------------------------------------------------
     bool getSessionCaching() const;
 
+    //--------------------------------------------------------------------------
+    // Set the number of shared event loops driving requests of this factory.
+    // 0 means every request drives its own multi handle. Only takes effect
+    // before the first request is issued through the shared loops.
+    //--------------------------------------------------------------------------
+    void setEventLoops(size_t count);
+
+    //--------------------------------------------------------------------------
+    // Get the number of shared event loops
+    //--------------------------------------------------------------------------
+    size_t getEventLoops() const;
+
+    //--------------------------------------------------------------------------
+    // Get the shared event loop responsible for the given session key. The
+    // loops are started on first use.
+    //--------------------------------------------------------------------------
+    CurlMultiLoop* getEventLoop(const std::string &sessionKey);
+
+    //--------------------------------------------------------------------------
+    // Should requests with the given parameters be driven by a shared event
+    // loop? True if loops are enabled, or if HTTP/2 multiplexing is requested,
+    // as multiplexing needs concurrent transfers on the same multi handle.
+    //--------------------------------------------------------------------------
+    bool usesEventLoop(const RequestParams &params) const;
+
+    //--------------------------------------------------------------------------
+    // Connection usage counters
+    //--------------------------------------------------------------------------
+    CurlConnectionCounters& getConnectionCounters();
+
+    //--------------------------------------------------------------------------
+    // Get a snapshot of connection usage counters
+    //--------------------------------------------------------------------------
+    ConnectionStats getConnectionStats() const;
+
 private:
     //--------------------------------------------------------------------------
     // Retrieve cached handle, if possible
@@ -81,6 +119,18 @@ private:
     // Session pool
     //--------------------------------------------------------------------------
     SessionPool<CurlHandlePtr> _session_pool;
+
+    //--------------------------------------------------------------------------
+    // Connection usage counters - must outlive the event loops
+    //--------------------------------------------------------------------------
+    CurlConnectionCounters _counters;
+
+    //--------------------------------------------------------------------------
+    // Shared event loops, sharded by session key - created on first use
+    //--------------------------------------------------------------------------
+    mutable std::mutex _event_loops_mtx;
+    size_t _event_loops_count;
+    std::vector<std::unique_ptr<CurlMultiLoop>> _event_loops;
 };
 
 }
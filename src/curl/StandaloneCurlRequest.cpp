@@ -22,6 +22,7 @@
 #include "StandaloneCurlRequest.hpp"
 #include "CurlSessionFactory.hpp"
 #include "CurlSession.hpp"
+#include "CurlMultiLoop.hpp"
 #include "HeaderlineParser.hpp"
 #include <utils/davix_logger_internal.hpp>
 #include <utils/davix_env_variables.hpp>
@@ -35,6 +36,11 @@
 
 namespace Davix {
 
+//------------------------------------------------------------------------------
+// Keep some data cached inside the response buffer, but not too much
+//------------------------------------------------------------------------------
+static const size_t kMaxBufferedBytes = 33554432;
+
 static std::vector<std::string> split(std::string data, std::string token) {
   std::vector<std::string> output;
   size_t pos = std::string::npos;
@@ -174,6 +180,21 @@ static size_t write_callback(char *ptr, size_t size, size_t nmemb, void *userdat
   return bytes;
 }
 
+//------------------------------------------------------------------------------
+// Write callback, shared event loop flavour - pause the transfer when the
+// consumer falls behind
+//------------------------------------------------------------------------------
+static size_t transfer_write_callback(char *ptr, size_t size, size_t nmemb, void *userdata) {
+  size_t bytes = size * nmemb;
+
+  CurlTransfer* transfer = (CurlTransfer*) userdata;
+  if(!transfer->feed(ptr, bytes)) {
+    return CURL_WRITEFUNC_PAUSE;
+  }
+
+  return bytes;
+}
+
 //------------------------------------------------------------------------------
 // Read callback
 //------------------------------------------------------------------------------
@@ -201,7 +222,7 @@ StandaloneCurlRequest::StandaloneCurlRequest(CurlSessionFactory &sessionFactory,
 : _session_factory(sessionFactory), _reuse_session(reuseSession), _bound_hooks(boundHooks),
   _uri(uri), _verb(verb), _params(params), _headers(headers), _req_flag(reqFlag),
   _content_provider(contentProvider), _deadline(deadline), _state(RequestState::kNotStarted),
-  _chunklist(NULL), _received_headers(false) {
+  _chunklist(NULL), _received_headers(false), _event_loop(NULL) {
   name = "curl";
 }
 
@@ -209,6 +230,7 @@ StandaloneCurlRequest::StandaloneCurlRequest(CurlSessionFactory &sessionFactory,
 // Destructor
 //------------------------------------------------------------------------------
 StandaloneCurlRequest::~StandaloneCurlRequest() {
+    detachTransfer();
     curl_slist_free_all(_chunklist);
 }
 
@@ -346,8 +368,64 @@ Status StandaloneCurlRequest::startRequest() {
   //----------------------------------------------------------------------------
   // Set up callback to consume response body
   //----------------------------------------------------------------------------
-  curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, write_callback);
-  curl_easy_setopt(handle, CURLOPT_WRITEDATA, &_response_buffer);
+  //----------------------------------------------------------------------------
+  // Handles without a private multi handle are driven by a shared event loop
+  //----------------------------------------------------------------------------
+  if(_session->getHandle()->mhandle == NULL) {
+    _event_loop = _session_factory.getEventLoop(_session->getHandle()->key);
+  }
+
+  if(_event_loop) {
+    _transfer.reset(new CurlTransfer(handle, kMaxBufferedBytes));
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, transfer_write_callback);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, _transfer.get());
+  }
+  else {
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &_response_buffer);
+  }
+
+  //----------------------------------------------------------------------------
+  // HTTP/2: wait for an existing connection to the same endpoint rather than
+  // opening a new one, and multiplex over it
+  //----------------------------------------------------------------------------
+  if(_params.getHttp2Multiplexing()) {
+    if(curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS) != CURLE_OK) {
+      DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_HTTP, "HTTP/2 not supported by libcurl {}, using HTTP/1.1", getCurlVersion());
+    }
+
+    curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+
+    if(_transfer) {
+      _transfer->setMaxConcurrentStreams(_params.getMaxConcurrentStreams());
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Bound the idle connections kept for reuse. libcurl has no per-host limit:
+  // the closest is the size of the connection cache, which belongs to the
+  // multi handle
+  //----------------------------------------------------------------------------
+  const long maxIdle = _params.getMaxIdleConnections();
+  if(maxIdle > 0) {
+    if(_transfer) {
+      _transfer->setMaxConnects(maxIdle);
+    }
+    else {
+      curl_multi_setopt(_session->getHandle()->mhandle, CURLMOPT_MAXCONNECTS, maxIdle);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Don't reuse cached connections which sat idle for too long, the server
+  // has most likely closed them already
+  //----------------------------------------------------------------------------
+#if LIBCURL_VERSION_NUM >= 0x074100
+  const struct timespec* idleTimeout = _params.getIdleConnectionTimeout();
+  if(idleTimeout->tv_sec > 0) {
+    curl_easy_setopt(handle, CURLOPT_MAXAGE_CONN, (long) idleTimeout->tv_sec);
+  }
+#endif
 
   //----------------------------------------------------------------------------
   // Set up callback to provide request body
@@ -444,6 +522,10 @@ Status StandaloneCurlRequest::startRequest() {
   //----------------------------------------------------------------------------
   _state = RequestState::kStarted;
 
+  if(_event_loop) {
+    _event_loop->submit(_transfer);
+  }
+
   while(true) {
     int still_running = 1;
     Status st = performBlockingRound(still_running);
@@ -457,7 +539,7 @@ Status StandaloneCurlRequest::startRequest() {
       return checkErrors();
     }
 
-    if(_response_buffer.size() != 0u) {
+    if(bufferedBytes() != 0u) {
       //------------------------------------------------------------------------
       // We've dealt with the headers already, startRequest() is done. Switch
       // to readBlock() mode.
@@ -472,9 +554,22 @@ Status StandaloneCurlRequest::startRequest() {
 // Check internal mhandle errors
 //------------------------------------------------------------------------------
 Status StandaloneCurlRequest::checkErrors() {
+  if(_transfer) {
+    if(_transfer->isDone() && _transfer->getResult() != CURLE_OK) {
+      sessionError = curlCodeToStatus((CURLcode) _transfer->getResult());
+      return sessionError;
+    }
+
+    return Status();
+  }
+
   CURLMsg *msg;
   int msgs_left = 0;
   while((msg = curl_multi_info_read(_session->getHandle()->mhandle, &msgs_left))) {
+    if(msg->msg == CURLMSG_DONE) {
+      _session_factory.getConnectionCounters().recordTransfer(msg->easy_handle);
+    }
+
     if(msg->msg == CURLMSG_DONE && msg->data.result != CURLE_OK) {
       sessionError = curlCodeToStatus(msg->data.result);
       return sessionError;
@@ -510,6 +605,10 @@ Status StandaloneCurlRequest::performBlockingRound(int &still_running) {
     return Status(davix_scope_http_request(), StatusCode::InvalidArgument, "Request not active");
   }
 
+  if(_transfer) {
+    return waitEventLoopRound(still_running);
+  }
+
   while(true) {
     Status st = checkTimeout();
     if(!st.ok()) {
@@ -552,6 +651,52 @@ Status StandaloneCurlRequest::performBlockingRound(int &still_running) {
   }
 }
 
+//------------------------------------------------------------------------------
+// Wait for the shared event loop to make progress on our transfer. Unlike
+// performBlockingRound, data which arrived in the meantime counts as progress.
+//------------------------------------------------------------------------------
+Status StandaloneCurlRequest::waitEventLoopRound(int &still_running) {
+  still_running = 1;
+
+  while(true) {
+    Status st = checkTimeout();
+    if(!st.ok()) {
+      return st;
+    }
+
+    bool done = _transfer->waitForData(getRemainingMs());
+
+    if(done) {
+      still_running = 0;
+      return checkErrors();
+    }
+
+    if(_transfer->size() != 0u) {
+      return Status();
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Number of response body bytes buffered so far
+//------------------------------------------------------------------------------
+size_t StandaloneCurlRequest::bufferedBytes() const {
+  if(_transfer) {
+    return _transfer->size();
+  }
+
+  return _response_buffer.size();
+}
+
+//------------------------------------------------------------------------------
+// Release transfer from the shared event loop, if any
+//------------------------------------------------------------------------------
+void StandaloneCurlRequest::detachTransfer() {
+  if(_event_loop && _transfer) {
+    _event_loop->detach(_transfer);
+  }
+}
+
 //------------------------------------------------------------------------------
 // Major read function - read a block of max_size bytes (at max) into buffer.
 //------------------------------------------------------------------------------
@@ -570,10 +715,24 @@ dav_ssize_t StandaloneCurlRequest::readBlock(char* buffer, dav_size_t max_size,
     return -1;
   }
 
+  if(_transfer) {
+    int still_running = 0;
+    st = waitEventLoopRound(still_running);
+
+    bool needsResume = false;
+    dav_ssize_t bytes = _transfer->consume(buffer, max_size, needsResume);
+
+    if(needsResume) {
+      _event_loop->resume(_transfer);
+    }
+
+    return bytes;
+  }
+
   //----------------------------------------------------------------------------
   // Keep some data cached inside the response buffer, but not too much
   //----------------------------------------------------------------------------
-  if(_response_buffer.size() <= 33554432) {
+  if(_response_buffer.size() <= kMaxBufferedBytes) {
     int still_running = 0;
     st = performBlockingRound(still_running);
   }
@@ -585,6 +744,7 @@ dav_ssize_t StandaloneCurlRequest::readBlock(char* buffer, dav_size_t max_size,
 // Finish an already started request.
 //------------------------------------------------------------------------------
 Status StandaloneCurlRequest::endRequest() {
+  detachTransfer();
   _state = RequestState::kFinished;
   return Status();
 }
@@ -615,6 +775,13 @@ Status StandaloneCurlRequest::checkTimeout() {
 int StandaloneCurlRequest::getStatusCode() const {
   long response_code = 0;
 
+  if(_transfer && !_transfer->isDetached()) {
+    //--------------------------------------------------------------------------
+    // The event loop thread owns the handle, use the status code it recorded
+    //--------------------------------------------------------------------------
+    return _transfer->getStatusCode();
+  }
+
   if(_session) {
     CURL* handle = _session->getHandle()->handle;
     curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response_code);
@@ -685,6 +852,13 @@ Status StandaloneCurlRequest::readResponseHeaders() {
 void StandaloneCurlRequest::feedResponseHeader(const std::string &header) {
   if(header == "\r\n") {
     _received_headers = true;
+
+    if(_transfer) {
+      long response_code = 0;
+      curl_easy_getinfo(_transfer->getHandle(), CURLINFO_RESPONSE_CODE, &response_code);
+      _transfer->setStatusCode(response_code);
+    }
+
     return;
   }
 
@@ -35,6 +35,8 @@ namespace Davix {
 class CurlSessionFactory;
 class ContentProvider;
 class CurlSession;
+class CurlMultiLoop;
+class CurlTransfer;
 
 //------------------------------------------------------------------------------
 // Implementation of StandaloneRequest interface based on libcurl.
@@ -167,6 +169,13 @@ private:
 
   ResponseBuffer _response_buffer;
 
+  //----------------------------------------------------------------------------
+  // Set when the request is driven by a shared event loop, in which case the
+  // response body is delivered through _transfer instead of _response_buffer
+  //----------------------------------------------------------------------------
+  CurlMultiLoop *_event_loop;
+  std::shared_ptr<CurlTransfer> _transfer;
+
   //----------------------------------------------------------------------------
   // Block until all response headers have been received
   //----------------------------------------------------------------------------
@@ -177,6 +186,21 @@ private:
   //----------------------------------------------------------------------------
   Status performBlockingRound(int &still_running);
 
+  //----------------------------------------------------------------------------
+  // Wait for the shared event loop to make progress on our transfer
+  //----------------------------------------------------------------------------
+  Status waitEventLoopRound(int &still_running);
+
+  //----------------------------------------------------------------------------
+  // Number of response body bytes buffered so far
+  //----------------------------------------------------------------------------
+  size_t bufferedBytes() const;
+
+  //----------------------------------------------------------------------------
+  // Release transfer from the shared event loop, if any
+  //----------------------------------------------------------------------------
+  void detachTransfer();
+
 };
 
 //------------------------------------------------------------------------------
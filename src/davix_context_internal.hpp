@@ -35,12 +35,30 @@ namespace Davix {
 
 class RedirectionResolver;
 class SessionFactory;
+class WorkerPool;
+class EndpointStats;
+class MultirangeCapabilityCache;
+class BufferPool;
+class BlockCache;
+class HostLimiter;
+class ReplicaCache;
+class Hedger;
+class RetryBudget;
 
 
 struct ContextExplorer{
 
 static SessionFactory & SessionFactoryFromContext(Context & c);
 static RedirectionResolver & RedirectionResolverFromContext(Context &c);
+static WorkerPool & WorkerPoolFromContext(Context &c);
+static EndpointStats & EndpointStatsFromContext(Context &c);
+static MultirangeCapabilityCache & MultirangeCapabilitiesFromContext(Context &c);
+static BufferPool & BufferPoolFromContext(Context &c);
+static BlockCache & BlockCacheFromContext(Context &c);
+static HostLimiter & HostLimiterFromContext(Context &c);
+static ReplicaCache & ReplicaCacheFromContext(Context &c);
+static Hedger & HedgerFromContext(Context &c);
+static RetryBudget & RetryBudgetFromContext(Context &c);
 
 };
 
@@ -29,6 +29,16 @@
 #include <backend/SessionFactory.hpp>
 #include <davix_context_internal.hpp>
 #include <core/RedirectionResolver.hpp>
+#include <core/WorkerPool.hpp>
+#include <core/EndpointStats.hpp>
+#include <core/MultirangeCapabilities.hpp>
+#include <core/BlockCache.hpp>
+#include <core/BufferPool.hpp>
+#include <core/Hedger.hpp>
+#include <core/HostLimiter.hpp>
+#include <core/ReplicaCache.hpp>
+#include <core/RetryPolicy.hpp>
+#include <curl/CurlSessionFactory.hpp>
 
 #include <curl/curl.h>
 
@@ -53,7 +63,17 @@ struct ContextInternal
     ContextInternal():
         _fsess(new SessionFactory()),
         _redirectionResolver(new RedirectionResolver(!redirCachingDisabled())),
-        _hook_list()
+        _endpointStats(new EndpointStats()),
+        _multirangeCaps(new MultirangeCapabilityCache()),
+        _bufferPool(new BufferPool()),
+        _blockCache(new BlockCache()),
+        _hostLimiter(new HostLimiter()),
+        _replicaCache(new ReplicaCache()),
+        _hedger(new Hedger()),
+        _retryBudget(new RetryBudget()),
+        _hook_list(),
+        _reapInterval(0),
+        _workerPool(new WorkerPool())
     {
             DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CORE, "libdavix path {}, version: {}", getLibPath(), version());
     }
@@ -61,8 +81,19 @@ struct ContextInternal
     ContextInternal(const ContextInternal & orig) :
         _fsess(new SessionFactory()),
         _redirectionResolver(new RedirectionResolver(!redirCachingDisabled())),
-        _hook_list(orig._hook_list)
+        _endpointStats(new EndpointStats()),
+        _multirangeCaps(new MultirangeCapabilityCache()),
+        _bufferPool(new BufferPool(orig._bufferPool->getLimit())),
+        _blockCache(new BlockCache(orig._blockCache->getLimit())),
+        _hostLimiter(new HostLimiter()),
+        _replicaCache(new ReplicaCache(orig._replicaCache->getMaxEntries(), orig._replicaCache->getTtl(), orig._replicaCache->getCooldown())),
+        _hedger(new Hedger()),
+        _retryBudget(new RetryBudget(orig._retryBudget->getBurst(), orig._retryBudget->getRate(), orig._retryBudget->getThreshold(), orig._retryBudget->getCooldown())),
+        _hook_list(orig._hook_list),
+        _reapInterval(0),
+        _workerPool(new WorkerPool())
     {
+        setReapInterval(orig._reapInterval);
     }
 
     virtual ~ContextInternal(){}
@@ -76,9 +107,65 @@ struct ContextInternal
         return _redirectionResolver.get();
     }
 
+    inline WorkerPool* getWorkerPool() {
+        return _workerPool.get();
+    }
+
+    inline EndpointStats* getEndpointStats() {
+        return _endpointStats.get();
+    }
+
+    inline MultirangeCapabilityCache* getMultirangeCapabilities() {
+        return _multirangeCaps.get();
+    }
+
+    inline BufferPool* getBufferPool() {
+        return _bufferPool.get();
+    }
+
+    inline BlockCache* getBlockCache() {
+        return _blockCache.get();
+    }
+
+    inline HostLimiter* getHostLimiter() {
+        return _hostLimiter.get();
+    }
+
+    inline ReplicaCache* getReplicaCache() {
+        return _replicaCache.get();
+    }
+
+    inline Hedger* getHedger() {
+        return _hedger.get();
+    }
+
+    inline RetryBudget* getRetryBudget() {
+        return _retryBudget.get();
+    }
+
+    void setReapInterval(unsigned int interval) {
+        _reapInterval = interval;
+        _fsess->setReapInterval(std::chrono::seconds(interval));
+    }
+
     std::unique_ptr<SessionFactory>  _fsess;
     std::unique_ptr<RedirectionResolver> _redirectionResolver;
+    std::unique_ptr<EndpointStats> _endpointStats;
+    std::unique_ptr<MultirangeCapabilityCache> _multirangeCaps;
+    std::unique_ptr<BufferPool> _bufferPool;
+    std::unique_ptr<BlockCache> _blockCache;
+    std::unique_ptr<HostLimiter> _hostLimiter;
+    std::unique_ptr<ReplicaCache> _replicaCache;
+    std::unique_ptr<Hedger> _hedger;
+    std::unique_ptr<RetryBudget> _retryBudget;
     HookList _hook_list;
+
+    // idle connection reaping interval in seconds, survives clearCache
+    unsigned int _reapInterval;
+
+    // declared last, so that it's destroyed first: pending asynchronous
+    // operations are drained while everything they use is still around
+    std::unique_ptr<WorkerPool> _workerPool;
 };
 
 ///////////////////////////////////////////////////////////////
@@ -121,8 +208,106 @@ bool Context::getSessionCaching() const{
     return _intern->_fsess->getSessionCaching();
 }
 
+void Context::setIdleConnectionReaping(unsigned int interval) {
+  _intern->setReapInterval(interval);
+}
+
+unsigned int Context::getIdleConnectionReaping() const {
+  return _intern->_reapInterval;
+}
+
+void Context::setUploadBufferLimit(dav_size_t limit) {
+  _intern->_bufferPool->setLimit(limit);
+}
+
+dav_size_t Context::getUploadBufferLimit() const {
+  return _intern->_bufferPool->getLimit();
+}
+
+ConnectionStats Context::getConnectionStats() const {
+  return _intern->_fsess->getCurl().getConnectionStats();
+}
+
+BufferPoolStats Context::getUploadBufferStats() const {
+  return _intern->_bufferPool->getStats();
+}
+
+void Context::setBlockCacheLimit(dav_size_t limit) {
+  _intern->_blockCache->setLimit(limit);
+}
+
+dav_size_t Context::getBlockCacheLimit() const {
+  return _intern->_blockCache->getLimit();
+}
+
+BlockCacheStats Context::getBlockCacheStats() const {
+  return _intern->_blockCache->getStats();
+}
+
+void Context::setReplicaCacheTtl(unsigned int ttl) {
+  _intern->_replicaCache->setTtl(std::chrono::seconds(ttl));
+}
+
+unsigned int Context::getReplicaCacheTtl() const {
+  return std::chrono::duration_cast<std::chrono::seconds>(_intern->_replicaCache->getTtl()).count();
+}
+
+void Context::setReplicaCacheMaxEntries(size_t maxEntries) {
+  _intern->_replicaCache->setMaxEntries(maxEntries);
+}
+
+size_t Context::getReplicaCacheMaxEntries() const {
+  return _intern->_replicaCache->getMaxEntries();
+}
+
+void Context::setReplicaCooldown(unsigned int cooldown) {
+  _intern->_replicaCache->setCooldown(std::chrono::seconds(cooldown));
+}
+
+unsigned int Context::getReplicaCooldown() const {
+  return std::chrono::duration_cast<std::chrono::seconds>(_intern->_replicaCache->getCooldown()).count();
+}
+
+HedgingStats Context::getHedgingStats() const {
+  return _intern->_hedger->getStats();
+}
+
+void Context::setRetryBudget(double burst, double rate) {
+  _intern->_retryBudget->setBudget(burst, rate);
+}
+
+double Context::getRetryBudgetBurst() const {
+  return _intern->_retryBudget->getBurst();
+}
+
+double Context::getRetryBudgetRate() const {
+  return _intern->_retryBudget->getRate();
+}
+
+void Context::setCircuitBreaker(unsigned int threshold, unsigned int cooldown) {
+  _intern->_retryBudget->setCircuitBreaker(threshold, std::chrono::milliseconds(cooldown));
+}
+
+unsigned int Context::getCircuitBreakerThreshold() const {
+  return _intern->_retryBudget->getThreshold();
+}
+
+unsigned int Context::getCircuitBreakerCooldown() const {
+  return _intern->_retryBudget->getCooldown().count();
+}
+
+RetryStats Context::getRetryStats() const {
+  return _intern->_retryBudget->getStats();
+}
+
 void Context::clearCache() {
   _intern->_fsess.reset(new SessionFactory());
+  _intern->setReapInterval(_intern->_reapInterval);
+  _intern->_multirangeCaps->clear();
+  _intern->_blockCache->clear();
+  _intern->_replicaCache->clear();
+  _intern->_hedger->clear();
+  _intern->_retryBudget->clear();
 }
 
 HttpRequest* Context::createRequest(const std::string & url, DavixError** err){
@@ -155,6 +340,42 @@ RedirectionResolver & ContextExplorer::RedirectionResolverFromContext(Context &c
     return *c._intern->getRedirectionResolver();
 }
 
+WorkerPool & ContextExplorer::WorkerPoolFromContext(Context &c) {
+    return *c._intern->getWorkerPool();
+}
+
+EndpointStats & ContextExplorer::EndpointStatsFromContext(Context &c) {
+    return *c._intern->getEndpointStats();
+}
+
+MultirangeCapabilityCache & ContextExplorer::MultirangeCapabilitiesFromContext(Context &c) {
+    return *c._intern->getMultirangeCapabilities();
+}
+
+BufferPool & ContextExplorer::BufferPoolFromContext(Context &c) {
+    return *c._intern->getBufferPool();
+}
+
+BlockCache & ContextExplorer::BlockCacheFromContext(Context &c) {
+    return *c._intern->getBlockCache();
+}
+
+HostLimiter & ContextExplorer::HostLimiterFromContext(Context &c) {
+    return *c._intern->getHostLimiter();
+}
+
+ReplicaCache & ContextExplorer::ReplicaCacheFromContext(Context &c) {
+    return *c._intern->getReplicaCache();
+}
+
+Hedger & ContextExplorer::HedgerFromContext(Context &c) {
+    return *c._intern->getHedger();
+}
+
+RetryBudget & ContextExplorer::RetryBudgetFromContext(Context &c) {
+    return *c._intern->getRetryBudget();
+}
+
 LibPath::LibPath(){
     Dl_info shared_lib_infos;
 
@@ -22,7 +22,15 @@
 #include <davix_internal.hpp>
 #include <core/ContentProvider.hpp>
 #include <file/davfile.hpp>
+#include <davix_context_internal.hpp>
+#include <backend/SessionFactory.hpp>
+#include <core/HostLimiter.hpp>
+#include <core/WorkerPool.hpp>
 #include <fileops/chain_factory.hpp>
+#include <fileops/AsyncIO.hpp>
+#include <fileops/davmeta.hpp>
+#include <fileops/RecursiveWalker.hpp>
+#include <neon/neonrequest.hpp>
 
 namespace Davix{
 
@@ -51,6 +59,8 @@ struct DavFile::DavFileInternal{
 
     DavFile::Iterator createIterator(const RequestParams * params);
 
+    DavFile::BatchIterator createBatchIterator(const RequestParams * params);
+
 
     static void check_iterator(DavFile::Iterator::Internal* ptr){
         if(ptr == NULL)
@@ -102,6 +112,42 @@ const StatInfo & DavFile::Iterator::info(){
 }
 
 
+struct DavFile::BatchIterator::Internal{
+
+    Internal(DavFile::DavFileInternal & f, const RequestParams* p) :
+        io_chain(),
+        io_context(f.getIOContext(p)),
+        end(false)
+    {
+        f.getIOChain(io_chain);
+    }
+
+    HttpIOChain io_chain;
+    IOChainContext io_context;
+    bool end;
+};
+
+
+DavFile::BatchIterator DavFile::DavFileInternal::createBatchIterator(const RequestParams * params){
+    DavFile::BatchIterator it;
+    it.d_ptr.reset(new DavFile::BatchIterator::Internal(*this, params));
+    return it;
+}
+
+
+bool DavFile::BatchIterator::next(ListingBatch & batch, size_t count){
+    if(d_ptr.get() == NULL)
+        throw DavixException(davix_scope_directory_listing_str(), StatusCode::InvalidArgument, "Usage of an invalid BatchIterator");
+
+    batch.clear();
+    if(d_ptr->end)
+        return false;
+
+    d_ptr->end = !d_ptr->io_chain.nextSubItems(d_ptr->io_context, batch, std::max<size_t>(count, 1));
+    return !d_ptr->end;
+}
+
+
 DavFile::DavFile(Context &c, const Uri &u) :
     d_ptr(new DavFileInternal(c,u))
 {
@@ -169,6 +215,36 @@ dav_ssize_t DavFile::readPartial(const RequestParams *params, void* buff, dav_si
     return -1;
 }
 
+std::future<dav_ssize_t> DavFile::readPartialBufferVecAsync(const RequestParams *params, const DavIOVecInput * input_vec,
+                      DavIOVecOuput * output_vec,
+                      const dav_size_t count_vec){
+    std::future<dav_ssize_t> future;
+    readPartialBufferVecAsync(params, input_vec, output_vec, count_vec, futureCallback(future));
+    return future;
+}
+
+void DavFile::readPartialBufferVecAsync(const RequestParams *params, const DavIOVecInput * input_vec,
+                      DavIOVecOuput * output_vec,
+                      const dav_size_t count_vec, const IOCallback & callback){
+    submitIO(d_ptr->_c, d_ptr->_u, (params)?(*params):(d_ptr->_params),
+        [input_vec, output_vec, count_vec](HttpIOChain & chain, IOChainContext & io_context) {
+            return chain.preadVec(io_context, input_vec, output_vec, count_vec);
+        }, callback);
+}
+
+std::future<dav_ssize_t> DavFile::readPartialAsync(const RequestParams *params, void* buff, dav_size_t count, dav_off_t offset){
+    std::future<dav_ssize_t> future;
+    readPartialAsync(params, buff, count, offset, futureCallback(future));
+    return future;
+}
+
+void DavFile::readPartialAsync(const RequestParams *params, void* buff, dav_size_t count, dav_off_t offset, const IOCallback & callback){
+    submitIO(d_ptr->_c, d_ptr->_u, (params)?(*params):(d_ptr->_params),
+        [buff, count, offset](HttpIOChain & chain, IOChainContext & io_context) {
+            return chain.pread(io_context, buff, count, offset);
+        }, callback);
+}
+
 int DavFile::deletion(const RequestParams *params, DavixError **err) throw(){
     TRY_DAVIX{
         deletion(params);
@@ -313,6 +389,58 @@ DavFile::Iterator DavFile::listCollection(const RequestParams *params){
     return d_ptr->createIterator(params);
 }
 
+DavFile::BatchIterator DavFile::listCollectionBatches(const RequestParams *params){
+    return d_ptr->createBatchIterator(params);
+}
+
+void DavFile::walk(const RequestParams *params, const WalkCallback &callback){
+    RequestParams p((params)?(*params):(d_ptr->_params));
+    configureRequestParamsProto(d_ptr->_u, p);
+
+    Context & context = d_ptr->_c;
+    const Uri root = d_ptr->_u;
+    std::vector<std::string> roots;
+
+    if(p.getWalkDepthInfinity()
+        && (p.getProtocol() == RequestProtocol::Webdav || p.getProtocol() == RequestProtocol::Auto)){
+        std::vector<std::string> unexplored;
+        if(webdav_walk_depth_infinity(context, p, root, callback, unexplored)){
+            if(unexplored.empty()){
+                return;
+            }
+            roots.swap(unexplored);
+        }
+    }
+
+    if(roots.empty()){
+        roots.push_back("");
+    }
+
+    const std::string host = SessionFactory::makeSessionKey(root);
+    const size_t limit = p.getWalkHostLimit();
+
+    // listings may need the worker pool for themselves, S3 prefetching for
+    // one: leave them room
+    const size_t parallelism = std::min<size_t>(p.getWalkParallelism(),
+        ContextExplorer::WorkerPoolFromContext(context).getMaxWorkers() / 2);
+
+    RecursiveWalker walker(context, [&context, &p, &root, &host, limit](const std::string & path, std::deque<FileProperties> & entries){
+        const Uri uri = (path.empty()) ? root : Uri(Uri::join(root.getString(), path) + "/");
+        HostSlot slot = ContextExplorer::HostLimiterFromContext(context).acquire(host, limit);
+
+        HttpIOChain chain;
+        IOChainContext io_context(context, uri, &p);
+        ChainFactory::instanceChain(CreationFlags(), chain);
+
+        FileProperties entry;
+        while(chain.nextSubItem(io_context, entry.filename, entry.info)){
+            entries.push_back(entry);
+        }
+    }, parallelism);
+
+    walker.walk(roots, callback);
+}
+
 int DavFile::checksum(const RequestParams *params, std::string & checksm, const std::string & chk_algo, DavixError **err) throw(){
     TRY_DAVIX{
         HttpIOChain chain;
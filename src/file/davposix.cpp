@@ -25,6 +25,7 @@
 #include <core/ContentProvider.hpp>
 #include <status/davixstatusrequest.hpp>
 #include <fileops/chain_factory.hpp>
+#include <fileops/AsyncIO.hpp>
 #include <xml/davpropxmlparser.hpp>
 #include <utils/davix_env_variables.hpp>
 #include <utils/stringutils.hpp>
@@ -413,6 +414,24 @@ struct dirent* DavPosix::readdirpp(DAVIX_DIR * d, struct stat *st, DavixError**
 }
 
 
+int DavPosix::walk(const RequestParams* params, const std::string &url, const WalkCallback &callback, DavixError** err){
+    DAVIX_SCOPE_TRACE(DAVIX_LOG_POSIX, walk);
+
+    int ret = -1;
+    TRY_DAVIX{
+        DavFile file(*context, Uri(url));
+        file.walk(params, [&callback](const std::string & path, const StatInfo & info){
+            struct stat st;
+            StatInfo(info).toPosixStat(st);
+            callback(path, st);
+        });
+        ret = 0;
+    }CATCH_DAVIX(err)
+
+    return ret;
+}
+
+
 int DavPosix::closedirpp(DAVIX_DIR * d, DavixError** err){
     int ret =-1;
 
@@ -710,6 +729,55 @@ dav_ssize_t DavPosix::preadVec(DAVIX_FD* fd, const DavIOVecInput * input_vec,
     return ret;
 }
 
+std::future<dav_ssize_t> DavPosix::preadAsync(DAVIX_FD* fd, void* buf, dav_size_t count, dav_off_t offset){
+    std::future<dav_ssize_t> future;
+    preadAsync(fd, buf, count, offset, futureCallback(future));
+    return future;
+}
+
+void DavPosix::preadAsync(DAVIX_FD* fd, void* buf, dav_size_t count, dav_off_t offset, const IOCallback & callback){
+    DAVIX_SCOPE_TRACE(DAVIX_LOG_POSIX, fun_pread);
+    DavixError* tmp_err=NULL;
+
+    if( davix_check_rw_fd(fd, &tmp_err) !=0){
+        callback(-1, tmp_err);
+        DavixError::clearError(&tmp_err);
+        return;
+    }
+
+    // a chain of its own, the buffering state of the fd isn't thread-safe
+    submitIO(*context, fd->_uri, fd->_params,
+        [buf, count, offset](HttpIOChain & chain, IOChainContext & io_context) {
+            return chain.pread(io_context, buf, count, offset);
+        }, callback);
+}
+
+std::future<dav_ssize_t> DavPosix::preadVecAsync(DAVIX_FD* fd, const DavIOVecInput * input_vec,
+                      DavIOVecOuput * output_vec,
+                      dav_size_t count_vec){
+    std::future<dav_ssize_t> future;
+    preadVecAsync(fd, input_vec, output_vec, count_vec, futureCallback(future));
+    return future;
+}
+
+void DavPosix::preadVecAsync(DAVIX_FD* fd, const DavIOVecInput * input_vec,
+                      DavIOVecOuput * output_vec,
+                      dav_size_t count_vec, const IOCallback & callback){
+    DAVIX_SCOPE_TRACE(DAVIX_LOG_POSIX, fun_preadvec);
+    DavixError* tmp_err=NULL;
+
+    if( davix_check_rw_fd(fd, &tmp_err) !=0){
+        callback(-1, tmp_err);
+        DavixError::clearError(&tmp_err);
+        return;
+    }
+
+    submitIO(*context, fd->_uri, fd->_params,
+        [input_vec, output_vec, count_vec](HttpIOChain & chain, IOChainContext & io_context) {
+            return chain.preadVec(io_context, input_vec, output_vec, count_vec);
+        }, callback);
+}
+
 ssize_t DavPosix::write(DAVIX_FD* fd, const void* buf, size_t count, Davix::DavixError** err){
 
 // By default, POSIX writes create an intermediate file that is uploaded when
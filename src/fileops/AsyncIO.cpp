@@ -0,0 +1,74 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include <davix_internal.hpp>
+#include "AsyncIO.hpp"
+#include <davix_context_internal.hpp>
+#include <core/WorkerPool.hpp>
+#include <fileops/chain_factory.hpp>
+
+#include <memory>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Run an operation on the Context worker pool, report through a callback
+//------------------------------------------------------------------------------
+void submitIO(Context & context, const Uri & uri, const RequestParams & params,
+              const IOOperation & op, const IOCallback & callback) {
+
+  ContextExplorer::WorkerPoolFromContext(context).submit([&context, uri, params, op, callback]() {
+    dav_ssize_t ret = -1;
+    DavixError* tmp_err = NULL;
+
+    TRY_DAVIX{
+      HttpIOChain chain;
+      IOChainContext io_context(context, uri, &params);
+      ret = op(ChainFactory::instanceChain(CreationFlags(), chain), io_context);
+    }CATCH_DAVIX(&tmp_err)
+
+    if(tmp_err) {
+      ret = -1;
+    }
+
+    callback(ret, tmp_err);
+    DavixError::clearError(&tmp_err);
+  });
+}
+
+//------------------------------------------------------------------------------
+// Callback fulfilling a future
+//------------------------------------------------------------------------------
+IOCallback futureCallback(std::future<dav_ssize_t> & future) {
+  std::shared_ptr<std::promise<dav_ssize_t>> promise = std::make_shared<std::promise<dav_ssize_t>>();
+  future = promise->get_future();
+
+  return [promise](dav_ssize_t ret, DavixError* err) {
+    if(err) {
+      promise->set_exception(std::make_exception_ptr(
+        DavixException(err->getErrScope(), err->getStatus(), err->getErrMsg())));
+    }
+    else {
+      promise->set_value(ret);
+    }
+  };
+}
+
+}
@@ -0,0 +1,51 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#ifndef DAVIX_FILEOPS_ASYNC_IO_HPP
+#define DAVIX_FILEOPS_ASYNC_IO_HPP
+
+#include <functional>
+#include <future>
+#include <fileops/httpiochain.hpp>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// A single I/O operation, run against a freshly instantiated chain
+//------------------------------------------------------------------------------
+typedef std::function<dav_ssize_t (HttpIOChain & chain, IOChainContext & io_context)> IOOperation;
+
+//------------------------------------------------------------------------------
+// Callback that fulfills "future" - with the result, or a DavixException
+//------------------------------------------------------------------------------
+IOCallback futureCallback(std::future<dav_ssize_t> & future);
+
+//------------------------------------------------------------------------------
+// Run "op" on the worker pool of the given Context, against private copies of
+// the uri and request parameters, and report the result through "callback".
+// The Context must outlive the operation - its destructor waits for every
+// queued operation to complete.
+//------------------------------------------------------------------------------
+void submitIO(Context & context, const Uri & uri, const RequestParams & params,
+              const IOOperation & op, const IOCallback & callback);
+
+}
+
+#endif
@@ -22,6 +22,9 @@
 #include "AzureIO.hpp"
 #include <utils/davix_logger_internal.hpp>
 #include <core/ContentProvider.hpp>
+#include <fileops/PartUploader.hpp>
+#include <fileops/UploadManifest.hpp>
+#include <xml/azureblocklistparser.hpp>
 
 #include <iomanip>
 #include <uuid/uuid.h>
@@ -51,8 +54,17 @@ static bool is_azure_operation(IOChainContext & context){
   return false;
 }
 
-static std::string stringifyBlockID(const std::string &prefix, size_t blockid) {
+// a block blob can't be made of more blocks than this
+static const size_t AZURE_MAX_BLOCKS = 50000;
+
+// block ids of resumable uploads end with the block digest, so that what the
+// server holds can be checked against the manifest - ids of a blob all have
+// the same length either way
+static std::string stringifyBlockID(const std::string &prefix, size_t blockid, const std::string &digest) {
   std::string strblockid = SSTR(prefix << "+" << std::setfill('0') << std::setw(10) << blockid); // TODO ensure fixed size
+  if(!digest.empty()) {
+    strblockid += "+" + digest;
+  }
   return Base64::base64_encode( (unsigned char*) strblockid.c_str(), strblockid.size());
 }
 
@@ -108,6 +120,47 @@ void AzureIO::commitChunks(IOChainContext & iocontext, const std::vector<std::st
   checkDavixError(&tmp_err);
 }
 
+bool AzureIO::resumeBlocks(IOChainContext & iocontext, UploadManifest &manifest) {
+  DavixError * tmp_err=NULL;
+  Uri url(iocontext._uri);
+  url.addQueryParam("comp", "blocklist");
+  url.addQueryParam("blocklisttype", "uncommitted");
+  url.addFragmentParam("azuremechanism", "true");
+
+  GetRequest req(iocontext._context, url, &tmp_err);
+  checkDavixError(&tmp_err);
+
+  req.setParameters(iocontext._reqparams);
+  req.executeRequest(&tmp_err);
+  if(!tmp_err && req.getRequestCode() == 404) {
+    // uncommitted blocks are garbage collected after a week
+    DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Azure write: no uncommitted blocks left for {}, starting over", iocontext._uri);
+    return false;
+  }
+
+  if(!tmp_err && httpcodeIsValid(req.getRequestCode()) == false){
+      httpcodeToDavixError(req.getRequestCode(), davix_scope_io_buff(),
+                           "write error: ", &tmp_err);
+  }
+  checkDavixError(&tmp_err);
+
+  AzureBlockListParser parser;
+  if(parser.parseChunk(req.getAnswerContent()) != 0) {
+    DavixError::setupError(&tmp_err, "Azure::BlockList", StatusCode::InvalidServerResponse, "Unable to parse server response for block list");
+  }
+  checkDavixError(&tmp_err);
+
+  const std::map<std::string, dav_size_t> &blocks = parser.getBlocks();
+  manifest.retainParts([&](size_t partNumber, const UploadedPart &part) {
+    std::map<std::string, dav_size_t>::const_iterator it = blocks.find(part.id);
+    return it != blocks.end() && it->second == part.size &&
+      part.id == stringifyBlockID(manifest.getUploadId(), partNumber - 1, part.digest);
+  });
+
+  DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Azure write: resuming upload of {}, {} blocks done", iocontext._uri, manifest.countParts());
+  return true;
+}
+
 static std::string uuid_to_string(uuid_t uuid) {
   std::stringstream ss;
   for(size_t i = 0; i < 16; i++) {
@@ -128,37 +181,49 @@ dav_ssize_t AzureIO::writeFromProvider(IOChainContext & iocontext, ContentProvid
     CHAIN_FORWARD(writeFromProvider(iocontext, provider));
   }
 
-  std::vector<std::string> blockIDs;
-
   DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Azure write: size {}, splitting into blocks", provider.getSize());
-  std::vector<char> buffer;
 
-  const dav_size_t MAX_CHUNK_SIZE = 1024 * 1024 * 100; // 100 MB
-  buffer.resize(std::min(MAX_CHUNK_SIZE, (dav_size_t) provider.getSize()) + 10);
+  std::unique_ptr<UploadManifest> manifest = UploadManifest::open(*iocontext._reqparams, iocontext._uri, provider);
+  if(manifest && manifest->resumable() && !resumeBlocks(iocontext, *manifest)) {
+    manifest->reset();
+  }
 
-  // generate UUID to use as blockid prefix
-  std::string prefix = get_uuid();
+  PartUploader uploader(iocontext._context, *iocontext._reqparams, provider.getSize(), AZURE_MAX_BLOCKS, manifest.get());
 
-  size_t blockid = 0;
-  size_t remaining = provider.getSize();
-  while(remaining > 0) {
-    size_t toRead = std::min( (dav_size_t) provider.getSize(), MAX_CHUNK_SIZE);
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Azure write: toRead from cb {}", toRead);
+  // the blockid prefix plays the part of an upload id
+  std::string prefix;
+  if(manifest && manifest->resumable()) {
+    prefix = manifest->getUploadId();
+  }
+  else {
+    // generate UUID to use as blockid prefix
+    prefix = get_uuid();
 
-    size_t bytesRead = provider.pullBytes(buffer.data(), toRead);
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Azure write: bytesRead from cb {}", bytesRead);
-    if(bytesRead == 0) break; // EOF?
+    if(manifest) {
+      manifest->start(prefix, uploader.getPartSize());
+    }
+  }
 
-    blockIDs.push_back(stringifyBlockID(prefix, blockid));
-    writeChunk(iocontext, buffer.data(), bytesRead, blockIDs.back());
-    blockid++;
+  std::vector<UploadedPart> parts = uploader.upload(provider,
+    [&](const char *data, dav_size_t size, size_t partNumber, const std::string &digest) {
+      std::string blockid = stringifyBlockID(prefix, partNumber - 1, digest);
+      writeChunk(iocontext, data, size, blockid);
+      return blockid;
+    });
 
-    remaining -= bytesRead;
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Azure write: remaining bytes {}", remaining);
+  std::vector<std::string> blockIDs;
+  blockIDs.reserve(parts.size());
+  for(size_t i = 0; i < parts.size(); i++) {
+    blockIDs.push_back(parts[i].id);
   }
 
   // Now let's commit the blobs
   commitChunks(iocontext, blockIDs);
+
+  if(manifest) {
+    manifest->remove();
+  }
+
   return provider.getSize();
 
 }
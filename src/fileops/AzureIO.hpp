@@ -26,6 +26,8 @@
 
 namespace Davix{
 
+class UploadManifest;
+
 class AzureIO : public HttpIOChain {
 public:
   AzureIO();
@@ -37,6 +39,10 @@ public:
 private:
   void writeChunk(IOChainContext & iocontext, const char* buff, dav_size_t size, const std::string &blockid);
   void commitChunks(IOChainContext & iocontext, const std::vector<std::string> &blocklist);
+
+  // Check the blocks recorded in the manifest against the uncommitted blocks
+  // of the blob, return false if the upload can't be resumed
+  bool resumeBlocks(IOChainContext & iocontext, UploadManifest &manifest);
 };
 
 }
@@ -0,0 +1,66 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "BlockCacheIO.hpp"
+#include <davix_context_internal.hpp>
+#include <core/BlockCache.hpp>
+#include <utils/davix_logger_internal.hpp>
+
+namespace Davix{
+
+BlockCacheIO::BlockCacheIO() {}
+
+BlockCacheIO::~BlockCacheIO() {}
+
+dav_ssize_t BlockCacheIO::pread(IOChainContext & iocontext, void* buf, dav_size_t count, dav_off_t offset) {
+  BlockCache &cache = ContextExplorer::BlockCacheFromContext(iocontext._context);
+
+  // large reads would only push out the blocks worth keeping
+  if(count == 0 || cache.getLimit() == 0 || count > DAVIX_BLOCK_CACHE_MAX_READ_BLOCKS * cache.getBlockSize()) {
+    CHAIN_FORWARD(pread(iocontext, buf, count, offset));
+  }
+
+  if(_next.get() == NULL) {
+    throw DavixException(davix_scope_io_buff(), StatusCode::OperationNonSupported, "I/O operation not supported");
+  }
+
+  DAVIX_SLOG(DAVIX_LOG_TRACE, DAVIX_LOG_CHAIN, "pread of {} bytes at offset {} of {} through the block cache", count, offset, iocontext._uri);
+  return cache.read(iocontext._uri.getString(), buf, count, offset,
+    [&](char *buffer, dav_size_t size, dav_off_t blockOffset, std::string &etag) {
+      iocontext.etag.clear();
+      dav_ssize_t ret = _next->pread(iocontext, buffer, size, blockOffset);
+      etag = iocontext.etag;
+      return ret;
+    });
+}
+
+dav_ssize_t BlockCacheIO::writeFromProvider(IOChainContext & iocontext, ContentProvider &provider) {
+  ContextExplorer::BlockCacheFromContext(iocontext._context).invalidate(iocontext._uri.getString());
+  CHAIN_FORWARD(writeFromProvider(iocontext, provider));
+}
+
+bool BlockCacheIO::commitChunks(IOChainContext& iocontext, const std::string &uploadId,
+                                const std::vector<std::string> &etags) {
+  ContextExplorer::BlockCacheFromContext(iocontext._context).invalidate(iocontext._uri.getString());
+  CHAIN_FORWARD(commitChunks(iocontext, uploadId, etags));
+}
+
+}
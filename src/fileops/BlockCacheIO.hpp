@@ -0,0 +1,50 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef BLOCK_CACHE_IO_HPP
+#define BLOCK_CACHE_IO_HPP
+
+#include <fileops/httpiochain.hpp>
+
+namespace Davix{
+
+//
+// Serves small position independent reads from the block cache of the
+// context, see Context::setBlockCacheLimit
+//
+class BlockCacheIO : public HttpIOChain {
+public:
+  BlockCacheIO();
+  ~BlockCacheIO();
+
+  // position independant read, block by block through the cache
+  virtual dav_ssize_t pread(IOChainContext & iocontext, void* buf, dav_size_t count, dav_off_t offset);
+
+  // writes make cached blocks of the file stale
+  virtual dav_ssize_t writeFromProvider(IOChainContext & iocontext, ContentProvider &provider);
+
+  virtual bool commitChunks(IOChainContext& iocontext, const std::string &uploadId,
+                            const std::vector<std::string> &etags);
+};
+
+}
+
+#endif
@@ -0,0 +1,185 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "ListingPrefetcher.hpp"
+#include <davix_internal.hpp>
+#include <davix_context_internal.hpp>
+#include <core/WorkerPool.hpp>
+#include <utils/davix_logger_internal.hpp>
+
+#include <sys/stat.h>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+ListingPrefetcher::ListingPrefetcher(Context &context, const PageFunction &fetch, size_t depth)
+: _context(context), _fetch(fetch), _depth(std::max<size_t>(depth, 1)),
+  _inflight(false), _done(false), _cancelled(false) {
+
+  std::lock_guard<std::mutex> lock(_mtx);
+  schedule();
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+ListingPrefetcher::~ListingPrefetcher() {
+  std::unique_lock<std::mutex> lock(_mtx);
+  _cancelled = true;
+  _cv.wait(lock, [this]() { return !_inflight; });
+}
+
+//------------------------------------------------------------------------------
+// Request the next page, if there is room for it
+//------------------------------------------------------------------------------
+void ListingPrefetcher::schedule() {
+  if(_inflight || _done || _cancelled || _error || _ready.size() >= _depth) {
+    return;
+  }
+
+  _inflight = true;
+  const std::string marker = _marker;
+  ContextExplorer::WorkerPoolFromContext(_context).submit([this, marker]() {
+    fetch(marker);
+  });
+}
+
+//------------------------------------------------------------------------------
+// Worker side: fetch a page
+//------------------------------------------------------------------------------
+void ListingPrefetcher::fetch(const std::string &marker) {
+  ListingPage page;
+  std::exception_ptr error;
+
+  try {
+    _fetch(marker, page);
+  }
+  catch(...) {
+    error = std::current_exception();
+  }
+
+  std::lock_guard<std::mutex> lock(_mtx);
+  _inflight = false;
+
+  if(error) {
+    _error = error;
+  }
+  else {
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Prefetched listing page after '{}': {} entries, next '{}'", marker, page.entries.size(), page.nextMarker);
+
+    // a server repeating its marker would have us list forever
+    if(page.nextMarker.empty() || page.nextMarker == marker) {
+      _done = true;
+    }
+
+    _marker = page.nextMarker;
+    _ready.push_back(std::move(page));
+    schedule();
+  }
+
+  _cv.notify_all();
+}
+
+//------------------------------------------------------------------------------
+// Get the next entry
+//------------------------------------------------------------------------------
+bool ListingPrefetcher::next(FileProperties &entry) {
+  while(_current.empty()) {
+    std::unique_lock<std::mutex> lock(_mtx);
+    _cv.wait(lock, [this]() { return !_ready.empty() || _error || !_inflight; });
+
+    if(!_ready.empty()) {
+      _current.swap(_ready.front().entries);
+      _ready.pop_front();
+      schedule();
+      continue;
+    }
+
+    if(_error) {
+      std::rethrow_exception(_error);
+    }
+
+    return false;
+  }
+
+  entry = std::move(_current.front());
+  _current.pop_front();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+PartitionedListing::PartitionedListing(std::unique_ptr<ListingPrefetcher> top, size_t parallelism, const OpenFunction &open)
+: _top(std::move(top)), _parallelism(std::max<size_t>(parallelism, 1)), _open(open),
+  _openPartitions(0), _topDone(false) {}
+
+//------------------------------------------------------------------------------
+// Read the top-level listing until enough partitions are being listed
+//------------------------------------------------------------------------------
+void PartitionedListing::fill() {
+  while(!_topDone && _openPartitions < _parallelism) {
+    Unit unit;
+    if(!_top->next(unit.entry)) {
+      _topDone = true;
+      break;
+    }
+
+    if(S_ISDIR(unit.entry.info.mode)) {
+      DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Listing partition {}", unit.entry.filename);
+      unit.partition = _open(unit.entry);
+      _openPartitions++;
+    }
+
+    _units.push_back(std::move(unit));
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get the next entry
+//------------------------------------------------------------------------------
+bool PartitionedListing::next(FileProperties &entry) {
+  while(true) {
+    fill();
+
+    if(_units.empty()) {
+      return false;
+    }
+
+    Unit &unit = _units.front();
+    if(!unit.partition) {
+      entry = std::move(unit.entry);
+      _units.pop_front();
+      return true;
+    }
+
+    if(unit.partition->next(entry)) {
+      return true;
+    }
+
+    _units.pop_front();
+    _openPartitions--;
+  }
+}
+
+}
@@ -0,0 +1,158 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef DAVIX_FILEOPS_LISTING_PREFETCHER_HPP
+#define DAVIX_FILEOPS_LISTING_PREFETCHER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utils/davix_fileproperties.hpp>
+
+namespace Davix {
+
+class Context;
+
+//------------------------------------------------------------------------------
+// A page of a paginated listing
+//------------------------------------------------------------------------------
+struct ListingPage {
+  std::deque<FileProperties> entries;
+
+  // where the next page starts - empty on the last page
+  std::string nextMarker;
+};
+
+//------------------------------------------------------------------------------
+// Paginated listing, fetched ahead of its reader.
+//
+// Pages are requested on the Context's worker pool, one at a time - each
+// page names the next one - and up to "depth" pages are kept ready ahead of
+// the one being read, so that the reader doesn't wait for a full round-trip
+// and parse at every page boundary.
+//------------------------------------------------------------------------------
+class ListingPrefetcher {
+public:
+  //----------------------------------------------------------------------------
+  // Fetch the page starting after "marker" (empty: the first page). Runs on
+  // a worker thread; throws DavixException on error.
+  //----------------------------------------------------------------------------
+  typedef std::function<void (const std::string &marker, ListingPage &page)> PageFunction;
+
+  //----------------------------------------------------------------------------
+  // Constructor - the first page is requested right away
+  //----------------------------------------------------------------------------
+  ListingPrefetcher(Context &context, const PageFunction &fetch, size_t depth);
+
+  //----------------------------------------------------------------------------
+  // Destructor - waits for the page in flight, if any
+  //----------------------------------------------------------------------------
+  ~ListingPrefetcher();
+
+  ListingPrefetcher(const ListingPrefetcher &other) = delete;
+  ListingPrefetcher& operator=(const ListingPrefetcher &other) = delete;
+
+  //----------------------------------------------------------------------------
+  // Get the next entry, waiting for its page if needed. Returns false at the
+  // end of the listing; throws the error of a failed page.
+  //----------------------------------------------------------------------------
+  bool next(FileProperties &entry);
+
+private:
+  //----------------------------------------------------------------------------
+  // Request the next page, if there is room for it. Call with _mtx held.
+  //----------------------------------------------------------------------------
+  void schedule();
+
+  //----------------------------------------------------------------------------
+  // Worker side: fetch the page after "marker"
+  //----------------------------------------------------------------------------
+  void fetch(const std::string &marker);
+
+  Context &_context;
+  PageFunction _fetch;
+  size_t _depth;
+
+  // the page being read, only touched by the reader
+  std::deque<FileProperties> _current;
+
+  std::mutex _mtx;
+  std::condition_variable _cv;
+  std::deque<ListingPage> _ready;
+  std::string _marker;
+  bool _inflight;
+  bool _done;
+  bool _cancelled;
+  std::exception_ptr _error;
+};
+
+//------------------------------------------------------------------------------
+// A listing split along the top level of its keyspace.
+//
+// The top-level listing is read first: its directory entries are partitions,
+// each listed on its own, up to "parallelism" of them at once; other entries
+// are passed through. Entries come out in the order of the top-level listing,
+// a partition being expanded in place.
+//------------------------------------------------------------------------------
+class PartitionedListing {
+public:
+  //----------------------------------------------------------------------------
+  // Start listing everything under the top-level directory entry "partition"
+  //----------------------------------------------------------------------------
+  typedef std::function<std::unique_ptr<ListingPrefetcher> (const FileProperties &partition)> OpenFunction;
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  PartitionedListing(std::unique_ptr<ListingPrefetcher> top, size_t parallelism, const OpenFunction &open);
+
+  //----------------------------------------------------------------------------
+  // Get the next entry. Returns false at the end of the listing.
+  //----------------------------------------------------------------------------
+  bool next(FileProperties &entry);
+
+private:
+  struct Unit {
+    FileProperties entry;
+    std::unique_ptr<ListingPrefetcher> partition;
+  };
+
+  //----------------------------------------------------------------------------
+  // Read the top-level listing until enough partitions are being listed
+  //----------------------------------------------------------------------------
+  void fill();
+
+  std::unique_ptr<ListingPrefetcher> _top;
+  size_t _parallelism;
+  OpenFunction _open;
+
+  std::deque<Unit> _units;
+  size_t _openPartitions;
+  bool _topDone;
+};
+
+}
+
+#endif
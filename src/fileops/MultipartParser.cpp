@@ -0,0 +1,273 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include "MultipartParser.hpp"
+#include <davix_internal.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <strings.h>
+
+namespace Davix {
+
+const dav_size_t MultipartParser::kMaxLineSize;
+const size_t MultipartParser::kMaxLines;
+
+static const std::string MultipartParser_scope() {
+  return "Davix::MultipartParser";
+}
+
+static bool isBlank(char c) {
+  return c == ' ' || c == '\t';
+}
+
+static bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+// case-insensitive match of "token" at p, advancing p past it
+static bool consumeToken(const char *&p, const char *end, const char *token) {
+  dav_size_t len = strlen(token);
+  if((dav_size_t) (end - p) < len || strncasecmp(p, token, len) != 0) {
+    return false;
+  }
+
+  p += len;
+  return true;
+}
+
+static void skipBlanks(const char *&p, const char *end) {
+  while(p < end && isBlank(*p)) {
+    p++;
+  }
+}
+
+static bool consumeNumber(const char *&p, const char *end, dav_size_t &value) {
+  if(p == end || !isDigit(*p)) {
+    return false;
+  }
+
+  value = 0;
+  while(p < end && isDigit(*p)) {
+    dav_size_t next = value * 10 + (*p - '0');
+    if(next / 10 != value) {
+      return false; // overflow
+    }
+
+    value = next;
+    p++;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Parse a Content-Range part header in place
+//------------------------------------------------------------------------------
+int parseContentRange(const char *line, dav_size_t len, dav_off_t &offset, dav_size_t &size) {
+  const char *p = line;
+  const char *end = line + len;
+
+  const char *colon = (const char*) memchr(line, ':', len);
+  if(colon == NULL) {
+    return -1;
+  }
+
+  if(!consumeToken(p, colon, "Content-Range") || p != colon) {
+    return 0;
+  }
+
+  p++;
+  skipBlanks(p, end);
+
+  dav_size_t first, last;
+  if(!consumeToken(p, end, "bytes") || p == end || !isBlank(*p)) {
+    return -1;
+  }
+
+  skipBlanks(p, end);
+  if(!consumeNumber(p, end, first) || p == end || *p != '-') {
+    return -1;
+  }
+
+  p++;
+  if(!consumeNumber(p, end, last) || last < first) {
+    return -1;
+  }
+
+  skipBlanks(p, end);
+  if(p != end && *p != '/') {
+    return -1;
+  }
+
+  offset = first;
+  size = last - first + 1;
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+MultipartParser::MultipartParser(const std::string &boundary, const PayloadCallback &callback)
+: _delimiter("--" + boundary), _callback(callback), _state(State::kBoundary),
+  _lines(0), _hasRange(false), _offset(0), _remaining(0), _payloadBytes(0) {}
+
+//------------------------------------------------------------------------------
+// Mark the response as malformed
+//------------------------------------------------------------------------------
+bool MultipartParser::fail(DavixError **err, const std::string &msg) {
+  _state = State::kError;
+  DavixError::setupError(err, MultipartParser_scope(), StatusCode::InvalidServerResponse, msg);
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Feed the next block of the response body
+//------------------------------------------------------------------------------
+dav_ssize_t MultipartParser::feed(const char *data, dav_size_t len, DavixError **err) {
+  const char *p = data;
+  const char *end = data + len;
+
+  while(p < end) {
+    if(_state == State::kDone) {
+      break;
+    }
+
+    if(_state == State::kError) {
+      return -1;
+    }
+
+    if(_state == State::kPayload) {
+      dav_size_t n = std::min<dav_size_t>(_remaining, end - p);
+      _callback(_offset, p, n);
+      skipPayload(n);
+      p += n;
+      continue;
+    }
+
+    const char *nl = (const char*) memchr(p, '\n', end - p);
+    if(nl == NULL) {
+      // line continues in the next block
+      if(_line.size() + (end - p) > kMaxLineSize) {
+        fail(err, "Invalid Multi-Part HTTP, Multi-part header too long");
+        return -1;
+      }
+
+      _line.append(p, end - p);
+      p = end;
+      break;
+    }
+
+    bool ok;
+    if(_line.empty()) {
+      ok = processLine(p, nl - p, err);
+    }
+    else {
+      if(_line.size() + (nl - p) > kMaxLineSize) {
+        fail(err, "Invalid Multi-Part HTTP, Multi-part header too long");
+        return -1;
+      }
+
+      _line.append(p, nl - p);
+      ok = processLine(_line.data(), _line.size(), err);
+      _line.clear();
+    }
+
+    if(!ok) {
+      return -1;
+    }
+
+    p = nl + 1;
+  }
+
+  return p - data;
+}
+
+//------------------------------------------------------------------------------
+// Handle a complete line
+//------------------------------------------------------------------------------
+bool MultipartParser::processLine(const char *line, dav_size_t len, DavixError **err) {
+  while(len > 0 && (line[len-1] == '\r' || isBlank(line[len-1]))) {
+    len--;
+  }
+
+  if(++_lines > kMaxLines) {
+    return fail(err, "Invalid Multi-Part HTTP, Multi-part header too long");
+  }
+
+  if(_state == State::kBoundary) {
+    if(len == 0) {
+      return true;
+    }
+
+    if(len >= _delimiter.size() && memcmp(line, _delimiter.data(), _delimiter.size()) == 0) {
+      if(len == _delimiter.size()) {
+        _state = State::kHeaders;
+        _hasRange = false;
+        _lines = 0;
+        return true;
+      }
+
+      if(len == _delimiter.size() + 2 && line[len-2] == '-' && line[len-1] == '-') {
+        _state = State::kDone;
+        return true;
+      }
+    }
+
+    return fail(err, std::string("Invalid boundary for multipart http response :").append(_delimiter, 2, std::string::npos));
+  }
+
+  // part headers, up to an empty line
+  if(len == 0) {
+    if(!_hasRange) {
+      return fail(err, "Invalid Multi-Part HTTP response");
+    }
+
+    _state = State::kPayload;
+    return true;
+  }
+
+  int ret = parseContentRange(line, len, _offset, _remaining);
+  if(ret < 0) {
+    return fail(err, "Invalid Multi-Part HTTP response");
+  }
+
+  if(ret == 1) {
+    _hasRange = true;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// The caller consumed payload by itself
+//------------------------------------------------------------------------------
+void MultipartParser::skipPayload(dav_size_t size) {
+  _offset += size;
+  _remaining -= size;
+  _payloadBytes += size;
+
+  if(_remaining == 0) {
+    _state = State::kBoundary;
+    _lines = 0;
+  }
+}
+
+}
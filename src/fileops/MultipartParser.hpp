@@ -0,0 +1,133 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#ifndef DAVIX_FILEOPS_MULTIPART_PARSER_HPP
+#define DAVIX_FILEOPS_MULTIPART_PARSER_HPP
+
+#include <functional>
+#include <string>
+#include <utils/davix_types.hpp>
+
+namespace Davix {
+
+class DavixError;
+
+//------------------------------------------------------------------------------
+// Parse a Content-Range part header in place, without allocating.
+// Returns 1 on success, 0 if this is some other header, -1 if malformed.
+//------------------------------------------------------------------------------
+int parseContentRange(const char *line, dav_size_t len, dav_off_t &offset, dav_size_t &size);
+
+//------------------------------------------------------------------------------
+// Streaming parser of multipart/byteranges response bodies.
+//
+// The body is fed in blocks of any size, split anywhere. Part headers are
+// scanned with memchr, and only buffered when a line straddles two blocks.
+// Payload bytes are handed out as they arrive, along with their offset in
+// the file, straight out of the fed block - the parser never copies them.
+//
+// In between feeds, the caller may consume payload on its own (eg reading
+// it directly into its destination) and report it through skipPayload.
+//------------------------------------------------------------------------------
+class MultipartParser {
+public:
+  typedef std::function<void (dav_off_t offset, const char *data, dav_size_t size)> PayloadCallback;
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  MultipartParser(const std::string &boundary, const PayloadCallback &callback);
+
+  //----------------------------------------------------------------------------
+  // Feed the next block of the response body. Returns the number of bytes
+  // consumed - less than "len" only once the terminating boundary has been
+  // seen - or -1 on a malformed response.
+  //----------------------------------------------------------------------------
+  dav_ssize_t feed(const char *data, dav_size_t len, DavixError **err);
+
+  //----------------------------------------------------------------------------
+  // Are we in the middle of a part's payload?
+  //----------------------------------------------------------------------------
+  bool inPayload() const {
+    return _state == State::kPayload;
+  }
+
+  //----------------------------------------------------------------------------
+  // File offset of the next payload byte, and how many remain in this part
+  //----------------------------------------------------------------------------
+  dav_off_t payloadOffset() const {
+    return _offset;
+  }
+
+  dav_size_t payloadRemaining() const {
+    return _remaining;
+  }
+
+  //----------------------------------------------------------------------------
+  // The caller consumed "size" bytes of payload by itself
+  //----------------------------------------------------------------------------
+  void skipPayload(dav_size_t size);
+
+  //----------------------------------------------------------------------------
+  // Has the terminating boundary been seen?
+  //----------------------------------------------------------------------------
+  bool done() const {
+    return _state == State::kDone;
+  }
+
+  //----------------------------------------------------------------------------
+  // Total payload bytes seen so far
+  //----------------------------------------------------------------------------
+  dav_size_t payloadBytes() const {
+    return _payloadBytes;
+  }
+
+  // longest part header line we accept
+  static const dav_size_t kMaxLineSize = 4096;
+
+  // blank lines and headers tolerated between two payloads
+  static const size_t kMaxLines = 100;
+
+private:
+  enum class State { kBoundary, kHeaders, kPayload, kDone, kError };
+
+  //----------------------------------------------------------------------------
+  // Handle a complete line, without its line terminator
+  //----------------------------------------------------------------------------
+  bool processLine(const char *line, dav_size_t len, DavixError **err);
+
+  bool fail(DavixError **err, const std::string &msg);
+
+  std::string _delimiter;
+  PayloadCallback _callback;
+
+  State _state;
+  std::string _line;
+  size_t _lines;
+
+  bool _hasRange;
+  dav_off_t _offset;
+  dav_size_t _remaining;
+  dav_size_t _payloadBytes;
+};
+
+}
+
+#endif
@@ -0,0 +1,344 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include "PartUploader.hpp"
+#include <davix_internal.hpp>
+#include <davix_context_internal.hpp>
+#include <core/BufferPool.hpp>
+#include <core/ContentProvider.hpp>
+#include <core/WorkerPool.hpp>
+#include <fileops/UploadManifest.hpp>
+#include <utils/davix_logger_internal.hpp>
+
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// Fill buffer from provider, short only on EOF
+//------------------------------------------------------------------------------
+dav_size_t fillBufferWithProviderData(char *buffer, dav_size_t size, ContentProvider &provider) {
+  dav_size_t written = 0u;
+
+  while(written < size) {
+    dav_ssize_t bytesRead = provider.pullBytes(buffer + written, size - written);
+    if(bytesRead < 0) {
+      throw DavixException(davix_scope_io_buff(), StatusCode::InvalidFileHandle, fmt::format("Error when reading from callback: {}", bytesRead));
+    }
+
+    if(bytesRead == 0) {
+      DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Reached data provider EOF, received 0 bytes, even though asked for {}", size - written);
+      break; // EOF
+    }
+
+    written += bytesRead;
+  }
+
+  DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Retrieved {} bytes from data provider", written);
+  return written;
+}
+
+//------------------------------------------------------------------------------
+// A window of a file, mapped in memory - or read into a pooled buffer, if it
+// can't be mapped, or doesn't lie within the file anymore.
+//
+// A mapped window is only safe as long as the file isn't truncated under it:
+// touching a page past the end of the file raises SIGBUS. The window is
+// checked against the file size before mapping, which catches a file already
+// cut short, but not one truncated while the part is being sent.
+//------------------------------------------------------------------------------
+class FdWindow {
+public:
+  FdWindow(BufferPool &pool, int fd, dav_off_t offset, dav_size_t size)
+  : _map(MAP_FAILED), _mapSize(0), _data(NULL) {
+
+    if(size == 0) {
+      return;
+    }
+
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+      DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Unable to stat the source file: {}, reading {} bytes at offset {} instead of mapping them", strerror(errno), size, offset);
+    }
+    else if(offset + (dav_off_t) size > st.st_size) {
+      DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Source file shrank to {} bytes, reading {} bytes at offset {} instead of mapping them", st.st_size, size, offset);
+    }
+    else if(mapWindow(fd, offset, size)) {
+      return;
+    }
+
+    _buffer = pool.acquire(size);
+
+    dav_size_t done = 0;
+    while(done < size) {
+      ssize_t ret = ::pread(fd, _buffer.data() + done, size - done, offset + done);
+      if(ret < 0 && errno == EINTR) {
+        continue;
+      }
+
+      if(ret <= 0) {
+        throw DavixException(davix_scope_io_buff(), StatusCode::InvalidFileHandle,
+          fmt::format("Unable to read {} bytes at offset {} of the source file: {}", size - done, offset + done, ret < 0 ? strerror(errno) : "unexpected EOF"));
+      }
+
+      done += ret;
+    }
+
+    _data = _buffer.data();
+  }
+
+  ~FdWindow() {
+    if(_map != MAP_FAILED) {
+      munmap(_map, _mapSize);
+    }
+  }
+
+  FdWindow(const FdWindow &other) = delete;
+  FdWindow& operator=(const FdWindow &other) = delete;
+
+  const char* data() const {
+    return _data;
+  }
+
+private:
+  bool mapWindow(int fd, dav_off_t offset, dav_size_t size) {
+    // mappings have to start on a page boundary
+    static const dav_off_t pageSize = sysconf(_SC_PAGESIZE);
+    dav_off_t start = offset - (offset % pageSize);
+    _mapSize = size + (offset - start);
+
+    _map = mmap(NULL, _mapSize, PROT_READ, MAP_SHARED, fd, start);
+    if(_map == MAP_FAILED) {
+      DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Unable to map {} bytes at offset {}: {}, reading them instead", size, offset, strerror(errno));
+      return false;
+    }
+
+    // advice values aren't flags, each needs a call of its own - and both
+    // are only hints
+    if(madvise(_map, _mapSize, MADV_SEQUENTIAL) != 0) {
+      DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "madvise(MADV_SEQUENTIAL) failed on {} bytes at offset {}: {}", _mapSize, start, strerror(errno));
+    }
+
+    if(madvise(_map, _mapSize, MADV_WILLNEED) != 0) {
+      DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "madvise(MADV_WILLNEED) failed on {} bytes at offset {}: {}", _mapSize, start, strerror(errno));
+    }
+
+    _data = static_cast<const char*>(_map) + (offset - start);
+    return true;
+  }
+
+  void *_map;
+  size_t _mapSize;
+  PooledBuffer _buffer;
+  const char *_data;
+};
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+PartUploader::PartUploader(Context &context, const RequestParams &params, dav_size_t totalSize, size_t maxParts,
+  UploadManifest *manifest)
+: _context(context), _manifest(manifest), _partSize(params.getUploadPartSize()), _parallelism(params.getUploadParallelism()) {
+
+  if(_manifest && _manifest->resumable()) {
+    _partSize = _manifest->getPartSize();
+  }
+  else {
+    if(_partSize == 0) {
+      _partSize = 1;
+    }
+
+    if(maxParts != 0 && totalSize / _partSize >= maxParts) {
+      _partSize = totalSize / maxParts + 1;
+      DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Upload of {} bytes needs more than {} parts, growing part size to {}", totalSize, maxParts, _partSize);
+    }
+
+    // a single part shouldn't take more than the whole buffer pool - unless
+    // the parts would then be too many, see upload()
+    dav_size_t limit = std::max<dav_size_t>(ContextExplorer::BufferPoolFromContext(_context).getLimit(), 1);
+    if(_partSize > limit) {
+      if(maxParts == 0 || totalSize / limit < maxParts) {
+        _partSize = limit;
+      }
+      else {
+        DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Upload of {} bytes in at most {} parts needs parts of {} bytes, over the upload buffer limit of {}", totalSize, maxParts, _partSize, limit);
+      }
+    }
+  }
+
+  // no point in lanes which would never get a part
+  dav_size_t nparts = totalSize / _partSize + 1;
+  if(_parallelism > nparts) {
+    _parallelism = nparts;
+  }
+
+  if(_parallelism == 0) {
+    _parallelism = 1;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Read provider until EOF, upload it part by part
+//------------------------------------------------------------------------------
+std::vector<UploadedPart> PartUploader::upload(ContentProvider &provider, const UploadFunction &fn) {
+  FdContentProvider *fdProvider = dynamic_cast<FdContentProvider*>(&provider);
+  if(fdProvider && fdProvider->ok()) {
+    struct stat st;
+    if(fstat(fdProvider->getFd(), &st) == 0 && S_ISREG(st.st_mode)) {
+      return uploadFromFd(fdProvider->getFd(), fdProvider->getOffset(), fdProvider->getSize(), fn);
+    }
+  }
+
+  std::mutex mtx;
+  std::vector<UploadedPart> parts;
+  bool eof = false;
+  bool failed = false;
+
+  DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Uploading in parts of {} bytes, {} in parallel", _partSize, _parallelism);
+
+  BufferPool &pool = ContextExplorer::BufferPoolFromContext(_context);
+  if(_partSize > pool.getLimit()) {
+    throw DavixException(davix_scope_io_buff(), StatusCode::InvalidArgument,
+      fmt::format("Parts of {} bytes don't fit in the upload buffer limit of {} bytes, raise it with Context::setUploadBufferLimit", _partSize, pool.getLimit()));
+  }
+
+  auto lane = [&](size_t laneNumber) {
+    // the first lane waits for memory, so that the upload always makes
+    // progress - the others only run if some is available right away
+    PooledBuffer buffer = (laneNumber == 0) ? pool.acquire(_partSize) : pool.tryAcquire(_partSize);
+    if(!buffer.valid()) {
+      DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Upload buffer limit reached, running one lane less");
+      return;
+    }
+
+    while(true) {
+      size_t partNumber;
+      dav_size_t size;
+
+      {
+        // the provider is read sequentially, one lane at a time
+        std::lock_guard<std::mutex> lock(mtx);
+        if(eof || failed) {
+          return;
+        }
+
+        try {
+          size = fillBufferWithProviderData(buffer.data(), _partSize, provider);
+        }
+        catch(...) {
+          failed = true;
+          throw;
+        }
+
+        if(size < _partSize) {
+          eof = true;
+        }
+
+        if(size == 0) {
+          return;
+        }
+
+        parts.emplace_back();
+        partNumber = parts.size();
+      }
+
+      UploadedPart part;
+
+      try {
+        part = uploadPart(buffer.data(), size, partNumber, fn);
+      }
+      catch(...) {
+        std::lock_guard<std::mutex> lock(mtx);
+        failed = true;
+        throw;
+      }
+
+      std::lock_guard<std::mutex> lock(mtx);
+      parts[partNumber-1] = std::move(part);
+    }
+  };
+
+  ContextExplorer::WorkerPoolFromContext(_context).forEach(_parallelism, _parallelism, lane);
+  return parts;
+}
+
+//------------------------------------------------------------------------------
+// Upload a window of a regular file, each part straight from the file
+//------------------------------------------------------------------------------
+std::vector<UploadedPart> PartUploader::uploadFromFd(int fd, dav_off_t offset, dav_size_t size, const UploadFunction &fn) {
+  size_t nparts = (size + _partSize - 1) / _partSize;
+  std::vector<UploadedPart> parts(nparts);
+
+  DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Uploading {} bytes of fd {} in {} parts of {} bytes, {} in parallel", size, fd, nparts, _partSize, _parallelism);
+  BufferPool &pool = ContextExplorer::BufferPoolFromContext(_context);
+
+  // parts don't depend on each other, and need no shared read position -
+  // any lane may take any part
+  ContextExplorer::WorkerPoolFromContext(_context).forEach(nparts, _parallelism, [&](size_t i) {
+    dav_off_t partOffset = i * _partSize;
+    dav_size_t partSize = std::min<dav_size_t>(_partSize, size - partOffset);
+
+    // parts already uploaded from the very same file need not even be mapped
+    if(_manifest && _manifest->sameSource() && _manifest->getPart(i + 1, parts[i]) && parts[i].size == partSize) {
+      return;
+    }
+
+    FdWindow window(pool, fd, offset + partOffset, partSize);
+    parts[i] = uploadPart(window.data(), partSize, i + 1, fn);
+  });
+
+  return parts;
+}
+
+//------------------------------------------------------------------------------
+// Upload a part, unless the manifest already holds it
+//------------------------------------------------------------------------------
+UploadedPart PartUploader::uploadPart(const char *data, dav_size_t size, size_t partNumber, const UploadFunction &fn) {
+  UploadedPart part;
+  std::string digest;
+
+  if(_manifest) {
+    digest = UploadManifest::digest(data, size);
+
+    if(_manifest->getPart(partNumber, part) && part.size == size) {
+      if(part.digest == digest) {
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Part #{} already uploaded as {}, skipping it", partNumber, part.id);
+        return part;
+      }
+
+      DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Part #{} changed since it was uploaded, uploading it again", partNumber);
+    }
+  }
+
+  part.size = size;
+  part.digest = digest;
+  part.id = fn(data, size, partNumber, digest);
+
+  if(_manifest) {
+    _manifest->addPart(partNumber, part);
+  }
+
+  return part;
+}
+
+}
@@ -0,0 +1,135 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#ifndef DAVIX_FILEOPS_PART_UPLOADER_HPP
+#define DAVIX_FILEOPS_PART_UPLOADER_HPP
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <utils/davix_types.hpp>
+
+namespace Davix {
+
+class Context;
+class ContentProvider;
+class RequestParams;
+class UploadManifest;
+
+//------------------------------------------------------------------------------
+// A part of a multi-part upload, once uploaded
+//------------------------------------------------------------------------------
+struct UploadedPart {
+  UploadedPart() : size(0) {}
+
+  // etag, block id... whatever is needed to commit the upload
+  std::string id;
+  dav_size_t size;
+
+  // hex MD5 of the part, if uploaded with an UploadManifest
+  std::string digest;
+};
+
+//------------------------------------------------------------------------------
+// Pipelined multi-part upload, shared by S3, Swift and Azure.
+//
+// Up to "parallelism" lanes run on the Context's worker pool, the calling
+// thread included. Each lane owns a single part-sized buffer: it reads the
+// next part from the ContentProvider - one lane at a time, so parts come out
+// in order - then uploads it while the other lanes read and upload theirs.
+//
+// Buffers come from the Context's BufferPool, so memory use is bounded by
+// parallelism * partSize per upload, and by the pool limit across uploads.
+// When the limit is reached, uploads run with fewer lanes - at least one.
+//
+// Regular files behind an FdContentProvider skip the buffers altogether:
+// each part is mapped straight from the file, saving a copy of the whole
+// upload through user space. The file must not be truncated while it is
+// uploaded: a part already mapped past the new end of the file raises SIGBUS.
+// Parts found past the end before being mapped are read instead, and fail
+// with a DavixException.
+//
+// Given an UploadManifest, completed parts are recorded as they go, along with
+// their digest. Parts it already holds are not uploaded again, as long as the
+// data to upload still has the same digest - or, for files, as long as the
+// file is still the one the manifest was recorded for.
+//------------------------------------------------------------------------------
+class PartUploader {
+public:
+  //----------------------------------------------------------------------------
+  // Upload a single part and return its id. Part numbers start at 1, and
+  // "digest" is the hex MD5 of the part - empty without an UploadManifest.
+  // Called concurrently from several threads; throws DavixException on error.
+  //----------------------------------------------------------------------------
+  typedef std::function<std::string (const char *data, dav_size_t size, size_t partNumber, const std::string &digest)> UploadFunction;
+
+  //----------------------------------------------------------------------------
+  // Constructor. Part size and parallelism are taken from "params". The part
+  // size is grown if an object of "totalSize" bytes would otherwise need more
+  // than "maxParts" parts (0: no limit), then capped to the BufferPool limit
+  // unless that would need too many parts again. When resuming from
+  // "manifest", its part size is kept, so that the recorded parts still line
+  // up.
+  //----------------------------------------------------------------------------
+  PartUploader(Context &context, const RequestParams &params, dav_size_t totalSize, size_t maxParts,
+    UploadManifest *manifest = NULL);
+
+  //----------------------------------------------------------------------------
+  // Size of each part, except possibly the last one
+  //----------------------------------------------------------------------------
+  dav_size_t getPartSize() const {
+    return _partSize;
+  }
+
+  //----------------------------------------------------------------------------
+  // Read "provider" until EOF and upload it, part by part. Returns the parts
+  // in order, ready to be committed. On failure, parts still in flight are
+  // waited for, then the first error is thrown. Parts read into buffers must
+  // fit under the BufferPool limit, or nothing is uploaded.
+  //----------------------------------------------------------------------------
+  std::vector<UploadedPart> upload(ContentProvider &provider, const UploadFunction &fn);
+
+private:
+  //----------------------------------------------------------------------------
+  // Upload "size" bytes of a regular file starting at "offset". Parts are
+  // mapped from the file rather than copied into a buffer, and uploaded in
+  // any order.
+  //----------------------------------------------------------------------------
+  std::vector<UploadedPart> uploadFromFd(int fd, dav_off_t offset, dav_size_t size, const UploadFunction &fn);
+
+  //----------------------------------------------------------------------------
+  // Upload a part, unless the manifest already holds it with the same digest
+  //----------------------------------------------------------------------------
+  UploadedPart uploadPart(const char *data, dav_size_t size, size_t partNumber, const UploadFunction &fn);
+
+  Context &_context;
+  UploadManifest *_manifest;
+  dav_size_t _partSize;
+  size_t _parallelism;
+};
+
+//------------------------------------------------------------------------------
+// Fill "buffer" with up to "size" bytes from "provider", short only on EOF
+//------------------------------------------------------------------------------
+dav_size_t fillBufferWithProviderData(char *buffer, dav_size_t size, ContentProvider &provider);
+
+}
+
+#endif
@@ -0,0 +1,348 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "ReadAheadCache.hpp"
+#include <davix_internal.hpp>
+#include <davix_context_internal.hpp>
+#include <core/WorkerPool.hpp>
+#include <utils/davix_logger_internal.hpp>
+
+#include <cstring>
+
+namespace Davix {
+
+//------------------------------------------------------------------------------
+// A range of the file, fetched or being fetched
+//------------------------------------------------------------------------------
+struct ReadAheadCache::Block {
+  enum State { kQueued, kInFlight, kReady, kFailed };
+
+  Block(dav_off_t o, dav_size_t s, bool a)
+  : offset(o), size(s), length(0), state(kQueued), ahead(a), read(false), lastUse(0) {}
+
+  dav_off_t offset;
+  dav_size_t size;
+
+  // filled by the worker - length is short of size at the end of the file
+  std::vector<char> data;
+  dav_size_t length;
+
+  State state;
+  bool ahead;
+  bool read;
+  size_t lastUse;
+};
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+ReadAheadCache::ReadAheadCache(Context &context, const FetchFunction &fetch, dav_size_t limit, dav_size_t blockSize)
+: _context(context), _fetch(fetch), _limit(limit), _blockSize(std::max<dav_size_t>(blockSize, 1)),
+  _cached(0), _window(std::min<dav_size_t>(2 * _blockSize, limit)), _readerPos(0), _inflight(0), _clock(0) {}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+ReadAheadCache::~ReadAheadCache() {
+  std::unique_lock<std::mutex> lock(_mtx);
+  _queue.clear();
+  _cv.wait(lock, [this]() { return _inflight == 0; });
+}
+
+//------------------------------------------------------------------------------
+// Read from the cache
+//------------------------------------------------------------------------------
+dav_ssize_t ReadAheadCache::read(void *buffer, dav_size_t count, dav_off_t offset) {
+  std::unique_lock<std::mutex> lock(_mtx);
+  char *out = static_cast<char*>(buffer);
+  dav_size_t copied = 0;
+  bool stalled = false;
+
+  while(copied < count) {
+    const dav_off_t pos = offset + copied;
+
+    std::map<dav_off_t, BlockPtr>::iterator it = _blocks.upper_bound(pos);
+    if(it == _blocks.begin()) {
+      break;
+    }
+
+    BlockPtr block = (--it)->second;
+    if(pos >= block->offset + (dav_off_t) block->size) {
+      break;
+    }
+
+    if(block->state == Block::kQueued || block->state == Block::kInFlight) {
+      // needed now, no point in waiting for a slot
+      if(block->state == Block::kQueued) {
+        start(block);
+      }
+
+      stalled = true;
+      _cv.wait(lock, [&]() { return block->state != Block::kInFlight; });
+
+      // someone else may have read it to its end meanwhile
+      it = _blocks.find(block->offset);
+      if(it == _blocks.end() || it->second != block) {
+        break;
+      }
+    }
+
+    if(block->state == Block::kFailed) {
+      drop(it);
+      break;
+    }
+
+    block->read = true;
+    block->lastUse = ++_clock;
+
+    const dav_off_t blockEnd = block->offset + block->length;
+    if(pos >= blockEnd) {
+      break; // end of file
+    }
+
+    dav_size_t n = std::min<dav_size_t>(blockEnd - pos, count - copied);
+    memcpy(out + copied, &block->data[pos - block->offset], n);
+    copied += n;
+
+    // read to its end, it won't be needed again
+    if(pos + (dav_off_t) n >= blockEnd) {
+      drop(it);
+      if(block->length < block->size) {
+        break; // end of file
+      }
+    }
+  }
+
+  if(copied > 0) {
+    _stats.hits++;
+  }
+  else {
+    _stats.misses++;
+  }
+
+  if(stalled) {
+    _stats.stalls++;
+    _window = std::min<dav_size_t>(_window * 2, _limit);
+  }
+
+  return copied;
+}
+
+//------------------------------------------------------------------------------
+// Fetch a hinted range
+//------------------------------------------------------------------------------
+void ReadAheadCache::willNeed(dav_off_t offset, dav_size_t size) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  size = std::min<dav_size_t>(size, _limit);
+
+  DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Read-ahead of {} bytes at offset {}", size, offset);
+  fetchRange(offset, offset + size, std::max<dav_size_t>(_blockSize, size / DAVIX_READ_AHEAD_MAX_INFLIGHT), false);
+}
+
+//------------------------------------------------------------------------------
+// Keep the sequential window fetched
+//------------------------------------------------------------------------------
+void ReadAheadCache::advance(dav_off_t offset, dav_size_t end) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _readerPos = offset;
+
+  const dav_off_t windowEnd = std::min<dav_off_t>(offset + _window, end);
+  fetchRange(offset, windowEnd, std::max<dav_size_t>(_blockSize, _window / DAVIX_READ_AHEAD_MAX_INFLIGHT), true);
+}
+
+//------------------------------------------------------------------------------
+// Accessors
+//------------------------------------------------------------------------------
+dav_size_t ReadAheadCache::getWindow() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _window;
+}
+
+dav_size_t ReadAheadCache::getCachedBytes() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _cached;
+}
+
+ReadAheadStats ReadAheadCache::getStats() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _stats;
+}
+
+//------------------------------------------------------------------------------
+// Queue the parts of a range not cached yet
+//------------------------------------------------------------------------------
+void ReadAheadCache::fetchRange(dav_off_t offset, dav_off_t end, dav_size_t chunkSize, bool ahead) {
+  dav_off_t pos = offset;
+
+  while(pos < end) {
+    std::map<dav_off_t, BlockPtr>::iterator next = _blocks.upper_bound(pos);
+
+    if(next != _blocks.begin()) {
+      std::map<dav_off_t, BlockPtr>::iterator prev = std::prev(next);
+      const dav_off_t prevEnd = prev->first + prev->second->size;
+      if(pos < prevEnd) {
+        pos = prevEnd;
+        continue;
+      }
+    }
+
+    dav_off_t chunkEnd = std::min<dav_off_t>(pos + chunkSize, end);
+    if(next != _blocks.end()) {
+      chunkEnd = std::min<dav_off_t>(chunkEnd, next->first);
+    }
+
+    if(!makeRoom(chunkEnd - pos, ahead)) {
+      DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Read-ahead cache full, not fetching [{}, {})", pos, end);
+      break;
+    }
+
+    BlockPtr block = std::make_shared<Block>(pos, chunkEnd - pos, ahead);
+    block->lastUse = ++_clock;
+
+    _blocks[pos] = block;
+    _cached += block->size;
+    _queue.push_back(block);
+    pos = chunkEnd;
+  }
+
+  schedule();
+}
+
+//------------------------------------------------------------------------------
+// Evict blocks until "size" more bytes fit
+//------------------------------------------------------------------------------
+bool ReadAheadCache::makeRoom(dav_size_t size, bool ahead) {
+  if(size > _limit) {
+    return false;
+  }
+
+  while(_cached + size > _limit) {
+    std::map<dav_off_t, BlockPtr>::iterator victim = _blocks.end();
+
+    for(std::map<dav_off_t, BlockPtr>::iterator it = _blocks.begin(); it != _blocks.end(); ++it) {
+      const Block &block = *it->second;
+      if(block.state != Block::kReady && block.state != Block::kFailed) {
+        continue;
+      }
+
+      // the oldest blocks of the window are the ones needed first
+      if(ahead && block.ahead && block.offset + (dav_off_t) block.size > _readerPos) {
+        continue;
+      }
+
+      if(victim == _blocks.end() || it->second->lastUse < victim->second->lastUse) {
+        victim = it;
+      }
+    }
+
+    if(victim == _blocks.end()) {
+      return false; // all in flight
+    }
+
+    drop(victim);
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Forget a block
+//------------------------------------------------------------------------------
+void ReadAheadCache::drop(std::map<dav_off_t, BlockPtr>::iterator it) {
+  const BlockPtr &block = it->second;
+
+  if(!block->read && block->state == Block::kReady) {
+    _stats.wasted++;
+
+    // fetched ahead for nothing: the window is larger than the reader needs
+    if(block->ahead) {
+      _window = std::max<dav_size_t>(_window / 2, _blockSize);
+    }
+  }
+
+  _cached -= block->size;
+  _blocks.erase(it);
+}
+
+//------------------------------------------------------------------------------
+// Start a queued block
+//------------------------------------------------------------------------------
+void ReadAheadCache::start(const BlockPtr &block) {
+  block->state = Block::kInFlight;
+  _inflight++;
+  _stats.fetches++;
+
+  ContextExplorer::WorkerPoolFromContext(_context).submit([this, block]() {
+    fetch(block);
+  });
+}
+
+//------------------------------------------------------------------------------
+// Start queued blocks, if there is room for them
+//------------------------------------------------------------------------------
+void ReadAheadCache::schedule() {
+  while(_inflight < DAVIX_READ_AHEAD_MAX_INFLIGHT && !_queue.empty()) {
+    BlockPtr block = _queue.front();
+    _queue.pop_front();
+
+    // the reader may have started it already, or it may be gone
+    std::map<dav_off_t, BlockPtr>::const_iterator it = _blocks.find(block->offset);
+    if(block->state == Block::kQueued && it != _blocks.end() && it->second == block) {
+      start(block);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Worker side: fetch a block
+//------------------------------------------------------------------------------
+void ReadAheadCache::fetch(BlockPtr block) {
+  std::vector<char> data(block->size);
+  dav_ssize_t ret = -1;
+
+  try {
+    ret = _fetch(data.data(), block->size, block->offset);
+  }
+  catch(DavixException &e) {
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Read-ahead of {} bytes at offset {} failed: {}", block->size, block->offset, e.what());
+  }
+  catch(...) {
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Read-ahead of {} bytes at offset {} failed", block->size, block->offset);
+  }
+
+  std::lock_guard<std::mutex> lock(_mtx);
+  _inflight--;
+
+  if(ret < 0) {
+    // the reader will fetch it itself, and get the error if it persists
+    block->state = Block::kFailed;
+  }
+  else {
+    block->data.swap(data);
+    block->length = std::min<dav_size_t>(ret, block->size);
+    block->state = Block::kReady;
+  }
+
+  schedule();
+  _cv.notify_all();
+}
+
+}
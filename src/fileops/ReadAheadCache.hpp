@@ -0,0 +1,189 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef DAVIX_FILEOPS_READ_AHEAD_CACHE_HPP
+#define DAVIX_FILEOPS_READ_AHEAD_CACHE_HPP
+
+#include <davix_internal_config.hpp>
+#include <utils/davix_types.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Davix {
+
+class Context;
+
+//------------------------------------------------------------------------------
+// Read-ahead statistics of a ReadAheadCache
+//------------------------------------------------------------------------------
+struct ReadAheadStats {
+  ReadAheadStats() : hits(0), misses(0), stalls(0), fetches(0), wasted(0) {}
+
+  // reads served from the cache - in part at least - and not
+  size_t hits;
+  size_t misses;
+
+  // reads which had to wait for a block in flight
+  size_t stalls;
+
+  // blocks fetched, and blocks dropped without having been read
+  size_t fetches;
+  size_t wasted;
+};
+
+//------------------------------------------------------------------------------
+// Bounded cache of byte ranges of a remote file, fetched in the background on
+// the Context's worker pool.
+//
+// Ranges are fetched ahead of time, either because they were hinted at
+// (willNeed), or to keep a window ahead of a sequential reader (advance).
+// That window adapts to the reader: it doubles whenever the reader has to
+// wait for data still in flight - it consumes faster than the window lets
+// it be fetched - and halves whenever read-ahead data goes unused.
+//
+// Blocks are dropped once read to their end, or evicted least recently used
+// first when room is needed; at most "limit" bytes are held or in flight.
+//------------------------------------------------------------------------------
+class ReadAheadCache {
+public:
+  //----------------------------------------------------------------------------
+  // Read up to "count" bytes at "offset" into "buffer", from a worker
+  // thread. Returns the number of bytes read, short only at the end of the
+  // file; throws DavixException on error.
+  //----------------------------------------------------------------------------
+  typedef std::function<dav_ssize_t (char *buffer, dav_size_t count, dav_off_t offset)> FetchFunction;
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  ReadAheadCache(Context &context, const FetchFunction &fetch, dav_size_t limit,
+    dav_size_t blockSize = DAVIX_READ_AHEAD_BLOCK_SIZE);
+
+  //----------------------------------------------------------------------------
+  // Destructor - waits for the fetches in flight
+  //----------------------------------------------------------------------------
+  ~ReadAheadCache();
+
+  ReadAheadCache(const ReadAheadCache &other) = delete;
+  ReadAheadCache& operator=(const ReadAheadCache &other) = delete;
+
+  //----------------------------------------------------------------------------
+  // Copy what the cache holds of [offset, offset + count) into buffer,
+  // contiguously from offset, waiting for the blocks in flight. Returns the
+  // number of bytes copied: 0 if offset is neither cached nor being fetched,
+  // or lies at the end of the file.
+  //----------------------------------------------------------------------------
+  dav_ssize_t read(void *buffer, dav_size_t count, dav_off_t offset);
+
+  //----------------------------------------------------------------------------
+  // Start fetching [offset, offset + size), as far as the limit allows
+  //----------------------------------------------------------------------------
+  void willNeed(dav_off_t offset, dav_size_t size);
+
+  //----------------------------------------------------------------------------
+  // A sequential reader is at "offset": keep the window ahead of it
+  // fetched, up to "end", the size of the file
+  //----------------------------------------------------------------------------
+  void advance(dav_off_t offset, dav_size_t end);
+
+  //----------------------------------------------------------------------------
+  // Current size of the sequential window
+  //----------------------------------------------------------------------------
+  dav_size_t getWindow() const;
+
+  //----------------------------------------------------------------------------
+  // Bytes held or in flight
+  //----------------------------------------------------------------------------
+  dav_size_t getCachedBytes() const;
+
+  //----------------------------------------------------------------------------
+  // Statistics
+  //----------------------------------------------------------------------------
+  ReadAheadStats getStats() const;
+
+private:
+  struct Block;
+  typedef std::shared_ptr<Block> BlockPtr;
+
+  //----------------------------------------------------------------------------
+  // Queue the parts of [offset, end) not cached yet, in chunks of
+  // "chunkSize" - "ahead" for the sequential window. Call with _mtx held.
+  //----------------------------------------------------------------------------
+  void fetchRange(dav_off_t offset, dav_off_t end, dav_size_t chunkSize, bool ahead);
+
+  //----------------------------------------------------------------------------
+  // Evict blocks, least recently used first, until "size" more bytes fit -
+  // sparing the window ahead of the sequential reader, if "ahead" is part of
+  // it. Call with _mtx held.
+  //----------------------------------------------------------------------------
+  bool makeRoom(dav_size_t size, bool ahead);
+
+  //----------------------------------------------------------------------------
+  // Forget a block. Call with _mtx held.
+  //----------------------------------------------------------------------------
+  void drop(std::map<dav_off_t, BlockPtr>::iterator it);
+
+  //----------------------------------------------------------------------------
+  // Start a queued block. Call with _mtx held.
+  //----------------------------------------------------------------------------
+  void start(const BlockPtr &block);
+
+  //----------------------------------------------------------------------------
+  // Start queued blocks, if there is room for them. Call with _mtx held.
+  //----------------------------------------------------------------------------
+  void schedule();
+
+  //----------------------------------------------------------------------------
+  // Worker side: fetch a block
+  //----------------------------------------------------------------------------
+  void fetch(BlockPtr block);
+
+  Context &_context;
+  FetchFunction _fetch;
+  dav_size_t _limit;
+  dav_size_t _blockSize;
+
+  mutable std::mutex _mtx;
+  std::condition_variable _cv;
+
+  // blocks, by offset - they never overlap
+  std::map<dav_off_t, BlockPtr> _blocks;
+
+  // blocks waiting for a fetch slot, first come first served
+  std::deque<BlockPtr> _queue;
+
+  dav_size_t _cached;
+  dav_size_t _window;
+  dav_off_t _readerPos;
+  size_t _inflight;
+  size_t _clock;
+  ReadAheadStats _stats;
+};
+
+}
+
+#endif
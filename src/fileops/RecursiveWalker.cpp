@@ -0,0 +1,207 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "RecursiveWalker.hpp"
+#include <davix_internal.hpp>
+#include <davix_context_internal.hpp>
+#include <core/WorkerPool.hpp>
+#include <utils/davix_logger_internal.hpp>
+
+#include <sys/stat.h>
+
+namespace Davix {
+
+const size_t RecursiveWalker::kLookaheadFactor;
+
+//------------------------------------------------------------------------------
+// A collection to list
+//------------------------------------------------------------------------------
+struct RecursiveWalker::Listing {
+  enum State { kPending, kInFlight, kDone };
+
+  Listing(const std::string &p) : path(p), state(kPending) {}
+
+  std::string path;
+  State state;
+
+  // filled by the worker, then only touched by the reader once kDone -
+  // subs holds the listings of the collections among entries, in order
+  std::deque<FileProperties> entries;
+  std::deque<ListingPtr> subs;
+  std::exception_ptr error;
+};
+
+static std::string joinPath(const std::string &parent, const std::string &name) {
+  return parent.empty() ? name : parent + "/" + name;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+RecursiveWalker::RecursiveWalker(Context &context, const ListFunction &list, size_t parallelism)
+: _context(context), _list(list), _parallelism(std::max<size_t>(parallelism, 1)),
+  _lookahead(kLookaheadFactor * _parallelism), _inflight(0), _buffered(0), _cancelled(false) {}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+RecursiveWalker::~RecursiveWalker() {
+  std::unique_lock<std::mutex> lock(_mtx);
+  _cancelled = true;
+  _cv.wait(lock, [this]() { return _inflight == 0; });
+}
+
+//------------------------------------------------------------------------------
+// Start listings, if there is room for them
+//------------------------------------------------------------------------------
+void RecursiveWalker::schedule() {
+  while(!_cancelled && _inflight < _parallelism) {
+    ListingPtr next;
+
+    if(_demanded) {
+      next.swap(_demanded);
+    }
+    else {
+      // listings done but not read yet count against the lookahead too
+      if(_inflight + _buffered >= _lookahead) {
+        return;
+      }
+
+      // the reader may have claimed some already
+      while(!_pending.empty() && _pending.front()->state != Listing::kPending) {
+        _pending.pop_front();
+      }
+
+      if(_pending.empty()) {
+        return;
+      }
+
+      next = _pending.front();
+      _pending.pop_front();
+    }
+
+    next->state = Listing::kInFlight;
+    _inflight++;
+
+    ContextExplorer::WorkerPoolFromContext(_context).submit([this, next]() {
+      list(next);
+    });
+  }
+}
+
+//------------------------------------------------------------------------------
+// Worker side: list a collection
+//------------------------------------------------------------------------------
+void RecursiveWalker::list(ListingPtr listing) {
+  std::deque<FileProperties> entries;
+  std::exception_ptr error;
+
+  try {
+    _list(listing->path, entries);
+  }
+  catch(...) {
+    error = std::current_exception();
+  }
+
+  std::deque<ListingPtr> subs;
+  for(std::deque<FileProperties>::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+    if(S_ISDIR(it->info.mode)) {
+      subs.push_back(std::make_shared<Listing>(joinPath(listing->path, it->filename)));
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(_mtx);
+  _inflight--;
+  _buffered++;
+
+  if(error) {
+    listing->error = error;
+  }
+  else {
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Walk listed '{}': {} entries, {} collections", listing->path, entries.size(), subs.size());
+
+    // found last, walked first
+    _pending.insert(_pending.begin(), subs.begin(), subs.end());
+    listing->entries.swap(entries);
+    listing->subs.swap(subs);
+  }
+
+  listing->state = Listing::kDone;
+  schedule();
+  _cv.notify_all();
+}
+
+//------------------------------------------------------------------------------
+// Walk
+//------------------------------------------------------------------------------
+void RecursiveWalker::walk(const std::vector<std::string> &roots, const WalkFunction &fn) {
+  // listings being read, innermost last - and whether the reader has seen
+  // them done, so that their entries can be read without the lock
+  std::vector<std::pair<ListingPtr, bool>> stack;
+
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    for(std::vector<std::string>::const_reverse_iterator it = roots.rbegin(); it != roots.rend(); ++it) {
+      stack.push_back(std::make_pair(std::make_shared<Listing>(*it), false));
+      _pending.push_front(stack.back().first);
+    }
+  }
+
+  while(!stack.empty()) {
+    ListingPtr top = stack.back().first;
+
+    if(!stack.back().second) {
+      std::unique_lock<std::mutex> lock(_mtx);
+      if(top->state == Listing::kPending) {
+        _demanded = top;
+        schedule();
+      }
+
+      _cv.wait(lock, [&]() { return top->state == Listing::kDone; });
+      if(top->error) {
+        std::rethrow_exception(top->error);
+      }
+
+      stack.back().second = true;
+    }
+
+    if(top->entries.empty()) {
+      stack.pop_back();
+
+      std::lock_guard<std::mutex> lock(_mtx);
+      _buffered--;
+      schedule();
+      continue;
+    }
+
+    FileProperties entry(std::move(top->entries.front()));
+    top->entries.pop_front();
+
+    fn(joinPath(top->path, entry.filename), entry.info);
+
+    if(S_ISDIR(entry.info.mode)) {
+      stack.push_back(std::make_pair(top->subs.front(), false));
+      top->subs.pop_front();
+    }
+  }
+}
+
+}
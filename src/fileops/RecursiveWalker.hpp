@@ -0,0 +1,124 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef DAVIX_FILEOPS_RECURSIVE_WALKER_HPP
+#define DAVIX_FILEOPS_RECURSIVE_WALKER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <utils/davix_fileproperties.hpp>
+
+namespace Davix {
+
+class Context;
+
+//------------------------------------------------------------------------------
+// Recursive walk of a namespace, one listing per collection.
+//
+// Collections are listed on the Context's worker pool, up to "parallelism"
+// of them at once, ahead of the reader: as soon as a listing comes back, the
+// collections it holds are queued, the most recently found first, so that
+// the listings needed next are the ones in flight. At most
+// kLookaheadFactor * parallelism listings are in flight or waiting to be
+// read, bounding memory on wide trees.
+//
+// Entries are reported in order, on the walking thread: each collection's
+// entries as listed, every sub-collection right after its own entry (pre-
+// order, like find). Paths are relative to the walked collection.
+//------------------------------------------------------------------------------
+class RecursiveWalker {
+public:
+  //----------------------------------------------------------------------------
+  // List the collection at "path" - relative to the walk's root, empty for
+  // the root itself - into "entries", by name. Runs on a worker thread;
+  // throws DavixException on error.
+  //----------------------------------------------------------------------------
+  typedef std::function<void (const std::string &path, std::deque<FileProperties> &entries)> ListFunction;
+
+  //----------------------------------------------------------------------------
+  // Called for every entry found, in order
+  //----------------------------------------------------------------------------
+  typedef std::function<void (const std::string &path, const StatInfo &info)> WalkFunction;
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  RecursiveWalker(Context &context, const ListFunction &list, size_t parallelism);
+
+  //----------------------------------------------------------------------------
+  // Destructor - waits for the listings in flight, if any
+  //----------------------------------------------------------------------------
+  ~RecursiveWalker();
+
+  RecursiveWalker(const RecursiveWalker &other) = delete;
+  RecursiveWalker& operator=(const RecursiveWalker &other) = delete;
+
+  //----------------------------------------------------------------------------
+  // Walk everything below the collections at "roots", in turn - the roots
+  // themselves are not reported. Throws the error of the first listing which
+  // failed, once the walk reaches it, or whatever "fn" throws.
+  //----------------------------------------------------------------------------
+  void walk(const std::vector<std::string> &roots, const WalkFunction &fn);
+
+  static const size_t kLookaheadFactor = 4;
+
+private:
+  struct Listing;
+  typedef std::shared_ptr<Listing> ListingPtr;
+
+  //----------------------------------------------------------------------------
+  // Start listings, if there is room for them. Call with _mtx held.
+  //----------------------------------------------------------------------------
+  void schedule();
+
+  //----------------------------------------------------------------------------
+  // Worker side: list a collection
+  //----------------------------------------------------------------------------
+  void list(ListingPtr listing);
+
+  Context &_context;
+  ListFunction _list;
+  size_t _parallelism;
+  size_t _lookahead;
+
+  std::mutex _mtx;
+  std::condition_variable _cv;
+
+  // collections found but not listed yet, next one first
+  std::deque<ListingPtr> _pending;
+
+  // collection the reader is waiting for, listed before anything else
+  ListingPtr _demanded;
+
+  size_t _inflight;
+  size_t _buffered;
+  bool _cancelled;
+};
+
+}
+
+#endif
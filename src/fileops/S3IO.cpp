@@ -21,8 +21,11 @@
 
 #include "S3IO.hpp"
 #include <core/ContentProvider.hpp>
+#include <fileops/PartUploader.hpp>
+#include <fileops/UploadManifest.hpp>
 #include <utils/davix_logger_internal.hpp>
 #include <xml/S3MultiPartInitiationParser.hpp>
+#include <xml/S3MultiPartListParser.hpp>
 
 #define SSTR(message) static_cast<std::ostringstream&>(std::ostringstream().flush() << message).str()
 
@@ -49,6 +52,20 @@ static bool should_use_s3_multipart(IOChainContext & context, dav_size_t size) {
   return size > (1024 * 1024 * 512); // 512 MB
 }
 
+// S3 refuses uploads made of more parts than this
+static const size_t S3_MAX_PARTS = 10000;
+
+static std::vector<std::string> partIds(const std::vector<UploadedPart> &parts) {
+  std::vector<std::string> ids;
+  ids.reserve(parts.size());
+
+  for(size_t i = 0; i < parts.size(); i++) {
+    ids.push_back(parts[i].id);
+  }
+
+  return ids;
+}
+
 S3IO::S3IO() {
 
 }
@@ -93,6 +110,63 @@ std::string S3IO::initiateMultipart(IOChainContext & iocontext, const Uri &url)
   return parser.getUploadId();
 }
 
+std::string S3IO::resumeMultipart(IOChainContext & iocontext, UploadManifest &manifest) {
+  const std::string uploadId = manifest.getUploadId();
+  std::map<size_t, S3MultiPartListParser::Part> listed;
+  std::string marker;
+
+  // ListParts answers are paginated, 1000 parts at a time
+  while(true) {
+    Uri url(iocontext._uri);
+    url.addQueryParam("uploadId", uploadId);
+    if(!marker.empty()) {
+      url.addQueryParam("part-number-marker", marker);
+    }
+
+    DavixError * tmp_err=NULL;
+    GetRequest req(iocontext._context, url, &tmp_err);
+    checkDavixError(&tmp_err);
+
+    req.setParameters(iocontext._reqparams);
+    req.executeRequest(&tmp_err);
+    if(!tmp_err && req.getRequestCode() == 404) {
+      // NoSuchUpload: aborted, or expired by a lifecycle rule
+      DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "S3IO: multi-part upload {} is gone, starting over", uploadId);
+      return std::string();
+    }
+
+    if(!tmp_err && httpcodeIsValid(req.getRequestCode()) == false) {
+      httpcodeToDavixError(req.getRequestCode(), davix_scope_io_buff(),
+        "write error: ", &tmp_err);
+    }
+    checkDavixError(&tmp_err);
+
+    S3MultiPartListParser parser;
+    if(parser.parseChunk(req.getAnswerContent()) != 0) {
+      DavixError::setupError(&tmp_err, "S3::MultiPart", StatusCode::InvalidServerResponse, "Unable to parse server response for multi-part listing");
+    }
+    checkDavixError(&tmp_err);
+
+    listed.insert(parser.getParts().begin(), parser.getParts().end());
+    if(!parser.isTruncated() || parser.getNextPartNumberMarker().empty() || parser.getNextPartNumberMarker() == marker) {
+      break;
+    }
+
+    marker = parser.getNextPartNumberMarker();
+  }
+
+  // the ETag of a part is its MD5 - except under SSE-C or SSE-KMS, where such
+  // parts are uploaded again
+  manifest.retainParts([&](size_t partNumber, const UploadedPart &part) {
+    std::map<size_t, S3MultiPartListParser::Part>::const_iterator it = listed.find(partNumber);
+    return it != listed.end() && it->second.first == part.id && it->second.second == part.size &&
+      UploadManifest::etagMatches(it->second.first, part.digest);
+  });
+
+  DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "S3IO: resuming multi-part upload {} for {}, {} parts done", uploadId, iocontext._uri, manifest.countParts());
+  return uploadId;
+}
+
 std::string S3IO::writeChunk(IOChainContext & iocontext, const char* buff, dav_size_t size, const std::string &uploadId, int partNumber) {
   Uri url(iocontext._uri);
   url.addQueryParam("uploadId", uploadId);
@@ -161,34 +235,6 @@ void S3IO::commitChunks(IOChainContext & iocontext,  const Uri &url, const std::
   checkDavixError(&tmp_err);
 }
 
-static dav_size_t fillBufferWithProviderData(std::vector<char> &buffer, const dav_size_t maxChunkSize, ContentProvider &provider) {
-    dav_size_t written = 0u;
-    dav_size_t remaining = maxChunkSize;
-
-    while(true) {
-      dav_ssize_t bytesRead = provider.pullBytes(buffer.data(), remaining);
-      if(bytesRead < 0) {
-        throw DavixException(davix_scope_io_buff(), StatusCode::InvalidFileHandle, fmt::format("Error when reading from callback: {}", bytesRead));
-      }
-
-      remaining -= bytesRead;
-      written += bytesRead;
-
-      if(bytesRead == 0) {
-        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Reached data provider EOF, received 0 bytes, even though asked for {}", remaining);
-        break; // EOF
-      }
-
-      if(remaining == 0) {
-        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Data provider buffer has been filled");
-        break; // buffer is full
-      }
-    }
-
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Retrieved {} bytes from data provider", written);
-    return written;
-}
-
 // write from a buffer
 bool S3IO::writeFromBuffer(IOChainContext& iocontext, const char* buff,
                            dav_size_t size, const std::string& uploadId,
@@ -203,30 +249,38 @@ dav_ssize_t S3IO::writeFromProvider(IOChainContext & iocontext, ContentProvider
     CHAIN_FORWARD(writeFromProvider(iocontext, provider));
   }
 
-  DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Initiating multi-part upload towards {} to upload file with size {}", iocontext._uri, provider.getSize());
-  std::string uploadId = initiateMultipart(iocontext);
+  std::unique_ptr<UploadManifest> manifest = UploadManifest::open(*iocontext._reqparams, iocontext._uri, provider);
+  std::string uploadId;
 
-  size_t remaining = provider.getSize();
-  const dav_size_t MAX_CHUNK_SIZE = 1024 * 1024 * 256; // 256 MB
+  if(manifest && manifest->resumable()) {
+    uploadId = resumeMultipart(iocontext, *manifest);
+    if(uploadId.empty()) {
+      manifest->reset();
+    }
+  }
 
-  std::vector<char> buffer;
-  buffer.resize(std::min(MAX_CHUNK_SIZE, (dav_size_t) provider.getSize()) + 10);
+  PartUploader uploader(iocontext._context, *iocontext._reqparams, provider.getSize(), S3_MAX_PARTS, manifest.get());
 
-  std::vector<std::string> etags;
+  if(uploadId.empty()) {
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Initiating multi-part upload towards {} to upload file with size {}", iocontext._uri, provider.getSize());
+    uploadId = initiateMultipart(iocontext);
 
-  size_t partNumber = 0;
-  while(remaining > 0) {
-    size_t toRead = std::min( (dav_size_t) provider.getSize(), MAX_CHUNK_SIZE);
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "S3IO write: toRead from cb {}", toRead);
+    if(manifest) {
+      manifest->start(uploadId, uploader.getPartSize());
+    }
+  }
 
-    dav_size_t bytesRead = fillBufferWithProviderData(buffer, MAX_CHUNK_SIZE, provider);
-    if(bytesRead == 0) break; // EOF
+  std::vector<UploadedPart> parts = uploader.upload(provider,
+    [&](const char *data, dav_size_t size, size_t partNumber, const std::string &digest) {
+      return writeChunk(iocontext, data, size, uploadId, partNumber);
+    });
 
-    partNumber++;
-    etags.emplace_back(writeChunk(iocontext, buffer.data(), bytesRead, uploadId, partNumber));
+  commitChunks(iocontext, uploadId, partIds(parts));
+
+  if(manifest) {
+    manifest->remove();
   }
 
-  commitChunks(iocontext, uploadId, etags);
   return provider.getSize();
 }
 
@@ -265,34 +319,22 @@ void S3IO::performUgrS3MultiPart(IOChainContext & iocontext, const std::string &
         Uri uri(posturl);
         std::string uploadId = initiateMultipart(iocontext, posturl);
 
-        const dav_size_t MAX_CHUNK_SIZE = 1024 * 1024 * 256; // 256 MB
-        std::vector<char> buffer;
-        buffer.resize(std::min(MAX_CHUNK_SIZE, (dav_size_t) provider.getSize()) + 10);
+        PartUploader uploader(iocontext._context, *iocontext._reqparams, provider.getSize(), S3_MAX_PARTS);
 
-        size_t nchunks = (provider.getSize() / MAX_CHUNK_SIZE) + 2;
+        size_t nchunks = (provider.getSize() / uploader.getPartSize()) + 2;
         DynafedUris uris = retrieveDynafedUris(iocontext, uploadId, pluginId, nchunks);
 
         if(uris.chunks.size() != nchunks) {
-          DAVIX_SLOG(DAVIX_LOG_WARNING, DAVIX_LOG_CHAIN, "Dynafed returned different number of URIs than expected: {} vs {]", "} retrieveDynafedUris: Obtained list with {} chunk URIs in total", uris.chunks.size(), nchunks);
+          DAVIX_SLOG(DAVIX_LOG_WARNING, DAVIX_LOG_CHAIN, "Dynafed returned different number of URIs than expected: {} vs {}", uris.chunks.size(), nchunks);
           throw DavixException("S3::MultiPart", StatusCode::InvalidServerResponse, "Dynafed returned different number of URIs than expected");
         }
 
-        std::vector<std::string> etags;
-        size_t partNumber = 1;
-        uint64_t remaining = provider.getSize();
-
-        while(remaining > 0) {
-          dav_size_t bytesRetrieved = fillBufferWithProviderData(buffer, MAX_CHUNK_SIZE, provider);
-          if(bytesRetrieved == 0) {
-            break; // EOF
-          }
-
-          etags.emplace_back(writeChunk(iocontext, buffer.data(), bytesRetrieved, Uri(uris.chunks[partNumber-1]), partNumber));
-          partNumber++;
-          remaining -= bytesRetrieved;
-        }
+        std::vector<UploadedPart> parts = uploader.upload(provider,
+          [&](const char *data, dav_size_t size, size_t partNumber, const std::string &digest) {
+            return writeChunk(iocontext, data, size, Uri(uris.chunks[partNumber-1]), partNumber);
+          });
 
-        commitChunks(iocontext, Uri(uris.post), etags);
+        commitChunks(iocontext, Uri(uris.post), partIds(parts));
     }
     CATCH_DAVIX(err);
 }
@@ -26,6 +26,8 @@
 
 namespace Davix{
 
+class UploadManifest;
+
 struct DynafedUris {
   std::vector<std::string> chunks;
   std::string post;
@@ -61,6 +63,10 @@ private:
   // Returns uploadId
   std::string initiateMultipart(IOChainContext & iocontext, const Uri &url);
 
+  // Check the parts recorded in the manifest against those the server holds,
+  // return the upload id to resume - empty if the upload is gone
+  std::string resumeMultipart(IOChainContext & iocontext, UploadManifest &manifest);
+
   DynafedUris retrieveDynafedUris(IOChainContext & iocontext, const std::string &uploadId, const std::string &pluginId, size_t nchunks);
 
   // Given the upload id, write the given chunk. Return object ETag,
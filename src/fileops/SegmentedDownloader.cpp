@@ -0,0 +1,598 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "SegmentedDownloader.hpp"
+#include <davix_internal.hpp>
+#include <davix_context_internal.hpp>
+#include <core/RetryPolicy.hpp>
+#include <core/WorkerPool.hpp>
+#include <utils/davix_logger_internal.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+namespace Davix {
+
+typedef std::chrono::steady_clock SteadyClock;
+
+// a source failing this many times in a row is dropped, if there are others
+static const size_t kMaxConsecutiveFailures = 2;
+
+// a source needs to be this much faster than another one to take over the
+// tail of its range
+static const double kStealFactor = 1.5;
+
+// a range which got no data at all for that long is considered stalled
+static const double kStallSeconds = 1.0;
+
+//------------------------------------------------------------------------------
+// Write all of "data" to "fd" at "offset"
+//------------------------------------------------------------------------------
+static void writeAt(int fd, const char *data, dav_size_t size, dav_off_t offset) {
+  dav_size_t done = 0;
+
+  while(done < size) {
+    ssize_t ret = ::pwrite(fd, data + done, size - done, offset + done);
+    if(ret < 0 && errno == EINTR) {
+      continue;
+    }
+
+    if(ret <= 0) {
+      throw DavixException(davix_scope_io_buff(), StatusCode::SystemError,
+        fmt::format("Unable to write {} bytes at offset {} of the destination: {}", size - done, offset + done, ret < 0 ? strerror(errno) : "no progress"));
+    }
+
+    done += ret;
+  }
+}
+
+namespace {
+
+//------------------------------------------------------------------------------
+// A range left to fetch
+//------------------------------------------------------------------------------
+struct Range {
+  Range() : offset(0), end(0), attempts(0) {}
+  Range(dav_off_t o, dav_off_t e, int a) : offset(o), end(e), attempts(a) {}
+
+  dav_off_t offset;
+  dav_off_t end;
+  int attempts;
+};
+
+//------------------------------------------------------------------------------
+// A lane, and the range it is fetching. Data up to "pos" is stored, up to
+// "reserved" it is being stored; "end" may move back when another lane takes
+// over the tail of the range - "abandoned" once another lane took all of it.
+// "cancelled" is raised once nothing is left for the fetch in flight, to let
+// it give up early.
+//------------------------------------------------------------------------------
+struct Lane {
+  Lane() : source(0), claimed(false), active(false), abandoned(false), pos(0), reserved(0), end(0), attempts(0), bytes(0), cancelled(false) {}
+
+  size_t source;
+  bool claimed;
+  bool active;
+  bool abandoned;
+  dav_off_t pos;
+  dav_off_t reserved;
+  dav_off_t end;
+  int attempts;
+  dav_size_t bytes;
+  SteadyClock::time_point started;
+  std::atomic<bool> cancelled;
+
+  double elapsed() const {
+    return std::chrono::duration<double>(SteadyClock::now() - started).count();
+  }
+};
+
+//------------------------------------------------------------------------------
+// Shared state of a single download. Shared by the caller and the lanes, it
+// outlives the caller if needed: the download is over once every byte is
+// stored, even if a stalled fetch whose range was taken over entirely is
+// still waiting for data.
+//------------------------------------------------------------------------------
+class StripedTransfer {
+public:
+  StripedTransfer(size_t nsources, size_t nlanes, dav_size_t total, dav_size_t minSteal, int retries,
+    std::chrono::milliseconds backoffBase, std::chrono::milliseconds backoffMax,
+    const SegmentedDownloader::StoreFunction &store, const SegmentedDownloader::FetchFunction &fetch)
+  : _sources(nsources), _consecutive(nsources, 0), _lanes(nlanes), _exited(0), _total(total), _stored(0), _minSteal(minSteal),
+    _retries(retries), _backoffBase(backoffBase), _backoffMax(backoffMax), _store(store), _fetch(fetch), _failed(false) {
+
+    for(size_t i = 0; i < _lanes.size(); i++) {
+      _lanes[i].source = i % _sources.size();
+    }
+  }
+
+  void queue(const Range &range) {
+    _queue.push_back(range);
+  }
+
+  //----------------------------------------------------------------------------
+  // Lane main: fetch ranges until there's none left - unless the lane was
+  // already picked up by another thread
+  //----------------------------------------------------------------------------
+  void run(size_t l) {
+    Lane &lane = _lanes[l];
+
+    {
+      std::lock_guard<std::mutex> lock(_mtx);
+      if(lane.claimed) {
+        return;
+      }
+      lane.claimed = true;
+    }
+
+    try {
+      fetchRanges(lane);
+    }
+    catch(...) {
+      std::lock_guard<std::mutex> lock(_mtx);
+      fail(std::current_exception());
+    }
+
+    std::lock_guard<std::mutex> lock(_mtx);
+    _exited++;
+    _cv.notify_all();
+  }
+
+  //----------------------------------------------------------------------------
+  // Wait until every byte is stored, or the download failed, then get the
+  // statistics of each source and throw the first error, if any. Lanes no
+  // worker picked up are run on the calling thread.
+  //----------------------------------------------------------------------------
+  void wait(std::vector<SourceStats> &sources) {
+    std::unique_lock<std::mutex> lock(_mtx);
+
+    while(!done()) {
+      _cv.wait_for(lock, std::chrono::milliseconds(50));
+      if(done()) {
+        break;
+      }
+
+      // no worker was free to run it
+      for(size_t i = 0; i < _lanes.size(); i++) {
+        if(!_lanes[i].claimed) {
+          lock.unlock();
+          run(i);
+          lock.lock();
+          break;
+        }
+      }
+    }
+
+    // fetches still in flight count as far as they got
+    sources = _sources;
+    for(size_t i = 0; i < _lanes.size(); i++) {
+      if(_lanes[i].active) {
+        sources[_lanes[i].source].bytes += _lanes[i].bytes;
+        sources[_lanes[i].source].seconds += _lanes[i].elapsed();
+      }
+    }
+
+    if(_error) {
+      std::rethrow_exception(_error);
+    }
+
+    if(_stored < _total) {
+      throw DavixException(davix_scope_io_buff(), StatusCode::ConnectionProblem,
+        fmt::format("Download ended after {} bytes out of {}", _stored, _total));
+    }
+  }
+
+private:
+  //----------------------------------------------------------------------------
+  // Fetch ranges until there's none left
+  //----------------------------------------------------------------------------
+  void fetchRanges(Lane &lane) {
+    SegmentedDownloader::WriteFunction write = [this, &lane](const char *data, dav_size_t size) {
+      return this->write(lane, data, size);
+    };
+
+    Range range;
+    while(next(lane, range)) {
+      bool retryable = true;
+      std::exception_ptr error;
+
+      try {
+        _fetch(lane.source, range.offset, range.end - range.offset, write, lane.cancelled);
+      }
+      catch(DavixException &e) {
+        error = std::current_exception();
+        retryable = (e.code() != StatusCode::OperationNonSupported && e.code() != StatusCode::SystemError);
+      }
+      catch(...) {
+        error = std::current_exception();
+        retryable = false;
+      }
+
+      if(!finish(lane, error, retryable)) {
+        backoff(lane);
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Wait before fetching another range after a failure, unless the download
+  // failed altogether
+  //----------------------------------------------------------------------------
+  void backoff(const Lane &lane) {
+    {
+      std::lock_guard<std::mutex> lock(_mtx);
+      if(_failed) {
+        return;
+      }
+    }
+
+    std::this_thread::sleep_for(backoffDelay(lane.attempts, _backoffBase, _backoffMax));
+  }
+
+  //----------------------------------------------------------------------------
+  // Whether the caller can go: everything stored, or failed, and no fetch in
+  // flight but those abandoned to another source. Call with _mtx held.
+  //----------------------------------------------------------------------------
+  bool done() const {
+    if(_exited == _lanes.size()) {
+      return true;
+    }
+
+    if(!_failed && _stored < _total) {
+      return false;
+    }
+
+    for(size_t i = 0; i < _lanes.size(); i++) {
+      const Lane &lane = _lanes[i];
+      if(lane.active && (!lane.abandoned || lane.pos < lane.reserved)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the next range for a lane, waiting while others may still need help
+  //----------------------------------------------------------------------------
+  bool next(Lane &lane, Range &range) {
+    std::unique_lock<std::mutex> lock(_mtx);
+
+    while(true) {
+      if(_failed || _stored >= _total || !_sources[lane.source].healthy) {
+        return false;
+      }
+
+      if(!_queue.empty()) {
+        range = _queue.front();
+        _queue.pop_front();
+        break;
+      }
+
+      if(steal(lane, range)) {
+        break;
+      }
+
+      // failed ranges of the others come back to the queue - lanes with
+      // nothing left won't give any back
+      bool busy = false;
+      for(size_t i = 0; i < _lanes.size(); i++) {
+        busy |= (_lanes[i].active && _lanes[i].pos < _lanes[i].end);
+      }
+
+      if(!busy) {
+        return false;
+      }
+
+      _cv.wait_for(lock, std::chrono::milliseconds(50));
+    }
+
+    lane.active = true;
+    lane.abandoned = false;
+    lane.cancelled = false;
+    lane.pos = lane.reserved = range.offset;
+    lane.end = range.end;
+    lane.attempts = range.attempts;
+    lane.bytes = 0;
+    lane.started = SteadyClock::now();
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Store data of a lane, return false once its range is complete
+  //----------------------------------------------------------------------------
+  bool write(Lane &lane, const char *data, dav_size_t size) {
+    dav_off_t offset;
+
+    {
+      std::lock_guard<std::mutex> lock(_mtx);
+      if(_failed || lane.reserved >= lane.end) {
+        return false;
+      }
+
+      offset = lane.reserved;
+      size = std::min<dav_size_t>(size, lane.end - offset);
+      lane.reserved = offset + size;
+    }
+
+    // ranges of lanes never overlap
+    _store(data, size, offset);
+
+    std::lock_guard<std::mutex> lock(_mtx);
+    lane.pos = offset + size;
+    lane.bytes += size;
+    _stored += size;
+
+    if(_stored >= _total) {
+      cancelAll();
+    }
+    else if(lane.pos >= lane.end) {
+      _cv.notify_all();
+    }
+
+    return lane.pos < lane.end;
+  }
+
+  //----------------------------------------------------------------------------
+  // Account for a finished fetch, queue again whatever it left. Returns true
+  // if the range is complete.
+  //----------------------------------------------------------------------------
+  bool finish(Lane &lane, std::exception_ptr error, bool retryable) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    SourceStats &source = _sources[lane.source];
+
+    source.bytes += lane.bytes;
+    source.seconds += lane.elapsed();
+    lane.active = false;
+    _cv.notify_all();
+
+    // nothing was left to it, however it ended
+    if(lane.abandoned) {
+      return true;
+    }
+
+    if(!error && lane.pos >= lane.end) {
+      source.ranges++;
+      _consecutive[lane.source] = 0;
+      return true;
+    }
+
+    if(!error) {
+      error = std::make_exception_ptr(DavixException(davix_scope_io_buff(), StatusCode::ConnectionProblem,
+        fmt::format("Range {}-{} ended after {} bytes", lane.pos - lane.bytes, lane.end, lane.bytes)));
+    }
+
+    source.failures++;
+    _consecutive[lane.source]++;
+
+    if(!retryable || lane.attempts >= _retries) {
+      fail(error);
+      return false;
+    }
+
+    DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Range at offset {} of source {} failed after {} bytes, queueing the {} bytes left again",
+      lane.pos - lane.bytes, lane.source, lane.bytes, lane.end - lane.pos);
+    _queue.push_front(Range(lane.pos, lane.end, lane.attempts + 1));
+
+    if(_sources.size() > 1 && _consecutive[lane.source] >= kMaxConsecutiveFailures) {
+      DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Source {} failed {} times in a row, not using it anymore", lane.source, _consecutive[lane.source]);
+      source.healthy = false;
+
+      bool healthy = false;
+      for(size_t i = 0; i < _sources.size(); i++) {
+        healthy |= _sources[i].healthy;
+      }
+
+      if(!healthy) {
+        fail(error);
+      }
+    }
+
+    return false;
+  }
+
+  //----------------------------------------------------------------------------
+  // Abort the download. Call with _mtx held.
+  //----------------------------------------------------------------------------
+  void fail(std::exception_ptr error) {
+    if(!_failed) {
+      _failed = true;
+      _error = error;
+      cancelAll();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Nothing left to fetch for anyone. Call with _mtx held.
+  //----------------------------------------------------------------------------
+  void cancelAll() {
+    for(size_t i = 0; i < _lanes.size(); i++) {
+      _lanes[i].cancelled = true;
+    }
+    _cv.notify_all();
+  }
+
+  //----------------------------------------------------------------------------
+  // Throughput of a source so far, fetches in flight included. Call with _mtx
+  // held.
+  //----------------------------------------------------------------------------
+  double throughput(size_t source) const {
+    double bytes = _sources[source].bytes;
+    double seconds = _sources[source].seconds;
+
+    for(size_t i = 0; i < _lanes.size(); i++) {
+      if(_lanes[i].active && _lanes[i].source == source) {
+        bytes += _lanes[i].bytes;
+        seconds += _lanes[i].elapsed();
+      }
+    }
+
+    return seconds > 0 ? bytes / seconds : 0;
+  }
+
+  //----------------------------------------------------------------------------
+  // Take over the tail of the range of a slower source, the one expected to
+  // finish last. Call with _mtx held.
+  //----------------------------------------------------------------------------
+  bool steal(Lane &lane, Range &range) {
+    if(_sources.size() < 2) {
+      return false;
+    }
+
+    const double mine = throughput(lane.source);
+    if(mine <= 0) {
+      return false;
+    }
+
+    Lane *victim = NULL;
+    double victimRate = 0;
+    double latest = 0;
+
+    for(size_t i = 0; i < _lanes.size(); i++) {
+      Lane &other = _lanes[i];
+      if(!other.active || other.source == lane.source || other.end - other.reserved < (dav_off_t) (2 * _minSteal)) {
+        continue;
+      }
+
+      double theirs = throughput(other.source);
+      if(theirs == 0 && other.elapsed() < kStallSeconds) {
+        continue;
+      }
+
+      if(mine < theirs * kStealFactor) {
+        continue;
+      }
+
+      double eta = (theirs > 0) ? (other.end - other.reserved) / theirs : std::numeric_limits<double>::infinity();
+      if(eta > latest) {
+        latest = eta;
+        victim = &other;
+        victimRate = theirs;
+      }
+    }
+
+    if(victim == NULL) {
+      return false;
+    }
+
+    // split what's left so that both should be done at the same time
+    const dav_off_t left = victim->end - victim->reserved;
+    const dav_off_t taken = std::max<dav_off_t>(left * (mine / (mine + victimRate)), _minSteal);
+
+    range = Range(victim->end - taken, victim->end, 0);
+    victim->end = range.offset;
+    _sources[victim->source].stolen++;
+
+    // all of it: the victim's fetch isn't needed anymore, and nobody waits
+    // for it
+    if(victim->reserved >= victim->end) {
+      victim->abandoned = true;
+      victim->cancelled = true;
+    }
+
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Source {} ({} B/s) takes over {} bytes at offset {} from source {} ({} B/s)",
+      lane.source, (uint64_t) mine, taken, range.offset, victim->source, (uint64_t) victimRate);
+    return true;
+  }
+
+  std::mutex _mtx;
+  std::condition_variable _cv;
+
+  std::vector<SourceStats> _sources;
+  std::vector<size_t> _consecutive;
+  std::vector<Lane> _lanes;
+  std::deque<Range> _queue;
+  size_t _exited;
+
+  const dav_size_t _total;
+  dav_size_t _stored;
+  const dav_size_t _minSteal;
+  const int _retries;
+  const std::chrono::milliseconds _backoffBase;
+  const std::chrono::milliseconds _backoffMax;
+  const SegmentedDownloader::StoreFunction _store;
+  const SegmentedDownloader::FetchFunction _fetch;
+
+  bool _failed;
+  std::exception_ptr _error;
+};
+
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+SegmentedDownloader::SegmentedDownloader(Context &context, const RequestParams &params, size_t nsources)
+: _context(context), _segmentSize(params.getDownloadSegmentSize()), _parallelism(params.getDownloadParallelism()),
+  _retries(params.getOperationRetry()), _backoffBase(backoffBase(params)),
+  _backoffMax(params.getRetryBackoffMax()), _sources(std::max<size_t>(nsources, 1)) {
+
+  if(_segmentSize == 0) {
+    _segmentSize = 1;
+  }
+
+  // at least one lane per source
+  _parallelism = std::max(_parallelism, _sources.size());
+}
+
+//------------------------------------------------------------------------------
+// Download a range of the data, segment by segment
+//------------------------------------------------------------------------------
+dav_size_t SegmentedDownloader::download(dav_off_t offset, dav_size_t size, const StoreFunction &store, const FetchFunction &fetch) {
+  std::shared_ptr<StripedTransfer> transfer = std::make_shared<StripedTransfer>(_sources.size(), _parallelism, size,
+    std::max<dav_size_t>(_segmentSize / 8, 1), _retries, _backoffBase, _backoffMax, store, fetch);
+
+  size_t nsegments = 0;
+  for(dav_size_t done = 0; done < size; done += _segmentSize) {
+    transfer->queue(Range(offset + done, offset + std::min(done + _segmentSize, size), 0));
+    nsegments++;
+  }
+
+  DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Downloading {} bytes at offset {} from {} sources in {} segments of {} bytes, {} in parallel",
+    size, offset, _sources.size(), nsegments, _segmentSize, _parallelism);
+
+  // lanes hold on to the transfer: a stalled one may finish after we return
+  WorkerPool &pool = ContextExplorer::WorkerPoolFromContext(_context);
+  for(size_t i = 0; i < _parallelism; i++) {
+    pool.submit([transfer, i]() { transfer->run(i); });
+  }
+
+  transfer->wait(_sources);
+  return size;
+}
+
+//------------------------------------------------------------------------------
+// Download into a file
+//------------------------------------------------------------------------------
+dav_size_t SegmentedDownloader::download(int fd, dav_off_t base, dav_size_t size, const FetchFunction &fetch) {
+  return download(0, size, [&](const char *data, dav_size_t n, dav_off_t offset) {
+    writeAt(fd, data, n, base + offset);
+  }, fetch);
+}
+
+}
@@ -0,0 +1,147 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef DAVIX_FILEOPS_SEGMENTED_DOWNLOADER_HPP
+#define DAVIX_FILEOPS_SEGMENTED_DOWNLOADER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <vector>
+#include <utils/davix_types.hpp>
+
+namespace Davix {
+
+class Context;
+class RequestParams;
+
+//------------------------------------------------------------------------------
+// What a SegmentedDownloader got out of one of its sources
+//------------------------------------------------------------------------------
+struct SourceStats {
+  SourceStats() : bytes(0), seconds(0), ranges(0), stolen(0), failures(0), healthy(true) {}
+
+  // bytes received, and time spent receiving them
+  dav_size_t bytes;
+  double seconds;
+  // ranges fetched, ranges whose tail was handed to a faster source, and
+  // failed fetches
+  size_t ranges;
+  size_t stolen;
+  size_t failures;
+  // false once dropped after failing repeatedly
+  bool healthy;
+
+  // observed throughput in bytes per second, 0 if unknown yet
+  double throughput() const {
+    return seconds > 0 ? bytes / seconds : 0;
+  }
+};
+
+//------------------------------------------------------------------------------
+// Segmented download, from one or several sources of the same data - such as
+// the replicas of a Metalink.
+//
+// The data is split into segments of a fixed size, queued, and fetched by
+// "parallelism" lanes on the Context's worker pool, the calling thread
+// included - at least one per source, lanes spread evenly across sources.
+// Lanes take the next segment whenever they are done with one, so a faster
+// source ends up with a larger share. Data is stored at its offset as it
+// arrives, no buffering beyond that.
+//
+// A segment which fails is queued again from its first byte not stored yet.
+// With several sources, a source failing repeatedly is dropped; once the queue
+// is empty, lanes of a source faster than another one still fetching take
+// over the tail of its range, in proportion to their throughput - all of it,
+// if the other one stalled. A fetch whose whole range was taken over is
+// cancelled, and the download doesn't wait for it to end.
+//------------------------------------------------------------------------------
+class SegmentedDownloader {
+public:
+  //----------------------------------------------------------------------------
+  // Take the next bytes of the range being fetched, in order. Returns false
+  // once the rest isn't needed anymore: the fetch should then stop.
+  //----------------------------------------------------------------------------
+  typedef std::function<bool (const char *data, dav_size_t size)> WriteFunction;
+
+  //----------------------------------------------------------------------------
+  // Fetch "size" bytes at "offset" of "source", passing them to "write" as
+  // they arrive. Called concurrently from several threads; throws
+  // DavixException on error - OperationNonSupported if the source can't be
+  // fetched by range at all, which is not retried.
+  //
+  // Once "cancelled" is raised, nothing is left to fetch: the fetch should
+  // give up as soon as it can. It may then still be running after download()
+  // returned, so it must not touch anything of the caller's once "write"
+  // returned false, nor after "cancelled" is raised.
+  //----------------------------------------------------------------------------
+  typedef std::function<void (size_t source, dav_off_t offset, dav_size_t size, const WriteFunction &write,
+    const std::atomic<bool> &cancelled)> FetchFunction;
+
+  //----------------------------------------------------------------------------
+  // Store "size" bytes at "offset" of the data. Called concurrently, for
+  // disjoint ranges.
+  //----------------------------------------------------------------------------
+  typedef std::function<void (const char *data, dav_size_t size, dav_off_t offset)> StoreFunction;
+
+  //----------------------------------------------------------------------------
+  // Constructor. Segment size, parallelism and retries are taken from
+  // "params".
+  //----------------------------------------------------------------------------
+  SegmentedDownloader(Context &context, const RequestParams &params, size_t nsources = 1);
+
+  dav_size_t getSegmentSize() const {
+    return _segmentSize;
+  }
+
+  //----------------------------------------------------------------------------
+  // Download the "size" bytes at "offset" of the data. Returns the number of
+  // bytes stored. On failure, data being stored is waited for, then the
+  // first error is thrown.
+  //----------------------------------------------------------------------------
+  dav_size_t download(dav_off_t offset, dav_size_t size, const StoreFunction &store, const FetchFunction &fetch);
+
+  //----------------------------------------------------------------------------
+  // Download the first "size" bytes of the data into "fd", byte i at offset
+  // base + i
+  //----------------------------------------------------------------------------
+  dav_size_t download(int fd, dav_off_t base, dav_size_t size, const FetchFunction &fetch);
+
+  //----------------------------------------------------------------------------
+  // Per-source statistics of the last download
+  //----------------------------------------------------------------------------
+  const std::vector<SourceStats>& getSourceStats() const {
+    return _sources;
+  }
+
+private:
+  Context &_context;
+  dav_size_t _segmentSize;
+  size_t _parallelism;
+  int _retries;
+  std::chrono::milliseconds _backoffBase;
+  std::chrono::milliseconds _backoffMax;
+  std::vector<SourceStats> _sources;
+};
+
+}
+
+#endif
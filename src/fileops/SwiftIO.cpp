@@ -20,7 +20,11 @@
 */
 
 #include "SwiftIO.hpp"
+#include <davix_context_internal.hpp>
 #include <core/ContentProvider.hpp>
+#include <core/WorkerPool.hpp>
+#include <fileops/PartUploader.hpp>
+#include <fileops/UploadManifest.hpp>
 #include <utils/davix_logger_internal.hpp>
 #include <utils/davix_swift_utils.hpp>
 
@@ -56,34 +60,6 @@ SwiftIO::~SwiftIO() {
 
 }
 
-static dav_size_t fillBufferWithProviderData(std::vector<char> &buffer, const dav_size_t maxChunkSize, ContentProvider &provider) {
-    dav_size_t written = 0u;
-    dav_size_t remaining = maxChunkSize;
-
-    while(true) {
-        dav_ssize_t bytesRead = provider.pullBytes(buffer.data(), remaining);
-        if(bytesRead < 0) {
-            throw DavixException(davix_scope_io_buff(), StatusCode::InvalidFileHandle, fmt::format("Error when reading from callback: {}", bytesRead));
-        }
-
-        remaining -= bytesRead;
-        written += bytesRead;
-
-        if(bytesRead == 0) {
-            DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Reached data provider EOF, received 0 bytes, even though asked for {}", remaining);
-            break; // EOF
-        }
-
-        if(remaining == 0) {
-            DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Data provider buffer has been filled");
-            break; // buffer is full
-        }
-    }
-
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Retrieved {} bytes from data provider", written);
-    return written;
-}
-
 std::string SwiftIO::writeChunk(IOChainContext &iocontext, const char *buff, dav_size_t size, int partNumber) {
     Uri url(iocontext._uri);
     url.setPath(url.getPath() + "/" + std::to_string(partNumber));
@@ -113,6 +89,53 @@ std::string SwiftIO::writeChunk(IOChainContext &iocontext, const char *buff, dav
     return etag;
 }
 
+static std::string unquote(const std::string &etag) {
+    if(etag.size() >= 2 && etag[0] == '"' && etag[etag.size()-1] == '"') {
+        return etag.substr(1, etag.size() - 2);
+    }
+    return etag;
+}
+
+void SwiftIO::resumeSegments(IOChainContext &iocontext, UploadManifest &manifest, dav_size_t size) {
+    // segments are plain objects: ask for each of them
+    const size_t nparts = size / manifest.getPartSize() + 1;
+    std::vector<char> present(nparts + 1, 0);
+
+    ContextExplorer::WorkerPoolFromContext(iocontext._context).forEach(nparts, iocontext._reqparams->getUploadParallelism(), [&](size_t i) {
+        UploadedPart part;
+        if(!manifest.getPart(i + 1, part)) {
+            return;
+        }
+
+        Uri url(iocontext._uri);
+        url.setPath(url.getPath() + "/" + std::to_string(i + 1));
+
+        DavixError * tmp_err=NULL;
+        HeadRequest req(iocontext._context, url, &tmp_err);
+        if(tmp_err) {
+            DavixError::clearError(&tmp_err);
+            return;
+        }
+
+        req.setParameters(iocontext._reqparams);
+        req.executeRequest(&tmp_err);
+
+        std::string etag;
+        if(!tmp_err && httpcodeIsValid(req.getRequestCode()) && req.getAnswerHeader("Etag", etag) &&
+           unquote(etag) == unquote(part.id) && UploadManifest::etagMatches(etag, part.digest) &&
+           req.getAnswerSize() == (dav_ssize_t) part.size) {
+            present[i + 1] = 1;
+        }
+        DavixError::clearError(&tmp_err);
+    });
+
+    manifest.retainParts([&](size_t partNumber, const UploadedPart &part) {
+        return partNumber < present.size() && present[partNumber];
+    });
+
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Resuming large file upload towards {}, {} segments done", iocontext._uri, manifest.countParts());
+}
+
 void SwiftIO::commitInlineChunks(IOChainContext & iocontext, const std::vector<Prop> &props, const size_t MaxManifestSegments){
     Uri url(iocontext._uri);
 
@@ -217,26 +240,28 @@ dav_ssize_t SwiftIO::writeFromProvider(IOChainContext & iocontext, ContentProvid
 
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Initiating large file upload towards {} to upload file with size {}", iocontext._uri, provider.getSize());
 
-    size_t remaining = provider.getSize();
-    const dav_size_t MAX_CHUNK_SIZE = 1024 * 1024 * 256; // 256 MB
     const size_t MAX_MANIFEST_SEGMENTS = 1000;
 
-    std::vector<char> buffer;
-    buffer.resize(std::min(MAX_CHUNK_SIZE, (dav_size_t) provider.getSize()) + 10);
-
-    std::vector<Prop> props;
-
-    size_t partNumber = 0;
+    // there is no upload id, segments are just objects named after the parts
+    std::unique_ptr<UploadManifest> manifest = UploadManifest::open(*iocontext._reqparams, iocontext._uri, provider);
+    if(manifest && manifest->resumable()) {
+        resumeSegments(iocontext, *manifest, provider.getSize());
+    }
 
-    while(remaining > 0) {
-        size_t toRead = std::min( (dav_size_t) provider.getSize(), MAX_CHUNK_SIZE);
-        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "SwiftIO write: toRead from cb {}", toRead);
+    PartUploader uploader(iocontext._context, *iocontext._reqparams, provider.getSize(), 0, manifest.get());
+    if(manifest && !manifest->resumable()) {
+        manifest->start("", uploader.getPartSize());
+    }
 
-        dav_size_t bytesRead = fillBufferWithProviderData(buffer, MAX_CHUNK_SIZE, provider);
-        if(bytesRead == 0) break; // EOF
+    std::vector<UploadedPart> parts = uploader.upload(provider,
+        [&](const char *data, dav_size_t size, size_t partNumber, const std::string &digest) {
+            return writeChunk(iocontext, data, size, partNumber);
+        });
 
-        partNumber++;
-        props.emplace_back(writeChunk(iocontext, buffer.data(), bytesRead, partNumber), bytesRead);
+    std::vector<Prop> props;
+    props.reserve(parts.size());
+    for(size_t i = 0; i < parts.size(); i++) {
+        props.emplace_back(parts[i].id, parts[i].size);
     }
 
     if(props.size() > MAX_MANIFEST_SEGMENTS){ // if segment number is larger than max_manifest_segments (by default 1000), use inline segments
@@ -244,6 +269,10 @@ dav_ssize_t SwiftIO::writeFromProvider(IOChainContext & iocontext, ContentProvid
     } else{
         commitChunks(iocontext, props);
     }
+
+    if(manifest) {
+        manifest->remove();
+    }
     return provider.getSize();
 }
 
@@ -26,6 +26,8 @@
 
 namespace Davix{
 
+class UploadManifest;
+
 typedef std::pair <std::string, int> Prop;
 
 class SwiftIO : public HttpIOChain {
@@ -47,6 +49,9 @@ private:
     void commitChunks(IOChainContext & iocontext, const std::vector<Prop> &props);
     // Commit chunks in a inline manner if the number of segments has exceeded the limit defined by max_manifest_segments
     void commitInlineChunks(IOChainContext & iocontext, const std::vector<Prop> &props, const size_t MaxManifestSegments);
+
+    // Check the segments recorded in the manifest against those on the server
+    void resumeSegments(IOChainContext & iocontext, UploadManifest &manifest, dav_size_t size);
 };
 
 }
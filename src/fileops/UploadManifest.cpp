@@ -0,0 +1,356 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "UploadManifest.hpp"
+#include <davix_internal.hpp>
+#include <core/ContentProvider.hpp>
+#include <utils/davix_logger_internal.hpp>
+#include <utils/davix_s3_utils.hpp>
+
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <openssl/evp.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Davix {
+
+// version 1 had neither source nor part digests: such manifests are ignored
+static const std::string kManifestVersion = "davix-upload-manifest 2";
+
+// size of an MD5 digest, in bytes
+static const dav_size_t kDigestSize = 16;
+
+static std::string UploadManifest_scope() {
+  return "Davix::UploadManifest";
+}
+
+//------------------------------------------------------------------------------
+// The object an upload is for - the query is left out, as it may hold
+// credentials which change from one attempt to the next
+//------------------------------------------------------------------------------
+static std::string objectName(const Uri &uri) {
+  return fmt::format("{}://{}:{}{}", uri.getProtocol(), uri.getHost(), uri.getPort(), uri.getPath());
+}
+
+//------------------------------------------------------------------------------
+// Open the manifest configured in params, if any
+//------------------------------------------------------------------------------
+std::unique_ptr<UploadManifest> UploadManifest::open(const RequestParams &params, const Uri &uri, ContentProvider &provider) {
+  if(params.getUploadManifest().empty()) {
+    return std::unique_ptr<UploadManifest>();
+  }
+
+  return std::unique_ptr<UploadManifest>(new UploadManifest(params.getUploadManifest(), uri, provider.getSize(), sourceIdentity(provider)));
+}
+
+//------------------------------------------------------------------------------
+// Identity of the file behind provider
+//------------------------------------------------------------------------------
+std::string UploadManifest::sourceIdentity(ContentProvider &provider) {
+  FdContentProvider *fdProvider = dynamic_cast<FdContentProvider*>(&provider);
+  struct stat st;
+
+  if(fdProvider == NULL || !fdProvider->ok() || fstat(fdProvider->getFd(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    return std::string();
+  }
+
+  return fmt::format("{}:{}:{}.{:09}:{}", (unsigned long long) st.st_dev, (unsigned long long) st.st_ino,
+    (long long) st.st_mtim.tv_sec, (long) st.st_mtim.tv_nsec, (long long) fdProvider->getOffset());
+}
+
+//------------------------------------------------------------------------------
+// Hex MD5 of a part
+//------------------------------------------------------------------------------
+std::string UploadManifest::digest(const char *data, dav_size_t size) {
+  unsigned char md[EVP_MAX_MD_SIZE];
+  unsigned int length = 0;
+
+  if(EVP_Digest(data, size, md, &length, EVP_md5(), NULL) != 1 || length != kDigestSize) {
+    throw DavixException(UploadManifest_scope(), StatusCode::SystemError, "Unable to compute the MD5 of a part");
+  }
+
+  return S3::hexPrinter(md, length);
+}
+
+//------------------------------------------------------------------------------
+// Whether a server ETag agrees with a part digest
+//------------------------------------------------------------------------------
+bool UploadManifest::etagMatches(const std::string &etag, const std::string &digest) {
+  std::string value = etag;
+  if(value.size() >= 2 && value[0] == '"' && value[value.size()-1] == '"') {
+    value = value.substr(1, value.size() - 2);
+  }
+
+  if(value.size() != 2 * kDigestSize) {
+    return true;
+  }
+
+  for(size_t i = 0; i < value.size(); i++) {
+    if(!isxdigit((unsigned char) value[i])) {
+      return true;
+    }
+
+    value[i] = tolower((unsigned char) value[i]);
+  }
+
+  return value == digest;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+UploadManifest::UploadManifest(const std::string &path, const Uri &uri, dav_size_t size, const std::string &source)
+: _path(path), _object(objectName(uri)), _size(size), _source(source), _resumable(false), _partSize(0), _file(NULL) {
+  load();
+}
+
+UploadManifest::~UploadManifest() {
+  if(_file) {
+    fclose(_file);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Load an earlier upload of the same object, if the manifest holds one
+//------------------------------------------------------------------------------
+void UploadManifest::load() {
+  std::ifstream in(_path.c_str());
+  if(!in) {
+    return;
+  }
+
+  std::string line;
+  if(!std::getline(in, line) || line != kManifestVersion) {
+    DAVIX_SLOG(DAVIX_LOG_WARNING, DAVIX_LOG_CHAIN, "Ignoring upload manifest {}: unknown format", _path);
+    return;
+  }
+
+  std::string object, source;
+  dav_size_t size = 0;
+  bool complete = false;
+
+  while(std::getline(in, line)) {
+    if(in.eof()) {
+      break; // no newline: cut short by a crash
+    }
+
+    std::istringstream ss(line);
+    std::string key;
+    ss >> key;
+
+    if(key == "object") {
+      std::getline(ss >> std::ws, object);
+    }
+    else if(key == "size") {
+      ss >> size;
+    }
+    else if(key == "source") {
+      std::getline(ss >> std::ws, source);
+    }
+    else if(key == "partsize") {
+      ss >> _partSize;
+    }
+    else if(key == "uploadid") {
+      std::getline(ss >> std::ws, _uploadId);
+      complete = true;
+    }
+    else if(key == "part") {
+      size_t partNumber = 0;
+      UploadedPart part;
+      ss >> partNumber >> part.size >> part.digest;
+      std::getline(ss >> std::ws, part.id);
+
+      if(part.digest == "-") {
+        part.digest.clear();
+      }
+
+      if(!ss.fail() && partNumber != 0 && !part.id.empty()) {
+        _parts[partNumber] = part;
+      }
+    }
+  }
+
+  if(!complete || object != _object || size != _size || _partSize == 0) {
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Upload manifest {} is not about {} bytes to {}, starting over", _path, _size, _object);
+    reset();
+    return;
+  }
+
+  if(source != _source) {
+    DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Upload manifest {}: the source of {} changed since the upload started, starting over", _path, _object);
+    reset();
+    return;
+  }
+
+  _resumable = true;
+  DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Upload manifest {}: resuming upload {} of {}, {} parts done", _path, _uploadId, _object, _parts.size());
+}
+
+//------------------------------------------------------------------------------
+// Get a completed part
+//------------------------------------------------------------------------------
+bool UploadManifest::getPart(size_t partNumber, UploadedPart &part) const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  std::map<size_t, UploadedPart>::const_iterator it = _parts.find(partNumber);
+  if(it == _parts.end()) {
+    return false;
+  }
+
+  part = it->second;
+  return true;
+}
+
+size_t UploadManifest::countParts() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _parts.size();
+}
+
+//------------------------------------------------------------------------------
+// Keep only parts the server agrees on
+//------------------------------------------------------------------------------
+void UploadManifest::retainParts(const std::function<bool (size_t partNumber, const UploadedPart &part)> &keep) {
+  std::lock_guard<std::mutex> lock(_mtx);
+
+  for(std::map<size_t, UploadedPart>::iterator it = _parts.begin(); it != _parts.end(); ) {
+    if(keep(it->first, it->second)) {
+      it++;
+    }
+    else {
+      DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Part #{} of upload {} is gone, uploading it again", it->first, _uploadId);
+      it = _parts.erase(it);
+    }
+  }
+
+  rewrite();
+}
+
+//------------------------------------------------------------------------------
+// Forget the earlier upload
+//------------------------------------------------------------------------------
+void UploadManifest::reset() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _resumable = false;
+  _uploadId.clear();
+  _partSize = 0;
+  _parts.clear();
+}
+
+//------------------------------------------------------------------------------
+// Record the start of a new upload
+//------------------------------------------------------------------------------
+void UploadManifest::start(const std::string &uploadId, dav_size_t partSize) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _uploadId = uploadId;
+  _partSize = partSize;
+  _parts.clear();
+
+  rewrite();
+}
+
+//------------------------------------------------------------------------------
+// Record a completed part
+//------------------------------------------------------------------------------
+void UploadManifest::addPart(size_t partNumber, const UploadedPart &part) {
+  std::lock_guard<std::mutex> lock(_mtx);
+  _parts[partNumber] = part;
+
+  if(_file == NULL) {
+    // resumed without being rewritten yet
+    rewrite();
+    return;
+  }
+
+  if(writePart(partNumber, part) < 0) {
+    throw DavixException(UploadManifest_scope(), StatusCode::SystemError, fmt::format("Unable to write upload manifest {}: {}", _path, strerror(errno)));
+  }
+
+  flush();
+}
+
+//------------------------------------------------------------------------------
+// The upload was committed
+//------------------------------------------------------------------------------
+void UploadManifest::remove() {
+  std::lock_guard<std::mutex> lock(_mtx);
+  if(_file) {
+    fclose(_file);
+    _file = NULL;
+  }
+
+  if(unlink(_path.c_str()) != 0 && errno != ENOENT) {
+    DAVIX_SLOG(DAVIX_LOG_WARNING, DAVIX_LOG_CHAIN, "Unable to remove upload manifest {}: {}", _path, strerror(errno));
+  }
+}
+
+//------------------------------------------------------------------------------
+// Write out the whole manifest, atomically, and keep it open for appending
+// parts. Call with _mtx held.
+//------------------------------------------------------------------------------
+void UploadManifest::rewrite() {
+  if(_file) {
+    fclose(_file);
+    _file = NULL;
+  }
+
+  const std::string tmpPath = _path + ".tmp";
+  _file = fopen(tmpPath.c_str(), "w");
+  if(_file == NULL) {
+    throw DavixException(UploadManifest_scope(), StatusCode::SystemError, fmt::format("Unable to create upload manifest {}: {}", tmpPath, strerror(errno)));
+  }
+
+  fprintf(_file, "%s\nobject %s\nsize %llu\n", kManifestVersion.c_str(), _object.c_str(), (unsigned long long) _size);
+  if(!_source.empty()) {
+    fprintf(_file, "source %s\n", _source.c_str());
+  }
+  fprintf(_file, "partsize %llu\nuploadid %s\n", (unsigned long long) _partSize, _uploadId.c_str());
+
+  for(std::map<size_t, UploadedPart>::const_iterator it = _parts.begin(); it != _parts.end(); it++) {
+    writePart(it->first, it->second);
+  }
+
+  flush();
+
+  if(rename(tmpPath.c_str(), _path.c_str()) != 0) {
+    throw DavixException(UploadManifest_scope(), StatusCode::SystemError, fmt::format("Unable to replace upload manifest {}: {}", _path, strerror(errno)));
+  }
+}
+
+//------------------------------------------------------------------------------
+// Append a part line - the id comes last, as it may hold spaces. Call with
+// _mtx held.
+//------------------------------------------------------------------------------
+int UploadManifest::writePart(size_t partNumber, const UploadedPart &part) {
+  return fprintf(_file, "part %zu %llu %s %s\n", partNumber, (unsigned long long) part.size,
+    part.digest.empty() ? "-" : part.digest.c_str(), part.id.c_str());
+}
+
+//------------------------------------------------------------------------------
+// Make sure what was written survives a crash. Call with _mtx held.
+//------------------------------------------------------------------------------
+void UploadManifest::flush() {
+  if(fflush(_file) != 0 || fsync(fileno(_file)) != 0) {
+    throw DavixException(UploadManifest_scope(), StatusCode::SystemError, fmt::format("Unable to write upload manifest {}: {}", _path, strerror(errno)));
+  }
+}
+
+}
@@ -0,0 +1,168 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef DAVIX_FILEOPS_UPLOAD_MANIFEST_HPP
+#define DAVIX_FILEOPS_UPLOAD_MANIFEST_HPP
+
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <fileops/PartUploader.hpp>
+
+namespace Davix {
+
+class ContentProvider;
+class Uri;
+
+//------------------------------------------------------------------------------
+// Local record of a multi-part upload in progress, so that it can be resumed
+// after a failure instead of starting over.
+//
+// The manifest is a small text file: a header naming the object, its size,
+// the source file when there is one, the part size and the upload id,
+// followed by one line per completed part with its size and MD5, appended -
+// and flushed to disk - as soon as the part is uploaded. A crash loses at most
+// the parts in flight.
+//
+// What the manifest says is only a hint: an upload from a file which is not
+// the same one anymore - other inode, or modified since - starts over, parts
+// whose data no longer has the recorded MD5 are uploaded again, and before
+// resuming, backends check the recorded parts against what the server
+// actually holds, and drop the rest.
+//------------------------------------------------------------------------------
+class UploadManifest {
+public:
+  //----------------------------------------------------------------------------
+  // Open the manifest configured in "params" for an upload of "provider" to
+  // "uri". Returns NULL if resumable uploads are not enabled.
+  //----------------------------------------------------------------------------
+  static std::unique_ptr<UploadManifest> open(const RequestParams &params, const Uri &uri, ContentProvider &provider);
+
+  //----------------------------------------------------------------------------
+  // Constructor. If "path" records an unfinished upload of the same object,
+  // from the same "source" - see sourceIdentity - it is loaded and can be
+  // resumed.
+  //----------------------------------------------------------------------------
+  UploadManifest(const std::string &path, const Uri &uri, dav_size_t size, const std::string &source = std::string());
+  ~UploadManifest();
+
+  UploadManifest(const UploadManifest &other) = delete;
+  UploadManifest& operator=(const UploadManifest &other) = delete;
+
+  //----------------------------------------------------------------------------
+  // Whether an earlier upload of the same object was found
+  //----------------------------------------------------------------------------
+  bool resumable() const {
+    return _resumable;
+  }
+
+  const std::string& getUploadId() const {
+    return _uploadId;
+  }
+
+  dav_size_t getPartSize() const {
+    return _partSize;
+  }
+
+  //----------------------------------------------------------------------------
+  // Whether the earlier upload was from this very source file, unmodified:
+  // its parts can then be trusted without reading them again
+  //----------------------------------------------------------------------------
+  bool sameSource() const {
+    return _resumable && !_source.empty();
+  }
+
+  //----------------------------------------------------------------------------
+  // Identity of the file behind "provider" - device, inode, modification
+  // time and offset - or empty if it's not a regular file
+  //----------------------------------------------------------------------------
+  static std::string sourceIdentity(ContentProvider &provider);
+
+  //----------------------------------------------------------------------------
+  // Digest of a part, as recorded in the manifest: hex MD5
+  //----------------------------------------------------------------------------
+  static std::string digest(const char *data, dav_size_t size);
+
+  //----------------------------------------------------------------------------
+  // Whether a server ETag agrees with a part digest. ETags which are not an
+  // MD5 can't tell, and always agree.
+  //----------------------------------------------------------------------------
+  static bool etagMatches(const std::string &etag, const std::string &digest);
+
+  //----------------------------------------------------------------------------
+  // Get a completed part, if recorded. Thread-safe.
+  //----------------------------------------------------------------------------
+  bool getPart(size_t partNumber, UploadedPart &part) const;
+
+  size_t countParts() const;
+
+  //----------------------------------------------------------------------------
+  // Keep only the parts for which "keep" returns true, typically those the
+  // server still knows about, and rewrite the manifest accordingly
+  //----------------------------------------------------------------------------
+  void retainParts(const std::function<bool (size_t partNumber, const UploadedPart &part)> &keep);
+
+  //----------------------------------------------------------------------------
+  // Forget the earlier upload - it can't be resumed after all
+  //----------------------------------------------------------------------------
+  void reset();
+
+  //----------------------------------------------------------------------------
+  // Record the start of a new upload, replacing whatever the manifest held
+  //----------------------------------------------------------------------------
+  void start(const std::string &uploadId, dav_size_t partSize);
+
+  //----------------------------------------------------------------------------
+  // Record a completed part. Thread-safe; the part is on disk on return.
+  //----------------------------------------------------------------------------
+  void addPart(size_t partNumber, const UploadedPart &part);
+
+  //----------------------------------------------------------------------------
+  // The upload was committed: delete the manifest
+  //----------------------------------------------------------------------------
+  void remove();
+
+private:
+  void load();
+  void rewrite();
+  int writePart(size_t partNumber, const UploadedPart &part);
+  void flush();
+
+  const std::string _path;
+  const std::string _object;
+  const dav_size_t _size;
+  const std::string _source;
+
+  bool _resumable;
+  std::string _uploadId;
+  dav_size_t _partSize;
+
+  mutable std::mutex _mtx;
+  std::map<size_t, UploadedPart> _parts;
+  FILE *_file;
+};
+
+}
+
+#endif
@@ -26,6 +26,7 @@
 #include "davix_reliability_ops.hpp"
 #include "iobuffmap.hpp"
 #include "AzureIO.hpp"
+#include "BlockCacheIO.hpp"
 #include "S3IO.hpp"
 #include "SwiftIO.hpp"
 
@@ -44,7 +45,7 @@ HttpIOChain& ChainFactory::instanceChain(const CreationFlags & flags, HttpIOChai
         elem = elem->add(new HttpIOBuffer());
     }
 
-    elem->add(new S3IO())->add(new SwiftIO())->add(new AzureIO())->add(new HttpIO())->add(new HttpIOVecOps());
+    elem->add(new BlockCacheIO())->add(new S3IO())->add(new SwiftIO())->add(new AzureIO())->add(new HttpIO())->add(new HttpIOVecOps());
     return c;
 }
 
@@ -22,6 +22,12 @@
 #include <mutex>
 #include <davix_internal.hpp>
 #include "davix_reliability_ops.hpp"
+#include "iobuffmap.hpp"
+#include "SegmentedDownloader.hpp"
+#include <davix_context_internal.hpp>
+#include <core/ReplicaCache.hpp>
+#include <core/RetryPolicy.hpp>
+#include <backend/SessionFactory.hpp>
 
 #include <utils/stringutils.hpp>
 #include <utils/davix_logger_internal.hpp>
@@ -29,6 +35,12 @@
 #include <xml/metalinkparser.hpp>
 #include "libs/alibxx/crypto/base64.hpp"
 
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+
 
 namespace Davix{
 
@@ -60,6 +72,10 @@ static bool isMetalinkDisabled(const RequestParams* params){
     return (params != NULL && params->getMetalinkMode() == MetalinkMode::Disable) || metalink_support_disabled;
 }
 
+static bool isMetalinkStriping(const RequestParams* params){
+    return !isMetalinkDisabled(params) && params != NULL && params->getMetalinkMode() == MetalinkMode::XStream;
+}
+
 
 template<class Executor, class ReturnType>
 ReturnType metalinkTryReplicas(HttpIOChain & chain, IOChainContext & io_context, Executor fun){
@@ -67,19 +83,25 @@ ReturnType metalinkTryReplicas(HttpIOChain & chain, IOChainContext & io_context,
 
     // check if we expired
     io_context.checkTimeout();
-    // get all replicas from Metalink
+    // get all replicas from Metalink, but those which failed recently
+    ReplicaCache & cache = ContextExplorer::ReplicaCacheFromContext(io_context._context);
     chain.getReplicas(io_context, replicas);
+    cache.filterHealthy(replicas, [](const File & f){ return f.getUri().getString(); });
+
     for(std::vector<File>::iterator it = replicas.begin();it != replicas.end(); ++it){
         IOChainContext internal_context(io_context._context, it->getUri(), io_context._reqparams);
         internal_context.fdHandler = io_context.fdHandler;
 
         try{
-            return fun(internal_context);
+            ReturnType ret = fun(internal_context);
+            cache.markSucceeded(it->getUri().getString());
+            return ret;
         }catch(DavixException & replica_error){
             DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Fail access to replica {}: {}", it->getUri(), replica_error.what());
         }catch(...){
             DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Fail access to replica: Unknown Error");
         }
+        cache.markFailed(it->getUri().getString());
 
         io_context.fdHandler = internal_context.fdHandler;
         // check timeout again between two iterations
@@ -96,14 +118,33 @@ ReturnType metalinkExecutor(HttpIOChain & chain, IOChainContext & io_context, Ex
         return fun(io_context);
     }
 
+    // known to have failed recently, go straight for the others
+    ReplicaCache & cache = ContextExplorer::ReplicaCacheFromContext(io_context._context);
+    const bool replicas_tried = !cache.isHealthy(io_context._uri.getString());
+    if(replicas_tried){
+        DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "{} failed recently, trying its replicas first", io_context._uri.getString());
+        try{
+            return metalinkTryReplicas<Executor, ReturnType>(chain, io_context, fun);
+        }catch(DavixException & metalink_error){
+            DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "No replica available: {}", metalink_error.what());
+        }
+    }
+
     try{
         // Execute operation
         return fun(io_context);
     }catch(DavixException & e){
 
         propagateNonRecoverableExceptions(e);
+        cache.markFailed(io_context._uri.getString());
 
         DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Could not execute operation on {}, error {}", io_context._uri.getString(), e.what());
+
+        // the replicas already failed us, don't go through them again
+        if(replicas_tried){
+            throw e;
+        }
+
         DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Try to Recover with Metalink...");
 
         try{
@@ -227,6 +268,69 @@ void davix_file_get_all_replicas_metalink( Context & c, const Uri & uri,
 }
 
 
+// replicas worth striping a download across - none if there's less than two
+static std::vector<File> metalinkStripingReplicas(HttpIOChain & chain, IOChainContext & io_context){
+    std::vector<File> replicas;
+    try{
+        chain.getReplicas(io_context, replicas);
+    }catch(DavixException & e){
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "No replicas of {} to stripe across: {}", io_context._uri, e.what());
+        replicas.clear();
+    }
+
+    ContextExplorer::ReplicaCacheFromContext(io_context._context).filterHealthy(replicas, [](const File & f){ return f.getUri().getString(); });
+
+    if(replicas.size() < 2){
+        replicas.clear();
+    }
+    return replicas;
+}
+
+// size of a file to stripe, stat'ed once for as long as its replicas stay
+// cached - rather than before each striped read
+static dav_size_t metalinkStripingSize(HttpIOChain & chain, IOChainContext & io_context){
+    ReplicaCache & cache = ContextExplorer::ReplicaCacheFromContext(io_context._context);
+    const std::string url = io_context._uri.getString();
+
+    dav_size_t size;
+    if(cache.getSize(url, size)){
+        return size;
+    }
+
+    StatInfo st;
+    chain.statInfo(io_context, st);
+    cache.putSize(url, st.size);
+    return st.size;
+}
+
+// download a range of the data from all replicas at once
+static dav_size_t metalinkStripedDownload(IOChainContext & io_context, const std::vector<File> & replicas,
+                                          dav_off_t offset, dav_size_t size, int fd, dav_off_t base,
+                                          const SegmentedDownloader::StoreFunction & store){
+    SegmentedDownloader downloader(io_context._context, *io_context._reqparams, replicas.size());
+
+    SegmentedDownloader::FetchFunction fetch = [&](size_t source, dav_off_t off, dav_size_t count, const SegmentedDownloader::WriteFunction & write,
+                                                   const std::atomic<bool> & cancelled){
+        IOChainContext replica_context(io_context._context, replicas[source].getUri(), io_context._reqparams);
+        read_range_request(replica_context, off, count, write, &cancelled);
+    };
+
+    DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Striping {} bytes of {} across {} replicas", size, io_context._uri, replicas.size());
+    dav_size_t ret = (fd >= 0) ? downloader.download(fd, base, size, fetch) : downloader.download(offset, size, store, fetch);
+
+    ReplicaCache & cache = ContextExplorer::ReplicaCacheFromContext(io_context._context);
+    const std::vector<SourceStats> & stats = downloader.getSourceStats();
+    for(size_t i = 0; i < stats.size(); i++){
+        if(!stats[i].healthy){
+            cache.markFailed(replicas[i].getUri().getString());
+        }
+        DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Replica {}: {} bytes in {} ranges at {} B/s, {} handed over, {} failures",
+                   replicas[i].getUri(), stats[i].bytes, stats[i].ranges, (uint64_t) stats[i].throughput(), stats[i].stolen, stats[i].failures);
+    }
+    return ret;
+}
+
+
 MetalinkOps::MetalinkOps()
 {
 
@@ -239,7 +343,39 @@ MetalinkOps::~MetalinkOps(){
 
 
 std::vector<File> & MetalinkOps::getReplicas(IOChainContext & iocontext, std::vector<File> &vec){
-    davix_file_get_all_replicas_metalink(iocontext._context, iocontext._uri, iocontext._reqparams, vec);
+    ReplicaCache & cache = ContextExplorer::ReplicaCacheFromContext(iocontext._context);
+    const std::string url = iocontext._uri.getString();
+    std::vector<std::string> urls;
+
+    if(cache.get(url, urls)){
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "{} replicas of {} found in cache", urls.size(), url);
+        if(urls.empty()){
+            throw DavixException(davix_scope_meta(), StatusCode::OperationNonSupported, "Server does not support Metalink standard");
+        }
+
+        for(std::vector<std::string>::iterator it = urls.begin(); it != urls.end(); ++it){
+            vec.push_back(File(iocontext._context, Uri(*it)));
+        }
+        return vec;
+    }
+
+    std::vector<File> replicas;
+    try{
+        davix_file_get_all_replicas_metalink(iocontext._context, iocontext._uri, iocontext._reqparams, replicas);
+    }catch(DavixException & e){
+        // no Metalink is worth remembering too, other errors may not last
+        if(e.code() == StatusCode::OperationNonSupported){
+            cache.put(url, urls);
+        }
+        throw;
+    }
+
+    for(std::vector<File>::iterator it = replicas.begin(); it != replicas.end(); ++it){
+        urls.push_back(it->getUri().getString());
+    }
+    cache.put(url, urls);
+
+    vec.insert(vec.end(), replicas.begin(), replicas.end());
     return vec;
 }
 
@@ -254,6 +390,29 @@ dav_ssize_t MetalinkOps::read(IOChainContext &iocontext, void *buf, dav_size_t c
 }
 
 dav_ssize_t MetalinkOps::pread(IOChainContext &iocontext, void *buf, dav_size_t count, dav_off_t offset){
+    // large reads are striped, when there are replicas to stripe across
+    if(isMetalinkStriping(iocontext._reqparams) && count >= 2 * iocontext._reqparams->getDownloadSegmentSize()){
+        std::vector<File> replicas = metalinkStripingReplicas(*this, iocontext);
+        if(!replicas.empty()){
+            const dav_size_t size = metalinkStripingSize(*this, iocontext);
+            if(offset >= (dav_off_t) size){
+                return 0;
+            }
+
+            char* out = static_cast<char*>(buf);
+            try{
+                return metalinkStripedDownload(iocontext, replicas, offset, std::min<dav_size_t>(count, size - offset), -1, 0,
+                    [&](const char* data, dav_size_t size, dav_off_t off){
+                        memcpy(out + (off - offset), data, size);
+                    });
+            }catch(DavixException & e){
+                if(e.code() != StatusCode::OperationNonSupported){
+                    throw;
+                }
+                DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Unable to stripe read of {}: {}, reading from a single replica", iocontext._uri, e.what());
+            }
+        }
+    }
 
     FuncIO func(std::bind(&HttpIOChain::pread, _next.get(), std::placeholders::_1, buf, count, offset));
     return metalinkExecutor<FuncIO, dav_ssize_t>(*this, iocontext, func);
@@ -268,8 +427,57 @@ dav_ssize_t MetalinkOps::preadVec(IOChainContext & iocontext, const DavIOVecInpu
     return metalinkExecutor<FuncIO, dav_ssize_t>(*this, iocontext, func);
 }
 
+dav_ssize_t MetalinkOps::readFull(IOChainContext & iocontext, std::vector<char> & buffer){
+    if(isMetalinkStriping(iocontext._reqparams)){
+        std::vector<File> replicas = metalinkStripingReplicas(*this, iocontext);
+        if(!replicas.empty()){
+            const dav_size_t size = metalinkStripingSize(*this, iocontext);
+
+            const size_t start = buffer.size();
+            buffer.resize(start + size);
+            try{
+                return metalinkStripedDownload(iocontext, replicas, 0, size, -1, 0,
+                    [&](const char* data, dav_size_t size, dav_off_t off){
+                        memcpy(&buffer[start + off], data, size);
+                    });
+            }catch(DavixException & e){
+                buffer.resize(start);
+                if(e.code() != StatusCode::OperationNonSupported){
+                    throw;
+                }
+                DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Unable to stripe read of {}: {}, reading from a single replica", iocontext._uri, e.what());
+            }
+        }
+    }
+
+    CHAIN_FORWARD(readFull(iocontext, buffer));
+}
+
 // read to fd Metalink manager
 dav_ssize_t MetalinkOps::readToFd(IOChainContext & iocontext, int fd, dav_size_t size){
+    struct stat fd_st;
+    if(size == 0 && iocontext.fdHandler.bytes_written_to_fd == 0 && isMetalinkStriping(iocontext._reqparams)
+            && fstat(fd, &fd_st) == 0 && S_ISREG(fd_st.st_mode)){
+        std::vector<File> replicas = metalinkStripingReplicas(*this, iocontext);
+        const off_t base = ::lseek(fd, 0, SEEK_CUR);
+
+        if(!replicas.empty() && base >= 0){
+            const dav_size_t size = metalinkStripingSize(*this, iocontext);
+
+            try{
+                dav_size_t total = metalinkStripedDownload(iocontext, replicas, 0, size, fd, base, SegmentedDownloader::StoreFunction());
+                ::lseek(fd, base + total, SEEK_SET);
+                iocontext.fdHandler.bytes_written_to_fd += total;
+                return total;
+            }catch(DavixException & e){
+                if(e.code() != StatusCode::OperationNonSupported){
+                    throw;
+                }
+                DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Unable to stripe download of {}: {}, downloading from a single replica", iocontext._uri, e.what());
+            }
+        }
+    }
+
     FuncIO func(std::bind(&HttpIOChain::readToFd, _next.get(), std::placeholders::_1, fd, size));
     return metalinkExecutor<FuncIO, dav_ssize_t>(*this, iocontext, func);
 }
@@ -292,16 +500,31 @@ ReturnType autoRetryExecutor(HttpIOChain & chain, IOChainContext & io_context, E
 
     (void) chain;
     const int max_retry = io_context._reqparams->getOperationRetry();
-    const int retry_delay = io_context._reqparams->getOperationRetryDelay();
     int retry =1;
     const Uri & u = io_context._uri;
 
+    // retry budget and circuit breaker of the endpoint, shared across the context
+    RetryBudget & budget = ContextExplorer::RetryBudgetFromContext(io_context._context);
+    const std::string endpoint = SessionFactory::makeSessionKey(u);
+
      while(1){
         io_context.checkTimeout();
+        // fail fast if the endpoint is down, without waiting for timeouts
+        budget.checkCircuit(endpoint);
         try{
-            return fun(io_context);
+            ReturnType ret = fun(io_context);
+            budget.recordSuccess(endpoint);
+            return ret;
         }catch(DavixException & error){
 
+            // errors answered by the server don't tell that it's down
+            if(RetryBudget::isEndpointFailure(error.code(), error.httpStatus())){
+                budget.recordFailure(endpoint);
+            }
+            else{
+                budget.recordSuccess(endpoint);
+            }
+
             // propagate fatal exceptions and connection error exceptions
             propagateNonRecoverableExceptions(error);
             // we can not recover from connexion timeout
@@ -318,12 +541,21 @@ ReturnType autoRetryExecutor(HttpIOChain & chain, IOChainContext & io_context, E
             if( retry >= max_retry){
                 throw DavixException(error.scope(), error.code(), fmt::format("Result {} after {} attempts", error.what(), retry));
             }
+
+            // don't flood an endpoint in trouble with retries
+            if(budget.tryRetry(endpoint) == false){
+                throw DavixException(error.scope(), error.code(), fmt::format("Result {} after {} attempts, retry budget of {} exhausted", error.what(), retry, endpoint));
+            }
         }catch(...){
+            budget.recordFailure(endpoint);
             DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Operation failure: Unknown Error");
             throw DavixException(davix_scope_io_buff(), StatusCode::UnknownError, fmt::format("Unrecoverable error from IOChain on {}", u));
         }
+
+        const std::chrono::milliseconds delay = backoffDelay(retry, *io_context._reqparams);
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Retrying in {} ms", delay.count());
         ++retry;
-        sleep(retry_delay);
+        std::this_thread::sleep_for(delay);
     }
 }
 
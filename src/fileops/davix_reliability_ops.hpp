@@ -37,6 +37,12 @@ namespace Davix{
 ///
 ///  the metalink chain element handle the recovery using metalink for any "reading" operation of the I/O chain
 ///
+///  replicas are looked up in the Context's ReplicaCache before fetching the Metalink, and those which
+///  failed recently are skipped
+///
+///  in MetalinkMode::XStream, downloads to a file, full reads and large preads are instead striped across
+///  all replicas at once, see SegmentedDownloader
+///
 class MetalinkOps: public HttpIOChain{
 public:
     MetalinkOps();
@@ -52,6 +58,9 @@ public:
                               DavIOVecOuput * output_vec,
                               const dav_size_t count_vec);
 
+    // read to dynamically allocated buffer
+    virtual dav_ssize_t readFull(IOChainContext & iocontext, std::vector<char> & buffer);
+
     // read to fd
     virtual dav_ssize_t readToFd(IOChainContext & iocontext, int fd, dav_size_t size);
 
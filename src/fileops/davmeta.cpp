@@ -39,6 +39,7 @@
 
 #include <request/httprequest.hpp>
 #include <fileops/fileutils.hpp>
+#include <fileops/ListingPrefetcher.hpp>
 #include <utils/stringutils.hpp>
 #include "libs/alibxx/crypto/base64.hpp"
 #include <neon/neonrequest.hpp>
@@ -62,11 +63,14 @@ static const std::string quota_stat("<?xml version=\"1.0\" encoding=\"utf-8\" ?>
 
 struct DirHandle{
 
-    DirHandle(HttpRequest* req, XMLPropParser * p): request(req), parser(p){}
+    DirHandle(HttpRequest* req, XMLPropParser * p): request(req), parser(p), read_size(DAVIX_LISTING_READ_SIZE_MIN){}
 
     std::unique_ptr<HttpRequest> request;
     std::unique_ptr<Davix::XMLPropParser> parser;
 
+    // reused between reads, grown along with read_size
+    std::vector<char> buffer;
+    dav_size_t read_size;
 
 };
 
@@ -191,25 +195,63 @@ int dav_stat_mapper_http_get(Context& context, const RequestParams* params, cons
 }
 
 
-dav_ssize_t incremental_listdir_parsing(HttpRequest* req, XMLPropParser * parser, dav_size_t s_buff, const std::string & scope){
+// read the next chunk of a listing body, and feed it to the parser straight
+// from the handle's buffer. Chunks start small so that the first entries come
+// early, and double with each full read up to DAVIX_LISTING_READ_SIZE_MAX.
+// Returns 0 once the body is over.
+dav_ssize_t incremental_listdir_parsing(DirHandle & handle, const std::string & scope){
     DavixError* tmp_err=NULL;
 
-    char* buffer;
-    buffer = (char*)malloc(s_buff+1);
-    const dav_ssize_t ret = req->readSegment(buffer, s_buff, &tmp_err);
+    if(handle.buffer.size() < handle.read_size){
+        handle.buffer.resize(handle.read_size);
+    }
+
+    const dav_ssize_t ret = handle.request->readSegment(&handle.buffer[0], handle.read_size, &tmp_err);
     checkDavixError(&tmp_err);
-    if(ret >= 0){
-        buffer[ret]= '\0';
-        parser->parseChunk(buffer, ret);
-    }else{
+    if(ret < 0){
         throw DavixException(scope, StatusCode::UnknownError, "Unknown readSegment error");
     }
 
-    free(buffer);
+    handle.parser->parseChunk(&handle.buffer[0], ret);
+
+    if((dav_size_t) ret == handle.read_size && handle.read_size < DAVIX_LISTING_READ_SIZE_MAX){
+        handle.read_size = std::min<dav_size_t>(handle.read_size * 2, DAVIX_LISTING_READ_SIZE_MAX);
+    }
+
     return ret;
 }
 
 
+// move the entries parsed so far to batch, then parse the rest of the body
+// straight into it - if the parser supports it, through the queue otherwise -
+// until it holds "limit" entries. Returns false once the body is over.
+static bool fill_listing_batch(DirHandle & handle, ListingBatch & batch, size_t limit, const std::string & scope){
+    XMLPropParser & parser = *(handle.parser);
+    std::deque<FileProperties> & props = parser.getProperties();
+    dav_ssize_t s_resu = handle.read_size;
+
+    parser.setBatch(&batch);
+    try{
+        while(true){
+            for(; props.empty() == false; props.pop_front()){
+                batch.append(props.front().filename, props.front().info);
+            }
+
+            if(batch.size() >= limit || s_resu <= 0){
+                break;
+            }
+            s_resu = incremental_listdir_parsing(handle, scope);
+        }
+    }catch(...){
+        parser.setBatch(NULL);
+        throw;
+    }
+
+    parser.setBatch(NULL);
+    return s_resu > 0;
+}
+
+
 dav_ssize_t getStatInfo(Context & c, const Uri & url, const RequestParams * p,
                       struct StatInfo& st_info){
     RequestParams params(p);
@@ -450,19 +492,15 @@ int internal_checksum(Context & c, const Uri & url, const RequestParams *p, std:
 
 bool wedav_get_next_property(std::unique_ptr<DirHandle> & handle, std::string & name_entry, StatInfo & info){
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, " -> wedav_get_next_property");
-    const size_t read_size = 2048;
-
-
-    HttpRequest& req = *(handle->request); // setup env again
     XMLPropParser& parser = *(handle->parser);
 
     size_t prop_size = parser.getProperties().size();
-    ssize_t s_resu = read_size;
+    ssize_t s_resu = handle->read_size;
 
     while( prop_size == 0
           && s_resu > 0){ // request not complete and current data too smalls
         // continue the parsing until one more result
-       s_resu = incremental_listdir_parsing(&req, &parser, read_size, "WebDav::listing");
+       s_resu = incremental_listdir_parsing(*handle, "WebDav::listing");
 
        prop_size = parser.getProperties().size();
     }
@@ -502,10 +540,10 @@ void webdav_start_listing_query(std::unique_ptr<DirHandle> & handle, Context & c
 
     size_t prop_size = 0;
     do{ // parse the begining of the request until the first property -> directory property
-       s_resu = incremental_listdir_parsing(&http_req, &parser, 2048, davix_scope_directory_listing_str());
+       s_resu = incremental_listdir_parsing(*handle, davix_scope_directory_listing_str());
 
        prop_size = parser.getProperties().size();
-       if(s_resu < 2048 && prop_size <1){ // verify request status : if req done + no data -> error
+       if(s_resu == 0 && prop_size <1){ // verify request status : if req done + no data -> error
            throw DavixException(davix_scope_directory_listing_str(), StatusCode::WebDavPropertiesParsingError, "bad server answer, not a valid WebDav PROPFIND answer");
        }
 
@@ -529,6 +567,92 @@ bool webdav_directory_listing(std::unique_ptr<DirHandle> & handle, Context & con
     return wedav_get_next_property(handle, name_entry, info);
 }
 
+
+bool webdav_walk_depth_infinity(Context & context, const RequestParams & params, const Uri & url,
+                                const std::function<void (const std::string &, const StatInfo &)> & fn,
+                                std::vector<std::string> & unexplored){
+    DavixError* tmp_err=NULL;
+    DirHandle handle(new PropfindRequest(context, url, &tmp_err), new DavPropXMLParser(true));
+    checkDavixError(&tmp_err);
+
+    HttpRequest & http_req = *(handle.request);
+    XMLPropParser & parser = *(handle.parser);
+
+    http_req.addHeaderField("Depth","infinity");
+    http_req.setParameters(params);
+    http_req.setRequestBody(stat_listing);
+
+    http_req.beginRequest(&tmp_err);
+    checkDavixError(&tmp_err);
+
+    // 403 with DAV:propfind-finite-depth is the standard refusal, but some
+    // servers answer 400 or 501 instead - anything but a listing or a
+    // missing collection means falling back to one listing per collection
+    const int code = http_req.getRequestCode();
+    if(code == 404){
+        check_file_status(http_req, davix_scope_directory_listing_str());
+    }
+    if(code != 207){
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Depth infinity PROPFIND on {} refused with {}", url, code);
+        http_req.discardBody(&tmp_err);
+        DavixError::clearError(&tmp_err);
+        return false;
+    }
+
+    std::string root = Uri::unescapeString(url.getPath());
+    rtrim(root, isSlash());
+
+    bool found_root = false;
+    bool nested = false;
+    std::vector<std::string> collections;
+
+    dav_ssize_t s_resu;
+    do{
+        s_resu = incremental_listdir_parsing(handle, davix_scope_directory_listing_str());
+
+        std::deque<FileProperties> & props = parser.getProperties();
+        for(; !props.empty(); props.pop_front()){
+            const FileProperties & entry = props.front();
+            if(entry.filename == root){
+                if(S_ISDIR(entry.info.mode) == false){
+                    std::ostringstream ss;
+                    ss << url << " is not a collection, listing impossible";
+                    throw DavixException(davix_scope_directory_listing_str(), StatusCode::IsNotADirectory, ss.str());
+                }
+                found_root = true;
+                continue;
+            }
+
+            if(entry.filename.size() <= root.size() + 1 || entry.filename.compare(0, root.size(), root) != 0
+                || entry.filename[root.size()] != '/'){
+                DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Depth infinity PROPFIND on {}: ignoring {}, out of the collection", url, entry.filename);
+                continue;
+            }
+
+            const std::string path = entry.filename.substr(root.size() + 1);
+            if(path.find('/') != std::string::npos){
+                nested = true;
+            }else if(S_ISDIR(entry.info.mode)){
+                collections.push_back(path);
+            }
+
+            fn(path, entry.info);
+        }
+    }while(s_resu > 0);
+
+    if(!found_root){
+        throw DavixException(davix_scope_directory_listing_str(), StatusCode::WebDavPropertiesParsingError, "bad server answer, not a valid WebDav PROPFIND answer");
+    }
+
+    // a server which quietly capped the depth to 1 only gives direct children:
+    // their own contents are still to be walked
+    if(!nested){
+        unexplored.swap(collections);
+    }
+
+    return true;
+}
+
 HttpMetaOps::HttpMetaOps(): HttpIOChain(){}
 
 HttpMetaOps::~HttpMetaOps(){}
@@ -567,6 +691,16 @@ bool HttpMetaOps::nextSubItem(IOChainContext &iocontext, std::string &entry_name
                              entry_name, info);
 }
 
+bool HttpMetaOps::nextSubItems(IOChainContext &iocontext, ListingBatch &batch, size_t count){
+    if(directoryItem.get() == NULL){
+        webdav_start_listing_query(directoryItem, iocontext._context, iocontext._reqparams, iocontext._uri, stat_listing);
+    }
+
+    const size_t before = batch.size();
+    fill_listing_batch(*directoryItem, batch, before + count, "WebDav::listing");
+    return batch.size() > before;
+}
+
 /////////////////////////
 /////////////////////////
 
@@ -710,10 +844,10 @@ void swift_start_listing_query(std::unique_ptr<DirHandle> & handle, Context & co
 
     size_t prop_size = 0;
     do{ // first entry -> container information
-        s_resu = incremental_listdir_parsing(&http_req, &parser, 2048, davix_scope_directory_listing_str());
+        s_resu = incremental_listdir_parsing(*handle, davix_scope_directory_listing_str());
 
         prop_size = parser.getProperties().size();
-        if(s_resu < 2048 && prop_size <1){ // verify request status : if req done + no data -> error
+        if(s_resu == 0 && prop_size <1){ // verify request status : if req done + no data -> error
             throw DavixException(davix_scope_directory_listing_str(), StatusCode::ParsingError, "Invalid server response, not a Swift listing or the directory is empty");
         }
         if(timestamp_timeout < time(NULL)){
@@ -742,6 +876,20 @@ bool SwiftMetaOps::nextSubItem(IOChainContext &iocontext, std::string &entry_nam
 
 }
 
+bool SwiftMetaOps::nextSubItems(IOChainContext &iocontext, ListingBatch &batch, size_t count){
+    if(is_swift_operation(iocontext)){
+        if(directoryItem.get() == NULL){
+            swift_start_listing_query(directoryItem, iocontext._context, iocontext._reqparams, iocontext._uri, stat_listing);
+        }
+
+        const size_t before = batch.size();
+        fill_listing_batch(*directoryItem, batch, before + count, "Swift::listing");
+        return batch.size() > before;
+    }else{
+        return HttpIOChain::nextSubItems(iocontext, batch, count);
+    }
+}
+
 void SwiftMetaOps::move(IOChainContext & iocontext, const std::string & target_url) {
     const std::string scope = "Davix::SwiftMetaOps::move";
     if(!is_swift_operation(iocontext)) {
@@ -951,7 +1099,7 @@ void s3StatMapper(Context& context, const RequestParams* params, const Uri & uri
             size_t prop_size = 0;
             do{ // first entry
                TRY_DAVIX{
-                    s_resu = incremental_listdir_parsing(&http_req, &parser, 2048, scope);
+                    s_resu = incremental_listdir_parsing(handle, scope);
                }CATCH_DAVIX(&tmp_err)
 
                if(tmp_err && (tmp_err->getStatus() == StatusCode::IsNotADirectory)){
@@ -961,7 +1109,7 @@ void s3StatMapper(Context& context, const RequestParams* params, const Uri & uri
                 }
 
                prop_size = parser.getProperties().size();
-               if(s_resu < 2048 && prop_size <1){ // verify request status : if req done + no data -> error
+               if(s_resu == 0 && prop_size <1){ // verify request status : if req done + no data -> error
                   throw DavixException(scope, StatusCode::ParsingError, "Invalid server response, not a S3 listing");
                }
                if(timestamp_timeout < time(NULL)){
@@ -1011,20 +1159,16 @@ StatInfo & S3MetaOps::statInfo(IOChainContext & iocontext, StatInfo & st_info){
 
 bool s3_get_next_property(std::unique_ptr<DirHandle> & handle, std::string & name_entry, StatInfo & info){
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, " -> s3_get_next_property");
-    const size_t read_size = 2048*1024;
-
-
-    HttpRequest& req = *(handle->request); // setup env again
     XMLPropParser& parser = *(handle->parser);
 
     size_t prop_size = parser.getProperties().size();
-    ssize_t s_resu = read_size;
+    ssize_t s_resu = handle->read_size;
 
     while( prop_size == 0
           && s_resu > 0){ // execute request only if no property are available
 
         // continue the parsing until one more result
-       s_resu = incremental_listdir_parsing(&req, &parser, read_size, "S3::listing");
+       s_resu = incremental_listdir_parsing(*handle, "S3::listing");
        prop_size = parser.getProperties().size();
     }
 
@@ -1041,40 +1185,59 @@ bool s3_get_next_property(std::unique_ptr<DirHandle> & handle, std::string & nam
 }
 
 
-void s3_start_listing_query(std::unique_ptr<DirHandle> & handle, Context & context, const RequestParams* params, const Uri & url, const std::string & body){
-    (void) body;
-    dav_ssize_t s_resu;
-    DavixError* tmp_err=NULL;
-    bool listing_buckets;
+// URL of the S3 listing page starting after "marker"
+static Uri s3_listing_uri(const Uri & url, const RequestParams* params, const std::string & marker){
+    Uri new_url;
 
     if(params->getProtocol() == RequestProtocol::Gcloud) {
-        Uri new_url = gcloud::getListingURI(url, params);
-
-        std::string prefix = gcloud::extract_path(url);
-        if(prefix != "/") prefix = "/" + prefix;
-        handle.reset(new DirHandle(new GetRequest(context, new_url, &tmp_err), new S3PropParser(params->getS3ListingMode(),  prefix)));
+        new_url = gcloud::getListingURI(url, params);
     }
     else if(params->getS3ListingMode() == S3ListingMode::Hierarchical){
-        Uri new_url = S3::s3UriTransformer(url, params, true);
-        if (handle.get() != NULL) {
-            XMLPropParser & parser = *(handle->parser);
-            std::string nextmarker = parser.getNextMarker();
-            if (nextmarker != "") {
-                new_url.addQueryParam("marker", nextmarker);
-            }
-        }
-        handle.reset(new DirHandle(new GetRequest(context, new_url, &tmp_err), new S3PropParser(params->getS3ListingMode(), S3::extract_s3_path(url, params->getAwsAlternate()))));
+        new_url = S3::s3UriTransformer(url, params, true);
     }
     else if(params->getS3ListingMode() == S3ListingMode::SemiHierarchical){
-        Uri new_url = S3::s3UriTransformer(url, params, false);
-        handle.reset(new DirHandle(new GetRequest(context, new_url, &tmp_err), new S3PropParser(params->getS3ListingMode(), S3::extract_s3_path(url, params->getAwsAlternate()))));
+        new_url = S3::s3UriTransformer(url, params, false);
     }
     else{
-        if(is_a_bucket(url) == false){
-           throw DavixException(davix_scope_directory_listing_str(), StatusCode::IsNotADirectory, "This is not a S3 bucket");
-        }
-        handle.reset(new DirHandle(new GetRequest(context, url, &tmp_err), new S3PropParser()));
+        new_url = url;
+    }
+
+    if(!marker.empty()){
+        new_url.addQueryParam("marker", marker);
     }
+    return new_url;
+}
+
+static S3PropParser* s3_listing_parser(const Uri & url, const RequestParams* params){
+    if(params->getProtocol() == RequestProtocol::Gcloud) {
+        std::string prefix = gcloud::extract_path(url);
+        if(prefix != "/") prefix = "/" + prefix;
+        return new S3PropParser(params->getS3ListingMode(), prefix);
+    }
+    else if(params->getS3ListingMode() == S3ListingMode::Flat){
+        return new S3PropParser();
+    }
+
+    return new S3PropParser(params->getS3ListingMode(), S3::extract_s3_path(url, params->getAwsAlternate()));
+}
+
+void s3_start_listing_query(std::unique_ptr<DirHandle> & handle, Context & context, const RequestParams* params, const Uri & url, const std::string & body){
+    (void) body;
+    dav_ssize_t s_resu;
+    DavixError* tmp_err=NULL;
+    bool listing_buckets;
+
+    if(params->getProtocol() != RequestProtocol::Gcloud && params->getS3ListingMode() == S3ListingMode::Flat && is_a_bucket(url) == false){
+        throw DavixException(davix_scope_directory_listing_str(), StatusCode::IsNotADirectory, "This is not a S3 bucket");
+    }
+
+    // continue after the previous page, if any
+    std::string nextmarker;
+    if (handle.get() != NULL) {
+        nextmarker = handle->parser->getNextMarker();
+    }
+
+    handle.reset(new DirHandle(new GetRequest(context, s3_listing_uri(url, params, nextmarker), &tmp_err), s3_listing_parser(url, params)));
     checkDavixError(&tmp_err);
 
     // Check if we are listing available buckets
@@ -1096,10 +1259,10 @@ void s3_start_listing_query(std::unique_ptr<DirHandle> & handle, Context & conte
 
     size_t prop_size = 0;
     do{ // first entry -> bucket information
-       s_resu = incremental_listdir_parsing(&http_req, &parser, 2048*1024, davix_scope_directory_listing_str());
+       s_resu = incremental_listdir_parsing(*handle, davix_scope_directory_listing_str());
 
        prop_size = parser.getProperties().size();
-       if(s_resu < 2048*1024 && prop_size <1){ // verify request status : if req done + no data -> error
+       if(s_resu == 0 && prop_size <1){ // verify request status : if req done + no data -> error
            throw DavixException(davix_scope_directory_listing_str(), StatusCode::ParsingError, "Invalid server response, not a S3 listing");
        }
        if(timestamp_timeout < time(NULL)){
@@ -1134,8 +1297,121 @@ bool s3_directory_listing(std::unique_ptr<DirHandle> & handle, Context & context
 }
 
 
+// Fetch a whole page of an S3 listing, for the prefetcher
+static void s3_fetch_listing_page(Context & context, const RequestParams & params, const Uri & page_url, XMLPropParser & parser, ListingPage & page){
+    DavixError* tmp_err=NULL;
+
+    GetRequest req(context, page_url, &tmp_err);
+    checkDavixError(&tmp_err);
+
+    req.setParameters(params);
+    req.executeRequest(&tmp_err);
+    checkDavixError(&tmp_err);
+
+    check_file_status(req, davix_scope_directory_listing_str());
+
+    if(parser.parseChunk(req.getAnswerContent()) != 0){
+        throw DavixException(davix_scope_directory_listing_str(), StatusCode::ParsingError, "Invalid server response, not a S3 listing");
+    }
+
+    // first entry -> bucket information
+    std::deque<FileProperties> & props = parser.getProperties();
+    if(props.empty() || S_ISDIR(props.front().info.mode) == false){
+        std::ostringstream ss;
+        ss << page_url << " is not a S3 bucket";
+        throw DavixException(davix_scope_directory_listing_str(), StatusCode::IsNotADirectory, ss.str());
+    }
+
+    props.pop_front();
+    page.entries.swap(props);
+    page.nextMarker = parser.getNextMarker();
+}
+
+// Start an S3 listing fetched ahead, partitioned along the top-level
+// prefixes of the bucket in flat mode
+static void s3_start_prefetched_listing(std::unique_ptr<PartitionedListing> & listing, Context & context, const RequestParams* p, const Uri & url){
+    const RequestParams params(p);
+    const size_t depth = std::max(1u, params.getListingPrefetch());
+    const bool flat = (params.getS3ListingMode() == S3ListingMode::Flat && params.getProtocol() != RequestProtocol::Gcloud);
+
+    if(flat && is_a_bucket(url) == false){
+        throw DavixException(davix_scope_directory_listing_str(), StatusCode::IsNotADirectory, "This is not a S3 bucket");
+    }
+
+    if(!flat || params.getListingPartitions() <= 1){
+        // a single partition, listed as usual
+        std::unique_ptr<ListingPrefetcher> pages(new ListingPrefetcher(context, [&context, params, url](const std::string & marker, ListingPage & page){
+            std::unique_ptr<S3PropParser> parser(s3_listing_parser(url, &params));
+            s3_fetch_listing_page(context, params, s3_listing_uri(url, &params, marker), *parser, page);
+        }, depth));
+
+        listing.reset(new PartitionedListing(std::move(pages), 1, [](const FileProperties &){
+            return std::unique_ptr<ListingPrefetcher>();
+        }));
+        return;
+    }
+
+    // top level: keys, and prefixes standing for everything below them
+    std::unique_ptr<ListingPrefetcher> top(new ListingPrefetcher(context, [&context, params, url](const std::string & marker, ListingPage & page){
+        Uri page_url(url);
+        page_url.addQueryParam("delimiter", "/");
+        if(!marker.empty()){
+            page_url.addQueryParam("marker", marker);
+        }
+
+        S3PropParser parser(S3ListingMode::Hierarchical, "");
+        s3_fetch_listing_page(context, params, page_url, parser, page);
+    }, depth));
+
+    listing.reset(new PartitionedListing(std::move(top), params.getListingPartitions(), [&context, params, url, depth](const FileProperties & partition){
+        const std::string prefix = partition.filename + "/";
+
+        return std::unique_ptr<ListingPrefetcher>(new ListingPrefetcher(context, [&context, params, url, prefix](const std::string & marker, ListingPage & page){
+            Uri page_url(url);
+            page_url.addQueryParam("prefix", prefix);
+            if(!marker.empty()){
+                page_url.addQueryParam("marker", marker);
+            }
+
+            S3PropParser parser(S3ListingMode::Flat, "");
+            s3_fetch_listing_page(context, params, page_url, parser, page);
+        }, depth));
+    }));
+}
+
+static bool s3_prefetched_listing(std::unique_ptr<PartitionedListing> & listing, Context & context, const RequestParams* params, const Uri & uri, std::string & name_entry, StatInfo & info){
+    if(listing.get() == NULL){
+        s3_start_prefetched_listing(listing, context, params, uri);
+    }
+
+    FileProperties entry;
+    if(listing->next(entry) == false){
+        return false;
+    }
+
+    name_entry.swap(entry.filename);
+    info = entry.info;
+    return true;
+}
+
+// background fetching only makes sense for real, paginated listings - not
+// for the list of buckets
+static bool s3_should_prefetch(IOChainContext & iocontext){
+    const RequestParams & params = *iocontext._reqparams;
+    if(params.getListingPrefetch() == 0 && params.getListingPartitions() <= 1){
+        return false;
+    }
+
+    return !(params.getAwsAlternate() && iocontext._uri.getPath() == "/");
+}
+
 bool S3MetaOps::nextSubItem(IOChainContext &iocontext, std::string &entry_name, StatInfo &info){
     if(is_s3_operation(iocontext)){
+        if(s3_should_prefetch(iocontext)){
+            return s3_prefetched_listing(prefetchedListing, iocontext._context, iocontext._reqparams, iocontext._uri,
+                                 entry_name, info);
+        }
+
         return s3_directory_listing(directoryItem, iocontext._context, iocontext._reqparams, iocontext._uri, stat_listing,
                                  entry_name, info);
     }else{
@@ -1144,6 +1420,41 @@ bool S3MetaOps::nextSubItem(IOChainContext &iocontext, std::string &entry_name,
 
 }
 
+bool S3MetaOps::nextSubItems(IOChainContext &iocontext, ListingBatch &batch, size_t count){
+    if(is_s3_operation(iocontext) == false){
+        return HttpIOChain::nextSubItems(iocontext, batch, count);
+    }
+
+    Context & context = iocontext._context;
+    const RequestParams* params = iocontext._reqparams;
+    const size_t before = batch.size();
+
+    if(s3_should_prefetch(iocontext)){
+        // pages come already parsed from the prefetcher
+        if(prefetchedListing.get() == NULL){
+            s3_start_prefetched_listing(prefetchedListing, context, params, iocontext._uri);
+        }
+
+        FileProperties entry;
+        while(batch.size() - before < count && prefetchedListing->next(entry)){
+            batch.append(entry.filename, entry.info);
+        }
+        return batch.size() > before;
+    }
+
+    if(directoryItem.get() == NULL){
+        s3_start_listing_query(directoryItem, context, params, iocontext._uri, stat_listing);
+    }
+
+    // go on with the next page while the batch isn't full
+    while(fill_listing_batch(*directoryItem, batch, before + count, "S3::listing") == false
+          && batch.size() - before < count
+          && directoryItem->parser->getNextMarker().empty() == false){
+        s3_start_listing_query(directoryItem, context, params, iocontext._uri, stat_listing);
+    }
+    return batch.size() > before;
+}
+
 /////////////////////////
 /////////////////////////
 
@@ -1195,10 +1506,10 @@ void azureStatMapper(Context& context, const RequestParams* params, const Uri &
 
             size_t prop_size = 0;
             do{ // first entry -> container information
-                s_resu = incremental_listdir_parsing(&http_req, &parser, 2048, davix_scope_directory_listing_str());
+                s_resu = incremental_listdir_parsing(handle, davix_scope_directory_listing_str());
 
                 prop_size = parser.getProperties().size();
-                if(s_resu < 2048 && prop_size <1){ // verify request status : if req done + no data -> error
+                if(s_resu == 0 && prop_size <1){ // verify request status : if req done + no data -> error
                     throw DavixException(davix_scope_directory_listing_str(), StatusCode::IsNotADirectory, "The specified directory does not exist");
                 }
                 if(timestamp_timeout < time(NULL)){
@@ -1253,10 +1564,10 @@ static void azure_start_listing_query(std::unique_ptr<DirHandle> & handle, Conte
 
     size_t prop_size = 0;
     do{ // first entry -> container information
-       s_resu = incremental_listdir_parsing(&http_req, &parser, 2048, davix_scope_directory_listing_str());
+       s_resu = incremental_listdir_parsing(*handle, davix_scope_directory_listing_str());
 
        prop_size = parser.getProperties().size();
-       if(s_resu < 2048 && prop_size <1){ // verify request status : if req done + no data -> error
+       if(s_resu == 0 && prop_size <1){ // verify request status : if req done + no data -> error
            throw DavixException(davix_scope_directory_listing_str(), StatusCode::IsNotADirectory, "The specified directory does not exist");
        }
        if(timestamp_timeout < time(NULL)){
@@ -1268,19 +1579,16 @@ static void azure_start_listing_query(std::unique_ptr<DirHandle> & handle, Conte
 
 bool azure_get_next_property(std::unique_ptr<DirHandle> & handle, std::string & name_entry, StatInfo & info) {
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, " -> azure_get_next_property");
-    const size_t read_size = 2048;
-
-    HttpRequest& req = *(handle->request); // setup env again
     XMLPropParser& parser = *(handle->parser);
 
     size_t prop_size = parser.getProperties().size();
-    ssize_t s_resu = read_size;
+    ssize_t s_resu = handle->read_size;
 
     while( prop_size == 0
           && s_resu > 0){ // execute request only if no property are available
 
         // continue the parsing until one more result
-       s_resu = incremental_listdir_parsing(&req, &parser, read_size, "S3::listing");
+       s_resu = incremental_listdir_parsing(*handle, "S3::listing");
        prop_size = parser.getProperties().size();
     }
 
@@ -1311,5 +1619,19 @@ bool AzureMetaOps::nextSubItem(IOChainContext &iocontext, std::string &entry_nam
     }
 }
 
+bool AzureMetaOps::nextSubItems(IOChainContext &iocontext, ListingBatch &batch, size_t count) {
+    if(is_azure_operation(iocontext)){
+        if(directoryItem.get() == NULL){
+            azure_start_listing_query(directoryItem, iocontext._context, iocontext._reqparams, iocontext._uri, stat_listing);
+        }
+
+        const size_t before = batch.size();
+        fill_listing_batch(*directoryItem, batch, before + count, "Azure::listing");
+        return batch.size() > before;
+    }else{
+        return HttpIOChain::nextSubItems(iocontext, batch, count);
+    }
+}
+
 
 } // Davix
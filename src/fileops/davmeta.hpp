@@ -30,6 +30,7 @@
 namespace Davix{
 
 struct DirHandle;
+class PartitionedListing;
 
 ///
 /// \brief The HttpMetaOps class
@@ -60,6 +61,8 @@ public:
 
     virtual bool nextSubItem(IOChainContext &iocontext, std::string &entry_name, StatInfo &info);
 
+    virtual bool nextSubItems(IOChainContext &iocontext, ListingBatch &batch, size_t count);
+
 private:
 
     std::unique_ptr<DirHandle> directoryItem;
@@ -87,9 +90,14 @@ public:
     // listing
     virtual bool nextSubItem(IOChainContext &iocontext, std::string &entry_name, StatInfo &info);
 
+    virtual bool nextSubItems(IOChainContext &iocontext, ListingBatch &batch, size_t count);
+
 private:
     std::unique_ptr<DirHandle> directoryItem;
 
+    // listing fetched in the background, see RequestParams::setListingPrefetch
+    std::unique_ptr<PartitionedListing> prefetchedListing;
+
 };
 
 /// Handle all meta-data operations related to Azure
@@ -110,6 +118,8 @@ public:
     // listing
     virtual bool nextSubItem(IOChainContext &iocontext, std::string &entry_name, StatInfo &info);
 
+    virtual bool nextSubItems(IOChainContext &iocontext, ListingBatch &batch, size_t count);
+
 private:
     std::unique_ptr<DirHandle> directoryItem;
 
@@ -130,11 +140,26 @@ public:
     // listing
     virtual bool nextSubItem(IOChainContext &iocontext, std::string &entry_name, StatInfo &info);
 
+    virtual bool nextSubItems(IOChainContext &iocontext, ListingBatch &batch, size_t count);
+
 private:
     std::unique_ptr<DirHandle> directoryItem;
 
 };
 
+///
+/// Walk the WebDAV collection "url" with a single PROPFIND "Depth: infinity",
+/// calling "fn" for every entry below it, in the server's order, with its
+/// path relative to "url".
+///
+/// Returns false, before calling "fn" at all, if the server refuses the
+/// request. If it answers with direct children only, having quietly capped the
+/// depth, the collections among them are left in "unexplored".
+///
+bool webdav_walk_depth_infinity(Context & context, const RequestParams & params, const Uri & url,
+                                const std::function<void (const std::string &, const StatInfo &)> & fn,
+                                std::vector<std::string> & unexplored);
+
 
 } // Davix
 
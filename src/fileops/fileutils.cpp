@@ -76,7 +76,7 @@ void setup_offset_request(HttpRequest* req, const dav_off_t *start_len, const da
 
 }
 
-std::vector< std::pair<dav_size_t, std::string> > generateRangeHeaders(dav_size_t max_header_size, OffsetCallback & offset_provider){
+std::vector< std::pair<dav_size_t, std::string> > generateRangeHeaders(dav_size_t max_header_size, OffsetCallback & offset_provider, dav_size_t max_ranges){
    std::vector< std::pair<dav_size_t, std::string> > range_rec;
    dav_off_t begin, end;
    int ret;
@@ -97,7 +97,7 @@ std::vector< std::pair<dav_size_t, std::string> > generateRangeHeaders(dav_size_
 
       range_string.append(buffer.str());
       range_size++;
-      if(range_string.size() >= max_header_size){
+      if(range_string.size() >= max_header_size || range_size == max_ranges){
           range_rec.push_back(std::make_pair(range_size, range_string));
           range_size = 0;
           range_string.assign(offset_value);
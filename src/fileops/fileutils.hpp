@@ -46,7 +46,8 @@ void setup_offset_request(HttpRequest* req, const dav_off_t *start_len, const da
 
 typedef std::function<int (dav_off_t &, dav_off_t &)> OffsetCallback;
 
-std::vector< std::pair<dav_size_t, std::string> > generateRangeHeaders(dav_size_t max_header_size, OffsetCallback & offset_provider);
+// split ranges into Range headers of at most ~max_header_size bytes, and at most max_ranges ranges (0 for no limit)
+std::vector< std::pair<dav_size_t, std::string> > generateRangeHeaders(dav_size_t max_header_size, OffsetCallback & offset_provider, dav_size_t max_ranges = 0);
 
 
 } // namespace Davix
@@ -80,6 +80,10 @@ bool HttpIOChain::nextSubItem(IOChainContext &iocontext, std::string &entry_name
     CHAIN_FORWARD(nextSubItem(iocontext, entry_name, info));
 }
 
+bool HttpIOChain::nextSubItems(IOChainContext &iocontext, ListingBatch &batch, size_t count){
+    CHAIN_FORWARD(nextSubItems(iocontext, batch, count));
+}
+
 
 bool HttpIOChain::open(IOChainContext & iocontext, int flags){
    CHAIN_FORWARD(open(iocontext, flags));
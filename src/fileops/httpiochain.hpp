@@ -80,6 +80,9 @@ struct IOChainContext{
     // Keep track of how many bytes we've written to an fd, so as to avoid
     // writing the same bytes again in an event of retries / metalink recovery
     FdHandler fdHandler;
+
+    // entity tag of the last response read by pread, empty if it had none
+    std::string etag;
 };
 
 // Davix IO chain
@@ -121,6 +124,10 @@ public:
     // return false if end of directory is reached
     virtual bool nextSubItem(IOChainContext & iocontext, std::string & entry_name, StatInfo & info);
 
+    // batch listing
+    // append about count entries to batch, return false if end of directory is reached
+    virtual bool nextSubItems(IOChainContext & iocontext, ListingBatch & batch, size_t count);
+
 
     /*
      *     I/O Layer
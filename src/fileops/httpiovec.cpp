@@ -21,33 +21,24 @@
 
 #include <davix_internal.hpp>
 #include "httpiovec.hpp"
+#include "MultipartParser.hpp"
 #include <utils/davix_logger_internal.hpp>
 #include <utils/stringutils.hpp>
 #include "libs/IntervalTree.h"
-
+#include <davix_context_internal.hpp>
+#include <core/WorkerPool.hpp>
+#include <core/EndpointStats.hpp>
+#include <core/MultirangeCapabilities.hpp>
+#include <backend/SessionFactory.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <map>
 
 #define DBG(message) std::cerr << __FILE__ << ":" << __LINE__ << " -- " << #message << " = " << message << std::endl;
 using namespace StrUtil;
 
-// remove trailing crlf
-template<class InputIterator>
-  dav_size_t trim_crlf (InputIterator first, InputIterator last, dav_size_t s)
-{
-  dav_size_t ret = s;
-  while (--last >= first) {
-      if(*last == '\n' || *last == '\r'){
-          *last = '\0';
-          ret--;
-      }else{
-          break;
-      }
-  }
-  return ret;
-}
-
-
-
 namespace Davix{
 
 const std::string HttpIoVec_scope(){
@@ -73,11 +64,6 @@ void HttpIoVecSetupErrorMultiPartSize( DavixError** err, dav_off_t req_offset, d
     DavixError::setupError(err, HttpIoVec_scope(), StatusCode::InvalidServerResponse, ss.str());
 }
 
-inline char* header_delimiter(char* buffer, dav_size_t len){
-    char* p = std::find(buffer, buffer + len, ':');
-    return (p < buffer + len)?p:NULL;
-}
-
 // Vector operation option provider
 /*int davIOVecProvider(const DavIOVecInput *input_vec, dav_ssize_t & counter, dav_ssize_t number, dav_off_t & begin, dav_off_t & end){
     if(counter < number){
@@ -98,16 +84,130 @@ int davIOVecProvider(const SortedRanges ranges, dav_size_t & counter, dav_off_t
 }
 
 
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// feed the endpoint estimates the planner relies upon
+static void recordTransfer(IOChainContext & iocontext, std::chrono::steady_clock::time_point start, dav_ssize_t bytes) {
+    if(bytes < 0)
+        return;
+
+    ContextExplorer::EndpointStatsFromContext(iocontext._context).recordTransfer(
+        SessionFactory::makeSessionKey(iocontext._uri), secondsSince(start), bytes);
+}
+
+// issue a single multi-range request out of a batch produced by generateRangeHeaders
+dav_ssize_t HttpIOVecOps::multirangeBatch(IOChainContext & iocontext,
+                                          const IntervalTree<ElemChunk> &tree,
+                                          const SortedRanges & ranges,
+                                          dav_size_t first,
+                                          const std::pair<dav_size_t, std::string> & batch,
+                                          dav_ssize_t bytes_to_read,
+                                          bool allow_whole_file,
+                                          MultirangeResult::OperationResult & opresult) {
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, " -> getPartialVec request for {} chunks", batch.first);
+    opresult = MultirangeResult::SUCCESS;
+
+    if(batch.first == 1){ // one chunk only : no need of multi part
+        return singleRangeRequest(iocontext, tree, ranges[first].first, ranges[first].second - ranges[first].first + 1);
+    }
+
+    EndpointStats & stats = ContextExplorer::EndpointStatsFromContext(iocontext._context);
+    MultirangeCapabilityCache & capabilities = ContextExplorer::MultirangeCapabilitiesFromContext(iocontext._context);
+    const std::string endpoint = SessionFactory::makeSessionKey(iocontext._uri);
+
+    DavixError * tmp_err=NULL;
+    dav_ssize_t ret = 0;
+
+    GetRequest req (iocontext._context, iocontext._uri, &tmp_err);
+    checkDavixError(&tmp_err);
+
+    RequestParams request_params(iocontext._reqparams);
+    req.setParameters(request_params);
+    req.addHeaderField(req_header_byte_range, batch.second);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if( req.beginRequest(&tmp_err) != 0){
+        checkDavixError(&tmp_err);
+        return -1;
+    }
+
+    const int retcode = req.getRequestCode();
+    stats.recordLatency(endpoint, secondsSince(start));
+
+    // looks like the server supports multi-range requests.. yay
+    if(retcode == 206) {
+        start = std::chrono::steady_clock::now();
+        ret = parseMultipartRequest(req, tree, &tmp_err);
+
+        // could not parse multipart response - server's broken?
+        // known to happen with ceph - return code is 206, but only
+        // returns the first range
+        if(ret == -1) {
+            DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Invalid multipart response: {}", tmp_err ? tmp_err->getErrMsg() : "");
+            DavixError::clearError(&tmp_err);
+            capabilities.recordFailure(endpoint, batch.first);
+            opresult = MultirangeResult::NOMULTIRANGE;
+            req.endRequest(&tmp_err);
+            DavixError::clearError(&tmp_err);
+            return 0;
+        }
+
+        stats.recordThroughput(endpoint, secondsSince(start), ret);
+        capabilities.recordSuccess(endpoint, batch.first);
+    }
+    // no multi-range.. bad server, bad
+    else if(retcode == 200) {
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Multi-range request resulted in getting the whole file.");
+        capabilities.recordFailure(endpoint, batch.first);
+
+        // we have two options: read the entire file or abort current
+        // request and start a multi-range simulation
+
+        // if this is a huge file, reading the entire contents is
+        // definitely not an option - neither is it when other batches
+        // are filling the same buffers concurrently
+        if(!allow_whole_file || (req.getAnswerSize() > 1000000 && req.getAnswerSize() > 2*bytes_to_read)) {
+            DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Will not read the entire file, bailing out");
+            opresult = MultirangeResult::NOMULTIRANGE;
+            req.endRequest(&tmp_err);
+            DavixError::clearError(&tmp_err);
+            return 0;
+        }
+
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Simulating multi-part response from the contents of the entire file");
+        opresult = MultirangeResult::SUCCESS_BUT_NO_MULTIRANGE;
+        ret = simulateMultiPartRequest(req, tree, &tmp_err);
+    }
+    else if(retcode == 416) {
+        ret = 0;
+        DavixError::clearError(&tmp_err);
+    }
+    // Range header too large for this server, use smaller ones from now on
+    else if(retcode == 413 || retcode == 414 || retcode == 431) {
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Range header of {} bytes rejected with {}", batch.second.size(), retcode);
+        capabilities.recordHeaderTooLarge(endpoint, batch.second.size());
+        opresult = MultirangeResult::NOMULTIRANGE;
+        req.endRequest(&tmp_err);
+        DavixError::clearError(&tmp_err);
+        return 0;
+    }
+    else {
+        httpcodeToDavixError(req.getRequestCode(),davix_scope_http_request(),", ", &tmp_err);
+    }
+
+    checkDavixError(&tmp_err);
+    return ret;
+}
+
 // do a multi-range on selected ranges
 MultirangeResult HttpIOVecOps::performMultirange(IOChainContext & iocontext,
                                                  const IntervalTree<ElemChunk> &tree,
-                                                 const SortedRanges & ranges) {
+                                                 const SortedRanges & ranges,
+                                                 const uint nconnections) {
 
-    DavixError * tmp_err=NULL;
-    dav_ssize_t tmp_ret=-1, ret = 0;
-    ptrdiff_t p_diff=0;
     dav_size_t counter = 0;
-    MultirangeResult::OperationResult opresult = MultirangeResult::SUCCESS;
 
     // calculate total bytes to be read (approximate, since ranges could overlap)
     dav_ssize_t bytes_to_read = 0;
@@ -119,83 +219,55 @@ MultirangeResult HttpIOVecOps::performMultirange(IOChainContext & iocontext,
 
     // header line need to be inferior to 8K on Apache2 / ngnix
     // in Addition, some S3 implementation limit the total header size to 4k....
-    // 3900 bytes maximum for the range seems to be a ood compromise
-    std::vector< std::pair<dav_size_t, std::string> > vecRanges = generateRangeHeaders(3900, offsetProvider);
-
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, " -> getPartialVec operation for {} vectors", ranges.size());
-
-    for(std::vector< std::pair<dav_size_t, std::string> >::iterator it = vecRanges.begin(); it < vecRanges.end(); ++it){
-        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, " -> getPartialVec request for {} chunks", it->first);
-
-        if(it->first == 1){ // one chunk only : no need of multi part
-            ret += singleRangeRequest(iocontext, tree, ranges[p_diff].first, ranges[p_diff].second - ranges[p_diff].first + 1);
-            p_diff += 1;
-        }else{
-            GetRequest req (iocontext._context, iocontext._uri, &tmp_err);
-            if(tmp_err == NULL){
-                RequestParams request_params(iocontext._reqparams);
-                req.setParameters(request_params);
-                req.addHeaderField(req_header_byte_range, it->second);
-
-                if( req.beginRequest(&tmp_err) == 0){
-                    const int retcode = req.getRequestCode();
-
-                    // looks like the server supports multi-range requests.. yay
-                    if(retcode == 206) {
-                        ret = parseMultipartRequest(req, tree, &tmp_err);
-
-                        // could not parse multipart response - server's broken?
-                        // known to happen with ceph - return code is 206, but only
-                        // returns the first range
-                        if(ret == -1) {
-                            opresult = MultirangeResult::NOMULTIRANGE;
-                            req.endRequest(&tmp_err);
-                            break;
-                        }
-                    }
-                    // no multi-range.. bad server, bad
-                    else if(retcode == 200) {
-                        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Multi-range request resulted in getting the whole file.");
-                        // we have two options: read the entire file or abort current
-                        // request and start a multi-range simulation
-
-                        // if this is a huge file, reading the entire contents is
-                        // definitely not an option
-                        if(req.getAnswerSize() > 1000000 && req.getAnswerSize() > 2*bytes_to_read) {
-                            DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "File is too large; will not waste bandwidth, bailing out");
-                            opresult = MultirangeResult::NOMULTIRANGE;
-                            req.endRequest(&tmp_err);
-                        }
-                        else {
-                            DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Simulating multi-part response from the contents of the entire file");
-                            opresult = MultirangeResult::SUCCESS_BUT_NO_MULTIRANGE;
-                            ret = simulateMultiPartRequest(req, tree, &tmp_err);
-                        }
-                        break;
-                    }
-                    else if(retcode == 416) {
-                      ret = 0;
-                      DavixError::clearError(&tmp_err);
-                    }
-                    else {
-                        httpcodeToDavixError(req.getRequestCode(),davix_scope_http_request(),", ", &tmp_err);
-                        ret = -1;
-                        break;
-                    }
-
-                    p_diff += it->first;
-                    ret += tmp_ret;
-                } else {
-                   ret = -1;
-                   break;
-                }
-            }
+    // 3900 bytes maximum for the range seems to be a ood compromise, unless the server told us otherwise
+    MultirangeCapability caps = ContextExplorer::MultirangeCapabilitiesFromContext(iocontext._context).get(
+        SessionFactory::makeSessionKey(iocontext._uri));
+    std::vector< std::pair<dav_size_t, std::string> > vecRanges = generateRangeHeaders(caps.maxHeaderSize, offsetProvider, caps.maxRanges);
+
+    // index of the first range covered by each request
+    std::vector<dav_size_t> firstRange;
+    dav_size_t p_diff = 0;
+    for(size_t i = 0; i < vecRanges.size(); i++) {
+        firstRange.push_back(p_diff);
+        p_diff += vecRanges[i].first;
+    }
+
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, " -> getPartialVec operation for {} vectors in {} requests", ranges.size(), vecRanges.size());
+
+    // unless multi-range is known to work on this server, send the first request
+    // on its own: no point in firing off many requests just to get the whole file
+    // back many times
+    size_t probe = (caps.largestSuccess == 0 || vecRanges.size() == 1) ? 1 : 0;
+    dav_ssize_t ret = 0;
+
+    for(size_t i = 0; i < probe; i++) {
+        MultirangeResult::OperationResult opresult;
+        ret += multirangeBatch(iocontext, tree, ranges, firstRange[i], vecRanges[i], bytes_to_read, true, opresult);
+
+        if(opresult != MultirangeResult::SUCCESS) {
+            DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, " <- getPartialVec operation for {} vectors", ranges.size());
+            return MultirangeResult(opresult, ret);
         }
     }
 
+    // the rest goes out concurrently, with a bounded number of requests in flight
+    std::atomic<dav_ssize_t> size(ret);
+    std::atomic<bool> nomultirange(false);
+
+    WorkerPool & pool = ContextExplorer::WorkerPoolFromContext(iocontext._context);
+    pool.forEach(vecRanges.size() - probe, nconnections, [&](size_t i) {
+        if(nomultirange) return;
+
+        MultirangeResult::OperationResult opresult;
+        size += multirangeBatch(iocontext, tree, ranges, firstRange[probe+i], vecRanges[probe+i], bytes_to_read, false, opresult);
+
+        if(opresult != MultirangeResult::SUCCESS) {
+            nomultirange = true;
+        }
+    });
+
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, " <- getPartialVec operation for {} vectors", ranges.size());
-    checkDavixError(&tmp_err);
-    return MultirangeResult(opresult, ret);
+    return MultirangeResult(nomultirange ? MultirangeResult::NOMULTIRANGE : MultirangeResult::SUCCESS, size);
 }
 
 /* fire off a single, one-range request */
@@ -229,7 +301,7 @@ static SortedRanges partialMerging(const IntervalTree<ElemChunk> &tree, const da
 
     for(MergedRanges::iterator it = allranges.begin(); it != allranges.end(); it++) {
         if(end + (dav_off_t) mergedist >= it->first) {
-            end = it->second;
+            end = std::max(end, (dav_off_t) it->second);
         }
         else {
             merged.insert(std::make_pair(offset, end));
@@ -259,84 +331,73 @@ static IntervalTree<ElemChunk> buildIntervalTree(const DavIOVecInput *in, DavIOV
     return IntervalTree<ElemChunk>(intervals);
 }
 
-typedef struct thread_data {
-    HttpIOVecOps *ptr;
-    int thread_no;
-    const SortedRanges *ranges;
-    const IntervalTree<ElemChunk> *tree;
-    IOChainContext *iocontext;
-    dav_size_t start, end;
-
-    dav_ssize_t size;
-    std::exception_ptr exc;
-} thdata;
-
-void* parallelSingleRange(void *args) {
-
-    thdata *data = (thdata*) args;
-    const SortedRanges & ranges = *data->ranges;
-
-    data->size = 0;
-    for(dav_size_t i = data->start; i < data->end; i++) {
-        try {
-          data->size += data->ptr->singleRangeRequest(*data->iocontext, *data->tree,
-                                                      ranges[i].first,
-                                                      ranges[i].second - ranges[i].first + 1);
-        }
-        catch(const Davix::DavixException &err) {
-          data->exc = std::current_exception();
-          return NULL;
-        }
-    }
-
-    return NULL;
-}
-
-
 dav_ssize_t HttpIOVecOps::simulateMultirange(IOChainContext & iocontext,
                                      const IntervalTree<ElemChunk> & tree,
                                      const SortedRanges & ranges,
                                      const uint nconnections) {
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Simulating a multi-range request with {} vectors", ranges.size());
-    dav_ssize_t size = 0;
+    std::atomic<dav_ssize_t> size(0);
 
-    uint num_threads = nconnections;
-    if(num_threads > ranges.size()) {
-        num_threads = ranges.size();
-    }
-    uint queries_per_thread = ranges.size() / num_threads;
-
-    pthread_t threads[num_threads];
-    thdata data[num_threads];
-    for(uint i = 0; i < num_threads; i++) {
-        data[i].ptr = this;
-        data[i].thread_no = i;
-        data[i].ranges = &ranges;
-        data[i].tree = &tree;
-        data[i].iocontext = &iocontext;
-
-        data[i].start = i*queries_per_thread;
-        data[i].end = data[i].start + queries_per_thread;
-
-        if(i == num_threads - 1) {
-            data[i].end = ranges.size();
-        }
+    // idle connections pick up the next merged range, a slow range does not stall the others
+    WorkerPool & pool = ContextExplorer::WorkerPoolFromContext(iocontext._context);
+    pool.forEach(ranges.size(), nconnections, [&](size_t i) {
+        size += singleRangeRequest(iocontext, tree, ranges[i].first,
+                                   ranges[i].second - ranges[i].first + 1);
+    });
 
-        pthread_create(&threads[i], NULL, parallelSingleRange, (void*) &data[i]);
-    }
+    return size;
+}
 
-    for(uint i = 0; i < num_threads; i++) {
-        pthread_join(threads[i], NULL);
-        size += data[i].size;
+// total size of the given ranges, bytes covered by more than one counted once
+static dav_size_t coveredBytes(const DavIOVecInput *in, const dav_size_t count_vec) {
+    MergedRanges ranges;
+    for(dav_size_t i = 0; i < count_vec; i++) {
+        if(in[i].diov_size > 0)
+            ranges.insert(std::make_pair(in[i].diov_offset, in[i].diov_size));
     }
 
-    for(uint i = 0; i < num_threads; i++) {
-        if(data[i].exc != std::exception_ptr()) {
-            std::rethrow_exception(data[i].exc);
+    dav_size_t covered = 0;
+    dav_off_t end = std::numeric_limits<dav_off_t>::min();
+    for(MergedRanges::iterator it = ranges.begin(); it != ranges.end(); it++) {
+        dav_off_t stop = it->first + (dav_off_t) it->second;
+        if(stop > end) {
+            covered += stop - std::max(end, it->first);
+            end = stop;
         }
     }
+    return covered;
+}
 
-    return size;
+static dav_size_t mergedBytes(const SortedRanges & ranges) {
+    dav_size_t total = 0;
+    for(SortedRanges::const_iterator it = ranges.begin(); it != ranges.end(); it++)
+        total += it->second - it->first + 1;
+    return total;
+}
+
+// merge distance worth reading through rather than paying an extra round trip
+dav_size_t HttpIOVecOps::planMergeWindow(const EndpointEstimate & estimate) {
+    if(!estimate.valid())
+        return HttpIOVecOps::kDefaultMergeWindow;
+
+    double bdp = estimate.bandwidthDelayProduct();
+    if(bdp < HttpIOVecOps::kDefaultMergeWindow)
+        return HttpIOVecOps::kDefaultMergeWindow;
+    if(bdp > HttpIOVecOps::kMaxMergeWindow)
+        return HttpIOVecOps::kMaxMergeWindow;
+    return (dav_size_t) bdp;
+}
+
+// enough connections to keep the link busy while each one waits for its next response
+uint HttpIOVecOps::planConnections(const EndpointEstimate & estimate, const SortedRanges & ranges) {
+    if(!estimate.valid() || ranges.empty())
+        return HttpIOVecOps::kDefaultConnections;
+
+    double avgsize = (double) mergedBytes(ranges) / ranges.size();
+    double connections = 1 + estimate.bandwidthDelayProduct() / avgsize;
+    if(connections > HttpIOVecOps::kMaxConnections)
+        return HttpIOVecOps::kMaxConnections;
+    return (uint) connections;
 }
 
 dav_ssize_t HttpIOVecOps::preadVec(IOChainContext & iocontext, const DavIOVecInput * input_vec,
@@ -349,40 +410,69 @@ dav_ssize_t HttpIOVecOps::preadVec(IOChainContext & iocontext, const DavIOVecInp
       output_vec[i].diov_size = 0;
     }
 
+    EndpointEstimate estimate = ContextExplorer::EndpointStatsFromContext(iocontext._context).getEstimate(
+        SessionFactory::makeSessionKey(iocontext._uri));
+
+    VecReadPlan plan;
+    plan.adaptive = estimate.valid();
+
     // size of merge window
-    dav_size_t mergewindow = 2000;
+    plan.merge_window = planMergeWindow(estimate);
     if(iocontext._uri.fragmentParamExists("mergewindow")) {
-        mergewindow = atoi(iocontext._uri.getFragmentParam("mergewindow").c_str());
-        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Setting mergewindow to {}", mergewindow);
+        plan.merge_window = atoi(iocontext._uri.getFragmentParam("mergewindow").c_str());
+        plan.adaptive = false;
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Setting mergewindow to {}", plan.merge_window);
     }
 
+    IntervalTree<ElemChunk> tree = buildIntervalTree(input_vec, output_vec, count_vec);
+    SortedRanges sorted = partialMerging(tree, plan.merge_window);
+
     // number of parallel connections in case of a simulation
-    uint nconnections = 3;
+    plan.nconnections = planConnections(estimate, sorted);
     if(iocontext._uri.fragmentParamExists("nconnections")) {
-        nconnections = atoi(iocontext._uri.getFragmentParam("nconnections").c_str());
-        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Setting number of desired parallel connections to {}", nconnections);
+        plan.nconnections = atoi(iocontext._uri.getFragmentParam("nconnections").c_str());
+        plan.adaptive = false;
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Setting number of desired parallel connections to {}", plan.nconnections);
     }
 
-    IntervalTree<ElemChunk> tree = buildIntervalTree(input_vec, output_vec, count_vec);
+    plan.ranges = sorted.size();
+    plan.bytes_requested = coveredBytes(input_vec, count_vec);
+    plan.bytes_overread = mergedBytes(sorted) - std::min(plan.bytes_requested, mergedBytes(sorted));
+
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Vector read plan ({}): {} vectors merged into {} ranges with mergewindow {}, {} connections, {} bytes requested, {} bytes over-read",
+        plan.adaptive ? "adaptive" : "fixed", count_vec, plan.ranges, plan.merge_window, plan.nconnections, plan.bytes_requested, plan.bytes_overread);
+
+    VecReadPlanHook hook = iocontext._context.getHook<VecReadPlanHook>();
+    if(hook) {
+        hook(iocontext._uri, plan);
+    }
 
     // a lot of servers do not support multirange... should we even try?
     if(count_vec == 1 || iocontext._uri.getFragmentParam("multirange") == "false") {
-        SortedRanges sorted = partialMerging(tree, mergewindow);
-        return simulateMultirange(iocontext, tree, sorted, nconnections);
+        return simulateMultirange(iocontext, tree, sorted, plan.nconnections);
     }
 
-    SortedRanges sorted = partialMerging(tree, mergewindow);
-    MultirangeResult res = performMultirange(iocontext, tree, sorted);
+    if(ContextExplorer::MultirangeCapabilitiesFromContext(iocontext._context).get(SessionFactory::makeSessionKey(iocontext._uri)).unsupported) {
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Server is known not to support multi-range requests, using multiple single-range requests");
+        return simulateMultirange(iocontext, tree, sorted, plan.nconnections);
+    }
+
+    MultirangeResult res = performMultirange(iocontext, tree, sorted, plan.nconnections);
     if(res.res == MultirangeResult::SUCCESS || res.res == MultirangeResult::SUCCESS_BUT_NO_MULTIRANGE) {
         return res.size_bytes;
     }
     else {
         DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Multi-range request has failed, attempting to recover by using multiple single-range requests");
-        sorted = partialMerging(tree, mergewindow);
-        return simulateMultirange(iocontext, tree, sorted, nconnections);
+
+        // some chunks might have been filled already by successful requests
+        for(dav_size_t i = 0; i < count_vec; i++) {
+          output_vec[i].diov_size = 0;
+        }
+        return simulateMultirange(iocontext, tree, sorted, plan.nconnections);
     }
 }
 
+
 int http_extract_boundary_from_content_type(const std::string & buffer, std::string & boundary, DavixError** err){
     dav_size_t pos_bound;
     static const std::string delimiter = "\";";
@@ -413,103 +503,7 @@ int get_multi_part_info(const HttpRequest& req, std::string & boundary, DavixErr
 // analyze header and try to find size of the part
 // return 0 -> not a content length header, return -1 : not a header or error, return 1 : success
 int find_header_params(char* buffer, dav_size_t buffer_len, dav_size_t* part_size, dav_off_t* part_offset){
-    static const std::string delimiter(" bytes-/\t");
-    char * p = header_delimiter(buffer, buffer_len);
-    if(p == NULL)
-        return -1;
-    std::string header_type(buffer, p - buffer);
-    if( compare_ncase(ans_header_byte_range, 0, p - buffer, buffer) !=0) // check header type
-        return 0;
-
-    std::vector<std::string> tokens = tokenSplit(std::string(p+1),delimiter);     // parse header
-    if(tokens.size() < 2)
-        return -1;
-
-    long chunk_size[2];
-    for(int i =0; i <2;++i){
-        chunk_size[i]= strtol(tokens[i].c_str(), &p, 10);
-        if(chunk_size[i] == LONG_MAX || chunk_size[i] < 0 || *p != '\0'){
-            errno =0;
-            return -1;
-        }
-    }
-    if(chunk_size[1] < chunk_size[0])
-        return -1;
-
-    *part_offset= chunk_size[0];
-    *part_size =  chunk_size[1]-chunk_size[0]+1;
-    return 1;
-}
-
-inline dav_ssize_t parse_multi_part_header_line(HttpRequest& req, char* buffer, DavixError** err){
-    dav_ssize_t ret =0;
-    if( (ret = req.readLine(buffer, DAVIX_READ_BLOCK_SIZE, err)) <0 ){
-        return -1;
-    }
-    ret=  trim_crlf(buffer, buffer + ret, ret);
-    return ret;
-}
-
-enum BoundaryType { NORMAL_BOUNDARY, TERMINATING_BOUNDARY, NOT_A_BOUNDARY };
-
-static BoundaryType parseBoundary(char* buffer, const std::string & boundary) {
-    dav_size_t len = strlen(buffer);
-
-    if(len <= 3)
-        return NOT_A_BOUNDARY;
-
-    char *p = buffer;
-    if(*p != '-' || *(p+1) != '-')
-        return NOT_A_BOUNDARY;
-
-    if(strncmp(buffer+2, boundary.c_str(), boundary.size()) != 0)
-        return NOT_A_BOUNDARY;
-
-    if(boundary.size()+2 == len)
-        return NORMAL_BOUNDARY;
-
-    if(boundary.size()+4 == len && *(p+len-2) == '-' && *(p+len-1) == '-')
-        return TERMINATING_BOUNDARY;
-
-    return NOT_A_BOUNDARY;
-}
-
-int  parse_multi_part_header(HttpRequest& req, const std::string & boundary, ChunkInfo & info,
-                            int & n_try, DavixError** err){
-    dav_ssize_t ret =0;
-    char buffer[DAVIX_READ_BLOCK_SIZE+1] = {0};
-
-    if(n_try > 100){
-        HttpIoVecSetupErrorMultiPartTooLong(err);
-        return -1;
-    }
-
-    if( (ret = parse_multi_part_header_line(req, buffer, err)) <0 ){
-        return -1;
-    }
-
-    if(!info.bounded){
-        if(ret == 0) // start with crlf
-            return parse_multi_part_header(req, boundary, info, ++n_try, err);
-
-        BoundaryType type = parseBoundary(buffer, boundary);
-        if(type == NOT_A_BOUNDARY) return -1;
-        if(type == TERMINATING_BOUNDARY) return -2;
-
-        info.bounded = true;
-        return parse_multi_part_header(req, boundary, info, ++n_try, err);
-    }
-
-    if( info.offset == 0 && info.size == 0){
-        if( find_header_params(buffer, ret, &(info.size), &(info.offset)) < 0)
-            return -1;
-        return parse_multi_part_header(req, boundary, info, ++n_try, err);
-    }
-    if(ret == 0) // end crlf
-        return 0;
-
-    HttpIoVecSetupErrorMultiPart(err);
-    return -1;
+    return parseContentRange(buffer, buffer_len, *part_offset, *part_size);
 }
 
 // copy from source to chunk
@@ -544,24 +538,23 @@ static void fillChunks(const char *source, const IntervalTree<ElemChunk> &tree,
     }
 }
 
-dav_ssize_t copyChunk(HttpRequest & req, const IntervalTree<ElemChunk> &tree, dav_off_t offset, dav_size_t size,
-                      DavixError** err){
-    DavixError* tmp_err=NULL;
-    dav_ssize_t ret;
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Davix::parseMultipartRequest::copyChunk copy {} bytes with offset {}", size, offset);
+// payload covered by a single output buffer, and nothing else, can go straight into it
+static bool findDirectTarget(const IntervalTree<ElemChunk> &tree, dav_off_t offset, dav_size_t size, char *&cursor,
+                             const DavIOVecInput *&input, DavIOVecOuput *&output) {
+    std::vector<Interval<ElemChunk> > matches;
+    tree.findOverlapping(offset, offset+size-1, matches);
 
-    std::vector<char> buffer;
-    buffer.resize(size+1);
+    if(matches.size() != 1)
+        return false;
 
-    ret = req.readSegment(&buffer[0], size, &tmp_err);
-    if(ret != (dav_ssize_t) size || tmp_err) {
-        DavixError::propagateError(err, tmp_err);
-    }
-    else {
-        fillChunks(&buffer[0], tree, offset, size);
-    }
+    const DavIOVecInput *in = matches[0].value._in;
+    if(in->diov_offset > offset || in->diov_offset + (dav_off_t) in->diov_size < offset + (dav_off_t) size)
+        return false;
 
-    return ret;
+    cursor = (char*) in->diov_buffer + (offset - in->diov_offset);
+    input = in;
+    output = matches[0].value._ou;
+    return true;
 }
 
 dav_ssize_t HttpIOVecOps::singleRangeRequest(IOChainContext & iocontext,
@@ -570,7 +563,11 @@ dav_ssize_t HttpIOVecOps::singleRangeRequest(IOChainContext & iocontext,
     std::vector<char> buffer;
     buffer.resize(size+1);
 
+    // hedged in HttpIO::pread, if enabled
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
     dav_ssize_t s = _start->pread(iocontext, &buffer[0], size, offset);
+    recordTransfer(iocontext, start, s);
+
     fillChunks(&buffer[0], tree, offset, s);
     return s;
 }
@@ -579,7 +576,6 @@ dav_ssize_t HttpIOVecOps::parseMultipartRequest(HttpRequest & _req,
                                                 const IntervalTree<ElemChunk> & tree,
                                                 DavixError** err) {
     std::string boundary;
-    dav_ssize_t ret = 0, tmp_ret =0;
     DAVIX_SLOG(DAVIX_LOG_TRACE, DAVIX_LOG_CHAIN, "Davix::parseMultipartRequest multi part parsing");
 
     if(get_multi_part_info(_req, boundary, err) != 0){
@@ -588,27 +584,52 @@ dav_ssize_t HttpIOVecOps::parseMultipartRequest(HttpRequest & _req,
     }
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Davix::parseMultipartRequest multi-part boundary {}", boundary);
 
-    while(1) {
-       DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Davix::parseMultipartRequest parsing a new chunk");
-       ChunkInfo infos;
-       int n_try = 0;
+    MultipartParser parser(boundary, [&tree](dav_off_t offset, const char *data, dav_size_t size) {
+        fillChunks(data, tree, offset, size);
+    });
 
-       tmp_ret = parse_multi_part_header(_req, boundary, infos, n_try, err);
-       if(tmp_ret == -2) break; // terminating boundary
-       if(tmp_ret == -1) return -1; // error
+    std::vector<char> buffer(kMultipartReadSize);
+    DavixError* tmp_err = NULL;
 
-       if( (tmp_ret = copyChunk(_req, tree, infos.offset, infos.size, err)) <0 )
-           return -1;
+    while(!parser.done()) {
+        char *cursor;
+        const DavIOVecInput *input;
+        DavIOVecOuput *output;
 
-       ret += tmp_ret;
-       DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Davix::parseMultipartRequest chunk parsed with success, next chunk..");
+        // the rest of this part belongs to a single buffer: no need to bounce it through ours
+        if(parser.inPayload() && findDirectTarget(tree, parser.payloadOffset(), parser.payloadRemaining(), cursor, input, output)) {
+            dav_size_t size = parser.payloadRemaining();
+            DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Davix::parseMultipartRequest read {} bytes with offset {} in place", size, parser.payloadOffset());
+
+            if(_req.readSegment(cursor, size, &tmp_err) != (dav_ssize_t) size || tmp_err) {
+                if(!tmp_err)
+                    HttpIoVecSetupErrorMultiPart(&tmp_err);
+                DavixError::propagateError(err, tmp_err);
+                return -1;
+            }
+
+            output->diov_buffer = input->diov_buffer;
+            output->diov_size += size;
+            parser.skipPayload(size);
+            continue;
+        }
+
+        dav_ssize_t ret = _req.readBlock(&buffer[0], buffer.size(), &tmp_err);
+        if(ret <= 0) {
+            if(!tmp_err)
+                HttpIoVecSetupErrorMultiPart(&tmp_err);
+            DavixError::propagateError(err, tmp_err);
+            return -1;
+        }
+
+        if(parser.feed(&buffer[0], ret, err) < 0)
+            return -1;
     }
 
     // finish with success, dump the remaining part of the query to end the request properly
-    char buffer[255];
-    while( _req.readBlock(buffer, 255, NULL) > 0);
+    while( _req.readBlock(&buffer[0], buffer.size(), NULL) > 0);
 
-    return ret;
+    return parser.payloadBytes();
 }
 
 dav_ssize_t HttpIOVecOps::simulateMultiPartRequest(HttpRequest & _req, const IntervalTree<ElemChunk> & tree, DavixError** err) {
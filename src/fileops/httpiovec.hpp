@@ -25,21 +25,11 @@
 #include <davix.hpp>
 #include <fileops/iobuffmap.hpp>
 #include <fileops/httpiochain.hpp>
+#include <core/EndpointStats.hpp>
 #include "libs/IntervalTree.h"
 
 namespace Davix{
 
-// simple chunk info handler
-struct ChunkInfo {
-    ChunkInfo() :
-        offset(0),
-        size(0),
-        bounded(false){}
-    dav_off_t offset;
-    dav_size_t size;
-    bool bounded;
-};
-
 struct ElemChunk{
     ElemChunk(const DavIOVecInput* in, DavIOVecOuput* ou) :
         _in(in),
@@ -77,12 +67,27 @@ public:
     HttpIOVecOps(){}
     virtual ~HttpIOVecOps(){}
 
+    // defaults used for endpoints we know nothing about yet, and upper bounds for the adaptive plan
+    static const dav_size_t kDefaultMergeWindow = 2000;
+    static const dav_size_t kMaxMergeWindow = 16*1024*1024;
+    static const uint kDefaultConnections = 3;
+    static const uint kMaxConnections = 16;
+
+    // multipart responses are read in blocks of this size, except for payload
+    // that is read directly into the caller's buffer
+    static const dav_size_t kMultipartReadSize = 64*1024;
+
+    // distance under which ranges of a vector read are merged, from the
+    // bandwidth-delay product of the endpoint
+    static dav_size_t planMergeWindow(const EndpointEstimate & estimate);
+
+    // number of connections used by a vector read of the given merged ranges
+    static uint planConnections(const EndpointEstimate & estimate, const SortedRanges & ranges);
+
     dav_ssize_t preadVec(IOChainContext & iocontext, const DavIOVecInput * input_vec,
                               DavIOVecOuput * output_vec,
                               const dav_size_t count_vec);
 
-    // these two should have been private, but because of pthread we need to call them from
-    // a function
     dav_ssize_t singleRangeRequest(IOChainContext & iocontext,
                                    const DavIOVecInput * input,
                                    DavIOVecOuput * output);
@@ -95,7 +100,17 @@ private:
 
     MultirangeResult performMultirange(IOChainContext & iocontext,
                                        const IntervalTree<ElemChunk> &tree,
-                                       const SortedRanges & ranges);
+                                       const SortedRanges & ranges,
+                                       uint nconnections);
+
+    dav_ssize_t multirangeBatch(IOChainContext & iocontext,
+                                const IntervalTree<ElemChunk> &tree,
+                                const SortedRanges & ranges,
+                                dav_size_t first,
+                                const std::pair<dav_size_t, std::string> & batch,
+                                dav_ssize_t bytes_to_read,
+                                bool allow_whole_file,
+                                MultirangeResult::OperationResult & opresult);
 
     dav_ssize_t simulateMultirange(IOChainContext & iocontext,
                                    const IntervalTree<ElemChunk> & tree,
@@ -117,9 +132,6 @@ int find_header_params(char* buffer, dav_size_t buffer_len, dav_size_t* part_siz
 int http_extract_boundary_from_content_type(const std::string & buffer, std::string & boundary, DavixError** err);
 
 
-int parse_multi_part_header(HttpRequest& req, const std::string & boundary, ChunkInfo & info,
-                            int & n_try, DavixError** err);
-
 void HttpIoVecSetupErrorMultiPart(DavixError** err);
 
 } // Davix
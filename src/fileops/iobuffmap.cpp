@@ -29,6 +29,13 @@
 #include <utils/davix_env_variables.hpp>
 #include <fileops/httpiovec.hpp>
 #include <fileops/davmeta.hpp>
+#include <fileops/ReadAheadCache.hpp>
+#include <fileops/SegmentedDownloader.hpp>
+#include <davix_context_internal.hpp>
+#include <backend/SessionFactory.hpp>
+#include <core/Hedger.hpp>
+#include <core/ReplicaCache.hpp>
+#include <core/WorkerPool.hpp>
 
 #include <sstream>
 #include <string>
@@ -37,6 +44,8 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <sys/stat.h>
+#include <unistd.h>
 
 
 namespace Davix {
@@ -165,14 +174,17 @@ dav_ssize_t HttpIO::readFull(IOChainContext & iocontext, std::vector<char> & buf
 }
 
 
-dav_ssize_t HttpIO::pread(IOChainContext & iocontext, void *buf, dav_size_t count, dav_off_t offset){
+// ranged GET into buf, given up on as soon as "cancelled" is raised
+static dav_ssize_t pread_request(Context & context, const Uri & uri, const RequestParams * reqparams,
+                                 void *buf, dav_size_t count, dav_off_t offset, std::string & etag,
+                                 const std::atomic<bool> * cancelled){
     DavixError * tmp_err=NULL;
     dav_ssize_t ret = -1;
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "pread operation for {} with size {} and offset {}", iocontext._uri, count, offset);
-    if(count ==0)
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "pread operation for {} with size {} and offset {}", uri, count, offset);
+    if(cancelled != NULL && *cancelled)
         return 0;
 
-    HttpRequest req(iocontext._context, iocontext._uri, &tmp_err);
+    HttpRequest req(context, uri, &tmp_err);
 
     // Check Partial Content support via response header
     // (EOS supports Partial Content but returns 200 instead of 206)
@@ -185,11 +197,18 @@ dav_ssize_t HttpIO::pread(IOChainContext & iocontext, void *buf, dav_size_t coun
     };
 
     if(tmp_err == NULL){
-        RequestParams params(iocontext._reqparams);
+        RequestParams params(reqparams);
         req.setParameters(params);
         setup_offset_request(&req, &offset, &count,1);
         if(req.beginRequest(&tmp_err) ==0){
-            if(req.getRequestCode() == 416 ){ // out of file, end of file
+            etag.clear();
+            req.getAnswerHeader("ETag", etag);
+
+            if(cancelled != NULL && *cancelled){
+                // the other read of a hedged read answered first
+                DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "pread operation for {} not needed anymore", uri);
+                ret = 0;
+            }else if(req.getRequestCode() == 416 ){ // out of file, end of file
                 ret = 0; // end of file
                 DavixError::clearError(&tmp_err);
             }else{
@@ -213,11 +232,61 @@ dav_ssize_t HttpIO::pread(IOChainContext & iocontext, void *buf, dav_size_t coun
         }
         req.endRequest(NULL);
     }
-    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "end pread operation for {} ",iocontext._uri);
+    DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "end pread operation for {} ", uri);
     checkDavixError(&tmp_err);
     return ret;
 }
 
+// pread sent again, to a replica or the same server, if it takes too long
+static dav_ssize_t hedged_pread(IOChainContext & iocontext, void *buf, dav_size_t count, dav_off_t offset){
+    Context & context = iocontext._context;
+    const Uri uri = iocontext._uri;
+    const RequestParams params(iocontext._reqparams);
+
+    // a replica we know of already, never worth a Metalink lookup here
+    Uri target = uri;
+    bool replica = false;
+    if(params.getMetalinkMode() != MetalinkMode::Disable){
+        ReplicaCache & cache = ContextExplorer::ReplicaCacheFromContext(context);
+        std::vector<std::string> replicas;
+        if(cache.get(uri.getString(), replicas)){
+            for(std::vector<std::string>::iterator it = replicas.begin(); it != replicas.end(); ++it){
+                if(*it != uri.getString() && cache.isHealthy(*it)){
+                    target = Uri(*it);
+                    replica = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    // the slower read may outlive this call: it gets copies of everything
+    std::shared_ptr<std::vector<std::string> > etags = std::make_shared<std::vector<std::string> >(2);
+    Hedger::ReadFunction fn = [&context, uri, target, params, count, offset, etags](size_t attempt, char *buffer, const std::atomic<bool> & cancelled){
+        return pread_request(context, (attempt == 0) ? uri : target, &params, buffer, count, offset, (*etags)[attempt], &cancelled);
+    };
+
+    size_t winner;
+    dav_ssize_t ret = ContextExplorer::HedgerFromContext(context).read(ContextExplorer::WorkerPoolFromContext(context),
+        SessionFactory::makeSessionKey(uri), params.getHedgePercentile(), params.getHedgeMaxRatio(),
+        static_cast<char*>(buf), count, fn, winner);
+
+    // the entity tag of another server tells nothing about this one
+    iocontext.etag = (winner == 1 && replica) ? std::string() : (*etags)[winner];
+    return ret;
+}
+
+dav_ssize_t HttpIO::pread(IOChainContext & iocontext, void *buf, dav_size_t count, dav_off_t offset){
+    if(count ==0)
+        return 0;
+
+    if(iocontext._reqparams->getHedgePercentile() > 0){
+        return hedged_pread(iocontext, buf, count, offset);
+    }
+
+    return pread_request(iocontext._context, iocontext._uri, iocontext._reqparams, buf, count, offset, iocontext.etag, NULL);
+}
+
 #define SSTR(message) static_cast<std::ostringstream&>(std::ostringstream().flush() << message).str()
 
 dav_ssize_t HttpIO::readToFd(IOChainContext & iocontext, int fd, dav_size_t read_size){
@@ -231,6 +300,15 @@ dav_ssize_t HttpIO::readToFd(IOChainContext & iocontext, int fd, dav_size_t read
 
     DAVIX_SCOPE_TRACE(DAVIX_LOG_CHAIN, fun_readToFd);
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "request size {}", read_size);
+
+    if(read_size == 0 && iocontext.fdHandler.bytes_written_to_fd == 0 && iocontext._reqparams->getDownloadParallelism() > 1){
+        ret = readToFdSegmented(iocontext, fd);
+        if(ret >= 0){
+            iocontext.fdHandler.bytes_written_to_fd += ret;
+            return ret;
+        }
+    }
+
     GetRequest req (iocontext._context, iocontext._uri, &tmp_err);
     if(!tmp_err){
         RequestParams params(iocontext._reqparams);
@@ -260,6 +338,104 @@ dav_ssize_t HttpIO::readToFd(IOChainContext & iocontext, int fd, dav_size_t read
     return ret;
 }
 
+void read_range_request(IOChainContext & iocontext, dav_off_t offset, dav_size_t size,
+                        const std::function<bool (const char*, dav_size_t)> & write,
+                        const std::atomic<bool> * cancelled){
+    DavixError * tmp_err=NULL;
+    if(cancelled != NULL && *cancelled)
+        return;
+
+    GetRequest req (iocontext._context, iocontext._uri, &tmp_err);
+    checkDavixError(&tmp_err);
+
+    RequestParams params(iocontext._reqparams);
+    req.setParameters(params);
+    req.addHeaderField("Range", SSTR("bytes=" << offset << "-" << (offset + size - 1)));
+
+    req.beginRequest(&tmp_err);
+    checkDavixError(&tmp_err);
+
+    if(cancelled != NULL && *cancelled){
+        // the range was taken over by another source meanwhile - the caller
+        // may be gone already, iocontext included
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "range {}-{} not needed anymore", offset, offset + size);
+        req.endRequest(NULL);
+        return;
+    }
+
+    // EOS answers ranges with 200, and a matching Content-Range
+    std::string content_range;
+    req.getAnswerHeader("Content-Range", content_range);
+    const bool partial = (content_range.find(SSTR("bytes " << offset << "-")) != std::string::npos);
+
+    if(req.getRequestCode() != 206 && !(req.getRequestCode() == 200 && partial)){
+        if(httpcodeIsValid(req.getRequestCode())){
+            throw DavixException(davix_scope_io_buff(), StatusCode::OperationNonSupported, "Server ignored the range of a segment");
+        }
+        httpcodeToDavixError(req.getRequestCode(), davix_scope_io_buff(), "read error: ", &tmp_err);
+        checkDavixError(&tmp_err);
+    }
+
+    std::vector<char> buffer(DAVIX_SEGMENT_READ_SIZE);
+    dav_ssize_t ret;
+    while( (ret = req.readBlock(&buffer[0], buffer.size(), &tmp_err)) > 0){
+        if(!write(&buffer[0], ret) || (cancelled != NULL && *cancelled)){
+            break;
+        }
+    }
+
+    checkDavixError(&tmp_err);
+    req.endRequest(NULL);
+}
+
+dav_ssize_t HttpIO::readToFdSegmented(IOChainContext & iocontext, int fd){
+    struct stat fd_st;
+    if(fstat(fd, &fd_st) != 0 || !S_ISREG(fd_st.st_mode)){
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "fd {} is not a regular file, no segmented download", fd);
+        return -1;
+    }
+
+    const off_t base = ::lseek(fd, 0, SEEK_CUR);
+    if(base < 0){
+        return -1;
+    }
+
+    SegmentedDownloader downloader(iocontext._context, *iocontext._reqparams);
+
+    StatInfo st;
+    try{
+        _start->statInfo(iocontext, st);
+    }catch(DavixException & e){
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_CHAIN, "Unable to get the size of {}: {}, no segmented download", iocontext._uri, e.what());
+        return -1;
+    }
+
+    if(S_ISDIR(st.mode) || st.size <= downloader.getSegmentSize()){
+        return -1;
+    }
+
+    dav_size_t total;
+    try{
+        total = downloader.download(fd, base, st.size,
+            [&](size_t source, dav_off_t offset, dav_size_t size, const SegmentedDownloader::WriteFunction & write,
+                const std::atomic<bool> & cancelled){
+                read_range_request(iocontext, offset, size, write, &cancelled);
+            });
+    }catch(DavixException & e){
+        if(e.code() != StatusCode::OperationNonSupported){
+            throw;
+        }
+
+        // whatever was written is overwritten by a plain GET from the same offset
+        DAVIX_SLOG(DAVIX_LOG_VERBOSE, DAVIX_LOG_CHAIN, "Segmented download of {} not possible: {}, downloading it whole", iocontext._uri, e.what());
+        return -1;
+    }
+
+    // same position as after a sequential download
+    ::lseek(fd, base + total, SEEK_SET);
+    return total;
+}
+
 dav_ssize_t HttpIO::writeFromProvider(IOChainContext & iocontext, ContentProvider &provider) {
     DavixError * tmp_err=NULL;
 
@@ -377,6 +553,17 @@ bool HttpIOBuffer::open(IOChainContext & iocontext, int flags){
         }
     }
 
+    const dav_size_t read_ahead_limit = iocontext._reqparams->getReadAheadLimit();
+    if(_file_exist && read_ahead_limit > 0){
+        // fetches go straight down the chain, each with its own copy of the
+        // context - the one of the fd outlives this buffer
+        const IOChainContext fetch_context(iocontext);
+        _read_ahead.reset(new ReadAheadCache(iocontext._context, [this, fetch_context](char* buffer, dav_size_t count, dav_off_t offset){
+            IOChainContext ctx(fetch_context);
+            return _next->pread(ctx, buffer, count, offset);
+        }, read_ahead_limit));
+    }
+
     DAVIX_SLOG(DAVIX_LOG_TRACE, DAVIX_LOG_CHAIN, "File open {}, size: {}", iocontext._uri, _file_size);
     return res;
 }
@@ -388,7 +575,11 @@ dav_ssize_t HttpIOBuffer::read(IOChainContext & iocontext, void *buf, dav_size_t
 
     if(_pos ==0) // reset read ahead offset to default if try to read a full file
         resetIO(iocontext);
-    if(_pos == _read_pos && isAdviseFullRead()){
+    if(isAdviseWindowRead()){
+        // keep the window ahead of the reader in flight, and read from it
+        _read_ahead->advance(_pos, _file_size);
+        ret = _start->pread(iocontext, buf, count, _pos);
+    }else if(_pos == _read_pos && isAdviseFullRead()){
         // try read ahead strategie
         ret = readInternal(iocontext, buf, count);
     }else{ // fallback on partial read
@@ -452,10 +643,29 @@ dav_ssize_t HttpIOBuffer::readInternal(IOChainContext & iocontext, void *buffer,
 
 
 
+dav_ssize_t HttpIOBuffer::pread(IOChainContext & iocontext, void *buf, dav_size_t count, dav_off_t offset){
+    if(!_read_ahead)
+        return HttpIOChain::pread(iocontext, buf, count, offset);
+
+    dav_ssize_t ret = _read_ahead->read(buf, count, offset);
+    if(ret == (dav_ssize_t) count || (_file_size > 0 && offset + ret >= (dav_off_t) _file_size))
+        return ret;
+
+    // not or not entirely cached
+    dav_ssize_t rest = HttpIOChain::pread(iocontext, static_cast<char*>(buf) + ret, count - ret, offset + ret);
+    return (rest < 0) ? rest : ret + rest;
+}
+
+
 void HttpIOBuffer::prefetchInfo(IOChainContext & iocontext, off_t offset, dav_size_t size_read, advise_t adv){
     (void) iocontext;
-    (void) offset;
-    (void) size_read;
+
+    if(adv == AdviseWillNeed){
+        // a hint about a range, not about the access pattern
+        if(_read_ahead && size_read > 0)
+            _read_ahead->willNeed(offset, size_read);
+        return;
+    }
     _last_advise = adv;
 }
 
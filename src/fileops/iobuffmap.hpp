@@ -23,6 +23,7 @@
 #ifndef DAVIX_IOBUFFMAP_HPP
 #define DAVIX_IOBUFFMAP_HPP
 
+#include <atomic>
 #include <davix_internal.hpp>
 #include <fileops/fileutils.hpp>
 #include <fileops/httpiochain.hpp>
@@ -60,6 +61,11 @@ public:
 
 private:
 
+    // download a whole file into a regular file in parallel segments, see
+    // RequestParams::setDownloadParallelism. Returns -1 if it can't be done
+    // that way, without having made any progress.
+    dav_ssize_t readToFdSegmented(IOChainContext & iocontext, int fd);
+
 
     HttpIO(const HttpIO & );
     HttpIO & operator=(const HttpIO & );
@@ -69,6 +75,7 @@ private:
 
 
 struct IOBufferLocalFile;
+class ReadAheadCache;
 
 ///
 /// RW operation with buffering support and POSIX like interface
@@ -84,6 +91,9 @@ public:
     //
     virtual dav_ssize_t read(IOChainContext & iocontext, void* buf, dav_size_t count);
 
+    // position independant read, served from the read-ahead cache when possible
+    virtual dav_ssize_t pread(IOChainContext & iocontext, void* buf, dav_size_t count, dav_off_t offset);
+
 
     // give information on the future operation for prefecting
     virtual void prefetchInfo(IOChainContext & iocontext, off_t offset, dav_size_t size_read, advise_t adv);
@@ -117,12 +127,20 @@ protected:
     bool _read_endfile;
     HttpRequest * _read_req;
 
+    // ranges fetched ahead of time, see RequestParams::setReadAheadLimit
+    std::unique_ptr<ReadAheadCache> _read_ahead;
+
 private:
 
     inline bool isAdviseFullRead(){
         return (_last_advise == AdviseAuto || _last_advise == AdviseSequential);
     }
 
+    // sequential reads with a read-ahead window need to know where the file ends
+    inline bool isAdviseWindowRead(){
+        return (_last_advise == AdviseSequential && _read_ahead && _file_size > 0);
+    }
+
     dav_ssize_t readInternal(IOChainContext & iocontext, void *buffer, dav_size_t size_read);
 
     HttpIOBuffer(const HttpIOBuffer & );
@@ -135,6 +153,13 @@ int get_valid_cache_file(FILE** stream, DavixError** err);
 
 dav_ssize_t read_segment_request(HttpRequest* req, void* buffer, dav_size_t size_read, DavixError**err);
 
+// fetch a range with its own GET, passing the body to "write" as it comes,
+// until it returns false or "cancelled" is raised. Throws
+// OperationNonSupported if the server ignores the range.
+void read_range_request(IOChainContext & iocontext, dav_off_t offset, dav_size_t size,
+                        const std::function<bool (const char*, dav_size_t)> & write,
+                        const std::atomic<bool> * cancelled = NULL);
+
 
 } // namespace Davix
 
@@ -25,7 +25,7 @@ namespace Davix{
 
 
 
-HookList::HookList() : _pre_run_req(), _pre_send_req(), _pre_rece_req()
+HookList::HookList() : _pre_run_req(), _pre_send_req(), _pre_rece_req(), _vec_read_plan()
 {}
 
 }
@@ -151,7 +151,7 @@ NEONSession::NEONSession(NEONSessionFactory &f, NeonHandlePtr sess, const Uri &
 NEONSession::~NEONSession(){
         if(_sess){
             if(_session_recycling) {
-                _f.storeNeonSession(std::move(_sess));
+                _f.storeNeonSession(std::move(_sess), _params);
             }
             else {
                 _sess.reset();
@@ -85,9 +85,19 @@ NeonHandlePtr NEONSessionFactory::createNeonSession(const RequestParams & params
     return NeonHandlePtr();
 }
 
-void NEONSessionFactory::storeNeonSession(NeonHandlePtr sess){
+void NEONSessionFactory::storeNeonSession(NeonHandlePtr sess, const RequestParams &params){
     DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_HTTP, "add old session to cache {}", sess->key.c_str());
-    _session_pool.insert(sess->key, sess);
+    const struct timespec* timeout = params.getIdleConnectionTimeout();
+    std::chrono::milliseconds idle(timeout->tv_sec * 1000 + timeout->tv_nsec / 1000000);
+
+    _session_pool.insert(sess->key, sess, idle, params.getMaxIdleConnections());
+}
+
+//------------------------------------------------------------------------------
+// Close expired idle sessions periodically
+//------------------------------------------------------------------------------
+void NEONSessionFactory::setReapInterval(std::chrono::milliseconds interval) {
+    _session_pool.setReapInterval(interval);
 }
 
 NeonHandlePtr NEONSessionFactory::create_session(const RequestParams & params, const std::string & protocol, const std::string &host, unsigned int port){
@@ -131,7 +141,11 @@ NeonHandlePtr NEONSessionFactory::create_recycled_session(const RequestParams &
 }
 
 std::string create_map_keys_from_URL(const std::string & protocol, const std::string &host, unsigned int port){
-    return SSTR(protocol << host << ":" << port);
+    std::string key = protocol;
+    key.append(host);
+    key.append(":");
+    key.append(std::to_string(port));
+    return key;
 }
 
 //------------------------------------------------------------------------------
@@ -22,6 +22,7 @@
 #ifndef DAVIX_NEONSESSIONFACTORY_H
 #define DAVIX_NEONSESSIONFACTORY_H
 
+#include <chrono>
 #include <map>
 #include <mutex>
 #include <utils/davix_uri.hpp>
@@ -55,9 +56,16 @@ public:
     std::unique_ptr<NEONSession> provideNEONSession(const Uri &uri, const RequestParams &params, DavixError **err);
 
     //--------------------------------------------------------------------------
-    // Store a Neon session object for session reuse purposes
+    // Store a Neon session object for session reuse purposes, subject to the
+    // idle connection policies of the given parameters
     //--------------------------------------------------------------------------
-    void storeNeonSession(NeonHandlePtr sess);
+    void storeNeonSession(NeonHandlePtr sess, const RequestParams &params);
+
+    //--------------------------------------------------------------------------
+    // Close expired idle sessions every "interval" from a background
+    // thread, 0 disables it
+    //--------------------------------------------------------------------------
+    void setReapInterval(std::chrono::milliseconds interval);
 
     //--------------------------------------------------------------------------
     // Set caching on or off
@@ -120,12 +120,33 @@ struct RequestParamsInternal{
         _copy_mode(CopyMode::Push),
         _support_100continue(true),
         _accepted_retry(180), // wait for half an hour by default
-        _accepted_delay(10)
+        _accepted_delay(10),
+        _http2_multiplexing(false),
+        _max_concurrent_streams(100),
+        _idle_timeout(),
+        _max_idle(DAVIX_DEFAULT_MAX_IDLE_CONN),
+        _upload_part_size(DAVIX_DEFAULT_UPLOAD_PART_SIZE),
+        _upload_parallelism(DAVIX_DEFAULT_UPLOAD_PARALLELISM),
+        _upload_manifest(),
+        _listing_prefetch(DAVIX_DEFAULT_LISTING_PREFETCH),
+        _listing_partitions(DAVIX_DEFAULT_LISTING_PARTITIONS),
+        _walk_parallelism(DAVIX_DEFAULT_WALK_PARALLELISM),
+        _walk_host_limit(DAVIX_DEFAULT_WALK_HOST_LIMIT),
+        _walk_depth_infinity(true),
+        _read_ahead_limit(DAVIX_DEFAULT_READ_AHEAD_LIMIT),
+        _download_segment_size(DAVIX_DEFAULT_DOWNLOAD_SEGMENT_SIZE),
+        _download_parallelism(DAVIX_DEFAULT_DOWNLOAD_PARALLELISM),
+        _hedge_percentile(0),
+        _hedge_max_ratio(DAVIX_DEFAULT_HEDGE_MAX_RATIO),
+        _retry_backoff_base(DAVIX_DEFAULT_RETRY_BACKOFF_BASE),
+        _retry_backoff_max(DAVIX_DEFAULT_RETRY_BACKOFF_MAX)
     {
         timespec_clear(&connexion_timeout);
         timespec_clear(&ops_timeout);
+        timespec_clear(&_idle_timeout);
         connexion_timeout.tv_sec = DAVIX_DEFAULT_CONN_TIMEOUT;
         ops_timeout.tv_sec = DAVIX_DEFAULT_OPS_TIMEOUT;
+        _idle_timeout.tv_sec = DAVIX_DEFAULT_IDLE_CONN_TIMEOUT;
     }
 
     virtual ~RequestParamsInternal(){
@@ -172,10 +193,30 @@ struct RequestParamsInternal{
         _copy_mode(param_private._copy_mode),
         _support_100continue(param_private._support_100continue),
         _accepted_retry(param_private._accepted_retry),
-        _accepted_delay(param_private._accepted_delay) {
+        _accepted_delay(param_private._accepted_delay),
+        _http2_multiplexing(param_private._http2_multiplexing),
+        _max_concurrent_streams(param_private._max_concurrent_streams),
+        _idle_timeout(),
+        _max_idle(param_private._max_idle),
+        _upload_part_size(param_private._upload_part_size),
+        _upload_parallelism(param_private._upload_parallelism),
+        _upload_manifest(param_private._upload_manifest),
+        _listing_prefetch(param_private._listing_prefetch),
+        _listing_partitions(param_private._listing_partitions),
+        _walk_parallelism(param_private._walk_parallelism),
+        _walk_host_limit(param_private._walk_host_limit),
+        _walk_depth_infinity(param_private._walk_depth_infinity),
+        _read_ahead_limit(param_private._read_ahead_limit),
+        _download_segment_size(param_private._download_segment_size),
+        _download_parallelism(param_private._download_parallelism),
+        _hedge_percentile(param_private._hedge_percentile),
+        _hedge_max_ratio(param_private._hedge_max_ratio),
+        _retry_backoff_base(param_private._retry_backoff_base),
+        _retry_backoff_max(param_private._retry_backoff_max) {
 
         timespec_copy(&(connexion_timeout), &(param_private.connexion_timeout));
         timespec_copy(&(ops_timeout), &(param_private.ops_timeout));
+        timespec_copy(&(_idle_timeout), &(param_private._idle_timeout));
     }
     bool _ssl_check; // ssl CA check
     bool _redirection; // redirection support
@@ -253,6 +294,44 @@ struct RequestParamsInternal{
     // delay in seconds between retries in case davix receives 202-Accepted
     int _accepted_delay;
 
+    // multiplex concurrent requests to the same endpoint over HTTP/2 (libcurl backend)
+    bool _http2_multiplexing;
+
+    // max number of concurrent HTTP/2 streams per connection
+    unsigned int _max_concurrent_streams;
+
+    // idle pooled connections: how long they are kept, and how many per host
+    struct timespec _idle_timeout;
+    unsigned int _max_idle;
+
+    // multi-part uploads: part size, and parts sent in parallel
+    dav_size_t _upload_part_size;
+    unsigned int _upload_parallelism;
+    std::string _upload_manifest;
+    unsigned int _listing_prefetch;
+    unsigned int _listing_partitions;
+
+    // recursive walks
+    unsigned int _walk_parallelism;
+    unsigned int _walk_host_limit;
+    bool _walk_depth_infinity;
+
+    // read-ahead of POSIX file descriptors
+    dav_size_t _read_ahead_limit;
+
+    // segmented downloads: segment size, and segments fetched in parallel
+    dav_size_t _download_segment_size;
+    unsigned int _download_parallelism;
+
+    // hedged reads: latency percentile after which a read is duplicated, and
+    // largest fraction of reads duplicated
+    double _hedge_percentile;
+    double _hedge_max_ratio;
+
+    // exponential backoff between retries, in milliseconds
+    unsigned int _retry_backoff_base;
+    unsigned int _retry_backoff_max;
+
     // method
     inline void regenerateStateUid(){
         _state_uid = get_requeste_uid();
@@ -625,6 +704,158 @@ void RequestParams::setAcceptedRetryDelay(int delay) {
   d_ptr->_accepted_delay = delay;
 }
 
+void RequestParams::setHttp2Multiplexing(bool enabled) {
+  d_ptr->_http2_multiplexing = enabled;
+}
+
+bool RequestParams::getHttp2Multiplexing() const {
+  return d_ptr->_http2_multiplexing;
+}
+
+void RequestParams::setMaxConcurrentStreams(unsigned int max_streams) {
+  d_ptr->_max_concurrent_streams = max_streams;
+}
+
+unsigned int RequestParams::getMaxConcurrentStreams() const {
+  return d_ptr->_max_concurrent_streams;
+}
+
+void RequestParams::setIdleConnectionTimeout(struct timespec *idle_timeout) {
+  timespec_copy(&(d_ptr->_idle_timeout), idle_timeout);
+}
+
+const struct timespec* RequestParams::getIdleConnectionTimeout() const {
+  return &d_ptr->_idle_timeout;
+}
+
+void RequestParams::setMaxIdleConnections(unsigned int max_idle) {
+  d_ptr->_max_idle = max_idle;
+}
+
+unsigned int RequestParams::getMaxIdleConnections() const {
+  return d_ptr->_max_idle;
+}
+
+void RequestParams::setUploadPartSize(dav_size_t part_size) {
+  d_ptr->_upload_part_size = part_size;
+}
+
+dav_size_t RequestParams::getUploadPartSize() const {
+  return d_ptr->_upload_part_size;
+}
+
+void RequestParams::setUploadParallelism(unsigned int parallelism) {
+  d_ptr->_upload_parallelism = parallelism;
+}
+
+unsigned int RequestParams::getUploadParallelism() const {
+  return d_ptr->_upload_parallelism;
+}
+
+void RequestParams::setUploadManifest(const std::string &path) {
+  d_ptr->_upload_manifest = path;
+}
+
+const std::string & RequestParams::getUploadManifest() const {
+  return d_ptr->_upload_manifest;
+}
+
+void RequestParams::setListingPrefetch(unsigned int pages) {
+  d_ptr->_listing_prefetch = pages;
+}
+
+unsigned int RequestParams::getListingPrefetch() const {
+  return d_ptr->_listing_prefetch;
+}
+
+void RequestParams::setListingPartitions(unsigned int partitions) {
+  d_ptr->_listing_partitions = partitions;
+}
+
+unsigned int RequestParams::getListingPartitions() const {
+  return d_ptr->_listing_partitions;
+}
+
+void RequestParams::setWalkParallelism(unsigned int parallelism) {
+  d_ptr->_walk_parallelism = parallelism;
+}
+
+unsigned int RequestParams::getWalkParallelism() const {
+  return d_ptr->_walk_parallelism;
+}
+
+void RequestParams::setWalkHostLimit(unsigned int limit) {
+  d_ptr->_walk_host_limit = limit;
+}
+
+unsigned int RequestParams::getWalkHostLimit() const {
+  return d_ptr->_walk_host_limit;
+}
+
+void RequestParams::setWalkDepthInfinity(bool enable) {
+  d_ptr->_walk_depth_infinity = enable;
+}
+
+bool RequestParams::getWalkDepthInfinity() const {
+  return d_ptr->_walk_depth_infinity;
+}
+
+void RequestParams::setReadAheadLimit(dav_size_t limit) {
+  d_ptr->_read_ahead_limit = limit;
+}
+
+dav_size_t RequestParams::getReadAheadLimit() const {
+  return d_ptr->_read_ahead_limit;
+}
+
+void RequestParams::setDownloadSegmentSize(dav_size_t segment_size) {
+  d_ptr->_download_segment_size = segment_size;
+}
+
+dav_size_t RequestParams::getDownloadSegmentSize() const {
+  return d_ptr->_download_segment_size;
+}
+
+void RequestParams::setDownloadParallelism(unsigned int parallelism) {
+  d_ptr->_download_parallelism = parallelism;
+}
+
+unsigned int RequestParams::getDownloadParallelism() const {
+  return d_ptr->_download_parallelism;
+}
+
+void RequestParams::setHedgePercentile(double percentile) {
+  d_ptr->_hedge_percentile = percentile;
+}
+
+double RequestParams::getHedgePercentile() const {
+  return d_ptr->_hedge_percentile;
+}
+
+void RequestParams::setHedgeMaxRatio(double ratio) {
+  d_ptr->_hedge_max_ratio = ratio;
+}
+
+double RequestParams::getHedgeMaxRatio() const {
+  return d_ptr->_hedge_max_ratio;
+}
+
+void RequestParams::setRetryBackoffBase(unsigned int base) {
+  d_ptr->_retry_backoff_base = base;
+}
+
+unsigned int RequestParams::getRetryBackoffBase() const {
+  return d_ptr->_retry_backoff_base;
+}
+
+void RequestParams::setRetryBackoffMax(unsigned int max) {
+  d_ptr->_retry_backoff_max = max;
+}
+
+unsigned int RequestParams::getRetryBackoffMax() const {
+  return d_ptr->_retry_backoff_max;
+}
+
 // suppress useless warning
 #pragma GCC diagnostic ignored "-Wint-to-pointer-cast"
 void* RequestParams::getParmState() const{
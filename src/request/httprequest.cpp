@@ -454,6 +454,9 @@ void httpcodeToDavixError(int code, const std::string & scope, const std::string
     std::string err_msg;
     httpcodeToDavixError(code, scope, end_message, davix_code, err_msg);
     DavixError::setupError(err, scope, davix_code, err_msg);
+    if(err && *err && davix_code != StatusCode::OK){
+        (*err)->setHttpStatus(code);
+    }
 }
 
 
@@ -461,7 +464,9 @@ void httpcodeToDavixException(int code, const std::string & scope, const std::st
     StatusCode::Code davix_code;
     std::string err_msg;
     httpcodeToDavixError(code, scope, end_message, davix_code, err_msg);
-    throw DavixException(scope, davix_code, err_msg);
+    DavixError* tmp_err = new DavixError(scope, davix_code, err_msg);
+    tmp_err->setHttpStatus(code);
+    throw DavixException(&tmp_err);
 }
 
 bool httpcodeIsValid(int code)
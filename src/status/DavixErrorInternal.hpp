@@ -30,19 +30,22 @@ struct DavixErrorInternal {
     DavixErrorInternal(const std::string &scope, StatusCode::Code errCode, const std::string &errMsg) :
         _scope(scope),
         _code(errCode),
-        _errMsg(errMsg){
+        _errMsg(errMsg),
+        _httpStatus(0){
     }
 
     DavixErrorInternal(const DavixErrorInternal & e) :
         _scope(e._scope),
         _code(e._code),
-        _errMsg(e._errMsg){
+        _errMsg(e._errMsg),
+        _httpStatus(e._httpStatus){
 
     }
 
     std::string _scope;
     StatusCode::Code _code;
     std::string _errMsg;
+    int _httpStatus;
 };
 
 
@@ -43,6 +43,7 @@ Status::Status(const std::string &scope, StatusCode::Code errcode, const std::st
 Status::Status(DavixError** err) {
   if(err && *err) {
     d_ptr = new DavixErrorInternal( (*err)->getErrScope(), (*err)->getStatus(), (*err)->getErrMsg());
+    d_ptr->_httpStatus = (*err)->getHttpStatus();
   }
   else {
     d_ptr = NULL;
@@ -150,6 +151,9 @@ void Status::clear() {
 int Status::toDavixError(DavixError **err) const {
   if(d_ptr) {
     DavixError::setupError(err, d_ptr->_scope, d_ptr->_code, d_ptr->_errMsg);
+    if(err && *err) {
+      (*err)->setHttpStatus(d_ptr->_httpStatus);
+    }
     return 1;
   }
   else {
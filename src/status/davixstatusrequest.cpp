@@ -77,6 +77,14 @@ void DavixError::setErrScope(const std::string &scope){
     d_ptr->_scope = scope;
 }
 
+int DavixError::getHttpStatus() const{
+    return d_ptr->_httpStatus;
+}
+
+void DavixError::setHttpStatus(int status){
+    d_ptr->_httpStatus = status;
+}
+
 
 
 void DavixError::setupError(DavixError **err, const std::string &scope, StatusCode::Code errCode, const std::string &errMsg){
@@ -219,6 +227,10 @@ StatusCode::Code DavixException::code() const throw(){
     return e.getStatus();
 }
 
+int DavixException::httpStatus() const throw(){
+    return e.getHttpStatus();
+}
+
 const char* DavixException::scope() const throw(){
     return e.getErrScope().c_str();
 }
@@ -45,6 +45,7 @@ std::string  get_base_get_options(){
     return "  Get Options:\n"
            "\t--accepted-retry:         Number of retries upon receiving 202-Accepted. default: 180\n"
            "\t--accepted-retry-delay:   Time in seconds to wait between 202-Accepted retries. default: 10\n"
+           "\t--segments NUMBER:        Download to a file in NUMBER parallel ranges of 16 MB. default: 1\n"
            "\t-r NUMBER_OF_THREADS:     Get directories and their contents recursively.\n";
 }
 
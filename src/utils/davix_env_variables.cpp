@@ -110,6 +110,23 @@ long getPartSizeValue() {
     return -1;
 }
 
+/// Read the "DAVIX_CURL_EVENT_LOOPS" environment variable
+/// Number of shared curl event loops per Context, 0 (default) disables them
+long getCurlEventLoopsValue() {
+    auto env = std::getenv("DAVIX_CURL_EVENT_LOOPS");
+
+    if (env != nullptr) {
+        char* endp;
+        long val = strtol(env, &endp, 10);
+
+        if (*endp == '\0' && val >= 0) {
+            return val;
+        }
+    }
+
+    return 0;
+}
+
 /// Read the "DAVIX_DEBUG" environment variable
 /// Allows to set the debug level via an envar (useful when Davix is used via a plugin)
 int getTraceValue() {
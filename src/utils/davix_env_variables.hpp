@@ -55,6 +55,9 @@ bool getMPUploadFlag();
 /// Read the "DAVIX_PARTSIZE" environment variable
 long getPartSizeValue();
 
+/// Read the "DAVIX_CURL_EVENT_LOOPS" environment variable
+long getCurlEventLoopsValue();
+
 /// Read the "DAVIX_DEBUG" environment variable
 int getTraceValue();
 
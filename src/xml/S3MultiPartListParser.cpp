@@ -0,0 +1,107 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "S3MultiPartListParser.hpp"
+#include <utils/davix_logger_internal.hpp>
+
+namespace Davix {
+
+S3MultiPartListParser::S3MultiPartListParser() : partNumber(0), truncated(false) {
+
+}
+
+S3MultiPartListParser::~S3MultiPartListParser(){
+}
+
+int S3MultiPartListParser::parserStartElemCb(int parent, const char *nspace, const char *name, const char **atts){
+    (void) parent;
+    (void) nspace;
+    (void) atts;
+
+    if(strcmp(name, "Part") == 0) {
+        partNumber = 0;
+        part = Part();
+    }
+
+    current.clear();
+    return 1;
+}
+
+int S3MultiPartListParser::parserCdataCb(int state, const char *cdata, size_t len){
+    (void) state;
+
+    current.append(cdata, len);
+    return 0;
+}
+
+int S3MultiPartListParser::parserEndElemCb(int state, const char *nspace, const char *name){
+    (void) state;
+    (void) nspace;
+
+    StrUtil::trim(current);
+    const std::string elem(name);
+
+    try {
+        if(elem == "PartNumber") {
+            partNumber = toType<size_t, std::string>()(current);
+        }
+        else if(elem == "ETag") {
+            part.first = current;
+        }
+        else if(elem == "Size") {
+            part.second = toType<dav_size_t, std::string>()(current);
+        }
+        else if(elem == "Part" && partNumber != 0) {
+            parts[partNumber] = part;
+        }
+        else if(elem == "IsTruncated") {
+            truncated = (current == "true");
+        }
+        else if(elem == "NextPartNumberMarker") {
+            nextMarker = current;
+        }
+    }
+    catch(...) {
+        DAVIX_SLOG(DAVIX_LOG_TRACE, DAVIX_LOG_XML, "Unable to parse {}: {}", elem, current);
+        return -1;
+    }
+
+    current.clear();
+    return 0;
+}
+
+const std::map<size_t, S3MultiPartListParser::Part> & S3MultiPartListParser::getParts() const {
+    return parts;
+}
+
+bool S3MultiPartListParser::isTruncated() const {
+    return truncated;
+}
+
+std::string S3MultiPartListParser::getNextPartNumberMarker() const {
+    return nextMarker;
+}
+
+std::deque<FileProperties> & S3MultiPartListParser::getProperties(){
+    return unusedFileProps;
+}
+
+}
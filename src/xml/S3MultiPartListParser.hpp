@@ -0,0 +1,67 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef S3_MULTIPART_LIST_PARSER_HPP
+#define S3_MULTIPART_LIST_PARSER_HPP
+
+#include <map>
+#include <davix_internal.hpp>
+#include <xml/davxmlparser.hpp>
+#include <utils/davix_fileproperties.hpp>
+
+namespace Davix{
+
+// Parses the answer to an S3 ListParts request: the parts of an unfinished
+// multi-part upload, by part number
+class S3MultiPartListParser :  public XMLPropParser {
+public:
+    // etag and size of a part
+    typedef std::pair<std::string, dav_size_t> Part;
+
+    S3MultiPartListParser();
+    virtual ~S3MultiPartListParser();
+
+    const std::map<size_t, Part> & getParts() const;
+
+    // more parts to list, starting after getNextPartNumberMarker()
+    bool isTruncated() const;
+    std::string getNextPartNumberMarker() const;
+
+    virtual std::deque<FileProperties> & getProperties(); // not used
+
+protected:
+    virtual int parserStartElemCb(int parent, const char *nspace, const char *name, const char **atts);
+    virtual int parserCdataCb(int state, const char *cdata, size_t len);
+    virtual int parserEndElemCb(int state, const char *nspace, const char *name);
+
+private:
+    std::string current;
+    size_t partNumber;
+    Part part;
+    std::map<size_t, Part> parts;
+    bool truncated;
+    std::string nextMarker;
+    std::deque<FileProperties> unusedFileProps;
+};
+
+}
+
+#endif
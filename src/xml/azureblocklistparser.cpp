@@ -0,0 +1,90 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include "azureblocklistparser.hpp"
+#include <utils/davix_logger_internal.hpp>
+
+namespace Davix {
+
+AzureBlockListParser::AzureBlockListParser() : blockSize(0) {
+
+}
+
+AzureBlockListParser::~AzureBlockListParser(){
+}
+
+int AzureBlockListParser::parserStartElemCb(int parent, const char *nspace, const char *name, const char **atts){
+    (void) parent;
+    (void) nspace;
+    (void) atts;
+
+    if(strcmp(name, "Block") == 0) {
+        blockName.clear();
+        blockSize = 0;
+    }
+
+    current.clear();
+    return 1;
+}
+
+int AzureBlockListParser::parserCdataCb(int state, const char *cdata, size_t len){
+    (void) state;
+
+    current.append(cdata, len);
+    return 0;
+}
+
+int AzureBlockListParser::parserEndElemCb(int state, const char *nspace, const char *name){
+    (void) state;
+    (void) nspace;
+
+    StrUtil::trim(current);
+    const std::string elem(name);
+
+    if(elem == "Name") {
+        blockName = current;
+    }
+    else if(elem == "Size") {
+        try {
+            blockSize = toType<dav_size_t, std::string>()(current);
+        }
+        catch(...) {
+            DAVIX_SLOG(DAVIX_LOG_TRACE, DAVIX_LOG_XML, "Unable to parse block size {}", current);
+            return -1;
+        }
+    }
+    else if(elem == "Block" && !blockName.empty()) {
+        blocks[blockName] = blockSize;
+    }
+
+    current.clear();
+    return 0;
+}
+
+const std::map<std::string, dav_size_t> & AzureBlockListParser::getBlocks() const {
+    return blocks;
+}
+
+std::deque<FileProperties> & AzureBlockListParser::getProperties(){
+    return unusedFileProps;
+}
+
+}
@@ -0,0 +1,58 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#ifndef AZUREBLOCKLISTPARSER_HPP
+#define AZUREBLOCKLISTPARSER_HPP
+
+#include <map>
+#include <davix_internal.hpp>
+#include <xml/davxmlparser.hpp>
+#include <utils/davix_fileproperties.hpp>
+
+namespace Davix {
+
+// Parses the answer to an Azure Get Block List request: the size of each
+// block, by block id
+class AzureBlockListParser :  public XMLPropParser {
+public:
+    AzureBlockListParser();
+    virtual ~AzureBlockListParser();
+
+    const std::map<std::string, dav_size_t> & getBlocks() const;
+
+    virtual std::deque<FileProperties> & getProperties(); // not used
+
+protected:
+    virtual int parserStartElemCb(int parent, const char *nspace, const char *name, const char **atts);
+    virtual int parserCdataCb(int state, const char *cdata, size_t len);
+    virtual int parserEndElemCb(int state, const char *nspace, const char *name);
+
+private:
+    std::string current;
+    std::string blockName;
+    dav_size_t blockSize;
+    std::map<std::string, dav_size_t> blocks;
+    std::deque<FileProperties> unusedFileProps;
+};
+
+}
+
+#endif // AZUREBLOCKLISTPARSER_HPP
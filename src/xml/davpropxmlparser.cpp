@@ -31,33 +31,44 @@ using namespace StrUtil;
 
 namespace Davix {
 
-const Xml::XmlPTree prop_node(Xml::ElementStart, "propstat");
-const Xml::XmlPTree prop_collection(Xml::ElementStart, "collection");
 static std::unique_ptr<Xml::XmlPTree> webDavTree;
 
 static std::once_flag _l_init;
 
+// An open element. Element names are resolved once, on the way in, to the
+// node of webDavTree they stand for: the deepest matching node of the path, and
+// whether the element itself is that node. Unknown elements share the node of
+// their closest known parent, and no element is copied or compared again.
+struct DavPropStackEntry{
+    DavPropStackEntry(Xml::XmlPTree* n, bool m) : node(n), matched(m){}
+
+    Xml::XmlPTree* node;
+    bool matched;
+};
+
 struct DavPropXMLParser::DavxPropXmlIntern{
-    DavxPropXmlIntern() : _stack(),
-        _props(), _current_props(), _last_response_status(500), _last_filename(){
+    DavxPropXmlIntern(bool full_paths) : _stack(),
+        _props(), _current_props(), _last_response_status(500), _last_filename(), _full_paths(full_paths), _batch(NULL){
         _stack.reserve(10);
         char_buffer.reserve(1024);
     }
 
     // node stack
-    std::vector<Xml::XmlPTree> _stack;
+    std::vector<DavPropStackEntry> _stack;
 
     // props
     std::deque<FileProperties> _props;
     FileProperties _current_props;
     int _last_response_status;
     std::string _last_filename;
+    bool _full_paths;
+    ListingBatch* _batch;
 
     // buffer
     std::string char_buffer;
 
     inline void appendChars(const char *buff, size_t len){
-        char_buffer.append(std::string(buff, len));
+        char_buffer.append(buff, len);
     }
 
     inline void clear(){
@@ -68,7 +79,7 @@ struct DavPropXMLParser::DavxPropXmlIntern{
     inline void add_new_elem(){
         DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_XML, " properties detected ");
         _current_props.clear();
-        _current_props.filename = _last_filename; // setup the current filename
+        _current_props.filename.assign(_last_filename); // setup the current filename
         _current_props.info.mode = 0777 | S_IFREG; // default : fake access to everything
     }
 
@@ -76,7 +87,12 @@ struct DavPropXMLParser::DavxPropXmlIntern{
         DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_XML, " end of properties... ");
         if( _last_response_status > 100
             && _last_response_status < 400){
-            _props.push_back(_current_props);
+            if(_batch){
+                // leaves _current_props with its string buffers for the next one
+                _batch->append(_current_props.filename, _current_props.info);
+            }else{
+                _props.push_back(std::move(_current_props));
+            }
         }else{
            DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_XML, "Bad status code ! properties dropped");
         }
@@ -177,6 +193,19 @@ static bool startswith(const std::string &str, const std::string &prefix) {
 static void check_href(DavPropXMLParser::DavxPropXmlIntern & par,  const std::string & name){
     std::string _href(name);
     rtrim(_href, isSlash()); // remove trailing slash
+
+    if(par._full_paths){
+        // strip scheme and authority of absolute hrefs
+        std::string::size_type pos = _href.find("://");
+        if(pos != std::string::npos){
+            pos = _href.find('/', pos + 3);
+            _href.erase(0, (pos == std::string::npos) ? _href.size() : pos);
+        }
+        par._last_filename = Uri::unescapeString(_href);
+        DAVIX_SLOG(DAVIX_LOG_DEBUG, DAVIX_LOG_XML, " href/path parsed -> {} ", par._last_filename);
+        return;
+    }
+
     std::string::reverse_iterator it = std::find(_href.rbegin(), _href.rend(), '/');
     if( it == _href.rend()){
         par._last_filename.assign(_href);
@@ -264,8 +293,8 @@ void init_webdavTree(){
     it->addChild(Xml::XmlPTree(Xml::ElementStart, "collection", Xml::XmlPTree::ChildrenList(), (void*) &check_is_directory));
 }
 
-DavPropXMLParser::DavPropXMLParser() :
-    d_ptr(new DavxPropXmlIntern())
+DavPropXMLParser::DavPropXMLParser(bool full_paths) :
+    d_ptr(new DavxPropXmlIntern(full_paths))
 {
     std::call_once(_l_init, init_webdavTree);
 }
@@ -279,18 +308,39 @@ std::deque<FileProperties> & DavPropXMLParser::getProperties(){
     return d_ptr->_props;
 }
 
+void DavPropXMLParser::setBatch(ListingBatch* batch){
+    d_ptr->_batch = batch;
+}
+
+
+// find the child of "node" named "name", NULL if none
+static Xml::XmlPTree* find_child(Xml::XmlPTree* node, const char* name){
+    for(Xml::XmlPTree::iterator it = node->beginChildren(); it != node->endChildren(); ++it){
+        if(match_element(it->getData().c_str(), name)){
+            return &(*it);
+        }
+    }
+    return NULL;
+}
+
 
 int DavPropXMLParser::parserStartElemCb(int parent, const char *nspace, const char *name, const char **atts){
     (void) parent;
-    (void) name;
     (void) nspace;
     (void) atts;
     // add elem to stack
-    Xml::XmlPTree node(Xml::ElementStart, name);
-    d_ptr->_stack.push_back(node);
+    std::vector<DavPropStackEntry> & stack = d_ptr->_stack;
+    if(stack.empty()){
+        const bool root = match_element(webDavTree->getData().c_str(), name);
+        stack.push_back(DavPropStackEntry(root ? webDavTree.get() : NULL, root));
+    }else{
+        const DavPropStackEntry & top = stack.back();
+        Xml::XmlPTree* child = (top.matched) ? find_child(top.node, name) : NULL;
+        stack.push_back(child ? DavPropStackEntry(child, true) : DavPropStackEntry(top.node, false));
+    }
 
     // if beginning of prop, add new element
-    if(node.compareNode(prop_node)){
+    if(match_element(name, "propstat")){
         d_ptr->add_new_elem();
     }
     return 1;
@@ -307,29 +357,26 @@ int DavPropXMLParser::parserCdataCb(int state, const char *cdata, size_t len){
 int DavPropXMLParser::parserEndElemCb(int state, const char *nspace, const char *name){
     (void) state;
     (void) nspace;
-    Xml::XmlPTree node(Xml::ElementStart, name);
+
+    if(d_ptr->_stack.size()  == 0)
+        throw DavixException(davix_scope_xml_parser(),StatusCode::ParsingError, "Corrupted Parser Stack, Invalid XML");
 
     // find potential interesting data
-    std::vector<Xml::XmlPTree::ptr_type> chain;
-    if(d_ptr->char_buffer.size() != 0 || node.compareNode(prop_collection)){
-        chain = webDavTree->findChain(d_ptr->_stack);
-        if(chain.size() > 0){
-            properties_cb cb = ((properties_cb) chain.at(chain.size()-1)->getMeta());
-            if(cb){
-                StrUtil::trim(d_ptr->char_buffer);
-                cb(*d_ptr, d_ptr->char_buffer);
-            }
+    Xml::XmlPTree* node = d_ptr->_stack.back().node;
+    if(node && (d_ptr->char_buffer.size() != 0 || match_element(name, "collection"))){
+        properties_cb cb = ((properties_cb) node->getMeta());
+        if(cb){
+            StrUtil::trim(d_ptr->char_buffer);
+            cb(*d_ptr, d_ptr->char_buffer);
         }
     }
 
     // push props
-    if(node.compareNode(prop_node)){
+    if(match_element(name, "propstat")){
         d_ptr->store_new_elem();
     }
 
     // cleaning work
-    if(d_ptr->_stack.size()  == 0)
-        throw DavixException(davix_scope_xml_parser(),StatusCode::ParsingError, "Corrupted Parser Stack, Invalid XML");
     d_ptr->_stack.pop_back();
     d_ptr->clear();
     return 0;
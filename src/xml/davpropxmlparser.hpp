@@ -34,11 +34,16 @@ class DavPropXMLParser : public XMLPropParser
 {
 public:
     struct DavxPropXmlIntern;
-    DavPropXMLParser();
+
+    // full_paths: report each entry by the unescaped path of its href,
+    // rather than by its last segment
+    DavPropXMLParser(bool full_paths = false);
     virtual ~DavPropXMLParser();
 
     virtual std::deque<FileProperties> & getProperties();
 
+    virtual void setBatch(ListingBatch* batch);
+
 
 protected:
     virtual int parserStartElemCb(int parent, const char *nspace, const char *name, const char **atts);
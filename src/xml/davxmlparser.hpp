@@ -29,6 +29,7 @@
 #include <ne_xml.h>
 
 #include <utils/davix_fileproperties.hpp>
+#include <file/davix_listing_batch.hpp>
 
 
 namespace Davix {
@@ -105,6 +106,11 @@ public:
     virtual std::deque<FileProperties> & getProperties()=0;
     virtual std::string getNextMarker() { return ""; };
 
+    /// append the entries parsed from now on straight to batch, instead of
+    /// queueing them in getProperties() - NULL to go back to the queue.
+    /// Parsers which don't support it keep queueing them.
+    virtual void setBatch(ListingBatch* batch) { (void) batch; }
+
 };
 
 
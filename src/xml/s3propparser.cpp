@@ -48,6 +48,7 @@ struct S3PropParser::Internal{
     int prop_count;
     std::stack<std::string> stack_status;
     std::deque<FileProperties> props;
+    ListingBatch* batch = NULL;
 
     FileProperties property;
     S3ListingMode::S3ListingMode _s3_listing_mode;
@@ -56,6 +57,14 @@ struct S3PropParser::Internal{
     std::string nextmarker;
     std::string nextmarker_last_key;
 
+    void store(const FileProperties & entry){
+        if(batch){
+            batch->append(entry.filename, entry.info);
+        }else{
+            props.push_back(entry);
+        }
+    }
+
     int start_elem(const std::string &elem){
         // new tag, clean content;
         current.clear();
@@ -117,7 +126,7 @@ struct S3PropParser::Internal{
                 property.filename = current.erase(0, prefix_to_remove.size());
                 property.info.mode =  0755 | S_IFDIR;
                 property.info.mode &= ~(S_IFREG);
-                props.push_back(property);
+                store(property);
                 prop_count++;
             }
         }
@@ -175,7 +184,7 @@ struct S3PropParser::Internal{
             property.filename = current;
             property.info.mode |= S_IFDIR;
             property.info.mode &= ~(S_IFREG);
-            props.push_back(property);
+            store(property);
         }
 
         // check element, if end entry push new entry
@@ -186,7 +195,7 @@ struct S3PropParser::Internal{
             // empty filename? That means this is the first "Contents" entry,
             // indicating the bucket name, which we have already pushed. Skip.
             if(property.filename.size() > 0) {
-                props.push_back(property);
+                store(property);
             }
         }
 
@@ -201,12 +210,12 @@ struct S3PropParser::Internal{
         }
 
         // IsTruncated
-        if( (_s3_listing_mode == S3ListingMode::Hierarchical) && (StrUtil::compare_ncase(istruncated_prop, elem) ==0)){
+        if( StrUtil::compare_ncase(istruncated_prop, elem) ==0){
             istruncated = (current == "True" || current == "true");
         }
 
         // NextMarker
-        if( (_s3_listing_mode == S3ListingMode::Hierarchical) && (StrUtil::compare_ncase(nextmarker_prop, elem) ==0)){
+        if( StrUtil::compare_ncase(nextmarker_prop, elem) ==0){
             nextmarker = current;
         }
 
@@ -272,6 +281,10 @@ std::deque<FileProperties> & S3PropParser::getProperties(){
     return d_ptr->props;
 }
 
+void S3PropParser::setBatch(ListingBatch* batch){
+    d_ptr->batch = batch;
+}
+
 std::string S3PropParser::getNextMarker() {
     if (d_ptr->istruncated) {
         if (!d_ptr->nextmarker.empty()) {
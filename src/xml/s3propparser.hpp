@@ -41,6 +41,8 @@ public:
     virtual ~S3PropParser();
 
     virtual std::deque<FileProperties> & getProperties();
+
+    virtual void setBatch(ListingBatch* batch);
     virtual std::string getNextMarker();
 
 
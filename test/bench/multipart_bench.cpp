@@ -0,0 +1,159 @@
+// Compare the line-oriented multipart/byteranges parsing formerly done by
+// HttpIOVecOps::parseMultipartRequest against the streaming MultipartParser,
+// over synthetic in-memory response bodies.
+//
+// usage: davix-bench-multipart [iterations] [parts] [part size]
+
+#include <fileops/MultipartParser.hpp>
+#include <davix.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace Davix;
+
+static const std::string boundary = "gc0p4Jq0M2Yt08jU534c0p";
+static const size_t kBlockSize = 64*1024;
+
+static std::string makeBody(size_t nparts, size_t partSize) {
+    std::ostringstream ss;
+    std::string payload(partSize, 'x');
+
+    for(size_t i = 0; i < nparts; i++) {
+        ss << "\r\n--" << boundary << "\r\n";
+        ss << "Content-Type: application/octet-stream\r\n";
+        ss << "Content-Range: bytes " << i*2*partSize << "-" << i*2*partSize + partSize - 1 << "/" << nparts*2*partSize << "\r\n\r\n";
+        ss << payload;
+    }
+
+    ss << "\r\n--" << boundary << "--\r\n";
+    return ss.str();
+}
+
+// in-memory stand-in for HttpRequest::readLine / readSegment
+struct Stream {
+    const std::string &body;
+    size_t pos;
+
+    size_t readLine(char *buffer, size_t max) {
+        size_t n = 0;
+        while(pos < body.size() && n < max) {
+            char c = body[pos++];
+            buffer[n++] = c;
+            if(c == '\n') break;
+        }
+        buffer[n] = '\0';
+        return n;
+    }
+
+    size_t readSegment(char *buffer, size_t size) {
+        size = std::min(size, body.size() - pos);
+        memcpy(buffer, body.data() + pos, size);
+        pos += size;
+        return size;
+    }
+};
+
+static std::vector<std::string> tokenize(const std::string &str, const std::string &delimiters) {
+    std::vector<std::string> tokens;
+    size_t start = str.find_first_not_of(delimiters);
+    while(start != std::string::npos) {
+        size_t end = str.find_first_of(delimiters, start);
+        tokens.push_back(str.substr(start, end - start));
+        start = str.find_first_not_of(delimiters, end);
+    }
+    return tokens;
+}
+
+// line by line, tokenizing part headers into strings, each payload bounced
+// through a temporary buffer
+static size_t legacyParse(const std::string &body, char *dest) {
+    Stream stream = { body, 0 };
+    char line[4097];
+    size_t total = 0;
+
+    while(true) {
+        size_t n = stream.readLine(line, 4096);
+        if(n == 0) return total;
+
+        std::string str(line);
+        while(!str.empty() && (str.back() == '\n' || str.back() == '\r')) str.pop_back();
+        if(str.empty()) continue;
+        if(str == "--" + boundary + "--") return total;
+
+        size_t offset = 0, size = 0;
+        while((n = stream.readLine(line, 4096)) > 0) {
+            std::string header(line);
+            while(!header.empty() && (header.back() == '\n' || header.back() == '\r')) header.pop_back();
+            if(header.empty()) break;
+
+            size_t colon = header.find(':');
+            if(header.compare(0, colon, "Content-Range") == 0) {
+                std::vector<std::string> tokens = tokenize(header.substr(colon + 1), " bytes-/\t");
+                offset = strtol(tokens[0].c_str(), NULL, 10);
+                size = strtol(tokens[1].c_str(), NULL, 10) - offset + 1;
+            }
+        }
+
+        std::vector<char> buffer(size + 1);
+        stream.readSegment(&buffer[0], size);
+        memcpy(dest + offset, &buffer[0], size);
+        total += size;
+    }
+}
+
+// streaming parser fed with large blocks, payload copied straight to its destination
+static size_t streamingParse(const std::string &body, char *dest) {
+    MultipartParser parser(boundary, [dest](dav_off_t offset, const char *data, dav_size_t size) {
+        memcpy(dest + offset, data, size);
+    });
+
+    for(size_t pos = 0; pos < body.size() && !parser.done(); pos += kBlockSize) {
+        if(parser.feed(body.data() + pos, std::min(kBlockSize, body.size() - pos), NULL) < 0) {
+            return 0;
+        }
+    }
+
+    return parser.payloadBytes();
+}
+
+template<typename F>
+static double measure(size_t iterations, F fn) {
+    auto start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < iterations; i++) {
+        fn();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = (argc > 1) ? atoi(argv[1]) : 20;
+    size_t nparts = (argc > 2) ? atoi(argv[2]) : 1000;
+    size_t partSize = (argc > 3) ? atoi(argv[3]) : 1024;
+
+    if(iterations == 0 || nparts == 0 || partSize == 0) {
+        std::cerr << "usage: " << argv[0] << " [iterations] [parts] [part size]" << std::endl;
+        return 1;
+    }
+
+    std::string body = makeBody(nparts, partSize);
+    std::vector<char> dest(nparts*2*partSize);
+
+    if(legacyParse(body, &dest[0]) != nparts*partSize || streamingParse(body, &dest[0]) != nparts*partSize) {
+        std::cerr << "parsers disagree on the synthetic body" << std::endl;
+        return 1;
+    }
+
+    double legacy_ms = measure(iterations, [&]() { legacyParse(body, &dest[0]); });
+    double streaming_ms = measure(iterations, [&]() { streamingParse(body, &dest[0]); });
+    double mb = iterations * body.size() / (1024.0 * 1024.0);
+
+    std::cout << iterations << " multipart bodies of " << nparts << " parts, " << partSize << " bytes each" << std::endl;
+    std::cout << "  line-oriented: " << legacy_ms << " ms (" << mb / (legacy_ms / 1000) << " MB/s)" << std::endl;
+    std::cout << "  streaming:     " << streaming_ms << " ms (" << mb / (streaming_ms / 1000) << " MB/s)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,223 @@
+// Parse a synthetic PROPFIND multistatus body of many entries, fed to the
+// DavPropXMLParser the way the listing code formerly did - fixed 2048-byte
+// reads, each into a freshly allocated buffer - and the way it does now, in
+// chunks growing from 16 KB to 2 MB, read into a single reused buffer - and
+// the same, parsed straight into a reused ListingBatch.
+//
+// usage: davix-bench-propfind [iterations] [entries]
+
+#include <xml/davpropxmlparser.hpp>
+#include <davix.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace Davix;
+
+static const size_t kDistinctEntries = 1000;
+
+static std::string makeEntry(size_t i) {
+    std::ostringstream ss;
+    ss << "<D:response><D:href>/dpm/cern.ch/home/dteam/bench/file_" << i << ".root</D:href>"
+       << "<D:propstat><D:prop>"
+       << "<D:displayname>file_" << i << ".root</D:displayname>"
+       << "<D:getlastmodified>Mon, 12 Oct 2026 10:23:" << (10 + i % 50) << " GMT</D:getlastmodified>"
+       << "<D:creationdate>2026-10-12T10:23:" << (10 + i % 50) << "Z</D:creationdate>"
+       << "<D:getcontentlength>" << 1024 * (i + 1) << "</D:getcontentlength>"
+       << "<D:resourcetype></D:resourcetype>"
+       << "<L:mode>0100644</L:mode>"
+       << "</D:prop><D:status>HTTP/1.1 200 OK</D:status></D:propstat></D:response>\n";
+    return ss.str();
+}
+
+// multistatus body of "nentries" entries, generated as it is read so that a
+// million of them needn't sit in memory - entries cycle through a fixed set
+struct Body {
+    Body(size_t nentries) : entries(nentries) {
+        header = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+                 "<D:multistatus xmlns:D=\"DAV:\" xmlns:L=\"LCGDM:\">\n"
+                 "<D:response><D:href>/dpm/cern.ch/home/dteam/bench/</D:href><D:propstat><D:prop>"
+                 "<D:resourcetype><D:collection/></D:resourcetype>"
+                 "</D:prop><D:status>HTTP/1.1 200 OK</D:status></D:propstat></D:response>\n";
+        footer = "</D:multistatus>\n";
+
+        for(size_t i = 0; i < kDistinctEntries; i++) {
+            block += makeEntry(i);
+            offsets.push_back(block.size());
+        }
+
+        rewind();
+    }
+
+    void rewind() {
+        piece = 0;
+        pos = 0;
+    }
+
+    // in-memory stand-in for HttpRequest::readSegment: fill "buffer" unless
+    // the body is over
+    size_t readSegment(char *buffer, size_t size) {
+        size_t done = 0;
+        while(done < size) {
+            const char *data;
+            size_t len;
+            if(!current(data, len)) break;
+
+            size_t n = std::min(size - done, len - pos);
+            memcpy(buffer + done, data + pos, n);
+            done += n;
+            pos += n;
+
+            if(pos == len) {
+                piece++;
+                pos = 0;
+            }
+        }
+        return done;
+    }
+
+    size_t size() const {
+        size_t full = entries / kDistinctEntries;
+        size_t rest = entries % kDistinctEntries;
+        return header.size() + full * block.size() + (rest ? offsets[rest - 1] : 0) + footer.size();
+    }
+
+    // pieces: header, whole blocks of entries, a partial block, footer
+    bool current(const char *&data, size_t &len) {
+        size_t full = entries / kDistinctEntries;
+        size_t rest = entries % kDistinctEntries;
+
+        if(piece == 0) {
+            data = header.data(); len = header.size();
+        }
+        else if(piece <= full) {
+            data = block.data(); len = block.size();
+        }
+        else if(piece == full + 1 && rest) {
+            data = block.data(); len = offsets[rest - 1];
+        }
+        else if(piece == full + 1 + (rest ? 1 : 0)) {
+            data = footer.data(); len = footer.size();
+        }
+        else {
+            return false;
+        }
+        return true;
+    }
+
+    size_t entries;
+    std::string header, block, footer;
+    std::vector<size_t> offsets;
+    size_t piece, pos;
+};
+
+// 2048-byte reads, each into a new buffer
+static size_t legacyParse(Body &body) {
+    DavPropXMLParser parser;
+    size_t count = 0;
+
+    while(true) {
+        char *buffer = (char*) malloc(2048 + 1);
+        size_t n = body.readSegment(buffer, 2048);
+        buffer[n] = '\0';
+        parser.parseChunk(buffer, n);
+        free(buffer);
+
+        count += parser.getProperties().size();
+        parser.getProperties().clear();
+        if(n < 2048) return count;
+    }
+}
+
+// adaptive reads into a single buffer
+static size_t adaptiveParse(Body &body) {
+    DavPropXMLParser parser;
+    std::vector<char> buffer;
+    size_t readSize = 16 * 1024;
+    size_t count = 0;
+
+    while(true) {
+        if(buffer.size() < readSize) buffer.resize(readSize);
+        size_t n = body.readSegment(&buffer[0], readSize);
+        parser.parseChunk(&buffer[0], n);
+
+        count += parser.getProperties().size();
+        parser.getProperties().clear();
+        if(n < readSize) return count;
+        readSize = std::min<size_t>(readSize * 2, 2 * 1024 * 1024);
+    }
+}
+
+// adaptive reads, entries appended to a batch instead of being queued
+static size_t batchParse(Body &body) {
+    static ListingBatch batch;
+    DavPropXMLParser parser;
+    std::vector<char> buffer;
+    size_t readSize = 16 * 1024;
+    size_t count = 0;
+
+    parser.setBatch(&batch);
+    while(true) {
+        if(buffer.size() < readSize) buffer.resize(readSize);
+        size_t n = body.readSegment(&buffer[0], readSize);
+        parser.parseChunk(&buffer[0], n);
+
+        count += batch.size();
+        batch.clear();
+        if(n < readSize) return count;
+        readSize = std::min<size_t>(readSize * 2, 2 * 1024 * 1024);
+    }
+}
+
+template<typename F>
+static double measure(size_t iterations, Body &body, F fn) {
+    auto start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < iterations; i++) {
+        body.rewind();
+        fn(body);
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = (argc > 1) ? atoi(argv[1]) : 1;
+    size_t nentries = (argc > 2) ? atoi(argv[2]) : 1000000;
+
+    if(iterations == 0 || nentries == 0) {
+        std::cerr << "usage: " << argv[0] << " [iterations] [entries]" << std::endl;
+        return 1;
+    }
+
+    Body body(nentries);
+
+    // the collection itself comes first
+    body.rewind();
+    size_t legacyCount = legacyParse(body);
+    body.rewind();
+    size_t adaptiveCount = adaptiveParse(body);
+    body.rewind();
+    size_t batchCount = batchParse(body);
+    if(legacyCount != nentries + 1 || adaptiveCount != nentries + 1 || batchCount != nentries + 1) {
+        std::cerr << "unexpected number of entries: " << legacyCount << ", " << adaptiveCount << ", " << batchCount << std::endl;
+        return 1;
+    }
+
+    double legacy_ms = measure(iterations, body, legacyParse);
+    double adaptive_ms = measure(iterations, body, adaptiveParse);
+    double batch_ms = measure(iterations, body, batchParse);
+    double mb = iterations * body.size() / (1024.0 * 1024.0);
+    double entries = iterations * (double) nentries;
+
+    std::cout << iterations << " multistatus bodies of " << nentries << " entries, " << body.size() << " bytes each" << std::endl;
+    std::cout << "  2048-byte reads: " << legacy_ms << " ms (" << mb / (legacy_ms / 1000) << " MB/s, "
+              << entries / (legacy_ms / 1000) << " entries/s)" << std::endl;
+    std::cout << "  adaptive reads:  " << adaptive_ms << " ms (" << mb / (adaptive_ms / 1000) << " MB/s, "
+              << entries / (adaptive_ms / 1000) << " entries/s)" << std::endl;
+    std::cout << "  into a batch:    " << batch_ms << " ms (" << mb / (batch_ms / 1000) << " MB/s, "
+              << entries / (batch_ms / 1000) << " entries/s)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,103 @@
+// Compare the static per-call pthread split formerly used by
+// HttpIOVecOps::simulateMultirange against the Context-owned WorkerPool,
+// with simulated range fetches of uneven latency.
+//
+// usage: davix-bench-range-pool [iterations] [ranges] [nconnections]
+
+#include <core/WorkerPool.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <random>
+#include <pthread.h>
+
+using namespace Davix;
+
+// simulated latency of each range, in microseconds - one in ten ranges hits
+// a slow server and takes twenty times longer than the rest
+static std::vector<int> makeLatencies(size_t nranges, std::mt19937 &rng) {
+    std::bernoulli_distribution slow(0.1);
+    std::vector<int> latencies(nranges);
+    for(size_t i = 0; i < nranges; i++) {
+        latencies[i] = slow(rng) ? 10000 : 500;
+    }
+    return latencies;
+}
+
+static std::vector<int> latencies;
+
+static void fetchRange(size_t i) {
+    std::this_thread::sleep_for(std::chrono::microseconds(latencies[i]));
+}
+
+struct SliceData {
+    size_t start, end;
+};
+
+static void* fetchSlice(void *args) {
+    SliceData *data = (SliceData*) args;
+    for(size_t i = data->start; i < data->end; i++) {
+        fetchRange(i);
+    }
+    return NULL;
+}
+
+static void staticSplit(size_t nranges, size_t nconnections) {
+    size_t num_threads = std::min(nranges, nconnections);
+    size_t queries_per_thread = nranges / num_threads;
+
+    std::vector<pthread_t> threads(num_threads);
+    std::vector<SliceData> data(num_threads);
+
+    for(size_t i = 0; i < num_threads; i++) {
+        data[i].start = i*queries_per_thread;
+        data[i].end = (i == num_threads - 1) ? nranges : data[i].start + queries_per_thread;
+        pthread_create(&threads[i], NULL, fetchSlice, &data[i]);
+    }
+
+    for(size_t i = 0; i < num_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+// both strategies see the exact same sequence of latencies
+template<typename F>
+static double measure(size_t iterations, size_t nranges, F fn) {
+    std::mt19937 rng(42);
+    std::chrono::duration<double, std::milli> elapsed(0);
+
+    for(size_t i = 0; i < iterations; i++) {
+        latencies = makeLatencies(nranges, rng);
+
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        elapsed += std::chrono::steady_clock::now() - start;
+    }
+
+    return elapsed.count();
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = (argc > 1) ? atoi(argv[1]) : 50;
+    size_t nranges = (argc > 2) ? atoi(argv[2]) : 30;
+    size_t nconnections = (argc > 3) ? atoi(argv[3]) : 3;
+
+    if(iterations == 0 || nranges == 0 || nconnections == 0) {
+        std::cerr << "usage: " << argv[0] << " [iterations] [ranges] [nconnections]" << std::endl;
+        return 1;
+    }
+
+    WorkerPool pool;
+
+    double static_ms = measure(iterations, nranges, [&]() { staticSplit(nranges, nconnections); });
+    double pool_ms = measure(iterations, nranges, [&]() { pool.forEach(nranges, nconnections, fetchRange); });
+
+    std::cout << iterations << " vector reads of " << nranges << " ranges over " << nconnections << " connections" << std::endl;
+    std::cout << "  static split: " << static_ms << " ms (" << static_ms / iterations << " ms per read)" << std::endl;
+    std::cout << "  worker pool:  " << pool_ms << " ms (" << pool_ms / iterations << " ms per read)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,110 @@
+// Many threads checking sessions in and out of the pool for a single host,
+// the way a parallel transfer to one storage endpoint does: against a
+// single lock over a map keyed by the session string - what the pool
+// amounted to for one host when it was sharded by key only - and against
+// the SessionPool, which spreads a host's sessions over per-thread lanes
+// and hashes the key once per call.
+//
+// usage: davix-bench-session-pool [iterations] [threads]
+
+#include <core/SessionPool.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+static const std::string kKey = "https://eospublic.cern.ch:443";
+
+// all sessions of the host behind one lock, with the same expiry
+// bookkeeping as the pool
+struct SingleLockPool {
+    typedef std::chrono::steady_clock Clock;
+
+    struct Entry {
+        int item;
+        Clock::time_point expires;
+    };
+
+    void insert(const std::string &key, int item) {
+        Entry entry;
+        entry.item = item;
+        entry.expires = Clock::time_point::max();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        map[key].push_back(entry);
+    }
+
+    bool retrieve(const std::string &key, int &item) {
+        Clock::time_point now = Clock::now();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = map.find(key);
+        if(it == map.end()) {
+            return false;
+        }
+
+        while(!it->second.empty()) {
+            Entry entry = it->second.back();
+            it->second.pop_back();
+            if(entry.expires > now) {
+                item = entry.item;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::mutex mutex;
+    std::unordered_map<std::string, std::vector<Entry>> map;
+};
+
+// every thread checks a session out - or would create one - then back in
+template<typename Pool>
+static double measure(Pool &pool, size_t iterations, size_t nthreads) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for(size_t t = 0; t < nthreads; t++) {
+        threads.emplace_back([&pool, iterations, t]() {
+            for(size_t i = 0; i < iterations; i++) {
+                int session;
+                if(!pool.retrieve(kKey, session)) {
+                    session = (int) t;
+                }
+                pool.insert(kKey, session);
+            }
+        });
+    }
+
+    for(size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = (argc > 1) ? atoi(argv[1]) : 200000;
+    size_t nthreads = (argc > 2) ? atoi(argv[2]) : 8;
+
+    if(iterations == 0 || nthreads == 0) {
+        std::cerr << "usage: " << argv[0] << " [iterations] [threads]" << std::endl;
+        return 1;
+    }
+
+    SingleLockPool single;
+    SessionPool<int> sharded;
+
+    double single_ms = measure(single, iterations, nthreads);
+    double sharded_ms = measure(sharded, iterations, nthreads);
+
+    std::cout << iterations << " checkouts by each of " << nthreads << " threads on one host" << std::endl;
+    std::cout << "  single lock:  " << single_ms << " ms" << std::endl;
+    std::cout << "  session pool: " << sharded_ms << " ms" << std::endl;
+    return 0;
+}
@@ -178,6 +178,13 @@ ssize_t DrunkServer::Connection::write(const std::string &buf) {
   return write(buf.c_str(), buf.size());
 }
 
+//------------------------------------------------------------------------------
+// Underlying socket
+//------------------------------------------------------------------------------
+int DrunkServer::Connection::getFd() const {
+  return _fd;
+}
+
 //------------------------------------------------------------------------------
 // Run acceptor thread
 //------------------------------------------------------------------------------
@@ -85,6 +85,11 @@ public:
     //--------------------------------------------------------------------------
     ssize_t write(const std::string &buf);
 
+    //--------------------------------------------------------------------------
+    // Underlying socket, for interactors layering TLS on top
+    //--------------------------------------------------------------------------
+    int getFd() const;
+
   private:
     int _fd;
   };
@@ -22,6 +22,9 @@
 #include "Interactors.hpp"
 #include "LineReader.hpp"
 #include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <openssl/x509.h>
 
 //------------------------------------------------------------------------------
 // Destructor
@@ -109,3 +112,292 @@ void SingleShotInteractor::main(ThreadAssistant &assistant) {
   std::cout << "Response written successfully" << std::endl;
   _is_ok = true;
 }
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+RangeInteractor::RangeInteractor(const std::string &contents, bool multirange)
+: _contents(contents), _multirange(multirange) {}
+
+//------------------------------------------------------------------------------
+// Range header received
+//------------------------------------------------------------------------------
+std::string RangeInteractor::getRangeHeader() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _range;
+}
+
+//------------------------------------------------------------------------------
+// Run interacting thread
+//------------------------------------------------------------------------------
+void RangeInteractor::main(ThreadAssistant &assistant) {
+  const std::string prefix = "Range: bytes=";
+  std::string range;
+  bool head = false;
+
+  for(size_t i = 0; ; i++) {
+    std::string line;
+    if(_reader->consumeLine(line) <= 0) {
+      return;
+    }
+
+    if(i == 0) {
+      head = (line.compare(0, 5, "HEAD ") == 0);
+    }
+
+    if(line == "\r\n") {
+      break;
+    }
+
+    if(line.compare(0, prefix.size(), prefix) == 0) {
+      range = line.substr(prefix.size(), line.size() - prefix.size() - 2);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _range = range;
+  }
+
+  std::vector<std::pair<size_t, size_t>> ranges;
+  std::vector<std::string> specs = split(range, ",");
+  for(size_t i = 0; i < specs.size() && !range.empty(); i++) {
+    size_t dash = specs[i].find("-");
+    ranges.emplace_back(atoll(specs[i].substr(0, dash).c_str()), atoll(specs[i].substr(dash+1).c_str()));
+  }
+
+  std::ostringstream response;
+  std::ostringstream body;
+
+  if(ranges.empty() || (ranges.size() > 1 && !_multirange)) {
+    body << _contents;
+    response << "HTTP/1.1 200 OK\r\n";
+  }
+  else if(ranges.size() == 1) {
+    body << _contents.substr(ranges[0].first, ranges[0].second - ranges[0].first + 1);
+    response << "HTTP/1.1 206 Partial Content\r\n";
+    response << "Content-Range: bytes " << ranges[0].first << "-" << ranges[0].second << "/" << _contents.size() << "\r\n";
+  }
+  else {
+    for(size_t i = 0; i < ranges.size(); i++) {
+      body << "--drunk-boundary\r\n";
+      body << "Content-Type: application/octet-stream\r\n";
+      body << "Content-Range: bytes " << ranges[i].first << "-" << ranges[i].second << "/" << _contents.size() << "\r\n\r\n";
+      body << _contents.substr(ranges[i].first, ranges[i].second - ranges[i].first + 1) << "\r\n";
+    }
+
+    body << "--drunk-boundary--\r\n";
+    response << "HTTP/1.1 206 Partial Content\r\n";
+    response << "Content-Type: multipart/byteranges; boundary=drunk-boundary\r\n";
+  }
+
+  response << "Content-Length: " << body.str().size() << "\r\n";
+  response << "Connection: close\r\n\r\n";
+
+  if(!head) {
+    response << body.str();
+  }
+
+  std::string out = response.str();
+  if(_conn->write(out) != (ssize_t) out.size()) {
+    std::cout << "Error when writing response" << std::endl;
+    return;
+  }
+
+  _is_ok = true;
+}
+
+//------------------------------------------------------------------------------
+// HTTP/2 frame types and flags
+//------------------------------------------------------------------------------
+static const uint8_t kFrameData = 0x0;
+static const uint8_t kFrameHeaders = 0x1;
+static const uint8_t kFrameSettings = 0x4;
+static const uint8_t kFramePing = 0x6;
+static const uint8_t kFlagAck = 0x1;
+static const uint8_t kFlagEndStream = 0x1;
+static const uint8_t kFlagEndHeaders = 0x4;
+
+//------------------------------------------------------------------------------
+// ALPN: pick h2, or fail the handshake
+//------------------------------------------------------------------------------
+static int selectH2(SSL *ssl, const unsigned char **out, unsigned char *outlen,
+  const unsigned char *in, unsigned int inlen, void *arg) {
+
+  static const unsigned char h2[] = { 2, 'h', '2' };
+  if(SSL_select_next_proto((unsigned char**) out, outlen, h2, sizeof(h2), in, inlen) != OPENSSL_NPN_NEGOTIATED) {
+    return SSL_TLSEXT_ERR_ALERT_FATAL;
+  }
+
+  return SSL_TLSEXT_ERR_OK;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+Http2Interactor::Http2Interactor(size_t streams, const std::string &body)
+: _streams(streams), _body(body), _ctx(NULL), _ssl(NULL), _answered(0) {}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+Http2Interactor::~Http2Interactor() {
+  _thread.join();
+
+  SSL_free(_ssl);
+  SSL_CTX_free(_ctx);
+}
+
+//------------------------------------------------------------------------------
+// Number of requests answered so far
+//------------------------------------------------------------------------------
+size_t Http2Interactor::getAnswered() const {
+  std::lock_guard<std::mutex> lock(_mtx);
+  return _answered;
+}
+
+//------------------------------------------------------------------------------
+// Set up TLS over the connection
+//------------------------------------------------------------------------------
+bool Http2Interactor::startTls() {
+  EVP_PKEY *key = NULL;
+  EVP_PKEY_CTX *kctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, NULL);
+  bool generated = kctx && EVP_PKEY_keygen_init(kctx) > 0 &&
+    EVP_PKEY_CTX_set_ec_paramgen_curve_nid(kctx, NID_X9_62_prime256v1) > 0 &&
+    EVP_PKEY_keygen(kctx, &key) > 0;
+  EVP_PKEY_CTX_free(kctx);
+
+  if(!generated) {
+    std::cerr << "Could not generate a key" << std::endl;
+    return false;
+  }
+
+  X509 *cert = X509_new();
+  ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+  X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+  X509_gmtime_adj(X509_getm_notAfter(cert), 3600);
+  X509_set_pubkey(cert, key);
+
+  X509_NAME *name = X509_get_subject_name(cert);
+  X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char*) "localhost", -1, -1, 0);
+  X509_set_issuer_name(cert, name);
+  X509_sign(cert, key, EVP_sha256());
+
+  _ctx = SSL_CTX_new(TLS_server_method());
+  bool ok = _ctx && SSL_CTX_use_certificate(_ctx, cert) == 1 && SSL_CTX_use_PrivateKey(_ctx, key) == 1;
+  X509_free(cert);
+  EVP_PKEY_free(key);
+
+  if(!ok) {
+    std::cerr << "Could not set up the TLS context" << std::endl;
+    return false;
+  }
+
+  SSL_CTX_set_alpn_select_cb(_ctx, selectH2, NULL);
+
+  _ssl = SSL_new(_ctx);
+  SSL_set_fd(_ssl, _conn->getFd());
+  if(SSL_accept(_ssl) != 1) {
+    std::cerr << "TLS handshake failed" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Read exactly "count" bytes
+//------------------------------------------------------------------------------
+bool Http2Interactor::readExact(std::string &buf, size_t count) {
+  buf.resize(count);
+  size_t done = 0;
+
+  while(done < count) {
+    int ret = SSL_read(_ssl, &buf[done], count - done);
+    if(ret <= 0) {
+      return false;
+    }
+    done += ret;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Write a single frame
+//------------------------------------------------------------------------------
+bool Http2Interactor::writeFrame(uint8_t type, uint8_t flags, uint32_t stream, const std::string &payload) {
+  std::string frame;
+  frame.push_back((payload.size() >> 16) & 0xff);
+  frame.push_back((payload.size() >> 8) & 0xff);
+  frame.push_back(payload.size() & 0xff);
+  frame.push_back(type);
+  frame.push_back(flags);
+  frame.push_back((stream >> 24) & 0x7f);
+  frame.push_back((stream >> 16) & 0xff);
+  frame.push_back((stream >> 8) & 0xff);
+  frame.push_back(stream & 0xff);
+  frame += payload;
+
+  return SSL_write(_ssl, frame.data(), frame.size()) == (int) frame.size();
+}
+
+//------------------------------------------------------------------------------
+// Run interacting thread
+//------------------------------------------------------------------------------
+void Http2Interactor::main(ThreadAssistant &assistant) {
+  const std::string preface = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+
+  if(!startTls()) {
+    return;
+  }
+
+  std::string buf;
+  if(!readExact(buf, preface.size()) || buf != preface) {
+    std::cerr << "Missing HTTP/2 connection preface" << std::endl;
+    return;
+  }
+
+  // no settings of our own
+  if(!writeFrame(kFrameSettings, 0, 0, "")) {
+    return;
+  }
+
+  size_t answered = 0;
+  while(answered < _streams && !assistant.terminationRequested()) {
+    std::string header, payload;
+    if(!readExact(header, 9)) {
+      return;
+    }
+
+    size_t length = ((uint8_t) header[0] << 16) | ((uint8_t) header[1] << 8) | (uint8_t) header[2];
+    uint8_t type = header[3];
+    uint8_t flags = header[4];
+    uint32_t stream = (((uint8_t) header[5] & 0x7f) << 24) | ((uint8_t) header[6] << 16) | ((uint8_t) header[7] << 8) | (uint8_t) header[8];
+
+    if(!readExact(payload, length)) {
+      return;
+    }
+
+    if(type == kFrameSettings && !(flags & kFlagAck)) {
+      writeFrame(kFrameSettings, kFlagAck, 0, "");
+    }
+    else if(type == kFramePing && !(flags & kFlagAck)) {
+      writeFrame(kFramePing, kFlagAck, 0, payload);
+    }
+    else if(type == kFrameHeaders) {
+      // 0x88: ":status: 200" out of the HPACK static table
+      if(!writeFrame(kFrameHeaders, kFlagEndHeaders, stream, std::string(1, (char) 0x88)) ||
+         !writeFrame(kFrameData, kFlagEndStream, stream, _body)) {
+        std::cout << "Error when writing response" << std::endl;
+        return;
+      }
+
+      answered++;
+      std::lock_guard<std::mutex> lock(_mtx);
+      _answered = answered;
+    }
+  }
+
+  _is_ok = true;
+}
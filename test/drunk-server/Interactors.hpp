@@ -25,6 +25,10 @@
 #include "AssistedThread.hh"
 #include "DrunkServer.hpp"
 
+#include <mutex>
+#include <string>
+#include <openssl/ssl.h>
+
 class LineReader;
 
 //------------------------------------------------------------------------------
@@ -93,4 +97,87 @@ protected:
   std::string _response;
 };
 
+//------------------------------------------------------------------------------
+// Range interactor - serves a single GET / HEAD out of an in-memory file,
+// honouring the Range header like a server with or without multi-range
+// support would.
+//------------------------------------------------------------------------------
+class RangeInteractor : public BasicInteractor {
+public:
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  RangeInteractor(const std::string &contents, bool multirange);
+
+  //----------------------------------------------------------------------------
+  // Run interacting thread
+  //----------------------------------------------------------------------------
+  void main(ThreadAssistant &assistant);
+
+  //----------------------------------------------------------------------------
+  // Range header received, empty if none
+  //----------------------------------------------------------------------------
+  std::string getRangeHeader() const;
+
+protected:
+  std::string _contents;
+  bool _multirange;
+
+  mutable std::mutex _mtx;
+  std::string _range;
+};
+
+//------------------------------------------------------------------------------
+// HTTP/2 interactor - speaks HTTP/2 over TLS, negotiated with ALPN, using a
+// throwaway self-signed certificate. Answers "streams" requests, possibly
+// multiplexed, with a 200 and the same body each.
+//------------------------------------------------------------------------------
+class Http2Interactor : public BasicInteractor {
+public:
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  Http2Interactor(size_t streams, const std::string &body);
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  virtual ~Http2Interactor();
+
+  //----------------------------------------------------------------------------
+  // Run interacting thread
+  //----------------------------------------------------------------------------
+  void main(ThreadAssistant &assistant);
+
+  //----------------------------------------------------------------------------
+  // Number of requests answered so far
+  //----------------------------------------------------------------------------
+  size_t getAnswered() const;
+
+protected:
+  //----------------------------------------------------------------------------
+  // Set up TLS over the connection, false on failure
+  //----------------------------------------------------------------------------
+  bool startTls();
+
+  //----------------------------------------------------------------------------
+  // Read exactly "count" bytes, false on error or end of connection
+  //----------------------------------------------------------------------------
+  bool readExact(std::string &buf, size_t count);
+
+  //----------------------------------------------------------------------------
+  // Write a single frame
+  //----------------------------------------------------------------------------
+  bool writeFrame(uint8_t type, uint8_t flags, uint32_t stream, const std::string &payload);
+
+  size_t _streams;
+  std::string _body;
+
+  SSL_CTX *_ctx;
+  SSL *_ssl;
+
+  mutable std::mutex _mtx;
+  size_t _answered;
+};
+
 #endif
@@ -22,11 +22,15 @@
 #include <gtest/gtest.h>
 #include <backend/StandaloneNeonRequest.hpp>
 #include <neon/neonsessionfactory.hpp>
+#include <curl/CurlSessionFactory.hpp>
 #include "../drunk-server/DrunkServer.hpp"
 #include "../drunk-server/LineReader.hpp"
 #include "../drunk-server/Interactors.hpp"
 #include "test-utils.hpp"
+#include <davix_context_internal.hpp>
+#include <atomic>
 #include <iostream>
+#include <thread>
 
 #define DBG(message) std::cerr << __FILE__ << ":" << __LINE__ << " -- " << #message << " = " << message << std::endl;
 
@@ -276,3 +280,194 @@ TEST_F(Standalone_Neon_Request, StopNoStart) {
   ASSERT_EQ(request->getState(), RequestState::kFinished);
   ASSERT_EQ(request->getStatusCode(), 0);
 }
+
+TEST_F(Standalone_Curl_Request, SharedEventLoop) {
+  _factory.getCurl().setEventLoops(2);
+  _uri = Uri("http://localhost:22222/chickens");
+
+  SingleShotInteractor inter(
+    SSTR("GET /chickens HTTP/1.1\r\n"  <<
+          "Host: localhost:22222\r\n"  <<
+          "Accept: */*\r\n"),
+
+    SSTR("HTTP/1.1 200 OK\r\n"                       <<
+         "Date: Mon, 07 Oct 2019 14:02:25 GMT\r\n"   <<
+         "Content-Type: ayy/lmao\r\n"                <<
+         "Content-Length: 19\r\n"                    <<
+         "\r\n"                                      <<
+         "I like turtles too.\r\n")
+  );
+
+  _drunk_server->autoAcceptNext(&inter);
+
+  std::unique_ptr<StandaloneRequest> request = makeStandaloneCurlReq();
+  ASSERT_EQ(request->getState(), RequestState::kNotStarted);
+
+  ASSERT_TRUE(request->startRequest().ok());
+  ASSERT_EQ(request->getState(), RequestState::kStarted);
+  ASSERT_EQ(request->getStatusCode(), 200);
+
+  std::string headerLine;
+  ASSERT_TRUE(request->getAnswerHeader("Content-Type", headerLine));
+  ASSERT_EQ(headerLine, "ayy/lmao");
+
+  char buffer[2048];
+
+  Status st;
+  ASSERT_EQ(request->readBlock(buffer, 2048, st), 19);
+  ASSERT_TRUE(st.ok());
+  ASSERT_EQ(std::string(buffer, 19), "I like turtles too.");
+  ASSERT_EQ(request->readBlock(buffer, 2048, st), 0);
+  ASSERT_TRUE(st.ok());
+
+  st = request->endRequest();
+  ASSERT_EQ(request->getState(), RequestState::kFinished);
+  ASSERT_TRUE(st.ok());
+  ASSERT_TRUE(inter.ok());
+  ASSERT_EQ(request->getStatusCode(), 200);
+  ASSERT_EQ(_factory.getCurl().getEventLoops(), 2u);
+}
+
+TEST_F(Standalone_Curl_Request, SharedEventLoopNetworkError) {
+  _factory.getCurl().setEventLoops(1);
+  setConnectionTimeout(std::chrono::seconds(1));
+
+  ConnectionShutdownInteractor inter;
+  _drunk_server->autoAcceptNext(&inter);
+
+  std::unique_ptr<StandaloneRequest> request = makeStandaloneCurlReq();
+  Status st = request->startRequest();
+  ASSERT_EQ(request->getState(), RequestState::kFinished);
+
+  ASSERT_FALSE(st.ok());
+  ASSERT_EQ(st.getCode(), StatusCode::ConnectionProblem);
+  ASSERT_EQ(request->getSessionError(), "curl error (52): Server returned nothing (no headers, no data)");
+  ASSERT_EQ(request->getStatusCode(), 0);
+
+  _drunk_server.reset();
+}
+
+TEST_F(Standalone_Curl_Request, SharedEventLoopStopEarly) {
+  _factory.getCurl().setEventLoops(1);
+  setDeadlineFromNow(std::chrono::seconds(5));
+
+  SingleShotInteractor inter(
+    SSTR("GET / HTTP/1.1\r\n"),
+    SSTR("HTTP/1.1 200 OK\r\n"        <<
+         "Content-Length: 4096\r\n"   <<
+         "\r\n"                       <<
+         "partial")
+  );
+
+  _drunk_server->autoAcceptNext(&inter);
+
+  std::unique_ptr<StandaloneRequest> request = makeStandaloneCurlReq();
+  ASSERT_TRUE(request->startRequest().ok());
+  ASSERT_EQ(request->getStatusCode(), 200);
+
+  // Abandon the transfer while the event loop is still waiting for the body
+  ASSERT_TRUE(request->endRequest().ok());
+  request.reset();
+}
+
+TEST_F(Standalone_Curl_Request, Http2ConnectionCounters) {
+  _params.setHttp2Multiplexing(true);
+  _params.setMaxConcurrentStreams(10);
+  _uri = Uri("http://localhost:22222/chickens");
+
+  for(size_t i = 0; i < 2; i++) {
+    // Plain http: curl only negotiates HTTP/2 over TLS, so this is HTTP/1.1
+    SingleShotInteractor inter(
+      SSTR("GET /chickens HTTP/1.1\r\n"  <<
+            "Host: localhost:22222\r\n"),
+
+      SSTR("HTTP/1.1 200 OK\r\n"          <<
+           "Connection: close\r\n"        <<
+           "Content-Length: 6\r\n"        <<
+           "\r\n"                         <<
+           "turtle")
+    );
+
+    _drunk_server->autoAcceptNext(&inter);
+
+    std::unique_ptr<StandaloneRequest> request = makeStandaloneCurlReq();
+    ASSERT_TRUE(request->startRequest().ok());
+    ASSERT_EQ(request->getStatusCode(), 200);
+
+    char buffer[16];
+    Status st;
+    dav_ssize_t total = 0;
+    dav_ssize_t bytes = 0;
+    while((bytes = request->readBlock(buffer + total, sizeof(buffer) - total, st)) > 0) {
+      total += bytes;
+    }
+
+    ASSERT_TRUE(st.ok());
+    ASSERT_EQ(std::string(buffer, total), "turtle");
+    ASSERT_TRUE(request->endRequest().ok());
+    ASSERT_TRUE(inter.ok());
+  }
+
+  ConnectionStats stats = _factory.getCurl().getConnectionStats();
+  ASSERT_EQ(stats.newConnections, 2u);
+  ASSERT_EQ(stats.reusedConnections, 0u);
+  ASSERT_EQ(stats.http2Streams, 0u);
+  ASSERT_EQ(stats.multiplexedStreams, 0u);
+}
+
+TEST_F(Standalone_Curl_Request, Http2Multiplexing) {
+  _params.setHttp2Multiplexing(true);
+  _params.setSSLCAcheck(false);
+  _uri = Uri("https://localhost:22222/chickens");
+
+  // a single connection, carrying all requests
+  const size_t nrequests = 5;
+  Http2Interactor inter(nrequests, "turtle");
+  _drunk_server->autoAcceptNext(&inter);
+
+  Context context;
+  CurlSessionFactory &factory = ContextExplorer::SessionFactoryFromContext(context).getCurl();
+  std::atomic<size_t> succeeded(0);
+
+  auto get = [&]() {
+    StandaloneCurlRequest request(factory, true, _boundHooks, _uri, _verb, _params, _headers, _flags, NULL, _deadline);
+    if(!request.startRequest().ok() || request.getStatusCode() != 200) {
+      return;
+    }
+
+    char buffer[16];
+    Status st;
+    dav_ssize_t total = 0;
+    dav_ssize_t bytes = 0;
+    while((bytes = request.readBlock(buffer + total, sizeof(buffer) - total, st)) > 0) {
+      total += bytes;
+    }
+
+    if(st.ok() && std::string(buffer, total) == "turtle" && request.endRequest().ok()) {
+      succeeded++;
+    }
+  };
+
+  // the connection is established once ...
+  get();
+  ASSERT_EQ(succeeded, 1u);
+
+  // ... then concurrent requests are multiplexed over it
+  std::vector<std::thread> threads;
+  for(size_t i = 1; i < nrequests; i++) {
+    threads.emplace_back(get);
+  }
+
+  for(size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+
+  ASSERT_EQ(succeeded, nrequests);
+  ASSERT_EQ(inter.getAnswered(), nrequests);
+
+  ConnectionStats stats = context.getConnectionStats();
+  ASSERT_EQ(stats.newConnections, 1u);
+  ASSERT_EQ(stats.reusedConnections, nrequests - 1);
+  ASSERT_EQ(stats.http2Streams, nrequests);
+  ASSERT_EQ(stats.multiplexedStreams, nrequests - 1);
+}
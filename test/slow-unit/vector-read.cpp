@@ -0,0 +1,221 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <davix.hpp>
+#include "../drunk-server/DrunkServer.hpp"
+#include "../drunk-server/Interactors.hpp"
+
+#include <condition_variable>
+#include <fcntl.h>
+#include <mutex>
+
+using namespace Davix;
+
+class VectorRead : public ::testing::Test {
+public:
+  VectorRead() {
+    for(size_t i = 0; i < 1500000; i++) {
+      _contents.push_back('a' + (i % 23));
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Queue "count" connections to be served out of _contents
+  //----------------------------------------------------------------------------
+  void serve(size_t count, bool multirange) {
+    for(size_t i = 0; i < count; i++) {
+      _interactors.emplace_back(new RangeInteractor(_contents, multirange));
+      _server->autoAcceptNext(_interactors.back().get());
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Read "count" ranges of 10 bytes, far enough apart not to be merged
+  //----------------------------------------------------------------------------
+  void readVec(size_t count) {
+    std::vector<DavIOVecInput> in(count);
+    std::vector<DavIOVecOuput> out(count);
+    std::vector<std::string> buffers(count, std::string(10, '\0'));
+
+    for(size_t i = 0; i < count; i++) {
+      in[i].diov_offset = i * 3000;
+      in[i].diov_size = 10;
+      in[i].diov_buffer = &buffers[i][0];
+    }
+
+    DavixError *err = NULL;
+    DavFile file(_context, Uri("http://localhost:22222/chickens"));
+    // bytes received from the server - the whole file, if that's what we got
+    ASSERT_GE(file.readPartialBufferVec(NULL, in.data(), out.data(), count, &err), (dav_ssize_t) (count * 10));
+    ASSERT_EQ(err, nullptr);
+
+    for(size_t i = 0; i < count; i++) {
+      ASSERT_EQ(out[i].diov_size, 10u);
+      ASSERT_EQ(buffers[i], _contents.substr(i * 3000, 10));
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Number of connections that received a request
+  //----------------------------------------------------------------------------
+  size_t served() {
+    size_t count = 0;
+    for(size_t i = 0; i < _interactors.size(); i++) {
+      if(!_interactors[i]->getRangeHeader().empty()) {
+        count++;
+      }
+    }
+
+    return count;
+  }
+
+protected:
+  std::string _contents;
+  Context _context;
+
+  // declared before the server, so that it is gone before the interactors
+  std::vector<std::unique_ptr<RangeInteractor>> _interactors;
+  std::unique_ptr<DrunkServer> _server { new DrunkServer(22222) };
+};
+
+TEST_F(VectorRead, ConcurrentBatches) {
+  // 500 ranges don't fit into a single Range header
+  serve(10, true);
+  readVec(500);
+
+  size_t batches = served();
+  ASSERT_GT(batches, 1u);
+
+  for(size_t i = 0; i < batches; i++) {
+    ASSERT_NE(_interactors[i]->getRangeHeader().find(","), std::string::npos);
+  }
+}
+
+TEST_F(VectorRead, MultipartInPlace) {
+  // each part of the answer maps to exactly one range, and is read in place
+  serve(1, true);
+
+  std::vector<DavIOVecInput> in(5);
+  std::vector<DavIOVecOuput> out(5);
+  std::vector<std::string> buffers(5, std::string(10, '\0'));
+
+  for(size_t i = 0; i < in.size(); i++) {
+    in[i].diov_offset = i * 3000;
+    in[i].diov_size = 10;
+    in[i].diov_buffer = &buffers[i][0];
+    out[i].diov_buffer = (void*) 0x1;
+  }
+
+  DavixError *err = NULL;
+  DavFile file(_context, Uri("http://localhost:22222/chickens"));
+  ASSERT_EQ(file.readPartialBufferVec(NULL, in.data(), out.data(), in.size(), &err), 50);
+  ASSERT_EQ(err, nullptr);
+  ASSERT_NE(_interactors[0]->getRangeHeader().find(","), std::string::npos);
+
+  for(size_t i = 0; i < in.size(); i++) {
+    ASSERT_EQ(out[i].diov_buffer, in[i].diov_buffer);
+    ASSERT_EQ(out[i].diov_size, 10u);
+    ASSERT_EQ(buffers[i], _contents.substr(i * 3000, 10));
+  }
+}
+
+TEST_F(VectorRead, WholeFileFallback) {
+  // first time around the server sends us the whole file, small enough to
+  // serve the ranges out of it
+  _contents.resize(20000);
+  serve(1, false);
+  readVec(5);
+  ASSERT_EQ(served(), 1u);
+
+  // ... which is remembered: go straight for single-range requests
+  serve(5, false);
+  readVec(5);
+  ASSERT_EQ(served(), 6u);
+
+  for(size_t i = 1; i < _interactors.size(); i++) {
+    ASSERT_EQ(_interactors[i]->getRangeHeader().find(","), std::string::npos);
+  }
+}
+
+TEST_F(VectorRead, Async) {
+  serve(3, true);
+
+  std::vector<std::string> buffers(3, std::string(100, '\0'));
+  DavFile file(_context, Uri("http://localhost:22222/chickens"));
+
+  // all in flight at the same time
+  std::future<dav_ssize_t> first = file.readPartialAsync(NULL, &buffers[0][0], 100, 1000);
+  std::future<dav_ssize_t> second = file.readPartialAsync(NULL, &buffers[1][0], 100, 5000);
+
+  std::mutex mtx;
+  std::condition_variable cv;
+  bool done = false;
+  dav_ssize_t result = 0;
+
+  file.readPartialAsync(NULL, &buffers[2][0], 100, 9000, [&](dav_ssize_t ret, DavixError *err) {
+    std::lock_guard<std::mutex> lock(mtx);
+    result = (err == NULL) ? ret : -1;
+    done = true;
+    cv.notify_one();
+  });
+
+  ASSERT_EQ(first.get(), 100);
+  ASSERT_EQ(second.get(), 100);
+
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(10), [&]() { return done; }));
+    ASSERT_EQ(result, 100);
+  }
+
+  ASSERT_EQ(buffers[0], _contents.substr(1000, 100));
+  ASSERT_EQ(buffers[1], _contents.substr(5000, 100));
+  ASSERT_EQ(buffers[2], _contents.substr(9000, 100));
+}
+
+TEST_F(VectorRead, AsyncPosix) {
+  // opening the file costs a HEAD
+  serve(2, true);
+
+  std::vector<DavIOVecInput> in(3);
+  std::vector<DavIOVecOuput> out(3);
+  std::vector<std::string> buffers(3, std::string(10, '\0'));
+
+  for(size_t i = 0; i < 3; i++) {
+    in[i].diov_offset = i * 3000;
+    in[i].diov_size = 10;
+    in[i].diov_buffer = &buffers[i][0];
+  }
+
+  DavPosix posix(&_context);
+  DAVIX_FD *fd = posix.open(NULL, "http://localhost:22222/chickens", O_RDONLY, NULL);
+  ASSERT_TRUE(fd != NULL);
+
+  ASSERT_EQ(posix.preadVecAsync(fd, in.data(), out.data(), 3).get(), 30);
+  for(size_t i = 0; i < 3; i++) {
+    ASSERT_EQ(buffers[i], _contents.substr(i * 3000, 10));
+  }
+
+  ASSERT_EQ(posix.close(fd, NULL), 0);
+
+  // invalid descriptors are reported right away
+  ASSERT_THROW(posix.preadAsync(NULL, &buffers[0][0], 10, 0).get(), DavixException);
+}
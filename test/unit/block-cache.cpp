@@ -0,0 +1,258 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include <davix.hpp>
+#include <core/BlockCache.hpp>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace Davix;
+
+static std::string makeContents(size_t size) {
+  std::string contents(size, '\0');
+  for(size_t i = 0; i < size; i++) {
+    contents[i] = 'a' + (i % 23);
+  }
+  return contents;
+}
+
+// fetch function over an in-memory file
+struct FakeFile {
+  FakeFile(size_t size, int delayMs = 0) : contents(makeContents(size)), etag("\"v1\""), delay(delayMs), fetches(0) {}
+
+  BlockCache::FetchFunction fetcher() {
+    return [this](char *buffer, dav_size_t count, dav_off_t offset, std::string &tag) -> dav_ssize_t {
+      fetches++;
+      if(delay > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+      }
+
+      tag = etag;
+      if(offset >= (dav_off_t) contents.size()) {
+        return 0;
+      }
+
+      dav_size_t n = std::min<dav_size_t>(count, contents.size() - offset);
+      memcpy(buffer, contents.data() + offset, n);
+      return n;
+    };
+  }
+
+  std::string contents;
+  std::string etag;
+  int delay;
+  std::atomic<size_t> fetches;
+};
+
+TEST(BlockCache, Hits) {
+  FakeFile file(10000);
+  BlockCache cache(64 * 1024, 1024);
+
+  std::string buffer(3000, '\0');
+  ASSERT_EQ(cache.read("https://example.org/file", &buffer[0], 3000, 500, file.fetcher()), 3000);
+  ASSERT_EQ(buffer, file.contents.substr(500, 3000));
+  ASSERT_EQ(file.fetches, 4u);
+
+  // same blocks, any range within them
+  ASSERT_EQ(cache.read("https://example.org/file", &buffer[0], 2000, 1024, file.fetcher()), 2000);
+  ASSERT_EQ(buffer.substr(0, 2000), file.contents.substr(1024, 2000));
+  ASSERT_EQ(file.fetches, 4u);
+
+  // another URL, other blocks
+  ASSERT_EQ(cache.read("https://example.org/other", &buffer[0], 100, 0, file.fetcher()), 100);
+  ASSERT_EQ(file.fetches, 5u);
+
+  BlockCacheStats stats = cache.getStats();
+  ASSERT_EQ(stats.misses, 5u);
+  ASSERT_EQ(stats.hits, 2u);
+  ASSERT_EQ(stats.cachedBytes, 5 * 1024u);
+  ASSERT_DOUBLE_EQ(stats.hitRatio(), 2.0 / 7);
+}
+
+TEST(BlockCache, EndOfFile) {
+  FakeFile file(2500);
+  BlockCache cache(64 * 1024, 1024);
+
+  std::string buffer(1000, '\0');
+  ASSERT_EQ(cache.read("https://example.org/file", &buffer[0], 1000, 2000, file.fetcher()), 500);
+  ASSERT_EQ(buffer.substr(0, 500), file.contents.substr(2000));
+
+  ASSERT_EQ(cache.read("https://example.org/file", &buffer[0], 1000, 2200, file.fetcher()), 300);
+  ASSERT_EQ(file.fetches, 2u);
+
+  // nothing to cache past the end
+  ASSERT_EQ(cache.read("https://example.org/file", &buffer[0], 1000, 5000, file.fetcher()), 0);
+  ASSERT_EQ(file.fetches, 3u);
+}
+
+TEST(BlockCache, Version) {
+  FakeFile file(10000);
+  BlockCache cache(64 * 1024, 1024);
+
+  std::string buffer(1024, '\0');
+  cache.read("https://example.org/file", &buffer[0], 1024, 0, file.fetcher());
+  cache.read("https://example.org/file", &buffer[0], 1024, 1024, file.fetcher());
+  ASSERT_EQ(file.fetches, 2u);
+
+  // a fetch seeing a new entity tag makes the blocks of the old one stale
+  file.contents = makeContents(20000).substr(1);
+  file.etag = "\"v2\"";
+  cache.read("https://example.org/file", &buffer[0], 1024, 2048, file.fetcher());
+
+  ASSERT_EQ(cache.read("https://example.org/file", &buffer[0], 1024, 0, file.fetcher()), 1024);
+  ASSERT_EQ(buffer, file.contents.substr(0, 1024));
+  ASSERT_EQ(file.fetches, 4u);
+
+  // no entity tag, no caching
+  file.etag.clear();
+  cache.invalidate("https://example.org/file");
+  cache.read("https://example.org/file", &buffer[0], 1024, 0, file.fetcher());
+  cache.read("https://example.org/file", &buffer[0], 1024, 0, file.fetcher());
+  ASSERT_EQ(file.fetches, 6u);
+  ASSERT_EQ(cache.getStats().cachedBytes, 0u);
+}
+
+TEST(BlockCache, VersionWithinRead) {
+  FakeFile file(10000);
+  BlockCache cache(64 * 1024, 1024);
+
+  std::string buffer(3072, '\0');
+  cache.read("https://example.org/file", &buffer[0], 1024, 0, file.fetcher());
+  ASSERT_EQ(file.fetches, 1u);
+
+  // the first block is served from the cache, the next ones show the file
+  // has changed: the stale block is fetched again instead of being mixed in
+  file.contents = makeContents(20000).substr(1);
+  file.etag = "\"v2\"";
+  ASSERT_EQ(cache.read("https://example.org/file", &buffer[0], 3072, 0, file.fetcher()), 3072);
+  ASSERT_EQ(buffer, file.contents.substr(0, 3072));
+  ASSERT_EQ(file.fetches, 4u);
+
+  // a file changing on every fetch can't be read consistently
+  BlockCache::FetchFunction fetch = file.fetcher();
+  size_t version = 2;
+  BlockCache::FetchFunction changing = [&](char *out, dav_size_t count, dav_off_t offset, std::string &tag) {
+    dav_ssize_t ret = fetch(out, count, offset, tag);
+    tag = "\"v" + std::to_string(++version) + "\"";
+    return ret;
+  };
+
+  cache.invalidate("https://example.org/file");
+  ASSERT_THROW(cache.read("https://example.org/file", &buffer[0], 3072, 0, changing), DavixException);
+}
+
+TEST(BlockCache, Limit) {
+  FakeFile file(100000);
+  BlockCache cache(4 * 1024, 1024);
+
+  std::string buffer(1024, '\0');
+  for(size_t i = 0; i < 4; i++) {
+    cache.read("https://example.org/file", &buffer[0], 1024, i * 1024, file.fetcher());
+  }
+
+  // block 0 is used again, block 1 is the least recently used
+  cache.read("https://example.org/file", &buffer[0], 1024, 0, file.fetcher());
+  cache.read("https://example.org/file", &buffer[0], 1024, 10 * 1024, file.fetcher());
+  ASSERT_EQ(cache.getStats().evictions, 1u);
+  ASSERT_EQ(cache.getStats().cachedBytes, 4 * 1024u);
+
+  size_t fetches = file.fetches;
+  cache.read("https://example.org/file", &buffer[0], 1024, 0, file.fetcher());
+  ASSERT_EQ(file.fetches, fetches);
+  cache.read("https://example.org/file", &buffer[0], 1024, 1024, file.fetcher());
+  ASSERT_EQ(file.fetches, fetches + 1);
+
+  cache.setLimit(2 * 1024);
+  ASSERT_EQ(cache.getStats().cachedBytes, 2 * 1024u);
+
+  cache.setLimit(0);
+  cache.read("https://example.org/file", &buffer[0], 1024, 0, file.fetcher());
+  ASSERT_EQ(cache.getStats().cachedBytes, 0u);
+}
+
+TEST(BlockCache, Coalesce) {
+  FakeFile file(100000, 50);
+  BlockCache cache(64 * 1024, 1024);
+
+  std::vector<std::thread> threads;
+  std::atomic<size_t> good(0);
+
+  for(size_t i = 0; i < 8; i++) {
+    threads.emplace_back([&, i] {
+      std::string buffer(100, '\0');
+      if(cache.read("https://example.org/file", &buffer[0], 100, 100 * i, file.fetcher()) == 100 &&
+         buffer == file.contents.substr(100 * i, 100)) {
+        good++;
+      }
+    });
+  }
+
+  for(size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+
+  ASSERT_EQ(good, 8u);
+  ASSERT_EQ(file.fetches, 1u);
+  ASSERT_EQ(cache.getStats().misses + cache.getStats().coalesced + cache.getStats().hits, 8u);
+}
+
+TEST(BlockCache, Failure) {
+  BlockCache cache(64 * 1024, 1024);
+  std::atomic<size_t> fetches(0);
+
+  auto failing = [&](char *buffer, dav_size_t count, dav_off_t offset, std::string &etag) -> dav_ssize_t {
+    fetches++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    throw DavixException("test", StatusCode::ConnectionProblem, "fetch failed");
+  };
+
+  // waiters get the error of the fetch they waited for
+  std::atomic<size_t> errors(0);
+  std::vector<std::thread> threads;
+  for(size_t i = 0; i < 4; i++) {
+    threads.emplace_back([&] {
+      char buffer[10];
+      try {
+        cache.read("https://example.org/file", buffer, 10, 0, failing);
+      }
+      catch(DavixException &e) {
+        errors++;
+      }
+    });
+  }
+
+  for(size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+
+  ASSERT_EQ(errors, 4u);
+  ASSERT_LE(fetches, 4u);
+
+  // failures aren't cached
+  FakeFile file(100);
+  char buffer[10];
+  ASSERT_EQ(cache.read("https://example.org/file", buffer, 10, 0, file.fetcher()), 10);
+}
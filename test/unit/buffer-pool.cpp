@@ -0,0 +1,105 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include <core/BufferPool.hpp>
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace Davix;
+
+static const dav_size_t MB = 1024 * 1024;
+
+TEST(BufferPool, SizeClasses) {
+  ASSERT_EQ(BufferPool::sizeClass(1), BufferPool::kMinSizeClass);
+  ASSERT_EQ(BufferPool::sizeClass(BufferPool::kMinSizeClass + 1), 2 * BufferPool::kMinSizeClass);
+  ASSERT_EQ(BufferPool::sizeClass(MB), MB);
+  ASSERT_EQ(BufferPool::sizeClass(MB + 1), 2 * MB);
+  ASSERT_EQ(BufferPool::sizeClass(5 * MB + 3), 6 * MB);
+}
+
+TEST(BufferPool, Reuse) {
+  BufferPool pool(4 * MB);
+
+  {
+    PooledBuffer buf = pool.acquire(MB);
+    ASSERT_TRUE(buf.valid());
+    ASSERT_EQ(buf.size(), MB);
+  }
+
+  PooledBuffer buf = pool.acquire(MB - 10);
+  ASSERT_TRUE(buf.valid());
+
+  BufferPoolStats stats = pool.getStats();
+  ASSERT_EQ(stats.misses, 1u);
+  ASSERT_EQ(stats.hits, 1u);
+  ASSERT_EQ(stats.allocatedBytes, MB);
+  ASSERT_EQ(stats.cachedBytes, 0u);
+
+  buf.release();
+  ASSERT_EQ(pool.getStats().cachedBytes, MB);
+
+  pool.trim();
+  ASSERT_EQ(pool.getStats().allocatedBytes, 0u);
+  ASSERT_EQ(pool.getStats().highWaterMark, MB);
+}
+
+TEST(BufferPool, Limit) {
+  BufferPool pool(2 * MB);
+
+  PooledBuffer a = pool.acquire(MB);
+  PooledBuffer b = pool.acquire(MB);
+  ASSERT_FALSE(pool.tryAcquire(MB).valid());
+  ASSERT_EQ(pool.getStats().waits, 1u);
+
+  // cached buffers of another size class make room
+  b.release();
+  PooledBuffer c = pool.tryAcquire(512 * 1024);
+  ASSERT_TRUE(c.valid());
+  ASSERT_EQ(pool.getStats().allocatedBytes, MB + 512 * 1024);
+
+  // blocked until something is released
+  std::thread releaser([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    a.release();
+  });
+
+  PooledBuffer d = pool.acquire(MB);
+  ASSERT_TRUE(d.valid());
+  releaser.join();
+
+  ASSERT_LE(pool.getStats().highWaterMark, 2 * MB);
+}
+
+TEST(BufferPool, LargerThanLimit) {
+  BufferPool pool(MB);
+
+  PooledBuffer big = pool.acquire(3 * MB);
+  ASSERT_TRUE(big.valid());
+  ASSERT_EQ(big.size(), 3 * MB);
+
+  // only served by an empty pool
+  ASSERT_FALSE(pool.tryAcquire(1).valid());
+  big.release();
+
+  // over the limit, not kept around
+  ASSERT_EQ(pool.getStats().cachedBytes, 0u);
+  ASSERT_EQ(pool.getStats().allocatedBytes, 0u);
+}
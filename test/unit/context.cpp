@@ -20,6 +20,23 @@ TEST(ContextTest, CreateDelete){
 
 
 
+TEST(ContextTest, VecReadPlanHook){
+    Davix::Context c1;
+    ASSERT_FALSE(c1.getHook<Davix::VecReadPlanHook>());
+
+    dav_size_t overread = 0;
+    c1.setHook<Davix::VecReadPlanHook>([&](const Davix::Uri &, const Davix::VecReadPlan & plan) {
+        overread = plan.bytes_overread;
+    });
+
+    // hooks are carried over to clones
+    std::unique_ptr<Davix::Context> c2(c1.clone());
+    Davix::VecReadPlan plan;
+    plan.bytes_overread = 42;
+    c2->getHook<Davix::VecReadPlanHook>()(Davix::Uri("http://example.org/"), plan);
+    ASSERT_EQ(overread, 42u);
+}
+
 TEST(RequestParametersTest, CreateDelete){
     Davix::RequestParams params;
 
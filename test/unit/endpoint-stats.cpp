@@ -0,0 +1,77 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include <core/EndpointStats.hpp>
+#include <gtest/gtest.h>
+
+using namespace Davix;
+
+TEST(EndpointStats, BasicSanity) {
+  EndpointStats stats;
+  ASSERT_FALSE(stats.getEstimate("http://example.org:80").valid());
+
+  stats.recordLatency("http://example.org:80", 0.1);
+  ASSERT_FALSE(stats.getEstimate("http://example.org:80").valid());
+
+  stats.recordThroughput("http://example.org:80", 2, 2000000);
+  EndpointEstimate est = stats.getEstimate("http://example.org:80");
+  ASSERT_TRUE(est.valid());
+  ASSERT_DOUBLE_EQ(est.rtt, 0.1);
+  ASSERT_DOUBLE_EQ(est.throughput, 1000000);
+  ASSERT_DOUBLE_EQ(est.bandwidthDelayProduct(), 100000);
+
+  // endpoints are tracked separately
+  ASSERT_FALSE(stats.getEstimate("http://example.org:8080").valid());
+
+  // new samples are smoothed in
+  stats.recordLatency("http://example.org:80", 0.2);
+  est = stats.getEstimate("http://example.org:80");
+  ASSERT_DOUBLE_EQ(est.rtt, 0.1 * (1 - EndpointStats::kSmoothing) + 0.2 * EndpointStats::kSmoothing);
+  ASSERT_EQ(est.latencySamples, 2u);
+
+  // bogus samples are ignored
+  stats.recordThroughput("http://example.org:80", 0, 1000);
+  stats.recordThroughput("http://example.org:80", 1, 0);
+  ASSERT_EQ(stats.getEstimate("http://example.org:80").throughputSamples, 1u);
+}
+
+TEST(EndpointStats, RecordTransfer) {
+  EndpointStats stats;
+
+  // nothing known yet, the whole request counts as latency
+  stats.recordTransfer("http://example.org:80", 0.05, 100);
+  EndpointEstimate est = stats.getEstimate("http://example.org:80");
+  ASSERT_EQ(est.latencySamples, 1u);
+  ASSERT_EQ(est.throughputSamples, 0u);
+  ASSERT_DOUBLE_EQ(est.rtt, 0.05);
+
+  // a request taking much longer than a round trip tells us about throughput
+  stats.recordTransfer("http://example.org:80", 1.05, 1000000);
+  est = stats.getEstimate("http://example.org:80");
+  ASSERT_EQ(est.latencySamples, 1u);
+  ASSERT_EQ(est.throughputSamples, 1u);
+  ASSERT_DOUBLE_EQ(est.throughput, 1000000);
+
+  // latency-dominated requests refine the round trip
+  stats.recordTransfer("http://example.org:80", 0.06, 100);
+  est = stats.getEstimate("http://example.org:80");
+  ASSERT_EQ(est.latencySamples, 2u);
+  ASSERT_EQ(est.throughputSamples, 1u);
+}
@@ -0,0 +1,314 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include <core/Hedger.hpp>
+#include <core/WorkerPool.hpp>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace Davix;
+
+static const std::string kEndpoint = "http://example.org:80";
+
+// size of the reads of most tests
+static const dav_size_t kSize = 8;
+
+typedef std::chrono::steady_clock SteadyClock;
+
+static double elapsedMs(SteadyClock::time_point start) {
+  return std::chrono::duration<double, std::milli>(SteadyClock::now() - start).count();
+}
+
+// sleep up to "ms", stop early once cancelled
+static bool sleepUnlessCancelled(int ms, const std::atomic<bool> &cancelled) {
+  for(int i = 0; i < ms; i++) {
+    if(cancelled) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+static void warmUp(Hedger &hedger, size_t n, double seconds) {
+  for(size_t i = 0; i < n; i++) {
+    hedger.recordLatency(kEndpoint, kSize, seconds);
+  }
+}
+
+TEST(Hedger, Delay) {
+  Hedger hedger(100, 10);
+  std::chrono::microseconds delay;
+
+  warmUp(hedger, 9, 0.001);
+  ASSERT_FALSE(hedger.getDelay(kEndpoint, kSize, 0.9, delay));
+
+  for(size_t i = 1; i <= 100; i++) {
+    hedger.recordLatency(kEndpoint, kSize, i / 1000.0);
+  }
+
+  ASSERT_TRUE(hedger.getDelay(kEndpoint, kSize, 0.9, delay));
+  ASSERT_EQ(delay.count(), 91000);
+  ASSERT_TRUE(hedger.getDelay(kEndpoint, kSize, 1, delay));
+  ASSERT_EQ(delay.count(), 100000);
+  ASSERT_FALSE(hedger.getDelay("http://example.org:8080", kSize, 0.9, delay));
+
+  hedger.clear();
+  ASSERT_FALSE(hedger.getDelay(kEndpoint, kSize, 0.9, delay));
+}
+
+TEST(Hedger, NoSamples) {
+  WorkerPool pool;
+  Hedger hedger(128, 4);
+  char buffer[8];
+  size_t winner;
+
+  // plain reads, straight into the caller's buffer, until enough are timed
+  for(size_t i = 0; i < 4; i++) {
+    dav_ssize_t ret = hedger.read(pool, kEndpoint, 0.9, 1, buffer, sizeof(buffer),
+      [&](size_t attempt, char *out, const std::atomic<bool> &cancelled) -> dav_ssize_t {
+        EXPECT_EQ(attempt, 0u);
+        EXPECT_EQ(out, buffer);
+        memcpy(out, "original", 8);
+        return 8;
+      }, winner);
+
+    ASSERT_EQ(ret, 8);
+    ASSERT_EQ(winner, 0u);
+  }
+
+  std::chrono::microseconds delay;
+  ASSERT_TRUE(hedger.getDelay(kEndpoint, kSize, 0.9, delay));
+  ASSERT_EQ(pool.getWorkerCount(), 0u);
+
+  HedgingStats stats = hedger.getStats();
+  ASSERT_EQ(stats.reads, 4u);
+  ASSERT_EQ(stats.hedged, 0u);
+}
+
+TEST(Hedger, Hedge) {
+  WorkerPool pool;
+  Hedger hedger(128, 4);
+  warmUp(hedger, 4, 0.005);
+
+  std::atomic<bool> originalCancelled(false);
+  char buffer[8];
+  size_t winner;
+
+  // the original read stalls, the duplicate answers right away
+  SteadyClock::time_point start = SteadyClock::now();
+  dav_ssize_t ret = hedger.read(pool, kEndpoint, 0.9, 1, buffer, sizeof(buffer),
+    [&](size_t attempt, char *out, const std::atomic<bool> &cancelled) -> dav_ssize_t {
+      if(attempt == 0) {
+        if(!sleepUnlessCancelled(2000, cancelled)) {
+          originalCancelled = true;
+          return 0;
+        }
+        memcpy(out, "original", 8);
+        return 8;
+      }
+
+      memcpy(out, "The hedg", 8);
+      return 8;
+    }, winner);
+
+  ASSERT_LT(elapsedMs(start), 1000);
+  ASSERT_EQ(ret, 8);
+  ASSERT_EQ(winner, 1u);
+  ASSERT_EQ(std::string(buffer, 8), "The hedg");
+
+  HedgingStats stats = hedger.getStats();
+  ASSERT_EQ(stats.reads, 1u);
+  ASSERT_EQ(stats.hedged, 1u);
+  ASSERT_EQ(stats.wins, 1u);
+
+  // the original read is told to stop
+  for(int i = 0; i < 1000 && !originalCancelled; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_TRUE(originalCancelled);
+}
+
+TEST(Hedger, OriginalFirst) {
+  WorkerPool pool;
+  Hedger hedger(128, 4);
+  warmUp(hedger, 4, 0.001);
+
+  std::atomic<bool> hedgeCancelled(false);
+  char buffer[8];
+  size_t winner;
+
+  // the original read is late, but still answers before the duplicate
+  dav_ssize_t ret = hedger.read(pool, kEndpoint, 0.9, 1, buffer, sizeof(buffer),
+    [&](size_t attempt, char *out, const std::atomic<bool> &cancelled) -> dav_ssize_t {
+      if(attempt == 1) {
+        if(!sleepUnlessCancelled(2000, cancelled)) {
+          hedgeCancelled = true;
+          return 0;
+        }
+      }
+      else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      }
+
+      memcpy(out, attempt == 0 ? "original" : "The hedg", 8);
+      return 8;
+    }, winner);
+
+  ASSERT_EQ(ret, 8);
+  ASSERT_EQ(winner, 0u);
+  ASSERT_EQ(std::string(buffer, 8), "original");
+  ASSERT_EQ(hedger.getStats().wins, 0u);
+
+  for(int i = 0; i < 1000 && !hedgeCancelled; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_TRUE(hedgeCancelled);
+}
+
+TEST(Hedger, Budget) {
+  WorkerPool pool;
+  Hedger hedger(128, 4);
+  warmUp(hedger, 4, 0.001);
+
+  char buffer[8];
+  size_t winner;
+  std::atomic<size_t> duplicates(0);
+
+  auto read = [&](size_t attempt, char *out, const std::atomic<bool> &cancelled) -> dav_ssize_t {
+    if(attempt == 1) {
+      duplicates++;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    memcpy(out, "original", 8);
+    return 8;
+  };
+
+  // one in four reads at most
+  for(size_t i = 0; i < 8; i++) {
+    ASSERT_EQ(hedger.read(pool, kEndpoint, 0.5, 0.25, buffer, sizeof(buffer), read, winner), 8);
+  }
+
+  HedgingStats stats = hedger.getStats();
+  ASSERT_EQ(stats.reads, 8u);
+  ASSERT_LE(stats.hedged, 2u);
+  ASSERT_LE(duplicates, stats.hedged);
+  ASSERT_LE(stats.hedgeRatio(), 0.25);
+}
+
+TEST(Hedger, Failure) {
+  WorkerPool pool;
+  Hedger hedger(128, 4);
+  warmUp(hedger, 4, 0.001);
+
+  char buffer[8];
+  size_t winner;
+
+  // the original read fails late, the duplicate saves the day
+  dav_ssize_t ret = hedger.read(pool, kEndpoint, 0.9, 1, buffer, sizeof(buffer),
+    [&](size_t attempt, char *out, const std::atomic<bool> &cancelled) -> dav_ssize_t {
+      if(attempt == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        throw DavixException("test", StatusCode::ConnectionProblem, "connection reset");
+      }
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      memcpy(out, "The hedg", 8);
+      return 8;
+    }, winner);
+
+  ASSERT_EQ(ret, 8);
+  ASSERT_EQ(winner, 1u);
+
+  // both fail: the error of the original read
+  try {
+    hedger.read(pool, kEndpoint, 0.9, 1, buffer, sizeof(buffer),
+      [&](size_t attempt, char *out, const std::atomic<bool> &cancelled) -> dav_ssize_t {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        throw DavixException("test", attempt == 0 ? StatusCode::ConnectionProblem : StatusCode::FileNotFound, "failed");
+      }, winner);
+    FAIL();
+  }
+  catch(DavixException &e) {
+    ASSERT_EQ(e.code(), StatusCode::ConnectionProblem);
+  }
+}
+
+TEST(Hedger, MixedSizes) {
+  WorkerPool pool;
+  Hedger hedger(128, 4, 1024 * 1024);
+  warmUp(hedger, 4, 0.001);
+
+  const std::thread::id caller = std::this_thread::get_id();
+  std::vector<char> buffer(4 * 1024 * 1024);
+  std::atomic<size_t> duplicates(0);
+  size_t winner;
+
+  // a larger read is only compared with reads of its size: none at first,
+  // so it runs plainly however much slower than the small ones it is
+  auto slowRead = [&](int ms) {
+    return [&, ms](size_t attempt, char *out, const std::atomic<bool> &cancelled) -> dav_ssize_t {
+      if(attempt == 1) {
+        duplicates++;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+      return 8;
+    };
+  };
+
+  for(size_t i = 0; i < 4; i++) {
+    ASSERT_EQ(hedger.read(pool, kEndpoint, 0.9, 1, buffer.data(), 256 * 1024, slowRead(20), winner), 8);
+  }
+  ASSERT_EQ(duplicates, 0u);
+
+  std::chrono::microseconds smallDelay, largeDelay;
+  ASSERT_TRUE(hedger.getDelay(kEndpoint, kSize, 0.9, smallDelay));
+  ASSERT_TRUE(hedger.getDelay(kEndpoint, 256 * 1024, 0.9, largeDelay));
+  ASSERT_EQ(smallDelay.count(), 1000);
+  ASSERT_GE(largeDelay.count(), 20000);
+
+  // within the usual time of its size: not hedged
+  ASSERT_EQ(hedger.read(pool, kEndpoint, 0.9, 1, buffer.data(), 256 * 1024, slowRead(5), winner), 8);
+  ASSERT_EQ(duplicates, 0u);
+
+  // over the size limit: never hedged nor timed, read on the caller's
+  // thread straight into its buffer
+  for(size_t i = 0; i < 5; i++) {
+    ASSERT_EQ(hedger.read(pool, kEndpoint, 0.9, 1, buffer.data(), buffer.size(),
+      [&](size_t attempt, char *out, const std::atomic<bool> &cancelled) -> dav_ssize_t {
+        EXPECT_EQ(attempt, 0u);
+        EXPECT_EQ(out, buffer.data());
+        EXPECT_EQ(std::this_thread::get_id(), caller);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        return 8;
+      }, winner), 8);
+  }
+
+  std::chrono::microseconds delay;
+  ASSERT_FALSE(hedger.getDelay(kEndpoint, buffer.size(), 0.9, delay));
+
+  HedgingStats stats = hedger.getStats();
+  ASSERT_EQ(stats.reads, 10u);
+  ASSERT_EQ(stats.hedged, 0u);
+}
@@ -0,0 +1,174 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include <davix.hpp>
+#include <fileops/ListingPrefetcher.hpp>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <sys/stat.h>
+
+using namespace Davix;
+
+static FileProperties makeEntry(const std::string &name, bool dir = false) {
+  FileProperties entry;
+  entry.filename = name;
+  entry.info.mode = dir ? (S_IFDIR | 0755) : (S_IFREG | 0644);
+  return entry;
+}
+
+// "npages" pages of "perPage" entries named prefix + number
+static ListingPrefetcher::PageFunction pages(const std::string &prefix, size_t npages, size_t perPage,
+  std::atomic<size_t> *fetched = NULL) {
+
+  return [=](const std::string &marker, ListingPage &page) {
+    size_t n = marker.empty() ? 0 : std::stoul(marker);
+    if(fetched) {
+      (*fetched)++;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    for(size_t i = 0; i < perPage; i++) {
+      page.entries.push_back(makeEntry(prefix + std::to_string(n * perPage + i)));
+    }
+
+    if(n + 1 < npages) {
+      page.nextMarker = std::to_string(n + 1);
+    }
+  };
+}
+
+TEST(ListingPrefetcher, InOrder) {
+  Context context;
+  std::atomic<size_t> fetched(0);
+  ListingPrefetcher listing(context, pages("", 5, 10, &fetched), 2);
+
+  FileProperties entry;
+  for(size_t i = 0; i < 50; i++) {
+    ASSERT_TRUE(listing.next(entry));
+    ASSERT_EQ(entry.filename, std::to_string(i));
+
+    // no more than "depth" pages ahead of the one being read
+    ASSERT_LE(fetched, i / 10 + 1 + 2);
+  }
+
+  ASSERT_FALSE(listing.next(entry));
+  ASSERT_FALSE(listing.next(entry));
+  ASSERT_EQ(fetched, 5u);
+}
+
+TEST(ListingPrefetcher, FetchesAhead) {
+  Context context;
+  std::atomic<size_t> fetched(0);
+  ListingPrefetcher listing(context, pages("", 10, 1, &fetched), 3);
+
+  // pages come in while nobody is reading
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_EQ(fetched, 3u);
+
+  FileProperties entry;
+  ASSERT_TRUE(listing.next(entry));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_EQ(fetched, 4u);
+}
+
+TEST(ListingPrefetcher, Failure) {
+  Context context;
+  ListingPrefetcher::PageFunction ok = pages("", 5, 10);
+
+  ListingPrefetcher listing(context, [&](const std::string &marker, ListingPage &page) {
+    if(marker == "2") {
+      throw DavixException("test", StatusCode::ConnectionProblem, "listing failed");
+    }
+    ok(marker, page);
+  }, 4);
+
+  // entries before the failed page are still delivered
+  FileProperties entry;
+  for(size_t i = 0; i < 20; i++) {
+    ASSERT_TRUE(listing.next(entry));
+  }
+
+  ASSERT_THROW(listing.next(entry), DavixException);
+}
+
+TEST(ListingPrefetcher, DestroyInFlight) {
+  Context context;
+  for(size_t i = 0; i < 20; i++) {
+    ListingPrefetcher listing(context, pages("", 100, 100), 4);
+  }
+}
+
+TEST(PartitionedListing, InOrder) {
+  Context context;
+
+  std::unique_ptr<ListingPrefetcher> top(new ListingPrefetcher(context, [](const std::string &marker, ListingPage &page) {
+    if(marker.empty()) {
+      page.entries.push_back(makeEntry("a"));
+      page.entries.push_back(makeEntry("b", true));
+      page.entries.push_back(makeEntry("c"));
+      page.nextMarker = "c";
+    }
+    else {
+      page.entries.push_back(makeEntry("d", true));
+      page.entries.push_back(makeEntry("e", true));
+      page.entries.push_back(makeEntry("f"));
+    }
+  }, 1));
+
+  std::atomic<size_t> open(0), maxOpen(0), opened(0);
+  auto countOpen = [&]() {
+    size_t now = ++open;
+    size_t prev = maxOpen;
+    while(now > prev && !maxOpen.compare_exchange_weak(prev, now)) {}
+  };
+
+  PartitionedListing listing(std::move(top), 2, [&](const FileProperties &partition) {
+    opened++;
+    ListingPrefetcher::PageFunction fetch = pages(partition.filename + "/", 3, 4);
+
+    return std::unique_ptr<ListingPrefetcher>(new ListingPrefetcher(context, [&, fetch](const std::string &marker, ListingPage &page) {
+      countOpen();
+      fetch(marker, page);
+      open--;
+    }, 1));
+  });
+
+  std::vector<std::string> names;
+  FileProperties entry;
+  while(listing.next(entry)) {
+    names.push_back(entry.filename);
+  }
+
+  ASSERT_EQ(names.size(), 3u + 3 * 12u);
+  ASSERT_EQ(names[0], "a");
+  ASSERT_EQ(names[1], "b/0");
+  ASSERT_EQ(names[12], "b/11");
+  ASSERT_EQ(names[13], "c");
+  ASSERT_EQ(names[14], "d/0");
+  ASSERT_EQ(names[26], "e/0");
+  ASSERT_EQ(names[38], "f");
+
+  ASSERT_EQ(opened, 3u);
+  ASSERT_LE(maxOpen, 2u);
+}
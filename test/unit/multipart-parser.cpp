@@ -0,0 +1,169 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include <fileops/MultipartParser.hpp>
+#include <davix.hpp>
+#include <gtest/gtest.h>
+
+using namespace Davix;
+
+static std::string contents() {
+  std::string out;
+  for(size_t i = 0; i < 1000; i++) {
+    out.push_back('a' + (i % 26));
+  }
+  return out;
+}
+
+static std::string makeBody(const std::vector<std::pair<size_t, size_t>> &ranges) {
+  std::string file = contents();
+  std::ostringstream ss;
+
+  ss << "\r\n";
+  for(size_t i = 0; i < ranges.size(); i++) {
+    ss << "--THIS_STRING_SEPARATES\r\n";
+    ss << "Content-Type: application/octet-stream\r\n";
+    ss << "Content-Range: bytes " << ranges[i].first << "-" << ranges[i].second << "/1000\r\n";
+    ss << "\r\n";
+    ss << file.substr(ranges[i].first, ranges[i].second - ranges[i].first + 1) << "\r\n";
+  }
+  ss << "--THIS_STRING_SEPARATES--\r\n";
+  return ss.str();
+}
+
+class MultipartParserTest : public ::testing::Test {
+public:
+  MultipartParserTest() : _received(contents().size(), '\0'),
+    _parser("THIS_STRING_SEPARATES", [this](dav_off_t offset, const char *data, dav_size_t size) {
+      _received.replace(offset, size, data, size);
+      _calls++;
+    }), _calls(0) {}
+
+protected:
+  std::string _received;
+  MultipartParser _parser;
+  size_t _calls;
+};
+
+TEST(MultipartParser, ContentRange) {
+  dav_off_t offset;
+  dav_size_t size;
+
+  std::string line = "Content-Range: bytes 600-900/8000";
+  ASSERT_EQ(parseContentRange(line.c_str(), line.size(), offset, size), 1);
+  ASSERT_EQ(offset, 600);
+  ASSERT_EQ(size, 301u);
+
+  line = "content-range:bytes 0-0/*";
+  ASSERT_EQ(parseContentRange(line.c_str(), line.size(), offset, size), 1);
+  ASSERT_EQ(offset, 0);
+  ASSERT_EQ(size, 1u);
+
+  line = "Content-Type: application/octet-stream";
+  ASSERT_EQ(parseContentRange(line.c_str(), line.size(), offset, size), 0);
+
+  line = "Content-Range: bytes 900-600/8000";
+  ASSERT_EQ(parseContentRange(line.c_str(), line.size(), offset, size), -1);
+
+  line = "Content-Range: bytes 99999999999999999999999-1/8000";
+  ASSERT_EQ(parseContentRange(line.c_str(), line.size(), offset, size), -1);
+
+  line = "Content-Range: pages 1-2/8000";
+  ASSERT_EQ(parseContentRange(line.c_str(), line.size(), offset, size), -1);
+}
+
+TEST_F(MultipartParserTest, WholeBody) {
+  std::string body = makeBody({ {0, 9}, {100, 199}, {995, 999} }) + "epilogue";
+  ASSERT_EQ(_parser.feed(body.c_str(), body.size(), NULL), (dav_ssize_t) (body.size() - 8));
+
+  ASSERT_TRUE(_parser.done());
+  ASSERT_EQ(_parser.payloadBytes(), 115u);
+  ASSERT_EQ(_calls, 3u);
+
+  std::string file = contents();
+  ASSERT_EQ(_received.substr(0, 10), file.substr(0, 10));
+  ASSERT_EQ(_received.substr(100, 100), file.substr(100, 100));
+  ASSERT_EQ(_received.substr(995, 5), file.substr(995, 5));
+  ASSERT_EQ(_received[10], '\0');
+}
+
+TEST_F(MultipartParserTest, ByteByByte) {
+  std::string body = makeBody({ {0, 9}, {100, 199} });
+
+  for(size_t i = 0; i < body.size(); i++) {
+    ASSERT_EQ(_parser.feed(body.c_str() + i, 1, NULL), 1);
+  }
+
+  ASSERT_TRUE(_parser.done());
+  ASSERT_EQ(_parser.payloadBytes(), 110u);
+  ASSERT_EQ(_received.substr(100, 100), contents().substr(100, 100));
+}
+
+TEST_F(MultipartParserTest, SkipPayload) {
+  std::string body = makeBody({ {100, 199} });
+  size_t payload = body.find("\r\n\r\n") + 4;
+
+  // headers and the first few bytes go through the parser, the rest is
+  // consumed by the caller
+  ASSERT_EQ(_parser.feed(body.c_str(), payload + 10, NULL), (dav_ssize_t) (payload + 10));
+  ASSERT_TRUE(_parser.inPayload());
+  ASSERT_EQ(_parser.payloadOffset(), 110);
+  ASSERT_EQ(_parser.payloadRemaining(), 90u);
+
+  _parser.skipPayload(90);
+  ASSERT_FALSE(_parser.inPayload());
+
+  std::string rest = body.substr(payload + 100);
+  ASSERT_EQ(_parser.feed(rest.c_str(), rest.size(), NULL), (dav_ssize_t) rest.size());
+  ASSERT_TRUE(_parser.done());
+  ASSERT_EQ(_parser.payloadBytes(), 100u);
+}
+
+TEST_F(MultipartParserTest, Malformed) {
+  DavixError *err = NULL;
+  std::string body = "--SOME_OTHER_BOUNDARY\r\n";
+  ASSERT_EQ(_parser.feed(body.c_str(), body.size(), &err), -1);
+  ASSERT_TRUE(err != NULL);
+  ASSERT_EQ(err->getStatus(), StatusCode::InvalidServerResponse);
+  DavixError::clearError(&err);
+
+  // sticks to the error
+  body = makeBody({ {0, 9} });
+  ASSERT_EQ(_parser.feed(body.c_str(), body.size(), NULL), -1);
+}
+
+TEST_F(MultipartParserTest, MissingContentRange) {
+  DavixError *err = NULL;
+  std::string body = "--THIS_STRING_SEPARATES\r\nContent-Type: text/plain\r\n\r\nabc\r\n";
+  ASSERT_EQ(_parser.feed(body.c_str(), body.size(), &err), -1);
+  ASSERT_TRUE(err != NULL);
+  DavixError::clearError(&err);
+}
+
+TEST_F(MultipartParserTest, LineTooLong) {
+  DavixError *err = NULL;
+  std::string body = "--THIS_STRING_SEPARATES\r\nX-Junk: ";
+
+  ASSERT_EQ(_parser.feed(body.c_str(), body.size(), &err), (dav_ssize_t) body.size());
+  body = std::string(MultipartParser::kMaxLineSize, 'x');
+  ASSERT_EQ(_parser.feed(body.c_str(), body.size(), &err), -1);
+  ASSERT_TRUE(err != NULL);
+  DavixError::clearError(&err);
+}
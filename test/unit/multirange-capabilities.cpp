@@ -0,0 +1,96 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include <core/MultirangeCapabilities.hpp>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace Davix;
+
+TEST(MultirangeCapabilities, Defaults) {
+  MultirangeCapabilityCache cache;
+  MultirangeCapability caps = cache.get("http://example.org:80");
+
+  ASSERT_FALSE(caps.unsupported);
+  ASSERT_EQ(caps.maxRanges, 0u);
+  ASSERT_EQ(caps.maxHeaderSize, 3900u);
+}
+
+TEST(MultirangeCapabilities, Unsupported) {
+  MultirangeCapabilityCache cache;
+
+  cache.recordFailure("http://example.org:80", 10);
+  ASSERT_TRUE(cache.get("http://example.org:80").unsupported);
+  ASSERT_FALSE(cache.get("http://example.org:8080").unsupported);
+
+  cache.clear();
+  ASSERT_FALSE(cache.get("http://example.org:80").unsupported);
+}
+
+TEST(MultirangeCapabilities, MaxRanges) {
+  MultirangeCapabilityCache cache;
+
+  cache.recordSuccess("http://example.org:80", 10);
+  cache.recordSuccess("http://example.org:80", 50);
+  cache.recordSuccess("http://example.org:80", 20);
+  cache.recordFailure("http://example.org:80", 200);
+
+  MultirangeCapability caps = cache.get("http://example.org:80");
+  ASSERT_FALSE(caps.unsupported);
+  ASSERT_EQ(caps.maxRanges, 50u);
+
+  // failing with no more ranges than what worked before: server is broken
+  cache.recordFailure("http://example.org:80", 30);
+  ASSERT_TRUE(cache.get("http://example.org:80").unsupported);
+}
+
+TEST(MultirangeCapabilities, HeaderTooLarge) {
+  MultirangeCapabilityCache cache;
+
+  cache.recordHeaderTooLarge("http://example.org:80", 3900);
+  ASSERT_EQ(cache.get("http://example.org:80").maxHeaderSize, 1950u);
+  ASSERT_FALSE(cache.get("http://example.org:80").unsupported);
+
+  // never grows back because of a late answer to a larger request
+  cache.recordHeaderTooLarge("http://example.org:80", 3900);
+  ASSERT_EQ(cache.get("http://example.org:80").maxHeaderSize, 1950u);
+
+  for(size_t i = 0; i < 10; i++) {
+    cache.recordHeaderTooLarge("http://example.org:80", cache.get("http://example.org:80").maxHeaderSize);
+  }
+
+  ASSERT_EQ(cache.get("http://example.org:80").maxHeaderSize, MultirangeCapabilityCache::kMinHeaderSize);
+}
+
+TEST(MultirangeCapabilities, Expiration) {
+  MultirangeCapabilityCache cache(std::chrono::milliseconds(50));
+
+  cache.recordFailure("http://example.org:80", 10);
+  ASSERT_TRUE(cache.get("http://example.org:80").unsupported);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_FALSE(cache.get("http://example.org:80").unsupported);
+
+  // stale knowledge doesn't leak into new entries
+  cache.recordSuccess("http://example.org:80", 10);
+  cache.recordFailure("http://example.org:80", 100);
+  ASSERT_FALSE(cache.get("http://example.org:80").unsupported);
+  ASSERT_EQ(cache.get("http://example.org:80").maxRanges, 10u);
+}
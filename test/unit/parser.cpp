@@ -120,6 +120,21 @@ TEST(IOVecMultiPartPaser, generateNormalRangeTest){
 
 }
 
+TEST(IOVecMultiPartPaser, generateRangeTestMaxRanges){
+    std::string singular_vector_range(normal_vector_range_cstr);
+    std::istringstream stream(singular_vector_range);
+    size_t n =0;
+    OffsetCallback generator_range( std::bind(&parse_range, std::ref(stream), std::ref(n), std::placeholders::_1, std::placeholders::_2));
+
+    std::vector< std::pair<dav_size_t, std::string> > res = generateRangeHeaders(3900, generator_range, 100);
+
+    ASSERT_EQ(287, n);
+    ASSERT_EQ(3, res.size());
+    ASSERT_EQ(100, res.at(0).first);
+    ASSERT_EQ(100, res.at(1).first);
+    ASSERT_EQ(87, res.at(2).first);
+}
+
 
 
 TEST(IOVecMultiPartParser, headerParser){
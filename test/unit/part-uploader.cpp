@@ -0,0 +1,390 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include <davix.hpp>
+#include <fileops/PartUploader.hpp>
+#include <fileops/UploadManifest.hpp>
+#include <core/ContentProvider.hpp>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+using namespace Davix;
+
+static std::string makeContents(size_t size) {
+  std::string contents(size, '\0');
+  for(size_t i = 0; i < size; i++) {
+    contents[i] = 'a' + (i % 23);
+  }
+  return contents;
+}
+
+TEST(PartUploader, PartsInOrder) {
+  Context context;
+  RequestParams params;
+  params.setUploadPartSize(1000);
+  params.setUploadParallelism(4);
+
+  std::string contents = makeContents(10500);
+  BufferContentProvider provider(contents.c_str(), contents.size());
+
+  std::mutex mtx;
+  std::string uploaded(contents.size(), '\0');
+  std::atomic<int> inflight(0), maxInflight(0);
+
+  PartUploader uploader(context, params, contents.size(), 0);
+  std::vector<UploadedPart> parts = uploader.upload(provider,
+    [&](const char *data, dav_size_t size, size_t partNumber, const std::string &digest) {
+      int now = ++inflight;
+      int prev = maxInflight;
+      while(now > prev && !maxInflight.compare_exchange_weak(prev, now)) {}
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      {
+        std::lock_guard<std::mutex> lock(mtx);
+        uploaded.replace((partNumber - 1) * 1000, size, data, size);
+      }
+
+      inflight--;
+      return std::to_string(partNumber);
+    });
+
+  ASSERT_EQ(parts.size(), 11u);
+  for(size_t i = 0; i < parts.size(); i++) {
+    ASSERT_EQ(parts[i].id, std::to_string(i + 1));
+    ASSERT_EQ(parts[i].size, i == 10 ? 500u : 1000u);
+  }
+
+  ASSERT_EQ(uploaded, contents);
+  ASSERT_LE(maxInflight, 4);
+}
+
+TEST(PartUploader, BufferLimit) {
+  Context context;
+  context.setUploadBufferLimit(2 * 64 * 1024);
+
+  RequestParams params;
+  params.setUploadPartSize(64 * 1024);
+  params.setUploadParallelism(4);
+
+  std::string contents = makeContents(10 * 64 * 1024);
+  BufferContentProvider provider(contents.c_str(), contents.size());
+  std::atomic<int> inflight(0), maxInflight(0);
+
+  PartUploader uploader(context, params, contents.size(), 0);
+  std::vector<UploadedPart> parts = uploader.upload(provider,
+    [&](const char *data, dav_size_t size, size_t partNumber, const std::string &digest) {
+      int now = ++inflight;
+      int prev = maxInflight;
+      while(now > prev && !maxInflight.compare_exchange_weak(prev, now)) {}
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      inflight--;
+      return std::string(data, size);
+    });
+
+  std::string uploaded;
+  for(size_t i = 0; i < parts.size(); i++) {
+    uploaded += parts[i].id;
+  }
+
+  // fewer lanes, same result
+  ASSERT_EQ(uploaded, contents);
+  ASSERT_LE(maxInflight, 2);
+
+  BufferPoolStats stats = context.getUploadBufferStats();
+  ASSERT_LE(stats.highWaterMark, 2 * 64 * 1024u);
+  ASSERT_EQ(stats.allocatedBytes, stats.cachedBytes);
+}
+
+TEST(PartUploader, FromFd) {
+  Context context;
+  RequestParams params;
+  params.setUploadPartSize(10000);
+  params.setUploadParallelism(3);
+
+  std::string contents = makeContents(105000);
+  FILE *file = tmpfile();
+  ASSERT_TRUE(file != NULL);
+  ASSERT_EQ(fwrite(contents.data(), 1, contents.size(), file), contents.size());
+  fflush(file);
+
+  // parts map the file at arbitrary, unaligned offsets
+  FdContentProvider provider(fileno(file), 1234);
+  ASSERT_TRUE(provider.ok());
+
+  PartUploader uploader(context, params, provider.getSize(), 0);
+  std::vector<UploadedPart> parts = uploader.upload(provider,
+    [&](const char *data, dav_size_t size, size_t partNumber, const std::string &digest) {
+      return std::string(data, size);
+    });
+
+  std::string uploaded;
+  for(size_t i = 0; i < parts.size(); i++) {
+    ASSERT_EQ(parts[i].size, parts[i].id.size());
+    uploaded += parts[i].id;
+  }
+
+  ASSERT_EQ(parts.size(), 11u);
+  ASSERT_EQ(uploaded, contents.substr(1234));
+
+  // no copy through the buffer pool
+  ASSERT_EQ(context.getUploadBufferStats().misses, 0u);
+  fclose(file);
+}
+
+TEST(PartUploader, FromTruncatedFd) {
+  Context context;
+  RequestParams params;
+  params.setUploadPartSize(10000);
+  params.setUploadParallelism(1);
+
+  std::string contents = makeContents(105000);
+  FILE *file = tmpfile();
+  ASSERT_TRUE(file != NULL);
+  ASSERT_EQ(fwrite(contents.data(), 1, contents.size(), file), contents.size());
+  fflush(file);
+
+  FdContentProvider provider(fileno(file));
+  ASSERT_TRUE(provider.ok());
+
+  // cut short after the provider took the size: the missing parts are read,
+  // not mapped, and fail cleanly
+  ASSERT_EQ(ftruncate(fileno(file), 45000), 0);
+
+  std::atomic<size_t> calls(0);
+  PartUploader uploader(context, params, provider.getSize(), 0);
+  ASSERT_THROW(uploader.upload(provider,
+    [&](const char *data, dav_size_t size, size_t partNumber, const std::string &digest) {
+      calls++;
+      return std::string(data, size);
+    }), DavixException);
+
+  ASSERT_EQ(calls, 4u);
+  fclose(file);
+}
+
+TEST(PartUploader, MaxParts) {
+  Context context;
+  RequestParams params;
+  params.setUploadPartSize(10);
+
+  // 1000 bytes in at most 10 parts
+  PartUploader uploader(context, params, 1000, 10);
+  ASSERT_GE(uploader.getPartSize(), 100u);
+
+  std::string contents = makeContents(1000);
+  BufferContentProvider provider(contents.c_str(), contents.size());
+
+  std::vector<UploadedPart> parts = uploader.upload(provider,
+    [&](const char *data, dav_size_t size, size_t partNumber, const std::string &digest) {
+      return std::string(data, size);
+    });
+
+  ASSERT_LE(parts.size(), 10u);
+
+  std::string uploaded;
+  for(size_t i = 0; i < parts.size(); i++) {
+    uploaded += parts[i].id;
+  }
+
+  ASSERT_EQ(uploaded, contents);
+}
+
+TEST(PartUploader, MaxPartsOverBufferLimit) {
+  Context context;
+  context.setUploadBufferLimit(4096);
+
+  RequestParams params;
+  params.setUploadPartSize(1024 * 1024);
+
+  // capped to the limit, as that still makes few enough parts
+  PartUploader capped(context, params, 9 * 4096, 10);
+  ASSERT_EQ(capped.getPartSize(), 4096u);
+
+  // 100 parts of 4096 bytes are too many: parts stay over the limit, and
+  // the upload fails before anything is sent
+  PartUploader grown(context, params, 100 * 4096, 10);
+  ASSERT_GT(grown.getPartSize(), 4096u);
+
+  std::string contents = makeContents(100 * 4096);
+  BufferContentProvider provider(contents.c_str(), contents.size());
+  size_t calls = 0;
+
+  ASSERT_THROW(grown.upload(provider,
+    [&](const char *data, dav_size_t size, size_t partNumber, const std::string &digest) {
+      calls++;
+      return std::string();
+    }), DavixException);
+
+  ASSERT_EQ(calls, 0u);
+  ASSERT_EQ(context.getUploadBufferStats().misses, 0u);
+}
+
+TEST(PartUploader, Failure) {
+  Context context;
+  RequestParams params;
+  params.setUploadPartSize(100);
+
+  std::string contents = makeContents(100000);
+  std::atomic<size_t> calls(0);
+
+  auto upload = [&](const char *data, dav_size_t size, size_t partNumber, const std::string &digest) -> std::string {
+    calls++;
+    if(partNumber == 5) {
+      throw DavixException("test", StatusCode::ConnectionProblem, "upload failed");
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    return "ok";
+  };
+
+  // no new parts read once one has failed
+  params.setUploadParallelism(1);
+  BufferContentProvider provider(contents.c_str(), contents.size());
+  PartUploader sequential(context, params, contents.size(), 0);
+  ASSERT_THROW(sequential.upload(provider, upload), DavixException);
+  ASSERT_EQ(calls, 5u);
+
+  // parts in flight are waited for
+  calls = 0;
+  params.setUploadParallelism(3);
+  provider.rewind();
+  PartUploader parallel(context, params, contents.size(), 0);
+  ASSERT_THROW(parallel.upload(provider, upload), DavixException);
+  ASSERT_LT(calls, 100u);
+}
+
+TEST(PartUploader, Resume) {
+  Context context;
+  RequestParams params;
+  params.setUploadPartSize(1000);
+  params.setUploadParallelism(3);
+
+  std::string contents = makeContents(10500);
+  const std::string path = "/tmp/davix-part-uploader-" + std::to_string(getpid());
+  Uri uri("https://example.org/bucket/object");
+
+  auto upload = [&](const char *data, dav_size_t size, size_t partNumber, const std::string &digest) -> std::string {
+    if(partNumber == 7) {
+      throw DavixException("test", StatusCode::ConnectionProblem, "upload failed");
+    }
+    return std::string(data, size);
+  };
+
+  {
+    UploadManifest manifest(path, uri, contents.size());
+    BufferContentProvider provider(contents.c_str(), contents.size());
+    PartUploader uploader(context, params, contents.size(), 0, &manifest);
+    manifest.start("upload-id", uploader.getPartSize());
+    ASSERT_THROW(uploader.upload(provider, upload), DavixException);
+  }
+
+  // the part size of the first attempt is kept, whatever params say
+  params.setUploadPartSize(3000);
+
+  UploadManifest manifest(path, uri, contents.size());
+  ASSERT_TRUE(manifest.resumable());
+  ASSERT_GE(manifest.countParts(), 6u);
+  size_t recorded = manifest.countParts();
+
+  std::atomic<size_t> calls(0);
+  BufferContentProvider provider(contents.c_str(), contents.size());
+  PartUploader uploader(context, params, contents.size(), 0, &manifest);
+  ASSERT_EQ(uploader.getPartSize(), 1000u);
+
+  std::vector<UploadedPart> parts = uploader.upload(provider,
+    [&](const char *data, dav_size_t size, size_t partNumber, const std::string &digest) {
+      calls++;
+      return std::string(data, size);
+    });
+
+  // only the missing parts were sent again
+  ASSERT_EQ(calls, 11u - recorded);
+  ASSERT_EQ(manifest.countParts(), 11u);
+
+  std::string uploaded;
+  for(size_t i = 0; i < parts.size(); i++) {
+    uploaded += parts[i].id;
+  }
+
+  ASSERT_EQ(uploaded, contents);
+  manifest.remove();
+}
+
+TEST(PartUploader, ResumeChangedContents) {
+  Context context;
+  RequestParams params;
+  params.setUploadPartSize(1000);
+  params.setUploadParallelism(1);
+
+  std::string contents = makeContents(10500);
+  const std::string path = "/tmp/davix-part-uploader-" + std::to_string(getpid());
+  Uri uri("https://example.org/bucket/object");
+
+  {
+    UploadManifest manifest(path, uri, contents.size());
+    BufferContentProvider provider(contents.c_str(), contents.size());
+    PartUploader uploader(context, params, contents.size(), 0, &manifest);
+    manifest.start("upload-id", uploader.getPartSize());
+
+    ASSERT_THROW(uploader.upload(provider,
+      [&](const char *data, dav_size_t size, size_t partNumber, const std::string &digest) -> std::string {
+        EXPECT_EQ(digest, UploadManifest::digest(data, size));
+        if(partNumber == 7) {
+          throw DavixException("test", StatusCode::ConnectionProblem, "upload failed");
+        }
+        return std::string(data, size);
+      }), DavixException);
+  }
+
+  // same size, different bytes in parts 2 and 5
+  contents[1500] = 'Z';
+  contents[4999] = 'Z';
+
+  UploadManifest manifest(path, uri, contents.size());
+  ASSERT_TRUE(manifest.resumable());
+  ASSERT_EQ(manifest.countParts(), 6u);
+
+  std::vector<size_t> sent;
+  BufferContentProvider provider(contents.c_str(), contents.size());
+  PartUploader uploader(context, params, contents.size(), 0, &manifest);
+
+  std::vector<UploadedPart> parts = uploader.upload(provider,
+    [&](const char *data, dav_size_t size, size_t partNumber, const std::string &digest) {
+      sent.push_back(partNumber);
+      return std::string(data, size);
+    });
+
+  // the changed parts were sent again, along with the missing ones
+  ASSERT_EQ(sent, std::vector<size_t>({2, 5, 7, 8, 9, 10, 11}));
+
+  std::string uploaded;
+  for(size_t i = 0; i < parts.size(); i++) {
+    uploaded += parts[i].id;
+  }
+
+  ASSERT_EQ(uploaded, contents);
+  manifest.remove();
+}
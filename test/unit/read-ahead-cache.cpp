@@ -0,0 +1,179 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include <davix.hpp>
+#include <fileops/ReadAheadCache.hpp>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+using namespace Davix;
+
+static std::string makeContents(size_t size) {
+  std::string contents(size, '\0');
+  for(size_t i = 0; i < size; i++) {
+    contents[i] = 'a' + (i % 23);
+  }
+  return contents;
+}
+
+// fetch function over an in-memory file
+struct FakeFile {
+  FakeFile(size_t size, int delayMs = 0) : contents(makeContents(size)), delay(delayMs), fetches(0) {}
+
+  ReadAheadCache::FetchFunction fetcher() {
+    return [this](char *buffer, dav_size_t count, dav_off_t offset) -> dav_ssize_t {
+      fetches++;
+      if(delay > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+      }
+
+      if(offset >= (dav_off_t) contents.size()) {
+        return 0;
+      }
+
+      dav_size_t n = std::min<dav_size_t>(count, contents.size() - offset);
+      memcpy(buffer, contents.data() + offset, n);
+      return n;
+    };
+  }
+
+  std::string contents;
+  int delay;
+  std::atomic<size_t> fetches;
+};
+
+TEST(ReadAheadCache, WillNeed) {
+  Context context;
+  FakeFile file(100000);
+  ReadAheadCache cache(context, file.fetcher(), 64 * 1024, 1024);
+
+  cache.willNeed(1000, 5000);
+  ASSERT_GT(cache.getCachedBytes(), 0u);
+
+  std::string buffer(5000, '\0');
+  ASSERT_EQ(cache.read(&buffer[0], 5000, 1000), 5000);
+  ASSERT_EQ(buffer, file.contents.substr(1000, 5000));
+  ASSERT_EQ(file.fetches, 5u);
+
+  // read to their end, the blocks are gone
+  ASSERT_EQ(cache.getCachedBytes(), 0u);
+  ASSERT_EQ(cache.read(&buffer[0], 5000, 1000), 0);
+
+  // a partial hit only covers what was hinted at
+  cache.willNeed(20000, 100);
+  ASSERT_EQ(cache.read(&buffer[0], 1000, 20000), 100);
+  ASSERT_EQ(buffer.substr(0, 100), file.contents.substr(20000, 100));
+
+  ReadAheadStats stats = cache.getStats();
+  ASSERT_EQ(stats.hits, 2u);
+  ASSERT_EQ(stats.misses, 1u);
+}
+
+TEST(ReadAheadCache, EndOfFile) {
+  Context context;
+  FakeFile file(10000);
+  ReadAheadCache cache(context, file.fetcher(), 64 * 1024, 1024);
+
+  cache.willNeed(8000, 4000);
+
+  std::string buffer(4000, '\0');
+  ASSERT_EQ(cache.read(&buffer[0], 4000, 8000), 2000);
+  ASSERT_EQ(buffer.substr(0, 2000), file.contents.substr(8000));
+}
+
+TEST(ReadAheadCache, Limit) {
+  Context context;
+  FakeFile file(1000000, 5);
+  ReadAheadCache cache(context, file.fetcher(), 16 * 1024, 1024);
+
+  // hints beyond the limit are dropped, not queued
+  cache.willNeed(0, 100000);
+  cache.willNeed(200000, 100000);
+  ASSERT_LE(cache.getCachedBytes(), 16 * 1024u);
+
+  std::string buffer(1000, '\0');
+  ASSERT_EQ(cache.read(&buffer[0], 1000, 0), 1000);
+  ASSERT_EQ(buffer, file.contents.substr(0, 1000));
+  ASSERT_EQ(cache.read(&buffer[0], 1000, 200000), 0);
+}
+
+TEST(ReadAheadCache, Sequential) {
+  Context context;
+  FakeFile file(1000000, 2);
+  ReadAheadCache cache(context, file.fetcher(), 256 * 1024, 4096);
+
+  const dav_size_t initialWindow = cache.getWindow();
+  std::string read;
+  std::string buffer(3000, '\0');
+
+  for(dav_off_t pos = 0; pos < (dav_off_t) file.contents.size(); ) {
+    cache.advance(pos, file.contents.size());
+    ASSERT_LE(cache.getCachedBytes(), 256 * 1024u);
+
+    dav_ssize_t ret = cache.read(&buffer[0], buffer.size(), pos);
+    ASSERT_GT(ret, 0);
+    read.append(buffer, 0, ret);
+    pos += ret;
+  }
+
+  ASSERT_EQ(read, file.contents);
+
+  // the reader waited for data, the window grew
+  ASSERT_GT(cache.getWindow(), initialWindow);
+  ASSERT_LE(cache.getWindow(), 256 * 1024u);
+  ASSERT_EQ(cache.getStats().misses, 0u);
+  ASSERT_EQ(cache.getCachedBytes(), 0u);
+}
+
+TEST(ReadAheadCache, Failure) {
+  Context context;
+  FakeFile file(100000);
+  ReadAheadCache::FetchFunction fetch = file.fetcher();
+
+  ReadAheadCache cache(context, [&](char *buffer, dav_size_t count, dav_off_t offset) -> dav_ssize_t {
+    if(offset >= 2048) {
+      throw DavixException("test", StatusCode::ConnectionProblem, "fetch failed");
+    }
+    return fetch(buffer, count, offset);
+  }, 64 * 1024, 1024);
+
+  // failed blocks are left to the reader
+  cache.willNeed(0, 4096);
+  std::string buffer(4096, '\0');
+  ASSERT_EQ(cache.read(&buffer[0], 4096, 0), 2048);
+  ASSERT_EQ(cache.read(&buffer[0], 4096, 2048), 0);
+}
+
+TEST(ReadAheadCache, DestroyInFlight) {
+  Context context;
+  FakeFile file(1000000, 10);
+
+  {
+    ReadAheadCache cache(context, file.fetcher(), 1024 * 1024, 1024);
+    cache.willNeed(0, 1000000);
+  }
+
+  // fetches in flight were waited for, queued ones never started
+  ASSERT_LE(file.fetches, (size_t) DAVIX_READ_AHEAD_MAX_INFLIGHT);
+}
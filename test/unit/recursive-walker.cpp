@@ -0,0 +1,213 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+#include <davix.hpp>
+#include <core/HostLimiter.hpp>
+#include <fileops/RecursiveWalker.hpp>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <thread>
+
+using namespace Davix;
+
+// fake namespace: path of each collection -> names of its entries, the
+// collections ending with '/'
+typedef std::map<std::string, std::vector<std::string>> Tree;
+
+static Tree makeTree(size_t width, size_t depth, const std::string &path = "") {
+  Tree tree;
+  std::vector<std::string> &entries = tree[path];
+
+  for(size_t i = 0; i < width; i++) {
+    entries.push_back("file" + std::to_string(i));
+    if(depth > 0) {
+      std::string name = "dir" + std::to_string(i);
+      entries.push_back(name + "/");
+
+      Tree sub = makeTree(width, depth - 1, path.empty() ? name : path + "/" + name);
+      tree.insert(sub.begin(), sub.end());
+    }
+  }
+
+  return tree;
+}
+
+static void listTree(const Tree &tree, const std::string &path, std::deque<FileProperties> &entries) {
+  Tree::const_iterator it = tree.find(path);
+  if(it == tree.end()) {
+    throw DavixException("test", StatusCode::FileNotFound, "no such collection: " + path);
+  }
+
+  for(size_t i = 0; i < it->second.size(); i++) {
+    FileProperties entry;
+    std::string name = it->second[i];
+    if(name.back() == '/') {
+      name.pop_back();
+      entry.info.mode = S_IFDIR | 0755;
+    }
+    else {
+      entry.info.mode = S_IFREG | 0644;
+    }
+
+    entry.filename = name;
+    entries.push_back(entry);
+  }
+}
+
+// what a sequential, depth-first walk gives
+static void expectedWalk(const Tree &tree, const std::string &path, std::vector<std::string> &out) {
+  const std::vector<std::string> &entries = tree.at(path);
+  for(size_t i = 0; i < entries.size(); i++) {
+    std::string name = entries[i];
+    bool dir = (name.back() == '/');
+    if(dir) {
+      name.pop_back();
+    }
+
+    std::string full = path.empty() ? name : path + "/" + name;
+    out.push_back(full);
+    if(dir) {
+      expectedWalk(tree, full, out);
+    }
+  }
+}
+
+TEST(RecursiveWalker, PreOrder) {
+  Context context;
+  Tree tree = makeTree(4, 3);
+
+  std::atomic<int> inflight(0), maxInflight(0);
+  RecursiveWalker walker(context, [&](const std::string &path, std::deque<FileProperties> &entries) {
+    int now = ++inflight;
+    int prev = maxInflight;
+    while(now > prev && !maxInflight.compare_exchange_weak(prev, now)) {}
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    listTree(tree, path, entries);
+    inflight--;
+  }, 3);
+
+  std::vector<std::string> walked;
+  walker.walk({""}, [&](const std::string &path, const StatInfo &info) {
+    walked.push_back(path);
+  });
+
+  std::vector<std::string> expected;
+  expectedWalk(tree, "", expected);
+
+  ASSERT_EQ(walked, expected);
+  ASSERT_LE(maxInflight, 3);
+}
+
+TEST(RecursiveWalker, SeveralRoots) {
+  Context context;
+  Tree tree = makeTree(3, 2);
+
+  RecursiveWalker walker(context, [&](const std::string &path, std::deque<FileProperties> &entries) {
+    listTree(tree, path, entries);
+  }, 4);
+
+  std::vector<std::string> walked;
+  walker.walk({"dir2", "dir0/dir1"}, [&](const std::string &path, const StatInfo &info) {
+    walked.push_back(path);
+  });
+
+  std::vector<std::string> expected;
+  expectedWalk(tree, "dir2", expected);
+  expectedWalk(tree, "dir0/dir1", expected);
+  ASSERT_EQ(walked, expected);
+}
+
+TEST(RecursiveWalker, Failure) {
+  Context context;
+  Tree tree = makeTree(3, 3);
+  tree.erase("dir1/dir2");
+
+  RecursiveWalker walker(context, [&](const std::string &path, std::deque<FileProperties> &entries) {
+    listTree(tree, path, entries);
+  }, 4);
+
+  // everything before the broken collection is reported
+  std::vector<std::string> walked;
+  ASSERT_THROW(walker.walk({""}, [&](const std::string &path, const StatInfo &info) {
+    walked.push_back(path);
+  }), DavixException);
+
+  ASSERT_FALSE(walked.empty());
+  ASSERT_EQ(walked.back(), "dir1/dir2");
+}
+
+TEST(RecursiveWalker, StopEarly) {
+  Context context;
+  Tree tree = makeTree(5, 4);
+  std::atomic<size_t> listings(0);
+
+  {
+    RecursiveWalker walker(context, [&](const std::string &path, std::deque<FileProperties> &entries) {
+      listings++;
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      listTree(tree, path, entries);
+    }, 4);
+
+    ASSERT_THROW(walker.walk({""}, [&](const std::string &path, const StatInfo &info) {
+      if(path == "dir0/dir0/dir0/file0") {
+        throw DavixException("test", StatusCode::OperationNonSupported, "stop");
+      }
+    }), DavixException);
+  }
+
+  // listings in flight were waited for, and the lookahead kept the rest of
+  // the tree from being listed
+  ASSERT_LE(listings, 4 + RecursiveWalker::kLookaheadFactor * 4);
+}
+
+TEST(HostLimiter, Limit) {
+  HostLimiter limiter;
+
+  HostSlot a = limiter.acquire("https://example.org:443", 2);
+  HostSlot b = limiter.acquire("https://example.org:443", 2);
+  HostSlot other = limiter.acquire("https://example.com:443", 2);
+  ASSERT_EQ(limiter.inUse("https://example.org:443"), 2u);
+  ASSERT_EQ(limiter.inUse("https://example.com:443"), 1u);
+
+  std::atomic<bool> acquired(false);
+  std::thread waiter([&]() {
+    HostSlot c = limiter.acquire("https://example.org:443", 2);
+    acquired = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  ASSERT_FALSE(acquired);
+
+  a.release();
+  waiter.join();
+  ASSERT_TRUE(acquired);
+  ASSERT_EQ(limiter.inUse("https://example.org:443"), 1u);
+
+  // no limit
+  std::vector<HostSlot> slots;
+  for(size_t i = 0; i < 10; i++) {
+    slots.push_back(limiter.acquire("https://example.org:443", 0));
+  }
+  ASSERT_EQ(limiter.inUse("https://example.org:443"), 11u);
+}
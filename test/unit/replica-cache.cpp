@@ -0,0 +1,140 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include <core/ReplicaCache.hpp>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace Davix;
+
+static const std::vector<std::string> kReplicas = { "http://a.example.org/f", "http://b.example.org/f", "http://c.example.org/f" };
+
+TEST(ReplicaCache, Lookup) {
+  ReplicaCache cache;
+  std::vector<std::string> replicas;
+
+  ASSERT_FALSE(cache.get("http://example.org/f", replicas));
+
+  cache.put("http://example.org/f", kReplicas);
+  ASSERT_TRUE(cache.get("http://example.org/f", replicas));
+  ASSERT_EQ(replicas, kReplicas);
+
+  // no Metalink is remembered as well
+  cache.put("http://example.org/g", std::vector<std::string>());
+  ASSERT_TRUE(cache.get("http://example.org/g", replicas));
+  ASSERT_TRUE(replicas.empty());
+
+  cache.invalidate("http://example.org/f");
+  ASSERT_FALSE(cache.get("http://example.org/f", replicas));
+  ASSERT_TRUE(cache.get("http://example.org/g", replicas));
+
+  cache.clear();
+  ASSERT_FALSE(cache.get("http://example.org/g", replicas));
+}
+
+TEST(ReplicaCache, Expiration) {
+  ReplicaCache cache(10, std::chrono::milliseconds(50));
+  std::vector<std::string> replicas;
+
+  cache.put("http://example.org/f", kReplicas);
+  ASSERT_TRUE(cache.get("http://example.org/f", replicas));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  ASSERT_FALSE(cache.get("http://example.org/f", replicas));
+
+  // disabled
+  cache.setTtl(std::chrono::milliseconds(0));
+  cache.put("http://example.org/f", kReplicas);
+  ASSERT_FALSE(cache.get("http://example.org/f", replicas));
+}
+
+TEST(ReplicaCache, Size) {
+  ReplicaCache cache(10, std::chrono::milliseconds(50));
+  dav_size_t size = 0;
+
+  // only kept along with the replicas
+  cache.putSize("http://example.org/f", 1234);
+  ASSERT_FALSE(cache.getSize("http://example.org/f", size));
+
+  cache.put("http://example.org/f", kReplicas);
+  ASSERT_FALSE(cache.getSize("http://example.org/f", size));
+  cache.putSize("http://example.org/f", 1234);
+  ASSERT_TRUE(cache.getSize("http://example.org/f", size));
+  ASSERT_EQ(size, 1234u);
+
+  // replicas stored again may describe another file
+  cache.put("http://example.org/f", kReplicas);
+  ASSERT_FALSE(cache.getSize("http://example.org/f", size));
+
+  cache.putSize("http://example.org/f", 1234);
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  ASSERT_FALSE(cache.getSize("http://example.org/f", size));
+}
+
+TEST(ReplicaCache, MaxEntries) {
+  ReplicaCache cache(3);
+  std::vector<std::string> replicas;
+
+  cache.put("http://example.org/1", kReplicas);
+  cache.put("http://example.org/2", kReplicas);
+  cache.put("http://example.org/3", kReplicas);
+
+  // least recently used goes first
+  ASSERT_TRUE(cache.get("http://example.org/1", replicas));
+  cache.put("http://example.org/4", kReplicas);
+
+  ASSERT_TRUE(cache.get("http://example.org/1", replicas));
+  ASSERT_FALSE(cache.get("http://example.org/2", replicas));
+  ASSERT_TRUE(cache.get("http://example.org/3", replicas));
+  ASSERT_TRUE(cache.get("http://example.org/4", replicas));
+
+  cache.setMaxEntries(1);
+  ASSERT_FALSE(cache.get("http://example.org/1", replicas));
+  ASSERT_TRUE(cache.get("http://example.org/4", replicas));
+}
+
+TEST(ReplicaCache, Cooldown) {
+  ReplicaCache cache(10, std::chrono::seconds(60), std::chrono::milliseconds(50));
+  auto url = [](const std::string &s) { return s; };
+
+  cache.markFailed(kReplicas[1]);
+  ASSERT_TRUE(cache.isHealthy(kReplicas[0]));
+  ASSERT_FALSE(cache.isHealthy(kReplicas[1]));
+
+  std::vector<std::string> replicas = kReplicas;
+  cache.filterHealthy(replicas, url);
+  ASSERT_EQ(replicas, std::vector<std::string>({ kReplicas[0], kReplicas[2] }));
+
+  // all dead: try them all anyway
+  cache.markFailed(kReplicas[0]);
+  cache.markFailed(kReplicas[2]);
+  replicas = kReplicas;
+  cache.filterHealthy(replicas, url);
+  ASSERT_EQ(replicas, kReplicas);
+
+  // back once it works, or after the cooldown
+  cache.markSucceeded(kReplicas[0]);
+  ASSERT_TRUE(cache.isHealthy(kReplicas[0]));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  ASSERT_TRUE(cache.isHealthy(kReplicas[1]));
+  ASSERT_TRUE(cache.isHealthy(kReplicas[2]));
+}
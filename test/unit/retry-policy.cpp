@@ -0,0 +1,193 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include <davix.hpp>
+#include <core/RetryPolicy.hpp>
+#include <gtest/gtest.h>
+#include <set>
+#include <thread>
+
+using namespace Davix;
+
+static const std::string kEndpoint = "https://example.org:443";
+
+TEST(RetryPolicy, Backoff) {
+  const std::chrono::milliseconds base(100), max(1000);
+
+  for(int i = 0; i < 100; i++) {
+    ASSERT_LE(backoffDelay(1, base, max).count(), 100);
+    ASSERT_LE(backoffDelay(3, base, max).count(), 400);
+    ASSERT_LE(backoffDelay(100, base, max).count(), 1000);
+    ASSERT_GE(backoffDelay(100, base, max).count(), 0);
+  }
+
+  // randomized
+  std::set<int64_t> delays;
+  for(int i = 0; i < 100; i++) {
+    delays.insert(backoffDelay(4, base, max).count());
+  }
+  ASSERT_GT(delays.size(), 10u);
+
+  ASSERT_EQ(backoffDelay(5, std::chrono::milliseconds(0), max).count(), 0);
+
+  // the legacy delay, in seconds, is the base
+  RequestParams params;
+  params.setRetryBackoffMax(60000);
+  ASSERT_EQ(backoffBase(params).count(), DAVIX_DEFAULT_RETRY_BACKOFF_BASE);
+  params.setOperationRetryDelay(2);
+  ASSERT_EQ(backoffBase(params).count(), 2000);
+  ASSERT_LE(backoffDelay(2, params).count(), 4000);
+}
+
+TEST(RetryPolicy, Budget) {
+  RetryBudget budget(3, 20, 0, std::chrono::milliseconds(0));
+
+  ASSERT_TRUE(budget.tryRetry(kEndpoint));
+  ASSERT_TRUE(budget.tryRetry(kEndpoint));
+  ASSERT_TRUE(budget.tryRetry(kEndpoint));
+  ASSERT_FALSE(budget.tryRetry(kEndpoint));
+
+  // per endpoint
+  ASSERT_TRUE(budget.tryRetry("https://other.example.org:443"));
+
+  // 20 tokens per second
+  std::this_thread::sleep_for(std::chrono::milliseconds(120));
+  ASSERT_TRUE(budget.tryRetry(kEndpoint));
+
+  RetryStats stats = budget.getStats();
+  ASSERT_EQ(stats.retries, 5u);
+  ASSERT_EQ(stats.budgetExhausted, 1u);
+
+  // disabled
+  budget.setBudget(0, 0);
+  for(int i = 0; i < 100; i++) {
+    ASSERT_TRUE(budget.tryRetry(kEndpoint));
+  }
+}
+
+TEST(RetryPolicy, CircuitBreaker) {
+  RetryBudget budget(0, 0, 3, std::chrono::milliseconds(50));
+
+  // successes in between keep it closed
+  budget.recordFailure(kEndpoint);
+  budget.recordFailure(kEndpoint);
+  budget.recordSuccess(kEndpoint);
+  budget.recordFailure(kEndpoint);
+  budget.recordFailure(kEndpoint);
+  ASSERT_TRUE(budget.allowRequest(kEndpoint));
+
+  budget.recordFailure(kEndpoint);
+  ASSERT_FALSE(budget.allowRequest(kEndpoint));
+  ASSERT_THROW(budget.checkCircuit(kEndpoint), DavixException);
+  ASSERT_TRUE(budget.allowRequest("https://other.example.org:443"));
+
+  // a single probe after the cooldown, a failed one opens it again
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  ASSERT_TRUE(budget.allowRequest(kEndpoint));
+  ASSERT_FALSE(budget.allowRequest(kEndpoint));
+  budget.recordFailure(kEndpoint);
+  ASSERT_FALSE(budget.allowRequest(kEndpoint));
+
+  // a successful one closes it
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  ASSERT_TRUE(budget.allowRequest(kEndpoint));
+  budget.recordSuccess(kEndpoint);
+  ASSERT_TRUE(budget.allowRequest(kEndpoint));
+  ASSERT_TRUE(budget.allowRequest(kEndpoint));
+
+  RetryStats stats = budget.getStats();
+  ASSERT_EQ(stats.circuitOpenings, 2u);
+  ASSERT_EQ(stats.fastFailures, 4u);
+
+  ASSERT_TRUE(RetryBudget::isEndpointFailure(StatusCode::ConnectionProblem, 0));
+  ASSERT_FALSE(RetryBudget::isEndpointFailure(StatusCode::FileNotFound, 0));
+}
+
+// the error an HTTP answer of status "code" turns into
+static DavixException answered(int code) {
+  try {
+    httpcodeToDavixException(code, davix_scope_io_buff(), "https://example.org/file");
+  }
+  catch(DavixException &e) {
+    return e;
+  }
+  return DavixException(davix_scope_io_buff(), StatusCode::OK, "");
+}
+
+TEST(RetryPolicy, ClientErrorsKeepCircuitClosed) {
+  RetryBudget budget;
+  budget.setCircuitBreaker(2, std::chrono::milliseconds(1000));
+
+  // several 4xx map to ConnectionProblem, none tells the server is down
+  for(int code = 400; code < 500; code++) {
+    DavixException e = answered(code);
+    ASSERT_FALSE(RetryBudget::isEndpointFailure(e.code(), e.httpStatus())) << code;
+
+    // as the retry loop records them
+    for(int i = 0; i < 3; i++) {
+      if(RetryBudget::isEndpointFailure(e.code(), e.httpStatus())) {
+        budget.recordFailure(kEndpoint);
+      }
+      else {
+        budget.recordSuccess(kEndpoint);
+      }
+    }
+    ASSERT_TRUE(budget.allowRequest(kEndpoint)) << code;
+  }
+
+  ASSERT_FALSE(RetryBudget::isEndpointFailure(answered(501).code(), answered(501).httpStatus()));
+  ASSERT_EQ(budget.getStats().circuitOpenings, 0u);
+
+  // the status survives the answer being reported as a DavixError
+  DavixError *err = NULL;
+  httpcodeToDavixError(503, davix_scope_io_buff(), "https://example.org/file", &err);
+  try {
+    checkDavixError(&err);
+    FAIL();
+  }
+  catch(DavixException &e) {
+    ASSERT_EQ(e.httpStatus(), 503);
+  }
+
+  // server errors and transport failures do
+  ASSERT_TRUE(RetryBudget::isEndpointFailure(answered(500).code(), answered(500).httpStatus()));
+  ASSERT_TRUE(RetryBudget::isEndpointFailure(answered(503).code(), answered(503).httpStatus()));
+  ASSERT_TRUE(RetryBudget::isEndpointFailure(answered(504).code(), answered(504).httpStatus()));
+  ASSERT_TRUE(RetryBudget::isEndpointFailure(StatusCode::ConnectionTimeout, 0));
+
+  budget.recordFailure(kEndpoint);
+  budget.recordFailure(kEndpoint);
+  ASSERT_FALSE(budget.allowRequest(kEndpoint));
+}
+
+TEST(RetryPolicy, Context) {
+  Context context;
+  context.setRetryBudget(10, 2);
+  context.setCircuitBreaker(5, 1000);
+
+  // copies keep the settings
+  Context copy(context);
+  ASSERT_EQ(copy.getRetryBudgetBurst(), 10);
+  ASSERT_EQ(copy.getRetryBudgetRate(), 2);
+  ASSERT_EQ(copy.getCircuitBreakerThreshold(), 5u);
+  ASSERT_EQ(copy.getCircuitBreakerCooldown(), 1000u);
+  ASSERT_EQ(copy.getRetryStats().retries, 0u);
+}
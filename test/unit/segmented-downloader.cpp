@@ -0,0 +1,384 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include <davix.hpp>
+#include <fileops/SegmentedDownloader.hpp>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unistd.h>
+
+using namespace Davix;
+
+static std::string makeContents(size_t size) {
+  std::string contents(size, '\0');
+  for(size_t i = 0; i < size; i++) {
+    contents[i] = 'a' + (i % 23);
+  }
+  return contents;
+}
+
+static std::string readBack(FILE *file) {
+  fflush(file);
+  std::string contents;
+  char buffer[4096];
+  ssize_t n;
+  off_t offset = 0;
+  while((n = pread(fileno(file), buffer, sizeof(buffer), offset)) > 0) {
+    contents.append(buffer, n);
+    offset += n;
+  }
+  return contents;
+}
+
+TEST(SegmentedDownloader, Parallel) {
+  Context context;
+  RequestParams params;
+  params.setDownloadSegmentSize(1000);
+  params.setDownloadParallelism(4);
+
+  std::string contents = makeContents(10500);
+  FILE *file = tmpfile();
+  ASSERT_TRUE(file != NULL);
+
+  std::atomic<int> inflight(0), maxInflight(0);
+  std::mutex mtx;
+  std::set<dav_off_t> offsets;
+
+  SegmentedDownloader downloader(context, params);
+  dav_size_t ret = downloader.download(fileno(file), 0, contents.size(),
+    [&](size_t source, dav_off_t offset, dav_size_t size, const SegmentedDownloader::WriteFunction &write,
+      const std::atomic<bool> &cancelled) {
+      int now = ++inflight;
+      int prev = maxInflight;
+      while(now > prev && !maxInflight.compare_exchange_weak(prev, now)) {}
+
+      {
+        std::lock_guard<std::mutex> lock(mtx);
+        offsets.insert(offset);
+      }
+
+      // in pieces, as from the network
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      write(contents.data() + offset, size / 2);
+      write(contents.data() + offset + size / 2, size - size / 2);
+
+      inflight--;
+    });
+
+  ASSERT_EQ(ret, contents.size());
+  ASSERT_EQ(offsets.size(), 11u);
+  ASSERT_LE(maxInflight, 4);
+  ASSERT_EQ(readBack(file), contents);
+  fclose(file);
+}
+
+TEST(SegmentedDownloader, Base) {
+  Context context;
+  RequestParams params;
+  params.setDownloadSegmentSize(100);
+  params.setDownloadParallelism(3);
+
+  std::string contents = makeContents(1050);
+  FILE *file = tmpfile();
+  ASSERT_TRUE(file != NULL);
+  ASSERT_EQ(fwrite("header", 1, 6, file), 6u);
+  fflush(file);
+
+  SegmentedDownloader downloader(context, params);
+  downloader.download(fileno(file), 6, contents.size(),
+    [&](size_t source, dav_off_t offset, dav_size_t size, const SegmentedDownloader::WriteFunction &write,
+      const std::atomic<bool> &cancelled) {
+      write(contents.data() + offset, size);
+    });
+
+  ASSERT_EQ(readBack(file), "header" + contents);
+  fclose(file);
+}
+
+TEST(SegmentedDownloader, Resume) {
+  Context context;
+  RequestParams params;
+  params.setDownloadSegmentSize(1000);
+  params.setDownloadParallelism(3);
+  params.setOperationRetry(2);
+
+  std::string contents = makeContents(5000);
+  FILE *file = tmpfile();
+  ASSERT_TRUE(file != NULL);
+
+  std::mutex mtx;
+  std::vector<std::pair<dav_off_t, dav_size_t>> requests;
+
+  // the segment at 2000 breaks twice, a bit further each time
+  SegmentedDownloader downloader(context, params);
+  std::atomic<int> failures(0);
+  downloader.download(fileno(file), 0, contents.size(),
+    [&](size_t source, dav_off_t offset, dav_size_t size, const SegmentedDownloader::WriteFunction &write,
+      const std::atomic<bool> &cancelled) {
+      {
+        std::lock_guard<std::mutex> lock(mtx);
+        requests.emplace_back(offset, size);
+      }
+
+      if(offset >= 2000 && offset < 3000 && failures < 2) {
+        failures++;
+        write(contents.data() + offset, 300);
+        throw DavixException("test", StatusCode::ConnectionProblem, "connection reset");
+      }
+
+      // or just ends early, without an error
+      if(offset == 0 && size == 1000) {
+        write(contents.data(), 10);
+        return;
+      }
+
+      write(contents.data() + offset, size);
+    });
+
+  ASSERT_EQ(readBack(file), contents);
+
+  // only the missing bytes were asked for again
+  std::set<std::pair<dav_off_t, dav_size_t>> seen(requests.begin(), requests.end());
+  ASSERT_EQ(seen.count(std::make_pair(dav_off_t(2300), dav_size_t(700))), 1u);
+  ASSERT_EQ(seen.count(std::make_pair(dav_off_t(2600), dav_size_t(400))), 1u);
+  ASSERT_EQ(seen.count(std::make_pair(dav_off_t(10), dav_size_t(990))), 1u);
+  ASSERT_EQ(requests.size(), 8u);
+  fclose(file);
+}
+
+TEST(SegmentedDownloader, Failure) {
+  Context context;
+  RequestParams params;
+  params.setDownloadSegmentSize(100);
+  params.setDownloadParallelism(2);
+  params.setOperationRetry(1);
+
+  std::string contents = makeContents(10000);
+  FILE *file = tmpfile();
+  ASSERT_TRUE(file != NULL);
+
+  std::atomic<size_t> calls(0);
+  SegmentedDownloader downloader(context, params);
+
+  // retries run out
+  ASSERT_THROW(downloader.download(fileno(file), 0, contents.size(),
+    [&](size_t source, dav_off_t offset, dav_size_t size, const SegmentedDownloader::WriteFunction &write,
+      const std::atomic<bool> &cancelled) {
+      calls++;
+      if(offset == 500) {
+        throw DavixException("test", StatusCode::ConnectionProblem, "connection reset");
+      }
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      write(contents.data() + offset, size);
+    }), DavixException);
+
+  ASSERT_LT(calls, 100u);
+
+  // no ranges at all is not retried
+  calls = 0;
+  ASSERT_THROW(downloader.download(fileno(file), 0, contents.size(),
+    [&](size_t source, dav_off_t offset, dav_size_t size, const SegmentedDownloader::WriteFunction &write,
+      const std::atomic<bool> &cancelled) {
+      calls++;
+      throw DavixException("test", StatusCode::OperationNonSupported, "no ranges");
+    }), DavixException);
+
+  ASSERT_LE(calls, 2u);
+  fclose(file);
+}
+
+TEST(SegmentedDownloader, Truncate) {
+  Context context;
+  RequestParams params;
+  params.setDownloadSegmentSize(100);
+  params.setDownloadParallelism(2);
+
+  std::string contents = makeContents(1000);
+  std::string received(contents.size(), '\0');
+
+  // more data than asked for is cut short
+  SegmentedDownloader downloader(context, params);
+  dav_size_t ret = downloader.download(0, contents.size(),
+    [&](const char *data, dav_size_t size, dav_off_t offset) {
+      received.replace(offset, size, data, size);
+    },
+    [&](size_t source, dav_off_t offset, dav_size_t size, const SegmentedDownloader::WriteFunction &write,
+      const std::atomic<bool> &cancelled) {
+      ASSERT_FALSE(write(contents.data() + offset, size + 1));
+    });
+
+  ASSERT_EQ(ret, contents.size());
+  ASSERT_EQ(received, contents);
+}
+
+TEST(SegmentedDownloader, Striping) {
+  Context context;
+  RequestParams params;
+  params.setDownloadSegmentSize(20000);
+  params.setDownloadParallelism(2);
+
+  std::string contents = makeContents(100000);
+  std::string received(contents.size(), '\0');
+
+  // source 1 is ten times slower than source 0
+  SegmentedDownloader downloader(context, params, 2);
+  dav_size_t ret = downloader.download(0, contents.size(),
+    [&](const char *data, dav_size_t size, dav_off_t offset) {
+      received.replace(offset, size, data, size);
+    },
+    [&](size_t source, dav_off_t offset, dav_size_t size, const SegmentedDownloader::WriteFunction &write,
+      const std::atomic<bool> &cancelled) {
+      for(dav_size_t done = 0; done < size; done += 1000) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(source == 0 ? 1 : 10));
+        if(!write(contents.data() + offset + done, std::min<dav_size_t>(1000, size - done))) {
+          return;
+        }
+      }
+    });
+
+  ASSERT_EQ(ret, contents.size());
+  ASSERT_EQ(received, contents);
+
+  const std::vector<SourceStats> &stats = downloader.getSourceStats();
+  ASSERT_EQ(stats.size(), 2u);
+  ASSERT_EQ(stats[0].bytes + stats[1].bytes, contents.size());
+  ASSERT_GT(stats[0].bytes, 2 * stats[1].bytes);
+  ASSERT_GT(stats[0].throughput(), stats[1].throughput());
+
+  // the tail of the slow source's last range went to the fast one
+  ASSERT_GE(stats[1].stolen, 1u);
+}
+
+TEST(SegmentedDownloader, DeadSource) {
+  Context context;
+  RequestParams params;
+  params.setDownloadSegmentSize(1000);
+  params.setDownloadParallelism(3);
+  params.setOperationRetry(2);
+
+  std::string contents = makeContents(20000);
+  FILE *file = tmpfile();
+  ASSERT_TRUE(file != NULL);
+
+  std::atomic<size_t> deadCalls(0);
+
+  // source 1 is down, the others are enough
+  SegmentedDownloader downloader(context, params, 3);
+  dav_size_t ret = downloader.download(fileno(file), 0, contents.size(),
+    [&](size_t source, dav_off_t offset, dav_size_t size, const SegmentedDownloader::WriteFunction &write,
+      const std::atomic<bool> &cancelled) {
+      if(source == 1) {
+        deadCalls++;
+        throw DavixException("test", StatusCode::ConnectionProblem, "connection refused");
+      }
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      write(contents.data() + offset, size);
+    });
+
+  ASSERT_EQ(ret, contents.size());
+  ASSERT_EQ(readBack(file), contents);
+
+  const std::vector<SourceStats> &stats = downloader.getSourceStats();
+  ASSERT_FALSE(stats[1].healthy);
+  ASSERT_EQ(stats[1].bytes, 0u);
+  ASSERT_LE(deadCalls, 2u);
+  ASSERT_TRUE(stats[0].healthy && stats[2].healthy);
+
+  // once every source is down, the download fails
+  ASSERT_THROW(downloader.download(fileno(file), 0, contents.size(),
+    [&](size_t source, dav_off_t offset, dav_size_t size, const SegmentedDownloader::WriteFunction &write,
+      const std::atomic<bool> &cancelled) {
+      throw DavixException("test", StatusCode::ConnectionProblem, "connection refused");
+    }), DavixException);
+  fclose(file);
+}
+
+TEST(SegmentedDownloader, StalledSource) {
+  Context context;
+  RequestParams params;
+  params.setDownloadSegmentSize(20000);
+  params.setDownloadParallelism(2);
+
+  std::string contents = makeContents(100000);
+  std::string received(contents.size(), '\0');
+
+  std::atomic<bool> release(false), stalledDone(false), sawCancelled(false), lateWrite(true);
+
+  // source 1 answers, then never sends anything - and doesn't notice it's
+  // not needed anymore until released, like a read blocked on a socket
+  SegmentedDownloader downloader(context, params, 2);
+  auto start = std::chrono::steady_clock::now();
+  dav_size_t ret = downloader.download(0, contents.size(),
+    [&](const char *data, dav_size_t size, dav_off_t offset) {
+      received.replace(offset, size, data, size);
+    },
+    [&](size_t source, dav_off_t offset, dav_size_t size, const SegmentedDownloader::WriteFunction &write,
+      const std::atomic<bool> &cancelled) {
+      if(source == 1) {
+        for(int i = 0; i < 10000 && !release; i++) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        sawCancelled = cancelled.load();
+        lateWrite = write(contents.data() + offset, size);
+        stalledDone = true;
+        return;
+      }
+
+      for(dav_size_t done = 0; done < size; done += 1000) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if(!write(contents.data() + offset + done, std::min<dav_size_t>(1000, size - done))) {
+          return;
+        }
+      }
+    });
+
+  // done once the stall was noticed and the range taken over, not once the
+  // stalled fetch gave up
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  ASSERT_LT(elapsed, 5.0);
+  ASSERT_FALSE(stalledDone);
+
+  ASSERT_EQ(ret, contents.size());
+  ASSERT_EQ(received, contents);
+
+  const std::vector<SourceStats> &stats = downloader.getSourceStats();
+  ASSERT_EQ(stats[0].bytes, contents.size());
+  ASSERT_EQ(stats[1].bytes, 0u);
+  ASSERT_EQ(stats[1].stolen, 1u);
+
+  // the stalled fetch was told to give up, and its data isn't taken anymore
+  release = true;
+  while(!stalledDone) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  ASSERT_TRUE(sawCancelled);
+  ASSERT_FALSE(lateWrite);
+}
@@ -7,7 +7,12 @@
 #include <utils/davix_swift_utils.hpp>
 #include <gtest/gtest.h>
 #include <core/SessionPool.hpp>
+#include <core/WorkerPool.hpp>
 #include <curl/HeaderlineParser.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 using namespace std;
 using namespace Davix;
@@ -228,6 +233,10 @@ TEST(SessionPool, BasicSanity) {
     pool.insert("test-2", 3);
     pool.insert("test-2", 5);
 
+    // most recently inserted first
+    ASSERT_TRUE(pool.retrieve("test-2", out));
+    ASSERT_EQ(out, 5);
+
     ASSERT_TRUE(pool.retrieve("test-2", out));
     ASSERT_EQ(out, 3);
 
@@ -236,9 +245,259 @@ TEST(SessionPool, BasicSanity) {
 
     ASSERT_TRUE(pool.retrieve("test-2", out));
     ASSERT_EQ(out, 3);
+}
 
-    ASSERT_TRUE(pool.retrieve("test-2", out));
-    ASSERT_EQ(out, 5);
+TEST(SessionPool, Concurrent) {
+    SessionPool<int> pool;
+    std::vector<std::thread> threads;
+
+    std::atomic<size_t> misses(0);
+
+    // each thread juggles its own endpoint, plus a shared one - a retrieve
+    // racing with other lanes of the shared one may come back empty, but
+    // must never lose an item
+    for(int t = 0; t < 8; t++) {
+        threads.emplace_back([&pool, &misses, t]() {
+            std::string own = "http://host-" + std::to_string(t) + ":80";
+            for(int i = 0; i < 1000; i++) {
+                int out;
+                pool.insert(own, i);
+                pool.insert("http://shared:80", i);
+                ASSERT_TRUE(pool.retrieve(own, out));
+                ASSERT_EQ(out, i);
+                if(!pool.retrieve("http://shared:80", out)) {
+                    misses++;
+                }
+            }
+        });
+    }
+
+    for(size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+
+    ASSERT_EQ(pool.size(), misses.load());
+}
+
+TEST(SessionPool, SingleHost) {
+    SessionPool<int> pool;
+    std::vector<std::thread> threads;
+    std::vector<std::atomic<int>> handedOut(8 * 1000);
+    std::atomic<size_t> retrieved(0);
+
+    for(size_t i = 0; i < handedOut.size(); i++) {
+        handedOut[i] = 0;
+    }
+
+    // all threads on one endpoint - every item is handed out at most once
+    for(int t = 0; t < 8; t++) {
+        threads.emplace_back([&, t]() {
+            for(int i = 0; i < 1000; i++) {
+                int out;
+                pool.insert("http://shared:80", t * 1000 + i);
+                if(pool.retrieve("http://shared:80", out)) {
+                    handedOut[out]++;
+                    retrieved++;
+                }
+            }
+        });
+    }
+
+    for(size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+
+    int out;
+    while(pool.retrieve("http://shared:80", out)) {
+        handedOut[out]++;
+        retrieved++;
+    }
+
+    ASSERT_EQ(retrieved.load(), handedOut.size());
+    for(size_t i = 0; i < handedOut.size(); i++) {
+        ASSERT_EQ(handedOut[i].load(), 1);
+    }
+    ASSERT_EQ(pool.size(), 0u);
+}
+
+TEST(SessionPool, OtherLanes) {
+    SessionPool<int> pool;
+    int out;
+
+    // items inserted by other threads, in other lanes, are still found
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 8; t++) {
+        threads.emplace_back([&pool, t]() {
+            pool.insert("test", t);
+        });
+    }
+
+    for(size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+
+    ASSERT_EQ(pool.size(), 8u);
+    for(int t = 0; t < 8; t++) {
+        ASSERT_TRUE(pool.retrieve("test", out));
+    }
+    ASSERT_FALSE(pool.retrieve("test", out));
+}
+
+TEST(SessionPool, MaxIdleAcrossLanes) {
+    SessionPool<int> pool;
+    int out;
+
+    // the limit is per key, whichever lanes the items are in
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 8; t++) {
+        threads.emplace_back([&pool, t]() {
+            for(int i = 0; i < 4; i++) {
+                pool.insert("test", t * 4 + i, std::chrono::milliseconds(0), 6);
+            }
+        });
+    }
+
+    for(size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+
+    ASSERT_EQ(pool.size(), 6u);
+
+    // items handed out or expired don't count anymore
+    for(int i = 0; i < 6; i++) {
+        ASSERT_TRUE(pool.retrieve("test", out));
+    }
+    ASSERT_FALSE(pool.retrieve("test", out));
+
+    pool.insert("test", 1, std::chrono::milliseconds(1), 6);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    ASSERT_EQ(pool.reap(), 1u);
+
+    for(int i = 0; i < 6; i++) {
+        pool.insert("test", i, std::chrono::milliseconds(0), 6);
+    }
+    ASSERT_EQ(pool.size(), 6u);
+}
+
+TEST(SessionPool, IdlePolicies) {
+    SessionPool<int> pool;
+    int out;
+
+    // least recently inserted are dropped beyond the per-key limit
+    for(int i = 0; i < 5; i++) {
+        pool.insert("test", i, std::chrono::milliseconds(0), 3);
+    }
+
+    ASSERT_EQ(pool.size(), 3u);
+    ASSERT_TRUE(pool.retrieve("test", out));
+    ASSERT_EQ(out, 4);
+    pool.clear();
+
+    // expired items are never handed out
+    pool.insert("test", 1, std::chrono::milliseconds(1));
+    pool.insert("test", 2, std::chrono::milliseconds(1));
+    pool.insert("other", 3, std::chrono::milliseconds(1));
+    pool.insert("other", 4);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    ASSERT_FALSE(pool.retrieve("test", out));
+    ASSERT_EQ(pool.size(), 2u);
+
+    ASSERT_EQ(pool.reap(), 1u);
+    ASSERT_TRUE(pool.retrieve("other", out));
+    ASSERT_EQ(out, 4);
+}
+
+TEST(SessionPool, Reaper) {
+    SessionPool<int> pool;
+    pool.setReapInterval(std::chrono::milliseconds(1));
+    pool.insert("test", 1, std::chrono::milliseconds(1));
+
+    for(size_t i = 0; i < 1000 && pool.size() != 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    ASSERT_EQ(pool.size(), 0u);
+}
+
+TEST(WorkerPool, ForEach) {
+    WorkerPool pool;
+    ASSERT_EQ(pool.getWorkerCount(), 0u);
+
+    std::vector<std::atomic<int>> hits(100);
+    pool.forEach(hits.size(), 4, [&](size_t i) { hits[i]++; });
+
+    for(size_t i = 0; i < hits.size(); i++) {
+        ASSERT_EQ(hits[i], 1);
+    }
+
+    // the calling thread does its share of the work
+    ASSERT_EQ(pool.getWorkerCount(), 3u);
+
+    pool.forEach(hits.size(), 2, [&](size_t i) { hits[i]++; });
+    ASSERT_EQ(pool.getWorkerCount(), 3u);
+
+    pool.forEach(0, 4, [&](size_t i) { hits[i]++; });
+    for(size_t i = 0; i < hits.size(); i++) {
+        ASSERT_EQ(hits[i], 2);
+    }
+}
+
+TEST(WorkerPool, ForEachException) {
+    WorkerPool pool;
+    std::atomic<size_t> processed(0);
+
+    ASSERT_THROW(pool.forEach(1000, 4, [&](size_t i) {
+        if(i == 10) {
+            throw DavixException("test", StatusCode::ConnectionProblem, "failure");
+        }
+        processed++;
+    }), DavixException);
+
+    // no new items are handed out once one of them failed
+    ASSERT_LT(processed, 999u);
+}
+
+TEST(WorkerPool, NestedForEach) {
+    WorkerPool pool(2);
+    std::atomic<size_t> total(0);
+
+    pool.forEach(8, 8, [&](size_t) {
+        pool.forEach(8, 8, [&](size_t) { total++; });
+    });
+
+    ASSERT_EQ(pool.getWorkerCount(), 2u);
+    ASSERT_EQ(total, 64u);
+}
+
+TEST(WorkerPool, SubmitConcurrently) {
+    WorkerPool pool(8);
+    std::mutex mtx;
+    std::condition_variable cv;
+    size_t started = 0;
+    size_t rendezvous = 0;
+
+    // every task waits for all others to start: only works if none of them
+    // is stuck in the queue behind another
+    for(size_t i = 0; i < 8; i++) {
+        pool.submit([&]() {
+            std::unique_lock<std::mutex> lock(mtx);
+            started++;
+            cv.notify_all();
+            if(cv.wait_for(lock, std::chrono::seconds(10), [&]() { return started == 8; })) {
+                rendezvous++;
+                cv.notify_all();
+            }
+        });
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait_for(lock, std::chrono::seconds(10), [&]() { return rendezvous == 8; });
+        ASSERT_EQ(rendezvous, 8u);
+    }
+
+    ASSERT_EQ(pool.getWorkerCount(), 8u);
 }
 
 TEST(HeaderlineParser, BasicSanity) {
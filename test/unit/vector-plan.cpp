@@ -0,0 +1,75 @@
+/*
+ * This File is part of Davix, The IO library for HTTP based protocols
+ * Copyright (C) CERN 2026
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+*/
+
+
+#include <fileops/httpiovec.hpp>
+#include <gtest/gtest.h>
+
+using namespace Davix;
+
+// copies, the constants themselves have no out-of-class definition
+static const dav_size_t kDefaultWindow = HttpIOVecOps::kDefaultMergeWindow;
+static const dav_size_t kMaxWindow = HttpIOVecOps::kMaxMergeWindow;
+static const uint kDefaultConnections = HttpIOVecOps::kDefaultConnections;
+static const uint kMaxConnections = HttpIOVecOps::kMaxConnections;
+
+static EndpointEstimate makeEstimate(double rtt, double throughput) {
+  EndpointEstimate estimate;
+  estimate.rtt = rtt;
+  estimate.throughput = throughput;
+  estimate.latencySamples = 1;
+  estimate.throughputSamples = 1;
+  return estimate;
+}
+
+TEST(VectorPlan, MergeWindow) {
+  // nothing known about the endpoint
+  ASSERT_EQ(HttpIOVecOps::planMergeWindow(EndpointEstimate()), kDefaultWindow);
+
+  // 1 KB in flight per round trip: never below the default
+  ASSERT_EQ(HttpIOVecOps::planMergeWindow(makeEstimate(0.001, 1000000)), kDefaultWindow);
+
+  // 50 ms at 10 MB/s
+  ASSERT_EQ(HttpIOVecOps::planMergeWindow(makeEstimate(0.05, 10000000)), 500000u);
+
+  // 1 s at 1 GB/s
+  ASSERT_EQ(HttpIOVecOps::planMergeWindow(makeEstimate(1, 1000000000)), kMaxWindow);
+}
+
+TEST(VectorPlan, Connections) {
+  // ranges of 100 KB on average
+  SortedRanges ranges;
+  ranges.push_back(std::make_pair(0, 49999));
+  ranges.push_back(std::make_pair(100000, 249999));
+
+  ASSERT_EQ(HttpIOVecOps::planConnections(EndpointEstimate(), ranges), kDefaultConnections);
+  ASSERT_EQ(HttpIOVecOps::planConnections(makeEstimate(0.05, 10000000), SortedRanges()), kDefaultConnections);
+
+  // 500 KB in flight per round trip: 5 ranges waiting, 1 being received
+  ASSERT_EQ(HttpIOVecOps::planConnections(makeEstimate(0.05, 10000000), ranges), 6u);
+
+  // ranges much larger than the bandwidth-delay product
+  ASSERT_EQ(HttpIOVecOps::planConnections(makeEstimate(0.001, 1000000), ranges), 1u);
+
+  // tiny ranges on a fat link
+  SortedRanges tiny;
+  tiny.push_back(std::make_pair(0, 9));
+  ASSERT_EQ(HttpIOVecOps::planConnections(makeEstimate(0.05, 10000000), tiny), kMaxConnections);
+}
@@ -10,6 +10,8 @@
 #include <xml/metalinkparser.hpp>
 #include <xml/s3propparser.hpp>
 #include <xml/S3MultiPartInitiationParser.hpp>
+#include <xml/S3MultiPartListParser.hpp>
+#include <xml/azureblocklistparser.hpp>
 #include <xml/swiftpropparser.hpp>
 #include <status/davixstatusrequest.hpp>
 #include <string.h>
@@ -436,6 +438,38 @@ const std::string s3_multipart_initiation_response = "<?xml version=\"1.0\" enco
 "   <UploadId>EXAMPLEJZ6e0YupT2h66iePQCc9IEbYbDUy4RTpMeoSMLPRp8Z5o1u8feSRonpvnWsKKG35tI2LB9VDPiCgTy.Gq2VxQLYjrue4Nq.NBdqI-</UploadId>"
 "</InitiateMultipartUploadResult>  ";
 
+const std::string s3_multipart_list_response = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+"<ListPartsResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"
+"   <Bucket>example-bucket</Bucket>"
+"   <Key>example-object</Key>"
+"   <UploadId>XXBsb2FkIElEIGZvciBlbHZpbmcncyVcdS1tb3ZpZS5tMnRzEEEwbG9hZA</UploadId>"
+"   <PartNumberMarker>1</PartNumberMarker>"
+"   <NextPartNumberMarker>3</NextPartNumberMarker>"
+"   <MaxParts>2</MaxParts>"
+"   <IsTruncated>true</IsTruncated>"
+"   <Part>"
+"     <PartNumber>2</PartNumber>"
+"     <LastModified>2010-11-10T20:48:34.000Z</LastModified>"
+"     <ETag>\"7778aef83f66abc1fa1e8477f296d394\"</ETag>"
+"     <Size>10485760</Size>"
+"   </Part>"
+"   <Part>"
+"     <PartNumber>3</PartNumber>"
+"     <LastModified>2010-11-10T20:48:33.000Z</LastModified>"
+"     <ETag>\"aaaa18db4cc2f85cedef654fccc4a4x8\"</ETag>"
+"     <Size>4</Size>"
+"   </Part>"
+"</ListPartsResult>";
+
+const std::string azure_block_list_response = "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+"<BlockList>"
+"  <CommittedBlocks />"
+"  <UncommittedBlocks>"
+"    <Block><Name>YmxvY2stMDAwMDAwMDAwMA==</Name><Size>4194304</Size></Block>"
+"    <Block><Name>YmxvY2stMDAwMDAwMDAwMQ==</Name><Size>1024</Size></Block>"
+"  </UncommittedBlocks>"
+"</BlockList>";
+
 const std::string swift_xml_response = "<?xml version=\"1.0\" encoding=\"UTF-8\"?><container name=\"backups\"><subdir name=\"photos/animals/\"><name>photos/animals/</name></subdir><object><name>photos/me.jpg</name><hash>b249a153f8f38b51e92916bbc6ea57ad</hash><bytes>2906</bytes><content_type>image/jpeg</content_type><last_modified>2015-12-03T17:31:28.187370</last_modified></object><subdir name=\"photos/plants/\"><name>photos/plants/</name></subdir></container>";
 
 TEST(XmlParserInstance, createParser){
@@ -503,6 +537,69 @@ TEST(XMLParserInstance,ParseList){
 }
 
 
+TEST(XMLParserInstance, ParseListByteByByte){
+    Davix::DavPropXMLParser whole, split;
+    whole.parseChunk(recursive_listing, strlen(recursive_listing));
+
+    // element names and values cut at every possible place
+    for(size_t i = 0; i < strlen(recursive_listing); ++i){
+        split.parseChunk(recursive_listing + i, 1);
+    }
+
+    ASSERT_EQ(whole.getProperties().size(), split.getProperties().size());
+    for(size_t i = 0; i < whole.getProperties().size(); ++i){
+        const Davix::FileProperties & a = whole.getProperties()[i];
+        const Davix::FileProperties & b = split.getProperties()[i];
+        ASSERT_EQ(a.filename, b.filename);
+        ASSERT_EQ(a.info.size, b.info.size);
+        ASSERT_EQ(a.info.mode, b.info.mode);
+        ASSERT_EQ(a.info.mtime, b.info.mtime);
+    }
+}
+
+
+TEST(XMLParserInstance, ParseListFullPaths){
+    Davix::DavPropXMLParser parser(true);
+    parser.parseChunk(recursive_listing, strlen(recursive_listing));
+
+    // Depth: infinity listings need the whole path of each entry
+    ASSERT_EQ(16u, parser.getProperties().size());
+    ASSERT_EQ("/pnfs/desy.de/data/dteam", parser.getProperties()[0].filename);
+    ASSERT_EQ("/pnfs/desy.de/data/dteam/g2", parser.getProperties()[1].filename);
+}
+
+
+TEST(XMLParserInstance, ParseListBatch){
+    Davix::DavPropXMLParser queued, batched;
+    queued.parseChunk(recursive_listing, strlen(recursive_listing));
+
+    // entries go to the batch while it is set, and only then
+    Davix::ListingBatch batch;
+    batched.setBatch(&batch);
+    for(size_t i = 0; i < strlen(recursive_listing); i += 100){
+        batched.parseChunk(recursive_listing + i, std::min<size_t>(100, strlen(recursive_listing) - i));
+    }
+    batched.setBatch(NULL);
+
+    ASSERT_TRUE(batched.getProperties().empty());
+    ASSERT_EQ(queued.getProperties().size(), batch.size());
+    for(size_t i = 0; i < batch.size(); ++i){
+        const Davix::FileProperties & f = queued.getProperties()[i];
+        ASSERT_EQ(f.filename, batch.name(i));
+        ASSERT_EQ(f.info.size, batch.info(i).size);
+        ASSERT_EQ(f.info.mode, batch.info(i).mode);
+        ASSERT_EQ(f.info.mtime, batch.info(i).mtime);
+    }
+
+    // reused without reallocating
+    const char* names = batch.name(0).data();
+    batch.clear();
+    ASSERT_TRUE(batch.empty());
+    batch.append("dteam", Davix::StatInfo());
+    ASSERT_EQ(names, batch.name(0).data());
+}
+
+
 TEST(XMLParserInstance, ParseCalDav){
 
 
@@ -694,6 +791,23 @@ TEST(XmlS3parsing, TestListingBucket){
     ASSERT_TRUE(parser.getNextMarker().empty());
 }
 
+TEST(XmlS3parsing, TestListingBatch){
+    using namespace Davix;
+    S3PropParser parser;
+    ListingBatch batch;
+
+    parser.setBatch(&batch);
+    ASSERT_EQ(0, parser.parseChunk(s3_xml_response));
+
+    ASSERT_TRUE(parser.getProperties().empty());
+    ASSERT_EQ(3u, batch.size());
+    ASSERT_EQ("a-random-random-bucket", batch.name(0));
+    ASSERT_EQ("h1big.root", batch.name(1));
+    ASSERT_EQ("services", batch.name(2));
+    ASSERT_EQ(280408881, batch.info(1).size);
+    ASSERT_TRUE(S_ISDIR(batch.info(0).mode));
+}
+
 TEST(XmlS3parsing, TestListingTruncated) {
     using namespace Davix;
     S3PropParser parser;
@@ -711,6 +825,18 @@ TEST(XmlS3parsing, TestListingTruncated) {
     ASSERT_EQ(std::string("dir/a.02"), parser.getNextMarker());
 }
 
+TEST(XmlS3parsing, TestListingTruncatedFlat) {
+    using namespace Davix;
+    S3PropParser parser(S3ListingMode::Flat, "");
+
+    int ret = parser.parseChunk(s3_xml_response_truncated);
+    ASSERT_EQ(0, ret);
+    ASSERT_EQ(3, parser.getProperties().size());
+
+    // flat listings are paginated too
+    ASSERT_EQ(std::string("dir/a.02"), parser.getNextMarker());
+}
+
 TEST(XmlS3parsing, TestListingTruncatedNoNextMarker) {
     using namespace Davix;
     S3PropParser parser;
@@ -740,6 +866,34 @@ TEST(XmlMultiPartUploadInitiationResponse, BasicSanity) {
     ASSERT_EQ(parser.getUploadId(), "EXAMPLEJZ6e0YupT2h66iePQCc9IEbYbDUy4RTpMeoSMLPRp8Z5o1u8feSRonpvnWsKKG35tI2LB9VDPiCgTy.Gq2VxQLYjrue4Nq.NBdqI-");
 }
 
+TEST(XmlMultiPartListResponse, BasicSanity) {
+    using namespace Davix;
+
+    S3MultiPartListParser parser;
+
+    int ret = parser.parseChunk(s3_multipart_list_response);
+    ASSERT_EQ(ret, 0);
+    ASSERT_EQ(parser.getParts().size(), 2u);
+    ASSERT_EQ(parser.getParts().at(2).first, "\"7778aef83f66abc1fa1e8477f296d394\"");
+    ASSERT_EQ(parser.getParts().at(2).second, 10485760u);
+    ASSERT_EQ(parser.getParts().at(3).second, 4u);
+
+    ASSERT_TRUE(parser.isTruncated());
+    ASSERT_EQ(parser.getNextPartNumberMarker(), "3");
+}
+
+TEST(XmlAzureBlockList, BasicSanity) {
+    using namespace Davix;
+
+    AzureBlockListParser parser;
+
+    int ret = parser.parseChunk(azure_block_list_response);
+    ASSERT_EQ(ret, 0);
+    ASSERT_EQ(parser.getBlocks().size(), 2u);
+    ASSERT_EQ(parser.getBlocks().at("YmxvY2stMDAwMDAwMDAwMA=="), 4194304u);
+    ASSERT_EQ(parser.getBlocks().at("YmxvY2stMDAwMDAwMDAwMQ=="), 1024u);
+}
+
 TEST(XmlSwiftParsing, TestListingDir) {
     using namespace Davix;
 
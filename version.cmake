@@ -0,0 +1,5 @@
+set(VERSION_MAJOR 0)
+set(VERSION_MINOR 8)
+set(VERSION_PATCH 11)
+set(VERSION_MINIPATCH @VERSION_MINIPATCH@)
+set(VERSION_FULL 0.8.11)